@@ -0,0 +1,29 @@
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+#include <filesystem>
+
+#include "Source/AssetPack.h"
+
+// Usage: AssetPacker <directory> <pack>
+int main(int argc, char* argv[])
+{
+    if (argc != 3) {
+        std::cerr << "usage: AssetPacker <directory> <pack>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        AssetPack::Build(argv[1], argv[2]);
+
+        AssetPack pack{ argv[2] };
+        std::cout << "packed " << pack.GetEntryCount() << " files from " << argv[1] << " into " << argv[2]
+            << " (" << std::filesystem::file_size(argv[2]) / 1024 << " KiB)" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
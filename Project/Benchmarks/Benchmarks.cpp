@@ -0,0 +1,546 @@
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <filesystem>
+#include <unordered_map>
+#include <limits>
+#include <random>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include "Source/Mesh.h"
+#include "Source/MeshCache.h"
+#include "Source/AsyncFileReader.h"
+#include "Source/VirtualFileSystem.h"
+#include "Source/VertexDeduplicator.h"
+#include "Source/BlockCompressor.h"
+#include "Source/AssetPack.h"
+#include "Source/InstanceBuffer.h"
+#include "Source/TransformStore.h"
+#include "Source/BoundsTable.h"
+#include "Source/Frustum.h"
+#include "Utils.h"
+#include "DataTypes.h"
+
+// Benchmarks that run without a window or a device, each prints its timings & MATCHING or MISMATCH where it checks a result
+namespace
+{
+    using Clock = std::chrono::high_resolution_clock;
+    using Milliseconds = std::chrono::duration<float, std::milli>;
+
+    void BenchmarkMeshCache()
+    {
+        std::cout << "mesh cache:\n";
+        for (const char* filePath : { "Resources/Models/vehicle.obj", "Resources/Models/viking_room.obj", "Resources/Models/fireFX.obj" })
+        {
+            // Cold: parse, deduplicate & calculate tangents, then write the cache
+            auto coldStart = Clock::now();
+            std::vector<config::VertexType> vertices{};
+            std::vector<uint32_t> indices{};
+            std::vector<MeshLod> lods{};
+            MeshletData meshlets{};
+            MeshBounds bounds = Mesh::LoadModel(filePath, vertices, indices, &lods, &meshlets);
+            MeshCache cache{ filePath };
+            cache.Write(config::VertexType::LayoutId, sizeof(config::VertexType), vertices.data(), static_cast<uint32_t>(vertices.size()), indices, bounds, lods, meshlets);
+            float coldTime = Milliseconds(Clock::now() - coldStart).count();
+
+            // Warm: map the cache and copy the blobs into the staging memory
+            auto warmStart = Clock::now();
+            if (cache.Open(config::VertexType::LayoutId, sizeof(config::VertexType)) == false) {
+                throw std::runtime_error("failed to open mesh cache!");
+            }
+            const size_t verticesSize{ static_cast<size_t>(cache.GetVertexCount()) * sizeof(config::VertexType) };
+            std::vector<char> staging(verticesSize + cache.GetIndexCount() * sizeof(uint32_t));
+            memcpy(staging.data(), cache.GetVertices(), verticesSize);
+            memcpy(staging.data() + verticesSize, cache.GetIndices(), cache.GetIndexCount() * sizeof(uint32_t));
+            float warmTime = Milliseconds(Clock::now() - warmStart).count();
+
+            // Warm without touching the mapping: read the blobs straight into the staging memory like the mesh does
+            auto readStart = Clock::now();
+            if (cache.Open(config::VertexType::LayoutId, sizeof(config::VertexType)) == false) {
+                throw std::runtime_error("failed to open mesh cache!");
+            }
+            AsyncFileReader reader{ 2 };
+            cache.ReadGeometry(reader, staging.data(), staging.data() + verticesSize);
+            reader.Wait();
+            float readTime = Milliseconds(Clock::now() - readStart).count();
+
+            std::cout << '\t' << filePath << ": cold " << coldTime << " ms, warm " << warmTime << " ms, warm read into staging " << readTime << " ms\n";
+        }
+        std::cout << '\n';
+    }
+
+    void BenchmarkVertexDeduplication()
+    {
+        std::cout << "vertex deduplication:\n";
+        for (const char* filePath : { "Resources/Models/vehicle.obj", "Resources/Models/viking_room.obj", "Resources/Models/fireFX.obj" })
+        {
+            std::vector<VertexPBR> corners{};
+            Mesh::LoadCorners(filePath, corners);
+
+            // Node based map with two lookups per corner
+            auto mapStart = Clock::now();
+            std::vector<VertexPBR> mapVertices{};
+            std::vector<uint32_t> mapIndices{};
+            std::unordered_map<VertexPBR, uint32_t> uniqueVertices{};
+            for (const VertexPBR& vertex : corners)
+            {
+                if (uniqueVertices.count(vertex) == 0) {
+                    uniqueVertices[vertex] = static_cast<uint32_t>(mapVertices.size());
+                    mapVertices.push_back(vertex);
+                }
+                mapIndices.push_back(uniqueVertices[vertex]);
+            }
+            float mapTime = Milliseconds(Clock::now() - mapStart).count();
+
+            auto tableStart = Clock::now();
+            std::vector<VertexPBR> tableVertices{};
+            std::vector<uint32_t> tableIndices{};
+            VertexDeduplicator<VertexPBR>::Deduplicate(corners, tableVertices, tableIndices);
+            float tableTime = Milliseconds(Clock::now() - tableStart).count();
+
+            auto sortStart = Clock::now();
+            std::vector<VertexPBR> sortVertices{};
+            std::vector<uint32_t> sortIndices{};
+            VertexDeduplicator<VertexPBR>::DeduplicateSorted(corners, sortVertices, sortIndices);
+            float sortTime = Milliseconds(Clock::now() - sortStart).count();
+
+            bool isEqual = mapIndices == tableIndices && mapIndices == sortIndices;
+            std::cout << '\t' << filePath << " (" << corners.size() << " corners, " << mapVertices.size() << " unique): "
+                << "unordered_map " << mapTime << " ms, flat table " << tableTime << " ms, parallel sort " << sortTime << " ms"
+                << (isEqual ? "\tMATCHING\n" : "\tMISMATCH\n");
+        }
+        std::cout << '\n';
+    }
+
+    void BenchmarkLodSelection()
+    {
+        std::vector<config::VertexType> vertices{};
+        std::vector<uint32_t> indices{};
+        std::vector<MeshLod> lods{};
+        const MeshBounds bounds = Mesh::LoadModel("Resources/Models/vehicle.obj", vertices, indices, &lods);
+        const float size = glm::length(bounds.max - bounds.min);
+
+        std::cout << "lod selection:\n";
+        for (size_t lod{ 0 }; lod < lods.size(); ++lod)
+        {
+            std::cout << "\tlod " << lod << ": " << lods[lod].IndexCount / 3 << " triangles, error " << lods[lod].Error << '\n';
+        }
+
+        // Same camera & upright vehicle as UpdateUniformBuffer at the default window size, looking down a 40 x 25 grid of vehicles that starts at the given distance
+        glm::mat4 proj = glm::perspective(glm::radians(45.0f), config::WIDTH / (float)config::HEIGHT, 0.1f, 100.0f);
+        float projectionScale = config::HEIGHT * 0.5f * std::abs(proj[1][1]);
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f, 1.0f, 5.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+        const glm::mat4 transform = glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), glm::vec3(1, 0, 0));
+
+        const uint32_t fullTriangleCount{ 1000 * lods[0].IndexCount / 3 };
+        for (float distance : { 1.f, 4.f, 16.f, 64.f, 256.f })
+        {
+            uint64_t triangleCount{ 0 };
+            std::vector<uint32_t> lodCounts(lods.size(), 0);
+            for (int x{ 0 }; x < 40; ++x)
+            {
+                for (int y{ 0 }; y < 25; ++y)
+                {
+                    glm::vec3 position{ (x - 20) * size * 1.5f, (distance + y * 1.5f) * size, 0.f };
+                    glm::mat4 modelView = view * glm::translate(glm::mat4(1.0f), position) * transform;
+
+                    // Starting from the coarsest level disables the hysteresis, every vehicle is selected from scratch
+                    uint32_t lod = Mesh::CalculateLod(lods, bounds, modelView, projectionScale, static_cast<uint32_t>(lods.size()) - 1);
+                    triangleCount += lods[lod].IndexCount / 3;
+                    ++lodCounts[lod];
+                }
+            }
+
+            std::cout << "\t1000 vehicles from " << distance << " vehicle sizes: " << triangleCount << " triangles ("
+                << 100.0 * triangleCount / fullTriangleCount << "% of full detail), per lod";
+            for (uint32_t count : lodCounts) std::cout << ' ' << count;
+            std::cout << '\n';
+        }
+        std::cout << '\n';
+    }
+
+    void BenchmarkTextureCompression()
+    {
+        // Same formats as LoadVehicleModel, the PSNR only covers the channels the format stores
+        const std::vector<std::pair<const char*, BlockFormat>> textures{
+            { "Resources/Textures/vehicle_diffuse.png", BlockFormat::BC7 },
+            { "Resources/Textures/vehicle_normal.png", BlockFormat::BC5 },
+            { "Resources/Textures/vehicle_specular.png", BlockFormat::BC7 },
+            { "Resources/Textures/vehicle_gloss.png", BlockFormat::BC4 } };
+        const BlockCompressor singleThreaded{ 1 };
+        const BlockCompressor multiThreaded{};
+
+        std::cout << "texture compression:\n";
+        for (const auto& [filePath, format] : textures)
+        {
+            AssetData file = vfs::Read(filePath);
+            int texWidth, texHeight, texChannels;
+            stbi_uc* pPixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file.GetData()), static_cast<int>(file.GetSize()), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+            if (!pPixels) {
+                throw std::runtime_error("failed to load texture image!");
+            }
+            const uint32_t width{ static_cast<uint32_t>(texWidth) }, height{ static_cast<uint32_t>(texHeight) };
+
+            auto singleStart = Clock::now();
+            singleThreaded.Compress(pPixels, width, height, format);
+            float singleTime = Milliseconds(Clock::now() - singleStart).count();
+
+            auto multiStart = Clock::now();
+            std::vector<uint8_t> blocks = multiThreaded.Compress(pPixels, width, height, format);
+            float multiTime = Milliseconds(Clock::now() - multiStart).count();
+
+            std::vector<uint8_t> decoded = multiThreaded.Decompress(blocks.data(), width, height, format);
+            const uint32_t channelCount{ format == BlockFormat::BC4 ? 1u : format == BlockFormat::BC5 ? 2u : 4u };
+            double squaredError{ 0.0 };
+            for (size_t pixel{ 0 }; pixel < static_cast<size_t>(width) * height; ++pixel)
+            {
+                for (uint32_t channel{ 0 }; channel < channelCount; ++channel)
+                {
+                    double difference{ static_cast<double>(pPixels[pixel * 4 + channel]) - decoded[pixel * 4 + channel] };
+                    squaredError += difference * difference;
+                }
+            }
+            const double meanSquaredError{ squaredError / (static_cast<double>(width) * height * channelCount) };
+            const double psnr{ meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : std::numeric_limits<double>::infinity() };
+            stbi_image_free(pPixels);
+
+            const float megaPixels{ width * height / 1'000'000.f };
+            std::cout << '\t' << filePath << " (" << width << 'x' << height << ", " << static_cast<size_t>(width) * height * 4 / 1024 << " KiB -> " << blocks.size() / 1024 << " KiB): "
+                << "PSNR " << psnr << " dB, 1 thread " << megaPixels / singleTime * 1000.f << " MPixel/s, all threads " << megaPixels / multiTime * 1000.f << " MPixel/s\n";
+        }
+        std::cout << '\n';
+    }
+
+    void BenchmarkAssetPack()
+    {
+        std::error_code error{};
+        if (std::filesystem::exists(config::ASSET_PACK_PATH, error) == false) {
+            std::cout << "asset pack: " << config::ASSET_PACK_PATH << " not found, build the AssetPack target first\n\n";
+            return;
+        }
+        const AssetPack singleThreaded{ config::ASSET_PACK_PATH.c_str(), 1 };
+        const AssetPack multiThreaded{ config::ASSET_PACK_PATH.c_str() };
+
+        // Loose files are read the way they used to be, through an ifstream
+        std::cout << "asset pack:\n";
+        for (const char* filePath : { "Resources/Models/vehicle.obj", "Resources/Textures/vehicle_diffuse.png", "Resources/Shaders/PBR.frag.spv" })
+        {
+            auto looseStart = Clock::now();
+            std::vector<char> looseData = util::ReadFile(filePath);
+            float looseTime = Milliseconds(Clock::now() - looseStart).count();
+
+            const PackEntry* pEntry = multiThreaded.Find(std::string_view{ filePath }.substr(std::string_view{ "Resources/" }.size()));
+            if (pEntry == nullptr) {
+                std::cout << '\t' << filePath << ": not in the pack\n";
+                continue;
+            }
+            std::vector<char> packedData(static_cast<size_t>(pEntry->Size));
+
+            auto singleStart = Clock::now();
+            singleThreaded.Read(*pEntry, packedData.data());
+            float singleTime = Milliseconds(Clock::now() - singleStart).count();
+
+            auto multiStart = Clock::now();
+            multiThreaded.Read(*pEntry, packedData.data());
+            float multiTime = Milliseconds(Clock::now() - multiStart).count();
+
+            std::cout << '\t' << filePath << " (" << pEntry->Size / 1024 << " KiB, " << (multiThreaded.IsStored(*pEntry) ? "stored" : "lz4") << "): loose "
+                << looseTime << " ms, pack 1 thread " << singleTime << " ms, all threads " << multiTime << " ms"
+                << (packedData == looseData ? "" : ", contents differ!") << '\n';
+        }
+        std::cout << '\n';
+    }
+
+    void BenchmarkFileReads()
+    {
+        std::vector<std::string> filePaths{};
+        size_t totalSize{ 0 };
+        for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator{ "Resources" })
+        {
+            if (entry.is_regular_file() == false) continue;
+            filePaths.push_back(entry.path().string());
+            totalSize += static_cast<size_t>(entry.file_size());
+        }
+
+        // Cold reads evict every file from the page cache first, which only works on Linux
+        std::cout << "file reads (" << filePaths.size() << " files, " << totalSize / 1024 << " KiB):\n";
+        for (const bool isCold : { true, false })
+        {
+            for (const bool useIoUring : { true, false })
+            {
+                if (isCold) {
+                    for (const std::string& filePath : filePaths) AsyncFileReader::DropCachedPages(filePath.c_str());
+                }
+
+                auto start = Clock::now();
+                AsyncFileReader reader{ 64, useIoUring };
+                size_t readSize{ 0 };
+                for (const std::string& filePath : filePaths)
+                {
+                    reader.Read(filePath.c_str(), [&readSize](std::vector<char>&& data) { readSize += data.size(); });
+                }
+                reader.Wait();
+                float time = Milliseconds(Clock::now() - start).count();
+
+                std::cout << '\t' << (isCold ? "cold" : "warm") << ", " << (reader.UsesIoUring() ? "io_uring" : "blocking") << ": " << time << " ms, "
+                    << readSize / 1'000'000.f / time * 1000.f << " MB/s" << (readSize == totalSize ? "" : ", sizes differ!") << '\n';
+            }
+        }
+        std::cout << '\n';
+    }
+
+    void BenchmarkInstanceFill()
+    {
+        // Same transform as the spinning vehicle, the destination stays resident like the persistently mapped slices
+        glm::mat4 transform = glm::rotate(glm::rotate(glm::mat4(1.0f), glm::radians(45.0f), glm::vec3(0, 0, 1)), glm::radians(90.0f), glm::vec3(1, 0, 0));
+        constexpr int repetitionCount{ 50 };
+
+        std::cout << "instance fill:\n";
+        for (uint32_t instanceCount : { 10'000u, 100'000u })
+        {
+            std::vector<InstanceData> instances(instanceCount);
+            const uint32_t side{ static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(instanceCount)))) };
+
+            // A full matrix product per instance, what filling the stream from separate mesh transforms would cost
+            auto multiplyStart = Clock::now();
+            for (int repetition{ 0 }; repetition < repetitionCount; ++repetition)
+            {
+                for (uint32_t i{ 0 }; i < instanceCount; ++i)
+                {
+                    glm::vec3 offset{ static_cast<float>(i % side), static_cast<float>(i / side), 0.f };
+                    instances[i].model = glm::translate(glm::mat4(1.0f), offset) * transform;
+                }
+            }
+            float multiplyTime = Milliseconds(Clock::now() - multiplyStart).count() / repetitionCount;
+
+            auto gridStart = Clock::now();
+            for (int repetition{ 0 }; repetition < repetitionCount; ++repetition)
+            {
+                InstanceBuffer::WriteGrid(instances.data(), instanceCount, transform, 1.f);
+            }
+            float gridTime = Milliseconds(Clock::now() - gridStart).count() / repetitionCount;
+
+            const float megaBytes{ sizeof(InstanceData) * instanceCount / (1024.f * 1024.f) };
+            std::cout << '\t' << instanceCount << " instances (" << megaBytes << " MiB): "
+                << "multiplied " << multiplyTime << " ms (" << instanceCount / multiplyTime / 1000.f << " M instances/s), "
+                << "WriteGrid " << gridTime << " ms (" << instanceCount / gridTime / 1000.f << " M instances/s, " << megaBytes / gridTime * 1000.f / 1024.f << " GiB/s)\n";
+        }
+        std::cout << '\n';
+    }
+
+    void BenchmarkTransformUpdate()
+    {
+        // Random roots, turned the way Mesh::SetRotation turns them
+        std::mt19937 generator{ 5489u };
+        std::uniform_real_distribution<float> positionDistribution{ -100.f, 100.f };
+        std::uniform_real_distribution<float> angleDistribution{ -180.f, 180.f };
+        std::uniform_real_distribution<float> scaleDistribution{ 0.25f, 4.f };
+
+        constexpr uint32_t transformCount{ 100'000 };
+        std::vector<glm::vec3> positions(transformCount), rotations(transformCount), scales(transformCount);
+        TransformStore store{};
+        for (uint32_t i{ 0 }; i < transformCount; ++i)
+        {
+            positions[i] = glm::vec3{ positionDistribution(generator), positionDistribution(generator), positionDistribution(generator) };
+            rotations[i] = glm::vec3{ angleDistribution(generator), angleDistribution(generator), angleDistribution(generator) };
+            scales[i] = glm::vec3{ scaleDistribution(generator), scaleDistribution(generator), scaleDistribution(generator) };
+
+            TransformStore::Handle handle = store.Create();
+            store.SetPosition(handle, positions[i]);
+            store.SetRotation(handle, glm::angleAxis(glm::radians(rotations[i].z), glm::vec3(0, 0, 1))
+                * glm::angleAxis(glm::radians(rotations[i].y), glm::vec3(0, 1, 0))
+                * glm::angleAxis(glm::radians(rotations[i].x), glm::vec3(1, 0, 0)));
+            store.SetScale(handle, scales[i]);
+        }
+
+        // What every mesh used to do for itself, once per draw
+        std::vector<glm::mat4> eulerMatrices(transformCount);
+        constexpr int repetitionCount{ 20 };
+        auto eulerStart = Clock::now();
+        for (int repetition{ 0 }; repetition < repetitionCount; ++repetition)
+        {
+            for (uint32_t i{ 0 }; i < transformCount; ++i)
+            {
+                glm::mat4 matRotX = glm::rotate(glm::mat4(1.0f), glm::radians(rotations[i].x), glm::vec3(1, 0, 0));
+                glm::mat4 matRotY = glm::rotate(glm::mat4(1.0f), glm::radians(rotations[i].y), glm::vec3(0, 1, 0));
+                glm::mat4 matRotZ = glm::rotate(glm::mat4(1.0f), glm::radians(rotations[i].z), glm::vec3(0, 0, 1));
+                eulerMatrices[i] = glm::translate(glm::mat4(1.0f), positions[i]) * matRotZ * matRotY * matRotX * glm::scale(glm::mat4(1.0f), scales[i]);
+            }
+        }
+        float eulerTime = Milliseconds(Clock::now() - eulerStart).count() / repetitionCount;
+
+        // Setting a position again is enough to mark every transform as dirty
+        float allTime{ 0.f };
+        for (int repetition{ 0 }; repetition < repetitionCount; ++repetition)
+        {
+            for (uint32_t i{ 0 }; i < transformCount; ++i) store.SetPosition(i, positions[i]);
+            auto allStart = Clock::now();
+            store.Update();
+            allTime += Milliseconds(Clock::now() - allStart).count();
+        }
+        allTime /= repetitionCount;
+
+        float maxDifference{ 0.f };
+        for (uint32_t i{ 0 }; i < transformCount; ++i)
+        {
+            const glm::mat4& world = store.GetWorld(i);
+            for (int column{ 0 }; column < 4; ++column)
+            {
+                for (int row{ 0 }; row < 4; ++row) maxDifference = std::max(maxDifference, std::abs(world[column][row] - eulerMatrices[i][column][row]));
+            }
+        }
+
+        // A frame where one in a hundred moved
+        float partialTime{ 0.f };
+        uint32_t partialCount{ 0 };
+        for (int repetition{ 0 }; repetition < repetitionCount; ++repetition)
+        {
+            for (uint32_t i{ static_cast<uint32_t>(repetition) }; i < transformCount; i += 100) store.SetPosition(i, positions[i]);
+            auto partialStart = Clock::now();
+            partialCount = store.Update();
+            partialTime += Milliseconds(Clock::now() - partialStart).count();
+        }
+        partialTime /= repetitionCount;
+
+        // Copying the finished matrices is as fast as the pass could ever get
+        std::vector<glm::mat4> copies(transformCount);
+        auto copyStart = Clock::now();
+        for (int repetition{ 0 }; repetition < repetitionCount; ++repetition) memcpy(copies.data(), store.GetWorldMatrices().data(), transformCount * sizeof(glm::mat4));
+        float copyTime = Milliseconds(Clock::now() - copyStart).count() / repetitionCount;
+
+        // A chain of children has to end up with the product of its local matrices
+        TransformStore chain{};
+        glm::mat4 expected{ 1.f };
+        TransformStore::Handle parent{ TransformStore::InvalidHandle };
+        for (uint32_t i{ 0 }; i < 8; ++i)
+        {
+            parent = chain.Create(parent);
+            chain.SetPosition(parent, glm::vec3{ 1.f, 0.f, 0.f });
+            chain.SetRotation(parent, glm::angleAxis(glm::radians(15.f), glm::vec3(0, 0, 1)));
+            expected = expected * glm::translate(glm::mat4(1.0f), glm::vec3{ 1.f, 0.f, 0.f }) * glm::rotate(glm::mat4(1.0f), glm::radians(15.f), glm::vec3(0, 0, 1));
+        }
+        chain.Update();
+        for (int column{ 0 }; column < 4; ++column)
+        {
+            for (int row{ 0 }; row < 4; ++row) maxDifference = std::max(maxDifference, std::abs(chain.GetWorld(parent)[column][row] - expected[column][row]));
+        }
+
+        // Inputs read & matrices written
+        const float megaBytes{ transformCount * (10 * sizeof(float) + sizeof(glm::mat4)) / (1024.f * 1024.f) };
+        const float copyMegaBytes{ transformCount * 2 * sizeof(glm::mat4) / (1024.f * 1024.f) };
+        std::cout << "transform update:\n";
+        std::cout << '\t' << transformCount << " transforms\n"
+            << "\teuler " << eulerTime << " ms (" << transformCount / eulerTime / 1000.f << " M transforms/s)\n"
+            << "\tall dirty " << allTime << " ms (" << transformCount / allTime / 1000.f << " M transforms/s, " << megaBytes / allTime * 1000.f / 1024.f << " GiB/s)\n"
+            << "\t" << partialCount << " dirty " << partialTime << " ms\n"
+            << "\tmemcpy " << copyTime << " ms (" << copyMegaBytes / copyTime * 1000.f / 1024.f << " GiB/s)\n"
+            << "\tmax difference " << maxDifference << '\n'
+            << (maxDifference < 1e-4f ? "\tMATCHING\n" : "\tMISMATCH\n") << '\n';
+    }
+
+    void BenchmarkObjectCulling()
+    {
+        // Same camera as UpdateUniformBuffer before the swap chain exists, looking into a cloud of randomly turned & scaled boxes
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, -50.0f, 5.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+        glm::mat4 proj = glm::perspective(glm::radians(45.0f), config::WIDTH / (float)config::HEIGHT, 0.1f, 100.0f);
+        proj[1][1] *= -1;
+        const Frustum frustum{ proj * view };
+
+        MeshBounds bounds{ glm::vec3{ -1.f, -2.f, -0.5f }, glm::vec3{ 1.f, 2.f, 0.5f } };
+        bounds.radius = glm::length(bounds.max - bounds.min) * 0.5f;
+        std::mt19937 generator{ 5489u };
+        std::uniform_real_distribution<float> positionDistribution{ -100.f, 100.f };
+        std::uniform_real_distribution<float> angleDistribution{ 0.f, glm::two_pi<float>() };
+        std::uniform_real_distribution<float> scaleDistribution{ 0.25f, 4.f };
+
+        constexpr uint32_t objectCount{ 1'000'000 };
+        BoundsTable table{};
+        for (uint32_t i{ 0 }; i < objectCount; ++i)
+        {
+            glm::vec3 position{ positionDistribution(generator), positionDistribution(generator), positionDistribution(generator) };
+            glm::mat4 transform = glm::translate(glm::mat4(1.0f), position);
+            transform = glm::rotate(transform, angleDistribution(generator), glm::vec3(0, 0, 1));
+            transform = glm::scale(transform, glm::vec3(scaleDistribution(generator)));
+            table.Add(bounds, transform);
+        }
+
+        std::vector<uint32_t> visible(objectCount), expected(objectCount);
+        constexpr int repetitionCount{ 20 };
+        uint32_t visibleCount{}, expectedCount{};
+
+        auto scalarStart = Clock::now();
+        for (int repetition{ 0 }; repetition < repetitionCount; ++repetition) expectedCount = table.CullScalar(frustum, expected.data());
+        float scalarTime = Milliseconds(Clock::now() - scalarStart).count() / repetitionCount;
+
+        auto simdStart = Clock::now();
+        for (int repetition{ 0 }; repetition < repetitionCount; ++repetition) visibleCount = table.Cull(frustum, visible.data());
+        float simdTime = Milliseconds(Clock::now() - simdStart).count() / repetitionCount;
+
+        bool isEqual = visibleCount == expectedCount && std::equal(visible.begin(), visible.begin() + visibleCount, expected.begin());
+
+        std::cout << "object culling:\n";
+        std::cout << '\t' << objectCount << " objects, " << visibleCount << " visible\n"
+            << "\tscalar " << scalarTime << " ms (" << objectCount / scalarTime / 1000.f << " M objects/s)\n"
+            << "\tsimd " << simdTime << " ms (" << objectCount / simdTime / 1000.f << " M objects/s)\n"
+            << (isEqual ? "\tMATCHING\n" : "\tMISMATCH\n") << '\n';
+    }
+}
+
+// Usage: Benchmarks [name...], runs every benchmark if no names are given, from the directory the Resources are copied to
+int main(int argc, char* argv[])
+{
+    const std::vector<std::pair<std::string_view, void(*)()>> benchmarks{
+        { "mesh-cache", BenchmarkMeshCache },
+        { "vertex-deduplication", BenchmarkVertexDeduplication },
+        { "lod-selection", BenchmarkLodSelection },
+        { "texture-compression", BenchmarkTextureCompression },
+        { "asset-pack", BenchmarkAssetPack },
+        { "file-reads", BenchmarkFileReads },
+        { "instance-fill", BenchmarkInstanceFill },
+        { "transform-update", BenchmarkTransformUpdate },
+        { "object-culling", BenchmarkObjectCulling },
+    };
+
+    for (int i{ 1 }; i < argc; ++i)
+    {
+        auto isNamed = [&](const auto& benchmark) { return benchmark.first == argv[i]; };
+        if (std::none_of(benchmarks.begin(), benchmarks.end(), isNamed)) {
+            std::cerr << "unknown benchmark " << argv[i] << ", pick from:";
+            for (const auto& benchmark : benchmarks) std::cerr << ' ' << benchmark.first;
+            std::cerr << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    try {
+        // Same mounts as the application, loose files override the pack
+        std::error_code error{};
+        if (std::filesystem::exists(config::ASSET_PACK_PATH, error)) vfs::MountPack(config::ASSET_PACK_PATH, "Resources/");
+        vfs::MountDirectory("Resources", "Resources/");
+
+        for (const auto& [name, pBenchmark] : benchmarks)
+        {
+            if (argc > 1 && std::find(argv + 1, argv + argc, name) == argv + argc) continue;
+            pBenchmark();
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -13,6 +13,7 @@ struct Vertex2D
     glm::vec2 texCoord{ 0.f, 0.f };
 
     bool operator==(const Vertex2D&) const = default;
+    static constexpr uint32_t LayoutId{ 1 }; // Identifies the memory layout in cached files, change it when the members change
 
     static constexpr VkVertexInputBindingDescription GetBindingDescription() {
         VkVertexInputBindingDescription bindingDescription{};
@@ -58,6 +59,7 @@ struct Vertex3D
     glm::vec2 texCoord{ 0.f, 0.f };
 
     bool operator==(const Vertex3D&) const = default;
+    static constexpr uint32_t LayoutId{ 2 };
 
     static constexpr VkVertexInputBindingDescription GetBindingDescription() {
         VkVertexInputBindingDescription bindingDescription{};
@@ -100,10 +102,11 @@ struct VertexPBR
 {
 	glm::vec3 pos{ 0.f, 0.f, 0.f };
 	glm::vec3 normal{ 0.f, 0.f, 0.f };
-	glm::vec3 tangent{ 0.f, 0.f, 0.f };
+	glm::vec4 tangent{ 0.f, 0.f, 0.f, 0.f }; // w is the bitangent sign, bitangent = w * cross(normal, tangent)
 	glm::vec2 texCoord{ 0.f, 0.f };
 
     bool operator==(const VertexPBR&) const = default;
+    static constexpr uint32_t LayoutId{ 3 };
 
     static constexpr VkVertexInputBindingDescription GetBindingDescription() {
         VkVertexInputBindingDescription bindingDescription{};
@@ -127,7 +130,7 @@ struct VertexPBR
 
         attributeDescriptions[2].binding = 0;
         attributeDescriptions[2].location = 2;
-        attributeDescriptions[2].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[2].format = VK_FORMAT_R32G32B32A32_SFLOAT;
         attributeDescriptions[2].offset = offsetof(VertexPBR, tangent);
 
         attributeDescriptions[3].binding = 0;
@@ -143,25 +146,130 @@ template<> struct std::hash<VertexPBR>
     size_t operator()(VertexPBR const& vertex) const {
         return (( (( std::hash<glm::vec3>()(vertex.pos) ^
             (std::hash<glm::vec3>()(vertex.normal) << 1)) >> 1) ^
-            (std::hash<glm::vec3>()(vertex.tangent) << 1)) >> 1) ^
+            (std::hash<glm::vec4>()(vertex.tangent) << 1)) >> 1) ^
             (std::hash<glm::vec2>()(vertex.texCoord) << 1);
     }
 };
 
-struct UniformBufferObject
+// 16 byte alternative to VertexPBR, decoded by PBR_Quantized.vert with the dequantization data in DrawConstants
+struct VertexPBRQuantized
+{
+    uint16_t pos[4]{ 0, 0, 0, 0 }; // Normalized inside of the mesh bounds, w is padding
+    uint32_t normalTangent{ 0 }; // Octahedral normal (10:10), tangent angle around the normal (10) & handedness (2)
+    uint32_t texCoord{ 0 }; // Half floats
+
+    bool operator==(const VertexPBRQuantized&) const = default;
+    static constexpr uint32_t LayoutId{ 4 };
+
+    static constexpr VkVertexInputBindingDescription GetBindingDescription() {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 0; // Index of the binding in the array of bindings
+        bindingDescription.stride = sizeof(VertexPBRQuantized); // Specifies number of bytes between entries
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX; // Move to next data entry after vertex/intance
+        return bindingDescription;
+    }
+    static constexpr std::array<VkVertexInputAttributeDescription, 3> GetAttributeDescriptions() {
+        std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{}; // One for each member variable
+
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+        attributeDescriptions[0].offset = offsetof(VertexPBRQuantized, pos);
+
+        attributeDescriptions[1].binding = 0;
+        attributeDescriptions[1].location = 1;
+        attributeDescriptions[1].format = VK_FORMAT_A2B10G10R10_UNORM_PACK32;
+        attributeDescriptions[1].offset = offsetof(VertexPBRQuantized, normalTangent);
+
+        attributeDescriptions[2].binding = 0;
+        attributeDescriptions[2].location = 2;
+        attributeDescriptions[2].format = VK_FORMAT_R16G16_SFLOAT;
+        attributeDescriptions[2].offset = offsetof(VertexPBRQuantized, texCoord);
+
+        return attributeDescriptions;
+    }
+};
+
+// Per instance stream of PBR_Instanced.vert, read from binding 1 once per instance
+struct InstanceData
 {
     alignas(16) glm::mat4 model;
-    alignas(16) glm::mat4 view;
-    alignas(16) glm::mat4 proj;
+
+    static constexpr uint32_t Binding{ 1 };
+    static constexpr uint32_t FirstLocation{ 4 }; // Right after the VertexPBR attributes, a mat4 takes four locations
+
+    static constexpr VkVertexInputBindingDescription GetBindingDescription() {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = Binding; // Index of the binding in the array of bindings
+        bindingDescription.stride = sizeof(InstanceData); // Specifies number of bytes between entries
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE; // Move to next data entry after vertex/intance
+        return bindingDescription;
+    }
+    static constexpr std::array<VkVertexInputAttributeDescription, 4> GetAttributeDescriptions() {
+        std::array<VkVertexInputAttributeDescription, 4> attributeDescriptions{}; // One for each column of the matrix
+
+        for (uint32_t column{ 0 }; column < 4; ++column)
+        {
+            attributeDescriptions[column].binding = Binding;
+            attributeDescriptions[column].location = FirstLocation + column;
+            attributeDescriptions[column].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+            attributeDescriptions[column].offset = static_cast<uint32_t>(offsetof(InstanceData, model) + sizeof(glm::vec4) * column);
+        }
+
+        return attributeDescriptions;
+    }
+};
+
+// Axis aligned box & sphere around all vertices of a mesh, in model space
+struct MeshBounds
+{
+    glm::vec3 min{ 0.f, 0.f, 0.f };
+    glm::vec3 max{ 0.f, 0.f, 0.f };
+    float radius{ 0.f }; // Around the center of the box, at most half its diagonal
+
+    glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
 };
-struct CameraViewProj
+
+// Level of detail, a part of the index range of a mesh that indexes the same vertices
+struct MeshLod
+{
+    uint32_t FirstIndex{ 0 }; // Relative to the first index of the mesh
+    uint32_t IndexCount{ 0 };
+    float Error{ 0.f }; // Largest distance to the full detail surface, in model units
+};
+
+struct CameraViewProj // 256 bytes, keeps the per frame uniform offsets a multiple of minUniformBufferOffsetAlignment
 {
     alignas(16) glm::mat4 invView;
     alignas(16) glm::mat4 view;
     alignas(16) glm::mat4 proj;
+    alignas(16) glm::mat4 viewProj; // proj * view, multiplied once per frame instead of once per vertex
+};
+struct DrawConstants // Per draw push constants of PBR.vert & PBR_Quantized.vert, 128 bytes is the size every device supports
+{
+    alignas(16) glm::mat4 mvp; // Of the position the vertex shader reads
+    alignas(16) glm::mat3x4 model; // Rows of the model matrix, a row_major mat4x3 in GLSL, its 3x3 part transforms the normals
+    alignas(16) glm::vec4 dequantScale; // Quantized positions are offset + pos * scale, the offset is part of mvp & model, unused by float vertices
+};
+struct ObjectData // Per object entry of the storage buffer read by Cull.comp & PBR_Indirect.vert, std430
+{
+    alignas(16) glm::mat4 model;
+    alignas(16) glm::vec4 boundingSphere; // Model space center & radius
+    uint32_t firstIndex; // Inside of the geometry pool, like VkDrawIndexedIndirectCommand
+    uint32_t indexCount;
+    int32_t vertexOffset;
+    uint32_t materialIndex;
+};
+struct CullConstants // Push constants of Cull.comp
+{
+    alignas(16) glm::vec4 planes[6]; // World space frustum planes, pointing inwards
+    uint32_t objectCount;
 };
-struct ModelTrans
+struct MeshletDrawConstants // Push constants of PBR_Meshlet.mesh, the same transforms as DrawConstants
 {
-    alignas(16) glm::mat4 pos;
+    alignas(16) glm::mat4 mvp;
+    alignas(16) glm::mat3x4 model;
+    uint32_t vertexOffset; // First vertex of the mesh inside of the geometry pool
+    uint32_t meshletCount;
 };
 #endif
\ No newline at end of file
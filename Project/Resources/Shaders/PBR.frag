@@ -16,15 +16,19 @@ layout(binding = 1) uniform sampler2D texSampler[4];
 #define specular    texSampler[2]
 #define glossiness  texSampler[3]
 
+// specular luminance in R & glossiness in G of one texture (R8G8 or BC5), the last sampler repeats it
+layout(constant_id = 0) const bool PACKED_SPECULAR_GLOSS = false;
+
 layout(binding = 0) uniform CameraData {
     mat4 invView;
     mat4 view;
     mat4 proj;
+    mat4 viewProj;
 } cam;
 
 layout(location = 0) in vec3 fragPosition;
 layout(location = 1) in vec3 fragNormal;
-layout(location = 2) in vec3 fragTangent;
+layout(location = 2) in vec4 fragTangent; // w is the bitangent sign
 layout(location = 3) in vec2 fragTexCoord;
 
 //---------------------------------------------------
@@ -57,10 +61,11 @@ void main() {
 	vec3 viewDirection = normalize(fragPosition - vec3(cam.invView[3].xyz));
 
 	// normal map
-	vec3 binormal = cross(fragNormal, fragTangent);
-	mat4 tangentSpaceAxis = mat4(vec4(fragTangent, 0.0), vec4(binormal, 0.0), vec4(fragNormal, 0.0), vec4(0.0, 0.0, 0.0, 1.0));
-	vec4 sampledColor = texture(normal, fragTexCoord);
-	vec3 partialColor = (2.0 * sampledColor.rgb) - vec3(1.0, 1.0, 1.0);
+	vec3 binormal = cross(fragNormal, fragTangent.xyz) * fragTangent.w;
+	mat4 tangentSpaceAxis = mat4(vec4(fragTangent.xyz, 0.0), vec4(binormal, 0.0), vec4(fragNormal, 0.0), vec4(0.0, 0.0, 0.0, 1.0));
+	// only XY are stored (BC5), Z follows from the unit length
+	vec2 sampledNormal = (2.0 * texture(normal, fragTexCoord).rg) - vec2(1.0, 1.0);
+	vec3 partialColor = vec3(sampledNormal, sqrt(clamp(1.0 - dot(sampledNormal, sampledNormal), 0.0, 1.0)));
 	vec3 normalResult = (tangentSpaceAxis * vec4(partialColor, 0.0)).xyz;
 
 	// observed area (lambert cosine law)
@@ -68,11 +73,20 @@ void main() {
 
 	// sampled textures
 	vec4 sampledDiffuse = texture(diffuse, fragTexCoord);
-	vec4 sampledSpecular = texture(specular, fragTexCoord);
-	vec4 sampledGlossiness = texture(glossiness, fragTexCoord);
+	vec3 sampledSpecular;
+	float sampledGlossiness;
+	if (PACKED_SPECULAR_GLOSS) {
+		vec2 sampledMasks = texture(specular, fragTexCoord).rg;
+		sampledSpecular = vec3(sampledMasks.r);
+		sampledGlossiness = sampledMasks.g;
+	}
+	else {
+		sampledSpecular = texture(specular, fragTexCoord).rgb;
+		sampledGlossiness = texture(glossiness, fragTexCoord).r;
+	}
 
 	finalColor += Lambert(gLightIntensity, sampledDiffuse.rgb) * dotProduct;
-	finalColor += Phong(sampledSpecular.rgb, gShininess * sampledGlossiness.r, -gLightDirection, viewDirection, normalResult) * dotProduct;
+	finalColor += Phong(sampledSpecular, gShininess * sampledGlossiness, -gLightDirection, viewDirection, normalResult) * dotProduct;
 	
 	outColor = vec4(finalColor, 1.0);
 }
\ No newline at end of file
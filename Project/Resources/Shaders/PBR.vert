@@ -2,19 +2,15 @@
 //---------------------------------------------------
 // Input Variables
 //---------------------------------------------------
-layout(binding = 0) uniform CameraData {
-    mat4 invView;
-    mat4 view;
-    mat4 proj;
-} cam;
-
-layout(binding = 2) uniform Model {
-    mat4 pos;
-} model;
+// Pushed for every draw, the view projection is already part of the MVP
+layout(push_constant) uniform DrawData {
+    mat4 mvp;
+    layout(row_major) mat4x3 model; // Its 3x3 part transforms the normals
+} draw;
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec3 inTangent;
+layout(location = 2) in vec4 inTangent; // w is the bitangent sign
 layout(location = 3) in vec2 inTexCoord;
 
 //---------------------------------------------------
@@ -22,17 +18,17 @@ layout(location = 3) in vec2 inTexCoord;
 //---------------------------------------------------
 layout(location = 0) out vec3 fragPosition;
 layout(location = 1) out vec3 fragNormal;
-layout(location = 2) out vec3 fragTangent;
+layout(location = 2) out vec4 fragTangent;
 layout(location = 3) out vec2 fragTexCoord;
 
 //---------------------------------------------------
 // Main Vertex Shader
 //---------------------------------------------------
 void main() {
-    gl_Position = cam.proj * cam.view * model.pos * vec4(inPosition, 1.0);
+    gl_Position = draw.mvp * vec4(inPosition, 1.0);
 
-    fragPosition = (model.pos * vec4(inPosition, 1.0)).xyz;
-    fragNormal = mat3(model.pos) * normalize(inNormal);
-    fragTangent = mat3(model.pos) * normalize(inTangent);
+    fragPosition = draw.model * vec4(inPosition, 1.0);
+    fragNormal = mat3(draw.model) * normalize(inNormal);
+    fragTangent = vec4(mat3(draw.model) * normalize(inTangent.xyz), inTangent.w);
     fragTexCoord = inTexCoord;
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+#version 450
+//---------------------------------------------------
+// Input Variables
+//---------------------------------------------------
+layout(binding = 0) uniform CameraData {
+    mat4 invView;
+    mat4 view;
+    mat4 proj;
+    mat4 viewProj;
+} cam;
+
+struct ObjectData {
+    mat4 model;
+    vec4 boundingSphere;
+    uint firstIndex;
+    uint indexCount;
+    int vertexOffset;
+    uint materialIndex;
+};
+
+// Indexed by the first instance Cull.comp wrote into the draw
+layout(std430, set = 1, binding = 0) readonly buffer Objects {
+    ObjectData objects[];
+};
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec4 inTangent; // w is the bitangent sign
+layout(location = 3) in vec2 inTexCoord;
+
+//---------------------------------------------------
+// Output Variables
+//---------------------------------------------------
+layout(location = 0) out vec3 fragPosition;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec4 fragTangent;
+layout(location = 3) out vec2 fragTexCoord;
+
+//---------------------------------------------------
+// Main Vertex Shader
+//---------------------------------------------------
+void main() {
+    mat4 model = objects[gl_InstanceIndex].model;
+    vec4 worldPosition = model * vec4(inPosition, 1.0);
+    gl_Position = cam.viewProj * worldPosition;
+
+    fragPosition = worldPosition.xyz;
+    fragNormal = mat3(model) * normalize(inNormal);
+    fragTangent = vec4(mat3(model) * normalize(inTangent.xyz), inTangent.w);
+    fragTexCoord = inTexCoord;
+}
\ No newline at end of file
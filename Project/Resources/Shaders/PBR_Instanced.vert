@@ -0,0 +1,38 @@
+#version 450
+//---------------------------------------------------
+// Input Variables
+//---------------------------------------------------
+layout(binding = 0) uniform CameraData {
+    mat4 invView;
+    mat4 view;
+    mat4 proj;
+    mat4 viewProj;
+} cam;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec4 inTangent; // w is the bitangent sign
+layout(location = 3) in vec2 inTexCoord;
+
+layout(location = 4) in mat4 inModel; // Per instance, takes locations 4 to 7
+
+//---------------------------------------------------
+// Output Variables
+//---------------------------------------------------
+layout(location = 0) out vec3 fragPosition;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec4 fragTangent;
+layout(location = 3) out vec2 fragTexCoord;
+
+//---------------------------------------------------
+// Main Vertex Shader
+//---------------------------------------------------
+void main() {
+    vec4 worldPosition = inModel * vec4(inPosition, 1.0);
+    gl_Position = cam.viewProj * worldPosition;
+
+    fragPosition = worldPosition.xyz;
+    fragNormal = mat3(inModel) * normalize(inNormal);
+    fragTangent = vec4(mat3(inModel) * normalize(inTangent.xyz), inTangent.w);
+    fragTexCoord = inTexCoord;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#version 450
+//---------------------------------------------------
+// Input Variables
+//---------------------------------------------------
+// Pushed for every draw, the view projection & the dequantization offset are already part of the matrices
+layout(push_constant) uniform DrawData {
+    mat4 mvp;
+    layout(row_major) mat4x3 model; // Its 3x3 part transforms the normals
+    vec4 dequantScale;
+} draw;
+
+layout(location = 0) in vec4 inPosition;      // Normalized inside of the mesh bounds
+layout(location = 1) in vec4 inNormalTangent; // Octahedral normal, tangent angle & handedness
+layout(location = 2) in vec2 inTexCoord;
+
+//---------------------------------------------------
+// Output Variables
+//---------------------------------------------------
+layout(location = 0) out vec3 fragPosition;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec4 fragTangent;
+layout(location = 3) out vec2 fragTexCoord;
+
+//---------------------------------------------------
+// Helper Functions (mirrored in VertexQuantizer.cpp)
+//---------------------------------------------------
+vec3 DecodeOctahedral(vec2 encoded)
+{
+    encoded = encoded * 2.0 - 1.0;
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-normal.z, 0.0);
+    normal.x += normal.x >= 0.0 ? -fold : fold;
+    normal.y += normal.y >= 0.0 ? -fold : fold;
+    return normalize(normal);
+}
+
+// Orthonormal basis around the normal without branches on its direction (Duff et al. 2017)
+void BuildBasis(vec3 normal, out vec3 axisX, out vec3 axisY)
+{
+    float s = normal.z >= 0.0 ? 1.0 : -1.0;
+    float a = -1.0 / (s + normal.z);
+    float b = normal.x * normal.y * a;
+    axisX = vec3(1.0 + s * normal.x * normal.x * a, s * b, -s * normal.x);
+    axisY = vec3(b, s + normal.y * normal.y * a, -normal.y);
+}
+
+//---------------------------------------------------
+// Main Vertex Shader
+//---------------------------------------------------
+void main() {
+    vec3 position = inPosition.xyz * draw.dequantScale.xyz;
+
+    vec3 normal = DecodeOctahedral(inNormalTangent.xy);
+    vec3 axisX, axisY;
+    BuildBasis(normal, axisX, axisY);
+    float angle = inNormalTangent.z * (1023.0 / 1024.0) * 6.28318530718;
+    vec3 tangent = cos(angle) * axisX + sin(angle) * axisY;
+
+    gl_Position = draw.mvp * vec4(position, 1.0);
+
+    fragPosition = draw.model * vec4(position, 1.0);
+    fragNormal = mat3(draw.model) * normal;
+    fragTangent = vec4(mat3(draw.model) * tangent, inNormalTangent.w > 0.5 ? 1.0 : -1.0);
+    fragTexCoord = inTexCoord;
+}
@@ -0,0 +1,322 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "AssetPack.h"
+#include "Lz4.h"
+#include <stdexcept>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <future>
+#include <thread>
+
+
+//-----------------------------------------------------------------
+// File Layout
+//-----------------------------------------------------------------
+namespace
+{
+	constexpr uint32_t FILE_MAGIC{ 0x4B415047 }; // "GPAK"
+	constexpr uint64_t DATA_ALIGNMENT{ 16 }; // Of stored entries & the tables
+
+	// Followed by the data, the entry & block tables and the names
+	struct FileHeader
+	{
+		uint32_t Magic{ FILE_MAGIC };
+		uint32_t Version{ AssetPack::Version };
+		uint32_t EntryCount{};
+		uint32_t BlockCount{};
+		uint64_t EntryOffset{};
+		uint64_t BlockOffset{};
+		uint64_t NameOffset{};
+		uint64_t NameSize{};
+	};
+
+	uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	constexpr size_t MIN_RANGE_SIZE{ 4 }; // Blocks per thread, smaller ranges don't make up for starting the thread
+	constexpr uint64_t MIN_SAVING_DIVISOR{ 8 }; // Files that don't shrink by at least 1/8th are stored
+
+	template<typename Function>
+	void ForEachRange(size_t count, size_t rangeCount, const Function& function)
+	{
+		std::vector<std::future<void>> tasks{};
+		for (size_t range{ 1 }; range < rangeCount; ++range)
+		{
+			size_t begin{ count * range / rangeCount }, end{ count * (range + 1) / rangeCount };
+			tasks.push_back(std::async(std::launch::async, [&function, begin, end]() { function(begin, end); }));
+		}
+		function(size_t{ 0 }, count / rangeCount);
+		for (std::future<void>& task : tasks) task.get();
+	}
+
+	uint32_t GetBlockCount(uint64_t size)
+	{
+		return static_cast<uint32_t>((size + AssetPack::BlockSize - 1) / AssetPack::BlockSize);
+	}
+
+	void WritePadding(std::ofstream& file, uint64_t& position, uint64_t alignment)
+	{
+		const char padding[DATA_ALIGNMENT]{};
+		uint64_t aligned{ AlignUp(position, alignment) };
+		file.write(padding, static_cast<std::streamsize>(aligned - position));
+		position = aligned;
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+AssetPack::AssetPack(const char* packPath, uint32_t threadCount)
+	: m_File{ packPath }
+	, m_ThreadCount{ threadCount }
+{
+	if (m_ThreadCount == 0) m_ThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+	FileHeader header{};
+	if (m_File.GetSize() < sizeof(header)) {
+		throw std::runtime_error("failed to read asset pack!");
+	}
+	memcpy(&header, m_File.GetData(), sizeof(header));
+
+	// Written by another build of the packer or truncated
+	const uint64_t fileSize{ m_File.GetSize() };
+	if (header.Magic != FILE_MAGIC || header.Version != Version
+		|| header.EntryOffset % DATA_ALIGNMENT != 0 || header.BlockOffset % DATA_ALIGNMENT != 0
+		|| header.EntryOffset + static_cast<uint64_t>(header.EntryCount) * sizeof(PackEntry) > fileSize
+		|| header.BlockOffset + static_cast<uint64_t>(header.BlockCount) * sizeof(PackBlock) > fileSize
+		|| header.NameOffset + header.NameSize > fileSize) {
+		throw std::runtime_error("failed to read asset pack!");
+	}
+
+	m_pEntries = reinterpret_cast<const PackEntry*>(m_File.GetData() + header.EntryOffset);
+	m_EntryCount = header.EntryCount;
+	m_pBlocks = reinterpret_cast<const PackBlock*>(m_File.GetData() + header.BlockOffset);
+	m_BlockCount = header.BlockCount;
+	m_pNames = m_File.GetData() + header.NameOffset;
+	m_NamesSize = header.NameSize;
+
+	// Checked once so reads never have to
+	for (uint32_t i{ 0 }; i < m_EntryCount; ++i)
+	{
+		const PackEntry& entry = m_pEntries[i];
+		bool isValid{ static_cast<uint64_t>(entry.NameOffset) + entry.NameSize <= m_NamesSize };
+		if (IsStored(entry)) isValid = isValid && entry.DataOffset + entry.Size <= fileSize;
+		else isValid = isValid && static_cast<uint64_t>(entry.FirstBlock) + GetBlockCount(entry.Size) <= m_BlockCount;
+		if (isValid == false) {
+			throw std::runtime_error("failed to read asset pack!");
+		}
+	}
+	for (uint32_t i{ 0 }; i < m_BlockCount; ++i)
+	{
+		if (m_pBlocks[i].Offset + m_pBlocks[i].Size > fileSize) {
+			throw std::runtime_error("failed to read asset pack!");
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+const PackEntry* AssetPack::Find(std::string_view name) const
+{
+	const uint64_t hash{ HashName(name) };
+	const PackEntry* pEnd = m_pEntries + m_EntryCount;
+	const PackEntry* pEntry = std::lower_bound(m_pEntries, pEnd, hash, [](const PackEntry& entry, uint64_t hash) { return entry.NameHash < hash; });
+
+	// Colliding names are next to each other
+	for (; pEntry != pEnd && pEntry->NameHash == hash; ++pEntry)
+	{
+		if (std::string_view{ m_pNames + pEntry->NameOffset, pEntry->NameSize } == name) return pEntry;
+	}
+	return nullptr;
+}
+
+void AssetPack::Read(const PackEntry& entry, char* pDst) const
+{
+	if (IsStored(entry)) {
+		memcpy(pDst, GetStoredData(entry), entry.Size);
+		return;
+	}
+
+	// Every block is independent, ranges of them are decompressed on separate threads
+	const size_t blockCount{ GetBlockCount(entry.Size) };
+	const size_t rangeCount{ std::clamp<size_t>(blockCount / MIN_RANGE_SIZE, 1, m_ThreadCount) };
+	ForEachRange(blockCount, rangeCount, [&](size_t begin, size_t end)
+		{
+			for (size_t i{ begin }; i < end; ++i)
+			{
+				const uint64_t offset{ static_cast<uint64_t>(i) * BlockSize };
+				ReadBlock(m_pBlocks[entry.FirstBlock + i], pDst + offset, static_cast<size_t>(std::min<uint64_t>(BlockSize, entry.Size - offset)));
+			}
+		});
+}
+
+void AssetPack::Build(const std::string& directory, const std::string& packPath, uint32_t threadCount)
+{
+	if (threadCount == 0) threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+	struct SourceFile
+	{
+		std::string Name{};
+		std::filesystem::path Path{};
+		uint64_t Hash{};
+	};
+
+	// Every regular file below the directory, sorted the way the index is searched
+	std::vector<SourceFile> sourceFiles{};
+	const std::string tempPath{ packPath + ".tmp" };
+	const std::filesystem::path packFile{ std::filesystem::weakly_canonical(packPath) };
+	const std::filesystem::path tempFile{ std::filesystem::weakly_canonical(tempPath) };
+	for (const std::filesystem::directory_entry& item : std::filesystem::recursive_directory_iterator(directory))
+	{
+		if (item.is_regular_file() == false) continue;
+
+		const std::filesystem::path path{ std::filesystem::canonical(item.path()) };
+		if (path == packFile || path == tempFile) continue;
+
+		std::string name{ std::filesystem::relative(item.path(), directory).generic_string() };
+		uint64_t hash{ HashName(name) };
+		sourceFiles.push_back({ std::move(name), item.path(), hash });
+	}
+	std::sort(sourceFiles.begin(), sourceFiles.end(), [](const SourceFile& a, const SourceFile& b) { return a.Hash != b.Hash ? a.Hash < b.Hash : a.Name < b.Name; });
+
+	std::vector<PackEntry> entries(sourceFiles.size());
+	std::vector<PackBlock> blocks{};
+	std::string names{};
+
+	// Write to a temporary file first so a failed build never leaves a half written pack behind
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			throw std::runtime_error("failed to write asset pack!");
+		}
+
+		FileHeader header{};
+		uint64_t position{ sizeof(header) };
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		std::vector<std::vector<char>> compressedBlocks{};
+		std::vector<size_t> compressedSizes{};
+		for (size_t i{ 0 }; i < sourceFiles.size(); ++i)
+		{
+			MappedFile source{ sourceFiles[i].Path.string().c_str() };
+			PackEntry& entry = entries[i];
+			entry.NameHash = sourceFiles[i].Hash;
+			entry.NameOffset = static_cast<uint32_t>(names.size());
+			entry.NameSize = static_cast<uint32_t>(sourceFiles[i].Name.size());
+			entry.Size = source.GetSize();
+			names += sourceFiles[i].Name;
+
+			// Compress all blocks first, the file is only worth decompressing if it shrinks enough
+			const size_t blockCount{ GetBlockCount(entry.Size) };
+			compressedBlocks.resize(std::max(compressedBlocks.size(), blockCount));
+			compressedSizes.assign(blockCount, 0);
+			const size_t rangeCount{ std::clamp<size_t>(blockCount / MIN_RANGE_SIZE, 1, threadCount) };
+			ForEachRange(blockCount, rangeCount, [&](size_t begin, size_t end)
+				{
+					for (size_t block{ begin }; block < end; ++block)
+					{
+						const uint64_t offset{ static_cast<uint64_t>(block) * BlockSize };
+						const size_t size{ static_cast<size_t>(std::min<uint64_t>(BlockSize, entry.Size - offset)) };
+						compressedBlocks[block].resize(lz4::GetMaxCompressedSize(size));
+						compressedSizes[block] = lz4::Compress(source.GetData() + offset, size, compressedBlocks[block].data(), compressedBlocks[block].size());
+						if (compressedSizes[block] == 0 || compressedSizes[block] >= size) compressedSizes[block] = size;
+					}
+				});
+
+			uint64_t packedSize{ 0 };
+			for (size_t size : compressedSizes) packedSize += size;
+			if (blockCount == 0 || packedSize > entry.Size - entry.Size / MIN_SAVING_DIVISOR) {
+				WritePadding(file, position, DATA_ALIGNMENT);
+				entry.DataOffset = position;
+				entry.Flags = StoredFlag;
+				file.write(source.GetData(), static_cast<std::streamsize>(entry.Size));
+				position += entry.Size;
+				continue;
+			}
+
+			entry.FirstBlock = static_cast<uint32_t>(blocks.size());
+			for (size_t block{ 0 }; block < blockCount; ++block)
+			{
+				const uint64_t offset{ static_cast<uint64_t>(block) * BlockSize };
+				const size_t size{ static_cast<size_t>(std::min<uint64_t>(BlockSize, entry.Size - offset)) };
+				const bool isStored{ compressedSizes[block] == size };
+				blocks.push_back({ position, static_cast<uint32_t>(compressedSizes[block]), isStored ? StoredFlag : 0 });
+				file.write(isStored ? source.GetData() + offset : compressedBlocks[block].data(), static_cast<std::streamsize>(compressedSizes[block]));
+				position += compressedSizes[block];
+			}
+		}
+
+		// Tables after the data, the header is written again once their offsets are known
+		WritePadding(file, position, DATA_ALIGNMENT);
+		header.EntryCount = static_cast<uint32_t>(entries.size());
+		header.EntryOffset = position;
+		file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(PackEntry)));
+		position += entries.size() * sizeof(PackEntry);
+
+		WritePadding(file, position, DATA_ALIGNMENT);
+		header.BlockCount = static_cast<uint32_t>(blocks.size());
+		header.BlockOffset = position;
+		file.write(reinterpret_cast<const char*>(blocks.data()), static_cast<std::streamsize>(blocks.size() * sizeof(PackBlock)));
+		position += blocks.size() * sizeof(PackBlock);
+
+		header.NameOffset = position;
+		header.NameSize = names.size();
+		file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+		file.seekp(0);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		if (!file.good()) {
+			file.close();
+			std::error_code error{};
+			std::filesystem::remove(tempPath, error);
+			throw std::runtime_error("failed to write asset pack!");
+		}
+	}
+
+	std::error_code error{};
+	std::filesystem::rename(tempPath, packPath, error);
+	if (error) {
+		std::filesystem::remove(tempPath, error);
+		throw std::runtime_error("failed to write asset pack!");
+	}
+}
+
+uint64_t AssetPack::HashName(std::string_view name)
+{
+	// FNV-1a
+	uint64_t hash{ 0xcbf29ce484222325ull };
+	for (char character : name) hash = (hash ^ static_cast<uint8_t>(character)) * 0x100000001b3ull;
+	return hash;
+}
+
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+void AssetPack::ReadBlock(const PackBlock& block, char* pDst, size_t size) const
+{
+	const char* pSrc = m_File.GetData() + block.Offset;
+	if ((block.Flags & StoredFlag) != 0 && block.Size == size) {
+		memcpy(pDst, pSrc, size);
+		return;
+	}
+	if ((block.Flags & StoredFlag) != 0 || lz4::Decompress(pSrc, block.Size, pDst, size) == false) {
+		throw std::runtime_error("failed to decompress asset!");
+	}
+}
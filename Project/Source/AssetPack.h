@@ -0,0 +1,88 @@
+#ifndef GP2VKT_ASSETPACK_H_
+#define GP2VKT_ASSETPACK_H_
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "MappedFile.h"
+
+// Class Forward Declarations
+
+
+// File of the pack, the index is sorted on the name hash
+struct PackEntry
+{
+	uint64_t NameHash{}; // FNV-1a of the name
+	uint32_t NameOffset{}; // Inside of the name table
+	uint32_t NameSize{};
+	uint64_t Size{}; // Uncompressed
+	uint64_t DataOffset{}; // Stored entries only, from the start of the pack
+	uint32_t FirstBlock{}; // Compressed entries only, one block per started BlockSize bytes
+	uint32_t Flags{};
+};
+
+// Compressed block of an entry, blocks that didn't shrink are stored as they are
+struct PackBlock
+{
+	uint64_t Offset{}; // From the start of the pack
+	uint32_t Size{}; // In the pack
+	uint32_t Flags{};
+};
+
+
+// Every file of a directory in one file, mapped as a whole so assets are read without opening other files
+// Files are split into blocks that are LZ4 compressed independently, the blocks of one file are decompressed in parallel
+// Files that don't compress (e.g. PNG) are stored as they are and read straight from the mapping
+class AssetPack final
+{
+public:
+	static constexpr uint32_t Version{ 1 }; // Bump when the file layout changes
+	static constexpr uint32_t BlockSize{ 64 * 1024 };
+	static constexpr uint32_t StoredFlag{ 1 }; // Of entries & blocks, the data isn't compressed
+
+	// Constructors and Destructor
+	explicit AssetPack(const char* packPath, uint32_t threadCount = 0); // 0 uses all hardware threads
+	~AssetPack() = default;
+
+	// Copy and Move semantics
+	AssetPack(const AssetPack& other)					= delete;
+	AssetPack& operator=(const AssetPack& other)		= delete;
+	AssetPack(AssetPack&& other) noexcept				= default;
+	AssetPack& operator=(AssetPack&& other) noexcept	= default;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	// Names are relative to the packed directory with forward slashes, e.g. "Textures/vehicle_diffuse.png"
+	const PackEntry* Find(std::string_view name) const; // nullptr if the pack doesn't have the file
+	uint32_t GetEntryCount() const { return m_EntryCount; }
+
+	bool IsStored(const PackEntry& entry) const { return (entry.Flags & StoredFlag) != 0; }
+	const char* GetStoredData(const PackEntry& entry) const { return m_File.GetData() + entry.DataOffset; } // Stored entries only
+	void Read(const PackEntry& entry, char* pDst) const; // Writes entry.Size bytes
+
+	// Packs every file below directory (except the pack itself), written next to packPath first & renamed once complete
+	static void Build(const std::string& directory, const std::string& packPath, uint32_t threadCount = 0);
+	static uint64_t HashName(std::string_view name);
+
+
+private:
+	// Member variables
+	MappedFile m_File{};
+	uint32_t m_ThreadCount{};
+
+	// Tables inside of the mapped file
+	const PackEntry* m_pEntries{ nullptr };
+	uint32_t m_EntryCount{};
+	const PackBlock* m_pBlocks{ nullptr };
+	uint32_t m_BlockCount{};
+	const char* m_pNames{ nullptr };
+	uint64_t m_NamesSize{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+	void ReadBlock(const PackBlock& block, char* pDst, size_t size) const;
+};
+#endif
@@ -0,0 +1,447 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "AsyncFileReader.h"
+#include <stdexcept>
+#include <filesystem>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define GP2VKT_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	constexpr size_t MAX_READ_SIZE{ size_t{ 1 } << 30 }; // Per request, larger files are read in several parts
+}
+
+
+//-----------------------------------------------------------------
+// Requests & Ring
+//-----------------------------------------------------------------
+struct AsyncFileReader::Request
+{
+	std::string FilePath{};
+	char* pDst{ nullptr };
+	uint64_t Offset{}; // In the file
+	size_t Size{};
+	size_t ReadSize{}; // Completed so far
+	std::vector<char> Buffer{}; // Only if the caller didn't give a destination
+	Callback OnComplete{};
+	IntoCallback OnCompleteInto{};
+#ifndef _WIN32
+	int File{ -1 };
+
+	~Request() { if (File >= 0) close(File); }
+#endif
+};
+
+#ifdef GP2VKT_IO_URING
+// Submission & completion queues shared with the kernel
+struct AsyncFileReader::Ring
+{
+	int File{ -1 };
+	void* pSqRing{ MAP_FAILED };
+	size_t SqRingSize{};
+	void* pCqRing{ MAP_FAILED };
+	size_t CqRingSize{};
+	io_uring_sqe* pSqes{ static_cast<io_uring_sqe*>(MAP_FAILED) };
+	size_t SqesSize{};
+
+	unsigned* pSqTail{ nullptr };
+	unsigned* pSqMask{ nullptr };
+	unsigned* pSqArray{ nullptr };
+	unsigned SqEntries{};
+	unsigned* pCqHead{ nullptr };
+	unsigned* pCqTail{ nullptr };
+	unsigned* pCqMask{ nullptr };
+	io_uring_cqe* pCqes{ nullptr };
+
+	~Ring()
+	{
+		if (pSqes != MAP_FAILED) munmap(pSqes, SqesSize);
+		if (pCqRing != MAP_FAILED && pCqRing != pSqRing) munmap(pCqRing, CqRingSize);
+		if (pSqRing != MAP_FAILED) munmap(pSqRing, SqRingSize);
+		if (File >= 0) close(File);
+	}
+
+	// nullptr if io_uring can't be used
+	static std::unique_ptr<Ring> Create(uint32_t entries)
+	{
+		auto pRing = std::make_unique<Ring>();
+		io_uring_params params{};
+		pRing->File = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+		if (pRing->File < 0) return nullptr;
+
+		// IORING_OP_READ needs Linux 5.6
+		std::vector<char> probeMemory(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op));
+		io_uring_probe* pProbe = reinterpret_cast<io_uring_probe*>(probeMemory.data());
+		if (syscall(__NR_io_uring_register, pRing->File, IORING_REGISTER_PROBE, pProbe, 256) < 0
+			|| pProbe->last_op < IORING_OP_READ || (pProbe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) == 0) return nullptr;
+
+		// Newer kernels map both rings at once
+		pRing->SqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		pRing->CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		const bool isSingleMapping{ (params.features & IORING_FEAT_SINGLE_MMAP) != 0 };
+		if (isSingleMapping) pRing->SqRingSize = pRing->CqRingSize = std::max(pRing->SqRingSize, pRing->CqRingSize);
+
+		pRing->pSqRing = mmap(nullptr, pRing->SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, pRing->File, IORING_OFF_SQ_RING);
+		if (pRing->pSqRing == MAP_FAILED) return nullptr;
+		pRing->pCqRing = isSingleMapping ? pRing->pSqRing : mmap(nullptr, pRing->CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, pRing->File, IORING_OFF_CQ_RING);
+		if (pRing->pCqRing == MAP_FAILED) return nullptr;
+		pRing->SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		pRing->pSqes = static_cast<io_uring_sqe*>(mmap(nullptr, pRing->SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, pRing->File, IORING_OFF_SQES));
+		if (pRing->pSqes == MAP_FAILED) return nullptr;
+
+		char* pSq = static_cast<char*>(pRing->pSqRing);
+		char* pCq = static_cast<char*>(pRing->pCqRing);
+		pRing->pSqTail = reinterpret_cast<unsigned*>(pSq + params.sq_off.tail);
+		pRing->pSqMask = reinterpret_cast<unsigned*>(pSq + params.sq_off.ring_mask);
+		pRing->pSqArray = reinterpret_cast<unsigned*>(pSq + params.sq_off.array);
+		pRing->SqEntries = params.sq_entries;
+		pRing->pCqHead = reinterpret_cast<unsigned*>(pCq + params.cq_off.head);
+		pRing->pCqTail = reinterpret_cast<unsigned*>(pCq + params.cq_off.tail);
+		pRing->pCqMask = reinterpret_cast<unsigned*>(pCq + params.cq_off.ring_mask);
+		pRing->pCqes = reinterpret_cast<io_uring_cqe*>(pCq + params.cq_off.cqes);
+		return pRing;
+	}
+};
+#else
+struct AsyncFileReader::Ring
+{
+};
+#endif
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+AsyncFileReader::AsyncFileReader(uint32_t queueDepth, bool useIoUring)
+{
+#ifdef GP2VKT_IO_URING
+	if (useIoUring) m_pRing = Ring::Create(std::max(queueDepth, 1u));
+#else
+	(void)queueDepth;
+	(void)useIoUring;
+#endif
+}
+
+
+//-----------------------------------------------------------------
+// Destructor
+//-----------------------------------------------------------------
+AsyncFileReader::~AsyncFileReader()
+{
+	// The kernel may still write into the buffers of the reads in flight, they complete without their callbacks
+	for (std::unique_ptr<Request>& pRequest : m_InFlight)
+	{
+		pRequest->OnComplete = nullptr;
+		pRequest->OnCompleteInto = nullptr;
+	}
+	try {
+		while (m_InFlight.empty() == false)
+		{
+			Enter(0, 1);
+			ReapCompletions();
+		}
+	}
+	catch (const std::exception&) {
+	}
+	UnregisterBuffer();
+}
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+bool AsyncFileReader::RegisterBuffer(char* pData, size_t size)
+{
+	UnregisterBuffer();
+#ifdef GP2VKT_IO_URING
+	if (m_pRing == nullptr) return false;
+
+	iovec range{ pData, size };
+	if (syscall(__NR_io_uring_register, m_pRing->File, IORING_REGISTER_BUFFERS, &range, 1) < 0) return false;
+	m_pRegistered = pData;
+	m_RegisteredSize = size;
+	return true;
+#else
+	(void)pData;
+	(void)size;
+	return false;
+#endif
+}
+
+void AsyncFileReader::UnregisterBuffer()
+{
+#ifdef GP2VKT_IO_URING
+	if (m_pRegistered) syscall(__NR_io_uring_register, m_pRing->File, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+#endif
+	m_pRegistered = nullptr;
+	m_RegisteredSize = 0;
+}
+
+void AsyncFileReader::Read(const char* filePath, Callback onComplete)
+{
+	Queue(filePath, 0, SIZE_MAX, nullptr, 0, std::move(onComplete), nullptr);
+}
+
+void AsyncFileReader::ReadInto(const char* filePath, char* pDst, size_t capacity, IntoCallback onComplete)
+{
+	Queue(filePath, 0, SIZE_MAX, pDst, capacity, nullptr, std::move(onComplete));
+}
+
+void AsyncFileReader::ReadRangeInto(const char* filePath, uint64_t offset, size_t size, char* pDst, IntoCallback onComplete)
+{
+	Queue(filePath, offset, size, pDst, size, nullptr, std::move(onComplete));
+}
+
+void AsyncFileReader::Submit()
+{
+	if (m_pRing == nullptr) return;
+	Enter(FillSubmissionQueue(), 0);
+}
+
+void AsyncFileReader::Wait()
+{
+	if (m_pRing == nullptr) {
+		// One blocking read after another
+		std::vector<std::unique_ptr<Request>> requests = std::move(m_Queued);
+		m_Queued.clear();
+		for (std::unique_ptr<Request>& pRequest : requests)
+		{
+			if (ReadBlocking(*pRequest)) Finish(*pRequest);
+			else m_HasFailed = true;
+			pRequest.reset();
+		}
+	}
+	else {
+		// Keep the queue full until everything completed
+		while (m_Queued.empty() == false || m_InFlight.empty() == false)
+		{
+			Enter(FillSubmissionQueue(), 1);
+			ReapCompletions();
+		}
+	}
+
+	if (m_HasFailed) {
+		m_HasFailed = false;
+		throw std::runtime_error("failed to read file!");
+	}
+}
+
+uint64_t AsyncFileReader::GetFileSize(const char* filePath)
+{
+	std::error_code error{};
+	uint64_t size{ std::filesystem::file_size(filePath, error) };
+	if (error) {
+		throw std::runtime_error("failed to open file!");
+	}
+	return size;
+}
+
+bool AsyncFileReader::DropCachedPages(const char* filePath)
+{
+#ifdef __linux__
+	int file = open(filePath, O_RDONLY | O_CLOEXEC);
+	if (file < 0) return false;
+	bool isDropped{ posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0 };
+	close(file);
+	return isDropped;
+#else
+	(void)filePath;
+	return false;
+#endif
+}
+
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+void AsyncFileReader::Queue(const char* filePath, uint64_t offset, size_t size, char* pDst, size_t capacity, Callback onComplete, IntoCallback onCompleteInto)
+{
+	auto pRequest = std::make_unique<Request>();
+	pRequest->FilePath = filePath;
+	pRequest->Offset = offset;
+	pRequest->OnComplete = std::move(onComplete);
+	pRequest->OnCompleteInto = std::move(onCompleteInto);
+
+	// Opened right away, only the reads are asynchronous
+#ifdef _WIN32
+	const uint64_t fileSize{ GetFileSize(filePath) };
+#else
+	pRequest->File = open(filePath, O_RDONLY | O_CLOEXEC);
+	struct stat fileStat {};
+	if (pRequest->File < 0 || fstat(pRequest->File, &fileStat) != 0) {
+		throw std::runtime_error("failed to open file!");
+	}
+	const uint64_t fileSize{ static_cast<uint64_t>(fileStat.st_size) };
+#endif
+	if (offset > fileSize || (size != SIZE_MAX && size > fileSize - offset)) {
+		throw std::runtime_error("failed to read file!");
+	}
+	pRequest->Size = size == SIZE_MAX ? static_cast<size_t>(fileSize - offset) : size;
+
+	if (pDst == nullptr) {
+		pRequest->Buffer.resize(pRequest->Size);
+		pDst = pRequest->Buffer.data();
+	}
+	else if (pRequest->Size > capacity) {
+		throw std::runtime_error("failed to fit file into buffer!");
+	}
+	pRequest->pDst = pDst;
+	m_Queued.push_back(std::move(pRequest));
+}
+
+uint32_t AsyncFileReader::FillSubmissionQueue()
+{
+	uint32_t submitCount{ 0 };
+#ifdef GP2VKT_IO_URING
+	while (m_Queued.empty() == false && m_InFlight.size() < m_pRing->SqEntries)
+	{
+		// Empty files never reach the kernel
+		std::unique_ptr<Request> pRequest = std::move(m_Queued.back());
+		m_Queued.pop_back();
+		if (pRequest->Size == 0) {
+			Finish(*pRequest);
+			continue;
+		}
+
+		PushRead(*pRequest);
+		m_InFlight.push_back(std::move(pRequest));
+		++submitCount;
+	}
+#endif
+	return submitCount;
+}
+
+void AsyncFileReader::PushRead(Request& request)
+{
+#ifdef GP2VKT_IO_URING
+	Ring& ring = *m_pRing;
+	const unsigned tail{ *ring.pSqTail }; // Only written by this thread
+	const unsigned index{ tail & *ring.pSqMask };
+
+	char* pDst = request.pDst + request.ReadSize;
+	const size_t size{ std::min(request.Size - request.ReadSize, MAX_READ_SIZE) };
+	const bool isRegistered{ m_pRegistered && pDst >= m_pRegistered && pDst + size <= m_pRegistered + m_RegisteredSize };
+
+	io_uring_sqe& entry = ring.pSqes[index];
+	memset(&entry, 0, sizeof(entry));
+	entry.opcode = isRegistered ? IORING_OP_READ_FIXED : IORING_OP_READ;
+	entry.fd = request.File;
+	entry.off = request.Offset + request.ReadSize;
+	entry.addr = reinterpret_cast<uint64_t>(pDst);
+	entry.len = static_cast<uint32_t>(size);
+	entry.buf_index = 0;
+	entry.user_data = reinterpret_cast<uint64_t>(&request);
+
+	ring.pSqArray[index] = index;
+	std::atomic_ref<unsigned>{ *ring.pSqTail }.store(tail + 1, std::memory_order_release);
+#else
+	(void)request;
+#endif
+}
+
+void AsyncFileReader::Enter(uint32_t submitCount, uint32_t waitCount)
+{
+#ifdef GP2VKT_IO_URING
+	// Interrupted calls submitted nothing, partial submissions are retried
+	while (submitCount > 0 || waitCount > 0)
+	{
+		long result = syscall(__NR_io_uring_enter, m_pRing->File, submitCount, waitCount, waitCount > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+		if (result < 0) {
+			if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+			throw std::runtime_error("failed to submit file reads!");
+		}
+		submitCount -= static_cast<uint32_t>(result);
+		waitCount = 0;
+	}
+#else
+	(void)submitCount;
+	(void)waitCount;
+#endif
+}
+
+void AsyncFileReader::ReapCompletions()
+{
+#ifdef GP2VKT_IO_URING
+	Ring& ring = *m_pRing;
+	unsigned head{ *ring.pCqHead }; // Only written by this thread
+	const unsigned tail{ std::atomic_ref<unsigned>{ *ring.pCqTail }.load(std::memory_order_acquire) };
+	std::vector<std::pair<Request*, int>> completions{};
+	for (; head != tail; ++head)
+	{
+		const io_uring_cqe& entry = ring.pCqes[head & *ring.pCqMask];
+		completions.emplace_back(reinterpret_cast<Request*>(entry.user_data), entry.res);
+	}
+	std::atomic_ref<unsigned>{ *ring.pCqHead }.store(head, std::memory_order_release);
+
+	uint32_t resubmitCount{ 0 };
+	for (const auto& [pRequest, result] : completions)
+	{
+		// Short reads continue where they stopped, a file that shrank fails
+		if (result == -EINTR || result == -EAGAIN || (result > 0 && pRequest->ReadSize + result < pRequest->Size)) {
+			if (result > 0) pRequest->ReadSize += static_cast<size_t>(result);
+			PushRead(*pRequest);
+			++resubmitCount;
+			continue;
+		}
+
+		auto it = std::find_if(m_InFlight.begin(), m_InFlight.end(), [pRequest](const std::unique_ptr<Request>& pInFlight) { return pInFlight.get() == pRequest; });
+		std::unique_ptr<Request> pDone = std::move(*it);
+		*it = std::move(m_InFlight.back());
+		m_InFlight.pop_back();
+
+		if (result > 0) {
+			pDone->ReadSize += static_cast<size_t>(result);
+			Finish(*pDone);
+		}
+		else {
+			m_HasFailed = true;
+		}
+	}
+	Enter(resubmitCount, 0);
+#endif
+}
+
+void AsyncFileReader::Finish(Request& request)
+{
+	if (request.OnComplete) request.OnComplete(std::move(request.Buffer));
+	else if (request.OnCompleteInto) request.OnCompleteInto(request.Size);
+}
+
+bool AsyncFileReader::ReadBlocking(Request& request)
+{
+#ifdef _WIN32
+	std::ifstream file(request.FilePath, std::ios::binary);
+	file.seekg(static_cast<std::streamoff>(request.Offset));
+	return file.read(request.pDst, static_cast<std::streamsize>(request.Size)).good() || request.Size == 0;
+#else
+	while (request.ReadSize < request.Size)
+	{
+		ssize_t result = pread(request.File, request.pDst + request.ReadSize, std::min(request.Size - request.ReadSize, MAX_READ_SIZE), static_cast<off_t>(request.Offset + request.ReadSize));
+		if (result < 0 && errno == EINTR) continue;
+		if (result <= 0) return false;
+		request.ReadSize += static_cast<size_t>(result);
+	}
+	return true;
+#endif
+}
@@ -0,0 +1,78 @@
+#ifndef GP2VKT_ASYNCFILEREADER_H_
+#define GP2VKT_ASYNCFILEREADER_H_
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+
+// Class Forward Declarations
+
+
+// Reads whole files in batches, on Linux every queued read goes to the kernel in one io_uring submission
+// Falls back to blocking reads in Wait when io_uring isn't available (other platforms, old kernels or seccomp filters)
+class AsyncFileReader final
+{
+public:
+	using Callback = std::function<void(std::vector<char>&& data)>;
+	using IntoCallback = std::function<void(size_t size)>;
+
+	// Constructors and Destructor
+	explicit AsyncFileReader(uint32_t queueDepth = 64, bool useIoUring = true); // Reads in flight at once
+	~AsyncFileReader();
+
+	// Copy and Move semantics
+	AsyncFileReader(const AsyncFileReader& other)					= delete;
+	AsyncFileReader& operator=(const AsyncFileReader& other)		= delete;
+	AsyncFileReader(AsyncFileReader&& other) noexcept				= delete;
+	AsyncFileReader& operator=(AsyncFileReader&& other) noexcept	= delete;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	bool UsesIoUring() const { return m_pRing != nullptr; }
+
+	// Reads that land inside of [pData, pData + size) skip pinning their pages for every request
+	// Only one range at a time, false if the kernel refused it (e.g. RLIMIT_MEMLOCK) or io_uring isn't used
+	bool RegisterBuffer(char* pData, size_t size);
+	void UnregisterBuffer();
+
+	// Queue a read of the whole file, nothing is submitted until Submit or Wait, throws if the file can't be opened
+	void Read(const char* filePath, Callback onComplete); // Reads into a buffer that's handed to the callback
+	void ReadInto(const char* filePath, char* pDst, size_t capacity, IntoCallback onComplete); // Throws if the file is larger than capacity
+	void ReadRangeInto(const char* filePath, uint64_t offset, size_t size, char* pDst, IntoCallback onComplete); // Throws if the range goes past the end of the file
+	void Submit(); // Everything queued since the last call in one system call
+	void Wait(); // Runs the callbacks on this thread as the reads complete, throws once all are done if one of them failed
+
+	static uint64_t GetFileSize(const char* filePath); // Throws if the file doesn't exist
+	static bool DropCachedPages(const char* filePath); // Evicts the file from the page cache for cold reads, Linux only
+
+
+private:
+	struct Request;
+	struct Ring;
+
+	// Member variables
+	std::unique_ptr<Ring> m_pRing{};
+	std::vector<std::unique_ptr<Request>> m_Queued{}; // Not submitted yet
+	std::vector<std::unique_ptr<Request>> m_InFlight{};
+	bool m_HasFailed{ false };
+
+	// Registered buffer
+	char* m_pRegistered{ nullptr };
+	size_t m_RegisteredSize{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+	void Queue(const char* filePath, uint64_t offset, size_t size, char* pDst, size_t capacity, Callback onComplete, IntoCallback onCompleteInto); // SIZE_MAX reads up to the end
+	uint32_t FillSubmissionQueue(); // Returns the number of new entries
+	void PushRead(Request& request);
+	void Enter(uint32_t submitCount, uint32_t waitCount);
+	void ReapCompletions();
+	void Finish(Request& request); // Runs the callback & releases the request
+	static bool ReadBlocking(Request& request);
+};
+#endif
@@ -0,0 +1,585 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "BlockCompressor.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <future>
+#include <thread>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GP2VKT_BLOCK_SSE2
+#include <emmintrin.h>
+#endif
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	constexpr uint32_t CHANNEL_COUNT{ 4 };
+	constexpr uint32_t BLOCK_DIMENSION{ 4 };
+	constexpr uint32_t BLOCK_TEXEL_COUNT{ BLOCK_DIMENSION * BLOCK_DIMENSION };
+	constexpr size_t MIN_RANGE_SIZE{ 1024 }; // Blocks per thread, smaller ranges don't make up for starting the thread
+	constexpr uint32_t BC7_REFINE_ITERATIONS{ 2 }; // Least squares passes over the endpoints, stops early once the error doesn't improve
+	constexpr uint32_t BC7_MODE{ 6 };
+	constexpr uint32_t BC7_WEIGHT_COUNT{ 16 };
+	constexpr int BC7_WEIGHTS[BC7_WEIGHT_COUNT]{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+	constexpr uint8_t BC4_RAMP_TO_INDEX[8]{ 1, 7, 6, 5, 4, 3, 2, 0 }; // Index of every step from the second (lowest) to the first endpoint
+
+	// Texels of one block, one array per channel so 4 texels fit an SSE register
+	struct Block
+	{
+		alignas(16) float Channels[CHANNEL_COUNT][BLOCK_TEXEL_COUNT]{};
+	};
+
+	template<typename Function>
+	void ForEachRange(size_t count, size_t rangeCount, const Function& function)
+	{
+		std::vector<std::future<void>> tasks{};
+		for (size_t range{ 1 }; range < rangeCount; ++range)
+		{
+			size_t begin{ count * range / rangeCount }, end{ count * (range + 1) / rangeCount };
+			tasks.push_back(std::async(std::launch::async, [&function, begin, end]() { function(begin, end); }));
+		}
+		function(size_t{ 0 }, count / rangeCount);
+		for (std::future<void>& task : tasks) task.get();
+	}
+
+	// Edge blocks clamp to the last row & column
+	void LoadBlock(const uint8_t* pPixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, Block& block)
+	{
+		for (uint32_t y{ 0 }; y < BLOCK_DIMENSION; ++y)
+		{
+			const uint8_t* pRow = pPixels + static_cast<size_t>(std::min(blockY * BLOCK_DIMENSION + y, height - 1)) * width * CHANNEL_COUNT;
+			for (uint32_t x{ 0 }; x < BLOCK_DIMENSION; ++x)
+			{
+				const uint8_t* pTexel = pRow + static_cast<size_t>(std::min(blockX * BLOCK_DIMENSION + x, width - 1)) * CHANNEL_COUNT;
+				for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+				{
+					block.Channels[channel][y * BLOCK_DIMENSION + x] = pTexel[channel];
+				}
+			}
+		}
+	}
+
+	// Least significant bit first, the block is zeroed before writing
+	class BitWriter final
+	{
+	public:
+		explicit BitWriter(uint8_t* pData) : m_pData{ pData } {}
+
+		void Write(uint32_t value, uint32_t bitCount)
+		{
+			for (uint32_t bit{ 0 }; bit < bitCount; ++bit, ++m_Position)
+			{
+				if ((value >> bit) & 1) m_pData[m_Position / 8] |= static_cast<uint8_t>(1 << (m_Position % 8));
+			}
+		}
+
+	private:
+		uint8_t* m_pData{ nullptr };
+		uint32_t m_Position{ 0 };
+	};
+
+	class BitReader final
+	{
+	public:
+		explicit BitReader(const uint8_t* pData) : m_pData{ pData } {}
+
+		uint32_t Read(uint32_t bitCount)
+		{
+			uint32_t value{ 0 };
+			for (uint32_t bit{ 0 }; bit < bitCount; ++bit, ++m_Position)
+			{
+				value |= static_cast<uint32_t>((m_pData[m_Position / 8] >> (m_Position % 8)) & 1) << bit;
+			}
+			return value;
+		}
+
+	private:
+		const uint8_t* m_pData{ nullptr };
+		uint32_t m_Position{ 0 };
+	};
+
+	//---------------------------
+	// BC4
+	//---------------------------
+	// Value of every step between the lowest & highest endpoint, the 8 value mode
+	void GetBc4Ramp(int low, int high, int (&ramp)[8])
+	{
+		for (int step{ 0 }; step < 8; ++step) ramp[step] = (step * high + (7 - step) * low + 3) / 7;
+	}
+
+	float AssignBc4Steps(const float* pValues, int low, int high, uint8_t (&steps)[BLOCK_TEXEL_COUNT])
+	{
+		int ramp[8]{};
+		GetBc4Ramp(low, high, ramp);
+
+		// The closest step is next to the rounded projection, the ramp values are rounded
+		float error{ 0.f };
+		const float scale{ 7.f / std::max(high - low, 1) };
+		for (uint32_t texel{ 0 }; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			int guess{ std::clamp(static_cast<int>(std::lround((pValues[texel] - low) * scale)), 0, 7) };
+			int bestStep{ guess };
+			float bestError{ std::abs(pValues[texel] - ramp[guess]) };
+			for (int step{ std::max(guess - 1, 0) }; step <= std::min(guess + 1, 7); ++step)
+			{
+				float stepError{ std::abs(pValues[texel] - ramp[step]) };
+				if (stepError < bestError) {
+					bestError = stepError;
+					bestStep = step;
+				}
+			}
+			steps[texel] = static_cast<uint8_t>(bestStep);
+			error += bestError * bestError;
+		}
+		return error;
+	}
+
+	// The values of 16 texels from a single channel
+	void EncodeBc4(const float* pValues, uint8_t* pDst)
+	{
+		const auto [pMin, pMax] = std::minmax_element(pValues, pValues + BLOCK_TEXEL_COUNT);
+		int low{ static_cast<int>(*pMin) }, high{ static_cast<int>(*pMax) };
+
+		// Equal endpoints select the 6 value mode, every texel uses the first endpoint
+		std::memset(pDst, 0, 8);
+		if (low == high) {
+			pDst[0] = pDst[1] = static_cast<uint8_t>(low);
+			return;
+		}
+
+		uint8_t steps[BLOCK_TEXEL_COUNT]{};
+		float error{ AssignBc4Steps(pValues, low, high, steps) };
+
+		// Least squares endpoints for the chosen steps, kept if they are still ordered & lower the error
+		float a{ 0.f }, b{ 0.f }, c{ 0.f }, x0{ 0.f }, x1{ 0.f };
+		for (uint32_t texel{ 0 }; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			float t{ steps[texel] / 7.f };
+			a += (1.f - t) * (1.f - t);
+			b += (1.f - t) * t;
+			c += t * t;
+			x0 += (1.f - t) * pValues[texel];
+			x1 += t * pValues[texel];
+		}
+		const float determinant{ a * c - b * b };
+		if (std::abs(determinant) > 1e-6f) {
+			int refinedLow{ std::clamp(static_cast<int>(std::lround((c * x0 - b * x1) / determinant)), 0, 255) };
+			int refinedHigh{ std::clamp(static_cast<int>(std::lround((a * x1 - b * x0) / determinant)), 0, 255) };
+			uint8_t refinedSteps[BLOCK_TEXEL_COUNT]{};
+			if (refinedHigh > refinedLow) {
+				float refinedError{ AssignBc4Steps(pValues, refinedLow, refinedHigh, refinedSteps) };
+				if (refinedError < error) {
+					low = refinedLow;
+					high = refinedHigh;
+					std::copy(refinedSteps, refinedSteps + BLOCK_TEXEL_COUNT, steps);
+				}
+			}
+		}
+
+		// The first endpoint being the highest selects the 8 value mode
+		pDst[0] = static_cast<uint8_t>(high);
+		pDst[1] = static_cast<uint8_t>(low);
+		BitWriter stream{ pDst + 2 };
+		for (uint32_t texel{ 0 }; texel < BLOCK_TEXEL_COUNT; ++texel) stream.Write(BC4_RAMP_TO_INDEX[steps[texel]], 3);
+	}
+
+	void DecodeBc4(const uint8_t* pSrc, uint8_t (&values)[BLOCK_TEXEL_COUNT])
+	{
+		const int first{ pSrc[0] }, second{ pSrc[1] };
+		int palette[8]{ first, second };
+		if (first > second) {
+			for (int index{ 2 }; index < 8; ++index) palette[index] = ((8 - index) * first + (index - 1) * second + 3) / 7;
+		}
+		else {
+			for (int index{ 2 }; index < 6; ++index) palette[index] = ((6 - index) * first + (index - 1) * second + 2) / 5;
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+
+		BitReader stream{ pSrc + 2 };
+		for (uint32_t texel{ 0 }; texel < BLOCK_TEXEL_COUNT; ++texel) values[texel] = static_cast<uint8_t>(palette[stream.Read(3)]);
+	}
+
+	//---------------------------
+	// BC7 mode 6
+	//---------------------------
+	// 7 bit channels with a shared lowest bit per endpoint, stored expanded to 8 bits
+	using Bc7Endpoints = int[2][CHANNEL_COUNT];
+
+	void QuantizeBc7Endpoint(const float (&color)[CHANNEL_COUNT], int (&endpoint)[CHANNEL_COUNT])
+	{
+		float bestError{ std::numeric_limits<float>::max() };
+		for (int pBit{ 0 }; pBit < 2; ++pBit)
+		{
+			int candidate[CHANNEL_COUNT]{};
+			float error{ 0.f };
+			for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+			{
+				int value{ std::clamp(static_cast<int>(std::lround((color[channel] - pBit) * 0.5f)), 0, 127) };
+				candidate[channel] = value * 2 + pBit;
+				error += (candidate[channel] - color[channel]) * (candidate[channel] - color[channel]);
+			}
+			if (error < bestError) {
+				bestError = error;
+				std::copy(candidate, candidate + CHANNEL_COUNT, endpoint);
+			}
+		}
+	}
+
+	void GetBc7Palette(const Bc7Endpoints& endpoints, float (&palette)[BC7_WEIGHT_COUNT][CHANNEL_COUNT])
+	{
+		for (uint32_t index{ 0 }; index < BC7_WEIGHT_COUNT; ++index)
+		{
+			for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+			{
+				int weight{ BC7_WEIGHTS[index] };
+				palette[index][channel] = static_cast<float>(((64 - weight) * endpoints[0][channel] + weight * endpoints[1][channel] + 32) >> 6);
+			}
+		}
+	}
+
+	// Closest palette entry of every texel, returns the summed squared error
+	float AssignBc7Indices(const Block& block, const Bc7Endpoints& endpoints, uint8_t (&indices)[BLOCK_TEXEL_COUNT])
+	{
+		float palette[BC7_WEIGHT_COUNT][CHANNEL_COUNT]{};
+		GetBc7Palette(endpoints, palette);
+
+		float error{ 0.f };
+#ifdef GP2VKT_BLOCK_SSE2
+		for (uint32_t texel{ 0 }; texel < BLOCK_TEXEL_COUNT; texel += 4)
+		{
+			__m128 texels[CHANNEL_COUNT]{};
+			for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel) texels[channel] = _mm_load_ps(block.Channels[channel] + texel);
+
+			__m128 bestError{ _mm_set1_ps(std::numeric_limits<float>::max()) };
+			__m128 bestIndex{ _mm_setzero_ps() };
+			for (uint32_t index{ 0 }; index < BC7_WEIGHT_COUNT; ++index)
+			{
+				__m128 indexError{ _mm_setzero_ps() };
+				for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+				{
+					__m128 difference{ _mm_sub_ps(texels[channel], _mm_set1_ps(palette[index][channel])) };
+					indexError = _mm_add_ps(indexError, _mm_mul_ps(difference, difference));
+				}
+				__m128 isCloser{ _mm_cmplt_ps(indexError, bestError) };
+				bestError = _mm_min_ps(indexError, bestError);
+				bestIndex = _mm_or_ps(_mm_and_ps(isCloser, _mm_set1_ps(static_cast<float>(index))), _mm_andnot_ps(isCloser, bestIndex));
+			}
+
+			alignas(16) float errors[4], bestIndices[4];
+			_mm_store_ps(errors, bestError);
+			_mm_store_ps(bestIndices, bestIndex);
+			for (uint32_t lane{ 0 }; lane < 4; ++lane)
+			{
+				indices[texel + lane] = static_cast<uint8_t>(bestIndices[lane]);
+				error += errors[lane];
+			}
+		}
+#else
+		for (uint32_t texel{ 0 }; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			float bestError{ std::numeric_limits<float>::max() };
+			for (uint32_t index{ 0 }; index < BC7_WEIGHT_COUNT; ++index)
+			{
+				float indexError{ 0.f };
+				for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+				{
+					float difference{ block.Channels[channel][texel] - palette[index][channel] };
+					indexError += difference * difference;
+				}
+				if (indexError < bestError) {
+					bestError = indexError;
+					indices[texel] = static_cast<uint8_t>(index);
+				}
+			}
+			error += bestError;
+		}
+#endif
+		return error;
+	}
+
+	// Extremes of the block along its principal axis, found with a few power iterations on the covariance
+	void FitBc7Endpoints(const Block& block, float (&first)[CHANNEL_COUNT], float (&second)[CHANNEL_COUNT])
+	{
+		float mean[CHANNEL_COUNT]{}, axis[CHANNEL_COUNT]{};
+		for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+		{
+			const float* pChannel = block.Channels[channel];
+			const auto [pMin, pMax] = std::minmax_element(pChannel, pChannel + BLOCK_TEXEL_COUNT);
+			for (uint32_t texel{ 0 }; texel < BLOCK_TEXEL_COUNT; ++texel) mean[channel] += pChannel[texel];
+			mean[channel] /= BLOCK_TEXEL_COUNT;
+			axis[channel] = *pMax - *pMin;
+		}
+
+		float covariance[CHANNEL_COUNT][CHANNEL_COUNT]{};
+		for (uint32_t texel{ 0 }; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			for (uint32_t row{ 0 }; row < CHANNEL_COUNT; ++row)
+			{
+				for (uint32_t column{ 0 }; column < CHANNEL_COUNT; ++column)
+				{
+					covariance[row][column] += (block.Channels[row][texel] - mean[row]) * (block.Channels[column][texel] - mean[column]);
+				}
+			}
+		}
+		for (int iteration{ 0 }; iteration < 8; ++iteration)
+		{
+			float next[CHANNEL_COUNT]{};
+			float length{ 0.f };
+			for (uint32_t row{ 0 }; row < CHANNEL_COUNT; ++row)
+			{
+				for (uint32_t column{ 0 }; column < CHANNEL_COUNT; ++column) next[row] += covariance[row][column] * axis[column];
+				length = std::max(length, std::abs(next[row]));
+			}
+			if (length < 1e-6f) break;
+			for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel) axis[channel] = next[channel] / length;
+		}
+
+		float axisLength{ 0.f };
+		for (float value : axis) axisLength += value * value;
+		float minProjection{ 0.f }, maxProjection{ 0.f };
+		if (axisLength > 1e-12f) {
+			minProjection = std::numeric_limits<float>::max();
+			maxProjection = std::numeric_limits<float>::lowest();
+			for (uint32_t texel{ 0 }; texel < BLOCK_TEXEL_COUNT; ++texel)
+			{
+				float projection{ 0.f };
+				for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel) projection += (block.Channels[channel][texel] - mean[channel]) * axis[channel];
+				minProjection = std::min(minProjection, projection / axisLength);
+				maxProjection = std::max(maxProjection, projection / axisLength);
+			}
+		}
+		for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+		{
+			first[channel] = std::clamp(mean[channel] + axis[channel] * minProjection, 0.f, 255.f);
+			second[channel] = std::clamp(mean[channel] + axis[channel] * maxProjection, 0.f, 255.f);
+		}
+	}
+
+	// Least squares endpoints for fixed weights, false if the weights can't separate them
+	bool RefineBc7Endpoints(const Block& block, const uint8_t (&indices)[BLOCK_TEXEL_COUNT], float (&first)[CHANNEL_COUNT], float (&second)[CHANNEL_COUNT])
+	{
+		float a{ 0.f }, b{ 0.f }, c{ 0.f };
+		float x0[CHANNEL_COUNT]{}, x1[CHANNEL_COUNT]{};
+		for (uint32_t texel{ 0 }; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			float t{ BC7_WEIGHTS[indices[texel]] / 64.f };
+			a += (1.f - t) * (1.f - t);
+			b += (1.f - t) * t;
+			c += t * t;
+			for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+			{
+				x0[channel] += (1.f - t) * block.Channels[channel][texel];
+				x1[channel] += t * block.Channels[channel][texel];
+			}
+		}
+
+		const float determinant{ a * c - b * b };
+		if (std::abs(determinant) < 1e-6f) return false;
+		for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+		{
+			first[channel] = std::clamp((c * x0[channel] - b * x1[channel]) / determinant, 0.f, 255.f);
+			second[channel] = std::clamp((a * x1[channel] - b * x0[channel]) / determinant, 0.f, 255.f);
+		}
+		return true;
+	}
+
+	void EncodeBc7(const Block& block, uint8_t* pDst)
+	{
+		float first[CHANNEL_COUNT]{}, second[CHANNEL_COUNT]{};
+		FitBc7Endpoints(block, first, second);
+
+		Bc7Endpoints endpoints{};
+		QuantizeBc7Endpoint(first, endpoints[0]);
+		QuantizeBc7Endpoint(second, endpoints[1]);
+		uint8_t indices[BLOCK_TEXEL_COUNT]{};
+		float error{ AssignBc7Indices(block, endpoints, indices) };
+
+		for (uint32_t iteration{ 0 }; iteration < BC7_REFINE_ITERATIONS && error > 0.f; ++iteration)
+		{
+			if (RefineBc7Endpoints(block, indices, first, second) == false) break;
+
+			Bc7Endpoints refinedEndpoints{};
+			QuantizeBc7Endpoint(first, refinedEndpoints[0]);
+			QuantizeBc7Endpoint(second, refinedEndpoints[1]);
+			uint8_t refinedIndices[BLOCK_TEXEL_COUNT]{};
+			float refinedError{ AssignBc7Indices(block, refinedEndpoints, refinedIndices) };
+			if (refinedError >= error) break;
+
+			error = refinedError;
+			std::copy(&refinedEndpoints[0][0], &refinedEndpoints[0][0] + 2 * CHANNEL_COUNT, &endpoints[0][0]);
+			std::copy(refinedIndices, refinedIndices + BLOCK_TEXEL_COUNT, indices);
+		}
+
+		// The highest bit of the first index is implied to be 0, the weights are symmetric so swapping the endpoints mirrors them
+		if (indices[0] >= BC7_WEIGHT_COUNT / 2) {
+			std::swap(endpoints[0], endpoints[1]);
+			for (uint8_t& index : indices) index = static_cast<uint8_t>(BC7_WEIGHT_COUNT - 1 - index);
+		}
+
+		std::memset(pDst, 0, 16);
+		BitWriter stream{ pDst };
+		stream.Write(1 << BC7_MODE, BC7_MODE + 1);
+		for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+		{
+			stream.Write(endpoints[0][channel] >> 1, 7);
+			stream.Write(endpoints[1][channel] >> 1, 7);
+		}
+		stream.Write(endpoints[0][0] & 1, 1);
+		stream.Write(endpoints[1][0] & 1, 1);
+		stream.Write(indices[0], 3);
+		for (uint32_t texel{ 1 }; texel < BLOCK_TEXEL_COUNT; ++texel) stream.Write(indices[texel], 4);
+	}
+
+	void DecodeBc7(const uint8_t* pSrc, uint8_t (&texels)[BLOCK_TEXEL_COUNT][CHANNEL_COUNT])
+	{
+		BitReader stream{ pSrc };
+		if (stream.Read(BC7_MODE + 1) != 1 << BC7_MODE) {
+			throw std::invalid_argument("can't decompress BC7 blocks that don't use mode 6!");
+		}
+
+		Bc7Endpoints endpoints{};
+		for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+		{
+			endpoints[0][channel] = static_cast<int>(stream.Read(7)) << 1;
+			endpoints[1][channel] = static_cast<int>(stream.Read(7)) << 1;
+		}
+		const int firstPBit{ static_cast<int>(stream.Read(1)) }, secondPBit{ static_cast<int>(stream.Read(1)) };
+		for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+		{
+			endpoints[0][channel] |= firstPBit;
+			endpoints[1][channel] |= secondPBit;
+		}
+
+		float palette[BC7_WEIGHT_COUNT][CHANNEL_COUNT]{};
+		GetBc7Palette(endpoints, palette);
+		for (uint32_t texel{ 0 }; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			uint32_t index{ stream.Read(texel == 0 ? 3 : 4) };
+			for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel) texels[texel][channel] = static_cast<uint8_t>(palette[index][channel]);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+BlockCompressor::BlockCompressor(uint32_t threadCount)
+	: m_ThreadCount{ threadCount }
+{
+	if (m_ThreadCount == 0) m_ThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+std::vector<uint8_t> BlockCompressor::Compress(const uint8_t* pPixels, uint32_t width, uint32_t height, BlockFormat format) const
+{
+	std::vector<uint8_t> blocks(GetCompressedSize(width, height, format));
+	CompressInto(pPixels, width, height, format, blocks.data());
+	return blocks;
+}
+
+void BlockCompressor::CompressInto(const uint8_t* pPixels, uint32_t width, uint32_t height, BlockFormat format, uint8_t* pBlocks) const
+{
+	if (pPixels == nullptr || width == 0 || height == 0) {
+		throw std::invalid_argument("can't compress an empty image!");
+	}
+
+	const uint32_t blockColumns{ (width + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION };
+	const uint32_t blockRows{ (height + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION };
+	const size_t blockSize{ GetBlockSize(format) };
+
+	// Every range encodes whole rows of blocks
+	const size_t rangeCount{ std::clamp<size_t>(static_cast<size_t>(blockColumns) * blockRows / MIN_RANGE_SIZE, 1, std::min<size_t>(m_ThreadCount, blockRows)) };
+	ForEachRange(blockRows, rangeCount, [&](size_t begin, size_t end)
+		{
+			Block block{};
+			for (uint32_t blockY{ static_cast<uint32_t>(begin) }; blockY < end; ++blockY)
+			{
+				for (uint32_t blockX{ 0 }; blockX < blockColumns; ++blockX)
+				{
+					LoadBlock(pPixels, width, height, blockX, blockY, block);
+					uint8_t* pDst = pBlocks + (static_cast<size_t>(blockY) * blockColumns + blockX) * blockSize;
+					switch (format)
+					{
+					case BlockFormat::BC4:
+						EncodeBc4(block.Channels[0], pDst);
+						break;
+					case BlockFormat::BC5:
+						EncodeBc4(block.Channels[0], pDst);
+						EncodeBc4(block.Channels[1], pDst + 8);
+						break;
+					case BlockFormat::BC7:
+						EncodeBc7(block, pDst);
+						break;
+					}
+				}
+			}
+		});
+}
+
+std::vector<uint8_t> BlockCompressor::Decompress(const uint8_t* pBlocks, uint32_t width, uint32_t height, BlockFormat format) const
+{
+	if (pBlocks == nullptr || width == 0 || height == 0) {
+		throw std::invalid_argument("can't decompress an empty image!");
+	}
+
+	const uint32_t blockColumns{ (width + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION };
+	const uint32_t blockRows{ (height + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION };
+	const size_t blockSize{ GetBlockSize(format) };
+	std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * CHANNEL_COUNT);
+
+	const size_t rangeCount{ std::clamp<size_t>(static_cast<size_t>(blockColumns) * blockRows / MIN_RANGE_SIZE, 1, std::min<size_t>(m_ThreadCount, blockRows)) };
+	ForEachRange(blockRows, rangeCount, [&](size_t begin, size_t end)
+		{
+			for (uint32_t blockY{ static_cast<uint32_t>(begin) }; blockY < end; ++blockY)
+			{
+				for (uint32_t blockX{ 0 }; blockX < blockColumns; ++blockX)
+				{
+					const uint8_t* pSrc = pBlocks + (static_cast<size_t>(blockY) * blockColumns + blockX) * blockSize;
+					uint8_t texels[BLOCK_TEXEL_COUNT][CHANNEL_COUNT]{};
+					if (format == BlockFormat::BC7) DecodeBc7(pSrc, texels);
+					else {
+						uint8_t values[BLOCK_TEXEL_COUNT]{};
+						for (uint32_t channel{ 0 }; channel < (format == BlockFormat::BC5 ? 2u : 1u); ++channel)
+						{
+							DecodeBc4(pSrc + channel * 8, values);
+							for (uint32_t texel{ 0 }; texel < BLOCK_TEXEL_COUNT; ++texel) texels[texel][channel] = values[texel];
+						}
+						for (auto& texel : texels) texel[3] = 255;
+					}
+
+					// Texels outside of the image only exist in the block
+					for (uint32_t y{ 0 }; y < BLOCK_DIMENSION && blockY * BLOCK_DIMENSION + y < height; ++y)
+					{
+						for (uint32_t x{ 0 }; x < BLOCK_DIMENSION && blockX * BLOCK_DIMENSION + x < width; ++x)
+						{
+							size_t pixel{ static_cast<size_t>(blockY * BLOCK_DIMENSION + y) * width + blockX * BLOCK_DIMENSION + x };
+							std::copy(texels[y * BLOCK_DIMENSION + x], texels[y * BLOCK_DIMENSION + x] + CHANNEL_COUNT, pixels.data() + pixel * CHANNEL_COUNT);
+						}
+					}
+				}
+			}
+		});
+	return pixels;
+}
+
+size_t BlockCompressor::GetBlockSize(BlockFormat format)
+{
+	return format == BlockFormat::BC4 ? 8 : 16;
+}
+
+size_t BlockCompressor::GetCompressedSize(uint32_t width, uint32_t height, BlockFormat format)
+{
+	return static_cast<size_t>((width + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION) * ((height + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION) * GetBlockSize(format);
+}
@@ -0,0 +1,60 @@
+#ifndef GP2VKT_BLOCKCOMPRESSOR_H_
+#define GP2VKT_BLOCKCOMPRESSOR_H_
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Class Forward Declarations
+
+
+// Block compressed formats, every block covers 4x4 texels
+enum class BlockFormat
+{
+	BC4, // Red, 8 bytes per block
+	BC5, // Red & green as two BC4 blocks, 16 bytes per block
+	BC7  // RGBA, 16 bytes per block
+};
+
+
+// Encodes RGBA8 images into block compressed formats, rows of blocks are spread over the threads
+// BC7 only uses mode 6 (one RGBA endpoint pair with 16 weights), its endpoints are fitted along the principal axis
+// of the block & refined with least squares, the closest weight of 4 texels at a time is searched with SSE2
+class BlockCompressor final
+{
+public:
+	// Constructors and Destructor
+	explicit BlockCompressor(uint32_t threadCount = 0); // 0 uses all hardware threads
+	~BlockCompressor() = default;
+
+	// Copy and Move semantics
+	BlockCompressor(const BlockCompressor& other)					= delete;
+	BlockCompressor& operator=(const BlockCompressor& other)		= delete;
+	BlockCompressor(BlockCompressor&& other) noexcept				= delete;
+	BlockCompressor& operator=(BlockCompressor&& other) noexcept	= delete;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	// BC4 reads the red channel, BC5 red & green and BC7 all four
+	// Sizes that aren't a multiple of 4 repeat their last row & column inside of the edge blocks
+	std::vector<uint8_t> Compress(const uint8_t* pPixels, uint32_t width, uint32_t height, BlockFormat format) const;
+	void CompressInto(const uint8_t* pPixels, uint32_t width, uint32_t height, BlockFormat format, uint8_t* pBlocks) const; // GetCompressedSize bytes, e.g. mapped staging memory
+
+	// Back to RGBA8, channels the format doesn't store are 0 (alpha 255), only reads BC7 mode 6
+	std::vector<uint8_t> Decompress(const uint8_t* pBlocks, uint32_t width, uint32_t height, BlockFormat format) const;
+
+	static size_t GetBlockSize(BlockFormat format); // In bytes
+	static size_t GetCompressedSize(uint32_t width, uint32_t height, BlockFormat format);
+
+
+private:
+	// Member variables
+	uint32_t m_ThreadCount{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+
+};
+#endif
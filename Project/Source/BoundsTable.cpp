@@ -0,0 +1,258 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "BoundsTable.h"
+#include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <glm/glm.hpp>
+#if defined(__AVX2__)
+#define GP2VKT_BOUNDS_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GP2VKT_BOUNDS_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define GP2VKT_BOUNDS_NEON
+#include <arm_neon.h>
+#endif
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	constexpr uint32_t BLOCK_SIZE{ 8 }; // Objects per iteration of Cull, a multiple of every SIMD width
+
+	// A frustum plane & the box columns of the corner furthest along its normal
+	struct CullPlane
+	{
+		float Normal[3]{};
+		float Distance{};
+		const float* pCorner[3]{};
+	};
+	struct CullInput
+	{
+		const float* pCenter[3]{};
+		const float* pRadius{};
+		std::array<CullPlane, 6> Planes{};
+	};
+
+	using Columns = std::array<const float*, 3>;
+	CullInput CreateCullInput(const Frustum& frustum, const Columns& center, const float* pRadius, const Columns& min, const Columns& max)
+	{
+		CullInput input{ { center[0], center[1], center[2] }, pRadius };
+		for (size_t i{ 0 }; i < input.Planes.size(); ++i)
+		{
+			const glm::vec4& plane = frustum.GetPlanes()[i];
+			input.Planes[i] = CullPlane{ { plane.x, plane.y, plane.z }, plane.w,
+				{ plane.x > 0.f ? max[0] : min[0], plane.y > 0.f ? max[1] : min[1], plane.z > 0.f ? max[2] : min[2] } };
+		}
+		return input;
+	}
+
+	bool IsVisibleScalar(const CullInput& input, uint32_t i)
+	{
+		for (const CullPlane& plane : input.Planes)
+		{
+			float sphereDistance{ plane.Normal[0] * input.pCenter[0][i] + plane.Normal[1] * input.pCenter[1][i] + plane.Normal[2] * input.pCenter[2][i] + plane.Distance };
+			float boxDistance{ plane.Normal[0] * plane.pCorner[0][i] + plane.Normal[1] * plane.pCorner[1][i] + plane.Normal[2] * plane.pCorner[2][i] + plane.Distance };
+			if ((sphereDistance >= -input.pRadius[i] && boxDistance >= 0.f) == false) return false;
+		}
+		return true;
+	}
+
+#if defined(GP2VKT_BOUNDS_AVX2)
+	using Lanes = __m256;
+	constexpr uint32_t LANE_COUNT{ 8 };
+	Lanes Load(const float* pSrc) { return _mm256_loadu_ps(pSrc); }
+	Lanes Broadcast(float value) { return _mm256_set1_ps(value); }
+	Lanes Add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+	Lanes Multiply(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+	Lanes Negate(Lanes a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.f)); }
+	Lanes And(Lanes a, Lanes b) { return _mm256_and_ps(a, b); }
+	Lanes GreaterEqual(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+	Lanes AllSet() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+	uint32_t MoveMask(Lanes mask) { return static_cast<uint32_t>(_mm256_movemask_ps(mask)); }
+#elif defined(GP2VKT_BOUNDS_SSE2)
+	using Lanes = __m128;
+	constexpr uint32_t LANE_COUNT{ 4 };
+	Lanes Load(const float* pSrc) { return _mm_loadu_ps(pSrc); }
+	Lanes Broadcast(float value) { return _mm_set1_ps(value); }
+	Lanes Add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+	Lanes Multiply(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+	Lanes Negate(Lanes a) { return _mm_xor_ps(a, _mm_set1_ps(-0.f)); }
+	Lanes And(Lanes a, Lanes b) { return _mm_and_ps(a, b); }
+	Lanes GreaterEqual(Lanes a, Lanes b) { return _mm_cmpge_ps(a, b); }
+	Lanes AllSet() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+	uint32_t MoveMask(Lanes mask) { return static_cast<uint32_t>(_mm_movemask_ps(mask)); }
+#elif defined(GP2VKT_BOUNDS_NEON)
+	using Lanes = float32x4_t;
+	constexpr uint32_t LANE_COUNT{ 4 };
+	Lanes Load(const float* pSrc) { return vld1q_f32(pSrc); }
+	Lanes Broadcast(float value) { return vdupq_n_f32(value); }
+	Lanes Add(Lanes a, Lanes b) { return vaddq_f32(a, b); }
+	Lanes Multiply(Lanes a, Lanes b) { return vmulq_f32(a, b); }
+	Lanes Negate(Lanes a) { return vnegq_f32(a); }
+	Lanes And(Lanes a, Lanes b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+	Lanes GreaterEqual(Lanes a, Lanes b) { return vreinterpretq_f32_u32(vcgeq_f32(a, b)); }
+	Lanes AllSet() { return vreinterpretq_f32_u32(vdupq_n_u32(0xFFFFFFFF)); }
+	uint32_t MoveMask(Lanes mask)
+	{
+		const uint32x4_t laneBits{ 1, 2, 4, 8 };
+		return vaddvq_u32(vandq_u32(vreinterpretq_u32_f32(mask), laneBits));
+	}
+#endif
+
+#if defined(GP2VKT_BOUNDS_AVX2) || defined(GP2VKT_BOUNDS_SSE2) || defined(GP2VKT_BOUNDS_NEON)
+	// Same math as IsVisibleScalar, the planes are broadcast once per cull
+	struct LanePlane
+	{
+		Lanes Normal[3];
+		Lanes Distance;
+		const float* pCorner[3];
+	};
+
+	uint32_t GetVisibleMask(const CullInput& input, const std::array<LanePlane, 6>& planes, uint32_t first)
+	{
+		const Lanes centerX{ Load(input.pCenter[0] + first) }, centerY{ Load(input.pCenter[1] + first) }, centerZ{ Load(input.pCenter[2] + first) };
+		const Lanes negativeRadius{ Negate(Load(input.pRadius + first)) };
+		const Lanes zero{ Broadcast(0.f) };
+
+		Lanes visible{ AllSet() };
+		for (const LanePlane& plane : planes)
+		{
+			Lanes sphereDistance{ Add(Add(Add(Multiply(plane.Normal[0], centerX), Multiply(plane.Normal[1], centerY)), Multiply(plane.Normal[2], centerZ)), plane.Distance) };
+			Lanes boxDistance{ Add(Add(Add(Multiply(plane.Normal[0], Load(plane.pCorner[0] + first)), Multiply(plane.Normal[1], Load(plane.pCorner[1] + first))),
+				Multiply(plane.Normal[2], Load(plane.pCorner[2] + first))), plane.Distance) };
+			visible = And(visible, And(GreaterEqual(sphereDistance, negativeRadius), GreaterEqual(boxDistance, zero)));
+		}
+		return MoveMask(visible);
+	}
+
+	uint32_t CullBlocks(const CullInput& input, uint32_t count, uint32_t* pVisibleDst)
+	{
+		std::array<LanePlane, 6> planes{};
+		for (size_t i{ 0 }; i < planes.size(); ++i)
+		{
+			const CullPlane& plane = input.Planes[i];
+			planes[i] = LanePlane{ { Broadcast(plane.Normal[0]), Broadcast(plane.Normal[1]), Broadcast(plane.Normal[2]) }, Broadcast(plane.Distance),
+				{ plane.pCorner[0], plane.pCorner[1], plane.pCorner[2] } };
+		}
+
+		// The arrays are padded to whole blocks, so only the mask of the last one has to be cut short
+		uint32_t visibleCount{ 0 };
+		for (uint32_t first{ 0 }; first < count; first += BLOCK_SIZE)
+		{
+			uint32_t mask{ 0 };
+			for (uint32_t lane{ 0 }; lane < BLOCK_SIZE; lane += LANE_COUNT)
+			{
+				mask |= GetVisibleMask(input, planes, first + lane) << lane;
+			}
+			if (count - first < BLOCK_SIZE) mask &= (1u << (count - first)) - 1;
+
+			// Compacted in ascending order, one store per visible object
+			while (mask != 0)
+			{
+				pVisibleDst[visibleCount++] = first + static_cast<uint32_t>(std::countr_zero(mask));
+				mask &= mask - 1;
+			}
+		}
+		return visibleCount;
+	}
+#endif
+}
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Destructor
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+uint32_t BoundsTable::Add(const MeshBounds& bounds, const glm::mat4& transform)
+{
+	const uint32_t index{ m_Size };
+	Resize(m_Size + 1);
+	Update(index, bounds, transform);
+	return index;
+}
+
+void BoundsTable::Update(uint32_t index, const MeshBounds& bounds, const glm::mat4& transform)
+{
+	if (index >= m_Size) {
+		throw std::invalid_argument("bounds table index is out of range!");
+	}
+
+	// The sphere grows with the largest scale of the transform
+	const glm::vec3 center{ transform * glm::vec4(bounds.GetCenter(), 1.f) };
+	const float scale{ std::max({ glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) }) };
+	m_CenterX[index] = center.x;
+	m_CenterY[index] = center.y;
+	m_CenterZ[index] = center.z;
+	m_Radius[index] = bounds.radius * scale;
+
+	// Box around the transformed box, every world axis collects the absolute projections of the model axes (Arvo)
+	const glm::vec3 halfExtent{ (bounds.max - bounds.min) * 0.5f };
+	const glm::vec3 worldHalfExtent{ glm::abs(glm::vec3(transform[0])) * halfExtent.x + glm::abs(glm::vec3(transform[1])) * halfExtent.y + glm::abs(glm::vec3(transform[2])) * halfExtent.z };
+	m_MinX[index] = center.x - worldHalfExtent.x;
+	m_MinY[index] = center.y - worldHalfExtent.y;
+	m_MinZ[index] = center.z - worldHalfExtent.z;
+	m_MaxX[index] = center.x + worldHalfExtent.x;
+	m_MaxY[index] = center.y + worldHalfExtent.y;
+	m_MaxZ[index] = center.z + worldHalfExtent.z;
+}
+
+void BoundsTable::Clear()
+{
+	Resize(0);
+}
+
+uint32_t BoundsTable::Cull(const Frustum& frustum, uint32_t* pVisibleDst) const
+{
+#if defined(GP2VKT_BOUNDS_AVX2) || defined(GP2VKT_BOUNDS_SSE2) || defined(GP2VKT_BOUNDS_NEON)
+	const CullInput input{ CreateCullInput(frustum, { m_CenterX.data(), m_CenterY.data(), m_CenterZ.data() }, m_Radius.data(),
+		{ m_MinX.data(), m_MinY.data(), m_MinZ.data() }, { m_MaxX.data(), m_MaxY.data(), m_MaxZ.data() }) };
+	return CullBlocks(input, m_Size, pVisibleDst);
+#else
+	return CullScalar(frustum, pVisibleDst);
+#endif
+}
+
+uint32_t BoundsTable::CullScalar(const Frustum& frustum, uint32_t* pVisibleDst) const
+{
+	const CullInput input{ CreateCullInput(frustum, { m_CenterX.data(), m_CenterY.data(), m_CenterZ.data() }, m_Radius.data(),
+		{ m_MinX.data(), m_MinY.data(), m_MinZ.data() }, { m_MaxX.data(), m_MaxY.data(), m_MaxZ.data() }) };
+
+	uint32_t visibleCount{ 0 };
+	for (uint32_t i{ 0 }; i < m_Size; ++i)
+	{
+		if (IsVisibleScalar(input, i)) pVisibleDst[visibleCount++] = i;
+	}
+	return visibleCount;
+}
+
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+void BoundsTable::Resize(uint32_t size)
+{
+	// Whole blocks, so the SIMD loads of the last block stay inside of the arrays
+	const size_t paddedSize{ (static_cast<size_t>(size) + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE };
+	for (std::vector<float>* pColumn : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_Radius, &m_MinX, &m_MinY, &m_MinZ, &m_MaxX, &m_MaxY, &m_MaxZ })
+	{
+		pColumn->resize(paddedSize, 0.f);
+	}
+	m_Size = size;
+}
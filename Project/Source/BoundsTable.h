@@ -0,0 +1,54 @@
+#ifndef GP2VKT_BOUNDSTABLE_H_
+#define GP2VKT_BOUNDSTABLE_H_
+// Includes
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include "DataTypes.h"
+#include "Frustum.h"
+
+// Class Forward Declarations
+
+
+// World space bounding spheres & boxes of the scene objects, one array per component so they can be culled 8 at a time
+// An object is visible if both its sphere & its box touch the frustum
+class BoundsTable final
+{
+public:
+	// Constructors and Destructor
+	explicit BoundsTable() = default;
+	~BoundsTable() = default;
+
+	// Copy and Move semantics
+	BoundsTable(const BoundsTable& other)					= default;
+	BoundsTable& operator=(const BoundsTable& other)		= default;
+	BoundsTable(BoundsTable&& other) noexcept				= default;
+	BoundsTable& operator=(BoundsTable&& other) noexcept	= default;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	uint32_t Add(const MeshBounds& bounds, const glm::mat4& transform); // Returns the index of the object
+	void Update(uint32_t index, const MeshBounds& bounds, const glm::mat4& transform);
+	void Clear();
+	uint32_t GetSize() const { return m_Size; }
+
+	// Writes the indices of the visible objects in ascending order & returns their count, pVisibleDst needs room for GetSize() indices
+	uint32_t Cull(const Frustum& frustum, uint32_t* pVisibleDst) const;
+	uint32_t CullScalar(const Frustum& frustum, uint32_t* pVisibleDst) const; // Reference for Cull, same results
+
+
+private:
+	// Member variables
+	uint32_t m_Size{ 0 };
+
+	// Padded to a multiple of 8 objects, the padding is never reported as visible
+	std::vector<float> m_CenterX{}, m_CenterY{}, m_CenterZ{}, m_Radius{};
+	std::vector<float> m_MinX{}, m_MinY{}, m_MinZ{};
+	std::vector<float> m_MaxX{}, m_MaxY{}, m_MaxZ{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+	void Resize(uint32_t size);
+};
+#endif
@@ -0,0 +1,259 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "CullingPass.h"
+#include "Frustum.h"
+#include "VirtualFileSystem.h"
+#include <stdexcept>
+#include <array>
+#include <algorithm>
+#include "RAII/GP2_VkShaderModule.h"
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	constexpr uint32_t WORKGROUP_SIZE{ 64 }; // Has to match local_size_x in Cull.comp
+	constexpr VkDeviceSize OFFSET_ALIGNMENT{ 256 }; // Largest minStorageBufferOffsetAlignment allowed
+
+	VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+CullingPass::CullingPass(VkDevice device, MemoryAllocator& allocator, uint32_t capacity, uint32_t sliceCount, bool useDrawCount, const std::string& computeShaderPath)
+	: m_Device{ device }
+	, m_Capacity{ capacity }
+	, m_SliceCount{ sliceCount }
+	, m_UseDrawCount{ useDrawCount }
+{
+	if (capacity == 0 || sliceCount == 0) {
+		throw std::invalid_argument("culling pass needs at least one object & one slice!");
+	}
+
+	// Only written by uploads
+	m_ObjectBuffer = GP2_VkBuffer{ m_Device, sizeof(ObjectData) * capacity, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, false };
+	m_ObjectBufferMemory = allocator.AllocateAndBind(m_ObjectBuffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+	m_DrawSliceSize = AlignUp(sizeof(VkDrawIndexedIndirectCommand) * capacity, OFFSET_ALIGNMENT);
+	CreateDrawBuffer(allocator);
+
+	CreatePipeline(computeShaderPath);
+	UpdateDescriptorSets();
+}
+
+
+//-----------------------------------------------------------------
+// Destructor
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+void CullingPass::Upload(UploadService& uploadService, const std::vector<ObjectData>& objects)
+{
+	if (objects.size() > m_Capacity) {
+		throw std::invalid_argument("more objects than the culling pass can hold!");
+	}
+
+	m_ObjectCount = static_cast<uint32_t>(objects.size());
+	if (objects.empty()) return;
+
+	uploadService.UploadBuffer(m_ObjectBuffer, 0, objects.data(), sizeof(ObjectData) * objects.size(),
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+}
+
+void CullingPass::Resize(MemoryAllocator& allocator, uint32_t sliceCount)
+{
+	if (sliceCount == 0) {
+		throw std::invalid_argument("culling pass needs at least one slice!");
+	}
+	if (sliceCount == m_SliceCount) return;
+
+	// The objects & their set don't depend on the slices, the cull sets are allocated again for the new count
+	m_pCullSets = nullptr;
+	m_SliceCount = sliceCount;
+	CreateDrawBuffer(allocator);
+	m_pCullSets = std::make_unique<PoolDescriptorSets>(m_Device, std::vector<VkDescriptorPoolSize>{ { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 * m_SliceCount } }, m_CullSetLayout, m_SliceCount);
+	UpdateDescriptorSets();
+}
+
+void CullingPass::CmdCull(VkCommandBuffer commandBuffer, uint32_t slice, const glm::mat4& viewProjection) const
+{
+	CheckSlice(slice);
+
+	// The count restarts at zero, without drawIndirectCount the slots behind the last visible object have to draw nothing
+	vkCmdFillBuffer(commandBuffer, m_DrawBuffer, GetCountOffset(slice), sizeof(uint32_t), 0);
+	if (m_UseDrawCount == false) vkCmdFillBuffer(commandBuffer, m_DrawBuffer, m_DrawSliceSize * slice, m_DrawSliceSize, 0);
+
+	VkMemoryBarrier clearBarrier{};
+	clearBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	clearBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	clearBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &clearBarrier, 0, nullptr, 0, nullptr);
+
+	// Planes in world space, the shader moves the bounding spheres there
+	CullConstants constants{};
+	Frustum frustum{ viewProjection };
+	std::copy(frustum.GetPlanes().begin(), frustum.GetPlanes().end(), constants.planes);
+	constants.objectCount = m_ObjectCount;
+
+	VkDescriptorSet cullSet{ m_pCullSets->Get()[slice] };
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1, &cullSet, 0, nullptr);
+	vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+	if (m_ObjectCount > 0) vkCmdDispatch(commandBuffer, (m_ObjectCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+
+	// Read as indirect arguments by the draw, or copied by CmdReadBack
+	VkMemoryBarrier cullBarrier{};
+	cullBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	cullBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	cullBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &cullBarrier, 0, nullptr, 0, nullptr);
+}
+
+void CullingPass::CmdDraw(VkCommandBuffer commandBuffer, uint32_t slice) const
+{
+	CheckSlice(slice);
+	if (m_ObjectCount == 0) return;
+
+	// One draw per visible object, their count never leaves the GPU
+	const VkDeviceSize drawOffset{ m_DrawSliceSize * slice };
+	if (m_UseDrawCount) {
+		vkCmdDrawIndexedIndirectCount(commandBuffer, m_DrawBuffer, drawOffset, m_DrawBuffer, GetCountOffset(slice), m_ObjectCount, sizeof(VkDrawIndexedIndirectCommand));
+	}
+	else {
+		vkCmdDrawIndexedIndirect(commandBuffer, m_DrawBuffer, drawOffset, m_ObjectCount, sizeof(VkDrawIndexedIndirectCommand));
+	}
+}
+
+void CullingPass::CmdReadBack(VkCommandBuffer commandBuffer, uint32_t slice, VkBuffer dstBuffer) const
+{
+	CheckSlice(slice);
+
+	std::array<VkBufferCopy, 2> regions{};
+	regions[0] = { GetCountOffset(slice), 0, sizeof(uint32_t) };
+	regions[1] = { m_DrawSliceSize * slice, sizeof(uint32_t), sizeof(VkDrawIndexedIndirectCommand) * m_Capacity };
+	vkCmdCopyBuffer(commandBuffer, m_DrawBuffer, dstBuffer, static_cast<uint32_t>(regions.size()), regions.data());
+
+	// Visible to the host once the submit has finished
+	VkMemoryBarrier hostBarrier{};
+	hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &hostBarrier, 0, nullptr, 0, nullptr);
+}
+
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+void CullingPass::CreatePipeline(const std::string& computeShaderPath)
+{
+	// Set 0 of Cull.comp, the objects, the draws & the draw count
+	VkDescriptorSetLayoutBinding storageLayoutBinding{};
+	storageLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	storageLayoutBinding.descriptorCount = 1;
+	storageLayoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	storageLayoutBinding.pImmutableSamplers = nullptr;
+
+	std::vector<VkDescriptorSetLayoutBinding> bindings(3, storageLayoutBinding);
+	for (uint32_t i{ 0 }; i < bindings.size(); ++i)
+	{
+		bindings[i].binding = i;
+	}
+	m_CullSetLayout = GP2_VkDescriptorSetLayout{ m_Device, bindings };
+
+	// Set 1 of PBR_Indirect.vert, only the objects
+	storageLayoutBinding.binding = 0;
+	storageLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+	m_ObjectSetLayout = GP2_VkDescriptorSetLayout{ m_Device, std::vector{ storageLayoutBinding } };
+
+	VkPushConstantRange pushConstantRange{};
+	pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = sizeof(CullConstants);
+	m_PipelineLayout = GP2_VkPipelineLayout{ m_Device, std::vector<VkDescriptorSetLayout>{ m_CullSetLayout }, std::vector<VkPushConstantRange>{ pushConstantRange } };
+
+	// Destroyed right after pipeline creation
+	GP2_VkShaderModule shaderModule{ m_Device, vfs::Read(computeShaderPath) };
+
+	VkComputePipelineCreateInfo pipelineInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	pipelineInfo.stage.module = shaderModule;
+	pipelineInfo.stage.pName = "main";
+	pipelineInfo.layout = m_PipelineLayout;
+	m_Pipeline = GP2_VkPipeline{ m_Device, pipelineInfo };
+
+	m_pCullSets = std::make_unique<PoolDescriptorSets>(m_Device, std::vector<VkDescriptorPoolSize>{ { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 * m_SliceCount } }, m_CullSetLayout, m_SliceCount);
+	m_pObjectSets = std::make_unique<PoolDescriptorSets>(m_Device, std::vector<VkDescriptorPoolSize>{ { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1 } }, m_ObjectSetLayout, 1);
+}
+
+void CullingPass::CreateDrawBuffer(MemoryAllocator& allocator)
+{
+	// Written by the compute shader & read as indirect arguments, cleared & read back with transfers
+	m_CountOffset = m_DrawSliceSize * m_SliceCount;
+	m_DrawBuffer = GP2_VkBuffer{ m_Device, m_CountOffset + OFFSET_ALIGNMENT * m_SliceCount,
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, false };
+	m_DrawBufferMemory = allocator.AllocateAndBind(m_DrawBuffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+void CullingPass::UpdateDescriptorSets() const
+{
+	VkDescriptorBufferInfo objectInfo{ m_ObjectBuffer, 0, VK_WHOLE_SIZE };
+
+	std::vector<VkWriteDescriptorSet> descriptorWrites{};
+	std::vector<std::array<VkDescriptorBufferInfo, 3>> bufferInfos(m_SliceCount); // Kept alive until the update
+	for (uint32_t slice{ 0 }; slice < m_SliceCount; ++slice)
+	{
+		bufferInfos[slice][0] = objectInfo;
+		bufferInfos[slice][1] = { m_DrawBuffer, m_DrawSliceSize * slice, m_DrawSliceSize };
+		bufferInfos[slice][2] = { m_DrawBuffer, GetCountOffset(slice), sizeof(uint32_t) };
+		for (uint32_t i{ 0 }; i < 3; ++i)
+		{
+			VkWriteDescriptorSet descriptorWrite{};
+			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrite.dstSet = m_pCullSets->Get()[slice];
+			descriptorWrite.dstBinding = i;
+			descriptorWrite.dstArrayElement = 0;
+			descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			descriptorWrite.descriptorCount = 1;
+			descriptorWrite.pBufferInfo = &bufferInfos[slice][i];
+			descriptorWrites.push_back(descriptorWrite);
+		}
+	}
+
+	VkWriteDescriptorSet objectWrite{};
+	objectWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	objectWrite.dstSet = m_pObjectSets->Get()[0];
+	objectWrite.dstBinding = 0;
+	objectWrite.dstArrayElement = 0;
+	objectWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	objectWrite.descriptorCount = 1;
+	objectWrite.pBufferInfo = &objectInfo;
+	descriptorWrites.push_back(objectWrite);
+
+	vkUpdateDescriptorSets(m_Device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+}
+
+VkDeviceSize CullingPass::GetCountOffset(uint32_t slice) const
+{
+	return m_CountOffset + OFFSET_ALIGNMENT * slice;
+}
+
+void CullingPass::CheckSlice(uint32_t slice) const
+{
+	if (slice >= m_SliceCount) {
+		throw std::invalid_argument("culling pass slice is out of range!");
+	}
+}
@@ -0,0 +1,89 @@
+#ifndef GP2VKT_CULLINGPASS_H_
+#define GP2VKT_CULLINGPASS_H_
+// Includes
+#include <vulkan/vulkan_core.h>
+#include <vector>
+#include <memory>
+#include <string>
+#include "DataTypes.h"
+#include "MemoryAllocator.h"
+#include "UploadService.h"
+#include "PoolDescriptorSets.h"
+#include "RAII/GP2_VkBuffer.h"
+#include "RAII/GP2_VkDescriptorSetLayout.h"
+#include "RAII/GP2_VkPipelineLayout.h"
+#include "RAII/GP2_VkPipeline.h"
+
+// Class Forward Declarations
+
+
+// Frustum culls every object on the GPU with Cull.comp & draws the survivors with a single indirect draw
+// The compacted draws & their count get one slice per swap chain image, like the other per frame buffers
+class CullingPass final
+{
+public:
+	// Constructors and Destructor
+	// Without drawIndirectCount every slot is drawn, the slots behind the visible objects are zeroed every frame instead
+	explicit CullingPass(VkDevice device, MemoryAllocator& allocator, uint32_t capacity, uint32_t sliceCount, bool useDrawCount, const std::string& computeShaderPath);
+	~CullingPass() = default;
+
+	// Copy and Move semantics
+	CullingPass(const CullingPass& other)					= delete;
+	CullingPass& operator=(const CullingPass& other)		= delete;
+	CullingPass(CullingPass&& other) noexcept				= delete;
+	CullingPass& operator=(CullingPass&& other) noexcept	= delete;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	void Upload(UploadService& uploadService, const std::vector<ObjectData>& objects); // Replaces all objects, throws if there are more than the capacity
+	uint32_t GetObjectCount() const { return m_ObjectCount; }
+	// Rebuilds the draws & their counts for a new swap chain image count, the objects are kept, the device has to be idle
+	void Resize(MemoryAllocator& allocator, uint32_t sliceCount);
+	uint32_t GetSliceCount() const { return m_SliceCount; }
+
+	void CmdCull(VkCommandBuffer commandBuffer, uint32_t slice, const glm::mat4& viewProjection) const; // Outside of a render pass
+	void CmdDraw(VkCommandBuffer commandBuffer, uint32_t slice) const; // The geometry pool & GetObjectSet have to be bound
+
+	// The draw count followed by the draws of a slice, for checking them on the CPU
+	void CmdReadBack(VkCommandBuffer commandBuffer, uint32_t slice, VkBuffer dstBuffer) const;
+	VkDeviceSize GetReadBackSize() const { return sizeof(uint32_t) + sizeof(VkDrawIndexedIndirectCommand) * m_Capacity; }
+
+	// Storage buffer with the objects for the vertex shader, set 1 of the indirect pipeline
+	VkDescriptorSetLayout GetObjectSetLayout() const { return m_ObjectSetLayout; }
+	VkDescriptorSet GetObjectSet() const { return m_pObjectSets->Get()[0]; }
+
+
+private:
+	// Member variables
+	VkDevice m_Device{ nullptr };
+
+	uint32_t m_Capacity{};
+	uint32_t m_SliceCount{};
+	uint32_t m_ObjectCount{ 0 };
+	bool m_UseDrawCount{ false };
+
+	GP2_VkBuffer m_ObjectBuffer{};
+	MemoryAllocation m_ObjectBufferMemory{};
+	GP2_VkBuffer m_DrawBuffer{}; // The draws of every slice, followed by the counts of every slice
+	MemoryAllocation m_DrawBufferMemory{};
+	VkDeviceSize m_DrawSliceSize{};
+	VkDeviceSize m_CountOffset{};
+
+	GP2_VkDescriptorSetLayout m_CullSetLayout{};
+	GP2_VkDescriptorSetLayout m_ObjectSetLayout{};
+	GP2_VkPipelineLayout m_PipelineLayout{};
+	GP2_VkPipeline m_Pipeline{};
+	std::unique_ptr<PoolDescriptorSets> m_pCullSets{}; // One per slice
+	std::unique_ptr<PoolDescriptorSets> m_pObjectSets{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+	void CreatePipeline(const std::string& computeShaderPath);
+	void CreateDrawBuffer(MemoryAllocator& allocator);
+	void UpdateDescriptorSets() const;
+	VkDeviceSize GetCountOffset(uint32_t slice) const;
+	void CheckSlice(uint32_t slice) const;
+};
+#endif
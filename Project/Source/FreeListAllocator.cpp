@@ -0,0 +1,306 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "FreeListAllocator.h"
+#include <stdexcept>
+#include <algorithm>
+#include <bit>
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+FreeListAllocator::FreeListAllocator(uint64_t size, uint64_t minSplitSize)
+	: m_Size{ size }
+	, m_MinSplitSize{ std::max<uint64_t>(minSplitSize, 1) }
+{
+	// Mark all lists as empty
+	for (auto& secondLevelLists : m_FreeLists)
+	{
+		secondLevelLists.fill(InvalidHandle);
+	}
+
+	// Start out with a single free range covering everything
+	if (m_Size > 0) {
+		InsertFreeNode(CreateNode(0, m_Size));
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Destructor
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+std::optional<FreeListAllocator::Allocation> FreeListAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+	// Exit early in case of wrong input values
+	if (size == 0 || size > m_Size) return std::nullopt;
+	alignment = std::max<uint64_t>(alignment, 1);
+
+	// Look for a range of the requested size first and only pay for worst case padding if its start isn't aligned well
+	uint32_t node = FindFreeNode(size);
+	if (node != InvalidHandle) {
+		const Node& candidate = m_Nodes[node];
+		uint64_t padding = (alignment - candidate.Offset % alignment) % alignment;
+		if (candidate.Size < size + padding) {
+			node = FindFreeNode(size + alignment - 1);
+		}
+	}
+	if (node == InvalidHandle) return std::nullopt;
+
+	RemoveFreeNode(node);
+
+	// Padding in front of the aligned offset goes back to the free lists
+	uint64_t padding = (alignment - m_Nodes[node].Offset % alignment) % alignment;
+	if (padding > 0) {
+		InsertFreeNode(SplitFront(node, padding));
+	}
+
+	// Return the tail to the free lists if it's big enough to be useful, otherwise it's wasted
+	if (m_Nodes[node].Size - size >= m_MinSplitSize) {
+		InsertFreeNode(SplitBack(node, size));
+	}
+
+	Node& allocated = m_Nodes[node];
+	allocated.IsFree = false;
+	allocated.RequestedSize = size;
+
+	m_UsedSize += allocated.Size;
+	m_RequestedSize += size;
+	++m_AllocationCount;
+
+	return Allocation{ allocated.Offset, allocated.Size, node };
+}
+
+void FreeListAllocator::Free(uint32_t handle)
+{
+	if (handle >= m_Nodes.size() || m_Nodes[handle].IsFree) {
+		throw std::invalid_argument("freeing a range that isn't allocated!");
+	}
+
+	m_UsedSize -= m_Nodes[handle].Size;
+	m_RequestedSize -= m_Nodes[handle].RequestedSize;
+	--m_AllocationCount;
+
+	// Merge with the previous range if it's free
+	uint32_t prev = m_Nodes[handle].PrevPhysical;
+	if (prev != InvalidHandle && m_Nodes[prev].IsFree) {
+		RemoveFreeNode(prev);
+
+		m_Nodes[handle].Offset = m_Nodes[prev].Offset;
+		m_Nodes[handle].Size += m_Nodes[prev].Size;
+		m_Nodes[handle].PrevPhysical = m_Nodes[prev].PrevPhysical;
+		if (m_Nodes[handle].PrevPhysical != InvalidHandle) {
+			m_Nodes[m_Nodes[handle].PrevPhysical].NextPhysical = handle;
+		}
+
+		ReleaseNode(prev);
+	}
+
+	// Merge with the next range if it's free
+	uint32_t next = m_Nodes[handle].NextPhysical;
+	if (next != InvalidHandle && m_Nodes[next].IsFree) {
+		RemoveFreeNode(next);
+
+		m_Nodes[handle].Size += m_Nodes[next].Size;
+		m_Nodes[handle].NextPhysical = m_Nodes[next].NextPhysical;
+		if (m_Nodes[handle].NextPhysical != InvalidHandle) {
+			m_Nodes[m_Nodes[handle].NextPhysical].PrevPhysical = handle;
+		}
+
+		ReleaseNode(next);
+	}
+
+	m_Nodes[handle].RequestedSize = 0;
+	InsertFreeNode(handle);
+}
+
+FreeListAllocator::Stats FreeListAllocator::GetStats() const
+{
+	Stats stats{};
+	stats.TotalSize = m_Size;
+	stats.UsedSize = m_UsedSize;
+	stats.WastedSize = m_UsedSize - m_RequestedSize;
+	stats.FreeSize = m_Size - m_UsedSize;
+	stats.AllocationCount = m_AllocationCount;
+
+	// Walk every free list
+	for (uint32_t firstLevel{ 0 }; firstLevel < FirstLevelCount; ++firstLevel)
+	{
+		for (uint32_t secondLevel{ 0 }; secondLevel < SecondLevelCount; ++secondLevel)
+		{
+			for (uint32_t node = m_FreeLists[firstLevel][secondLevel]; node != InvalidHandle; node = m_Nodes[node].NextFree)
+			{
+				stats.LargestFreeRange = std::max(stats.LargestFreeRange, m_Nodes[node].Size);
+				++stats.FreeRangeCount;
+			}
+		}
+	}
+
+	return stats;
+}
+
+float FreeListAllocator::GetFragmentation() const
+{
+	Stats stats = GetStats();
+	if (stats.FreeSize == 0) return 0.f;
+
+	return 1.f - static_cast<float>(static_cast<double>(stats.LargestFreeRange) / static_cast<double>(stats.FreeSize));
+}
+
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+void FreeListAllocator::Mapping(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel)
+{
+	// Small sizes are spread linearly over the first list
+	if (size < SecondLevelCount) {
+		firstLevel = 0;
+		secondLevel = static_cast<uint32_t>(size);
+		return;
+	}
+
+	// Bigger sizes use their highest bit as first level and the bits right below it as second level
+	uint32_t highestBit = static_cast<uint32_t>(std::bit_width(size)) - 1;
+	firstLevel = highestBit - SecondLevelBits + 1;
+	secondLevel = static_cast<uint32_t>(size >> (highestBit - SecondLevelBits)) ^ SecondLevelCount;
+}
+
+uint32_t FreeListAllocator::FindFreeNode(uint64_t size) const
+{
+	// Round up to the next list so that every range inside of the found list is big enough
+	if (size >= SecondLevelCount) {
+		uint32_t highestBit = static_cast<uint32_t>(std::bit_width(size)) - 1;
+		size += (1ull << (highestBit - SecondLevelBits)) - 1;
+	}
+
+	uint32_t firstLevel{}, secondLevel{};
+	Mapping(size, firstLevel, secondLevel);
+	if (firstLevel >= FirstLevelCount) return InvalidHandle;
+
+	// Look for a non-empty list in the same first level
+	uint32_t secondLevelMap = m_SecondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+	if (secondLevelMap == 0) {
+		// Otherwise take the smallest non-empty first level above it
+		uint64_t firstLevelMap = (firstLevel + 1 < 64) ? m_FirstLevelBitmap & (~0ull << (firstLevel + 1)) : 0;
+		if (firstLevelMap == 0) return InvalidHandle;
+
+		firstLevel = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+		secondLevelMap = m_SecondLevelBitmaps[firstLevel];
+	}
+
+	secondLevel = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+	return m_FreeLists[firstLevel][secondLevel];
+}
+
+void FreeListAllocator::InsertFreeNode(uint32_t node)
+{
+	uint32_t firstLevel{}, secondLevel{};
+	Mapping(m_Nodes[node].Size, firstLevel, secondLevel);
+
+	// Push in front of the list
+	uint32_t head = m_FreeLists[firstLevel][secondLevel];
+	m_Nodes[node].IsFree = true;
+	m_Nodes[node].PrevFree = InvalidHandle;
+	m_Nodes[node].NextFree = head;
+	if (head != InvalidHandle) {
+		m_Nodes[head].PrevFree = node;
+	}
+	m_FreeLists[firstLevel][secondLevel] = node;
+
+	// Flag the list as non-empty
+	m_FirstLevelBitmap |= 1ull << firstLevel;
+	m_SecondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+}
+
+void FreeListAllocator::RemoveFreeNode(uint32_t node)
+{
+	uint32_t firstLevel{}, secondLevel{};
+	Mapping(m_Nodes[node].Size, firstLevel, secondLevel);
+
+	// Unlink from the list
+	uint32_t prev = m_Nodes[node].PrevFree;
+	uint32_t next = m_Nodes[node].NextFree;
+	if (prev != InvalidHandle) m_Nodes[prev].NextFree = next;
+	if (next != InvalidHandle) m_Nodes[next].PrevFree = prev;
+	if (m_FreeLists[firstLevel][secondLevel] == node) {
+		m_FreeLists[firstLevel][secondLevel] = next;
+	}
+
+	m_Nodes[node].IsFree = false;
+	m_Nodes[node].PrevFree = InvalidHandle;
+	m_Nodes[node].NextFree = InvalidHandle;
+
+	// Flag the list as empty if this was the last node
+	if (m_FreeLists[firstLevel][secondLevel] == InvalidHandle) {
+		m_SecondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+		if (m_SecondLevelBitmaps[firstLevel] == 0) {
+			m_FirstLevelBitmap &= ~(1ull << firstLevel);
+		}
+	}
+}
+
+uint32_t FreeListAllocator::CreateNode(uint64_t offset, uint64_t size)
+{
+	// Reuse a released node if there is one
+	uint32_t node{};
+	if (m_UnusedNodes.empty() == false) {
+		node = m_UnusedNodes.back();
+		m_UnusedNodes.pop_back();
+	}
+	else {
+		node = static_cast<uint32_t>(m_Nodes.size());
+		m_Nodes.emplace_back();
+	}
+
+	m_Nodes[node] = Node{};
+	m_Nodes[node].Offset = offset;
+	m_Nodes[node].Size = size;
+	return node;
+}
+
+void FreeListAllocator::ReleaseNode(uint32_t node)
+{
+	m_Nodes[node] = Node{};
+	m_UnusedNodes.push_back(node);
+}
+
+uint32_t FreeListAllocator::SplitFront(uint32_t node, uint64_t frontSize)
+{
+	// Create a new node for the front part, the given node keeps the back part
+	uint32_t front = CreateNode(m_Nodes[node].Offset, frontSize);
+	m_Nodes[node].Offset += frontSize;
+	m_Nodes[node].Size -= frontSize;
+
+	// Link physical neighbours
+	m_Nodes[front].PrevPhysical = m_Nodes[node].PrevPhysical;
+	m_Nodes[front].NextPhysical = node;
+	if (m_Nodes[front].PrevPhysical != InvalidHandle) {
+		m_Nodes[m_Nodes[front].PrevPhysical].NextPhysical = front;
+	}
+	m_Nodes[node].PrevPhysical = front;
+
+	return front;
+}
+
+uint32_t FreeListAllocator::SplitBack(uint32_t node, uint64_t frontSize)
+{
+	// Create a new node for the back part, the given node keeps the front part
+	uint32_t back = CreateNode(m_Nodes[node].Offset + frontSize, m_Nodes[node].Size - frontSize);
+	m_Nodes[node].Size = frontSize;
+
+	// Link physical neighbours
+	m_Nodes[back].PrevPhysical = node;
+	m_Nodes[back].NextPhysical = m_Nodes[node].NextPhysical;
+	if (m_Nodes[back].NextPhysical != InvalidHandle) {
+		m_Nodes[m_Nodes[back].NextPhysical].PrevPhysical = back;
+	}
+	m_Nodes[node].NextPhysical = back;
+
+	return back;
+}
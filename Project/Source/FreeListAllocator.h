@@ -0,0 +1,104 @@
+#ifndef GP2VKT_FREELISTALLOCATOR_H_
+#define GP2VKT_FREELISTALLOCATOR_H_
+// Includes
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <optional>
+
+// Class Forward Declarations
+
+
+// Two-level segregated fit (TLSF) allocator that hands out offset ranges of a fixed size range
+// It doesn't own or touch any Vulkan objects, the offsets can be used for any kind of memory
+class FreeListAllocator final
+{
+public:
+	static constexpr uint32_t InvalidHandle{ UINT32_MAX };
+
+	struct Allocation
+	{
+		uint64_t Offset{};
+		uint64_t Size{};
+		uint32_t Handle{ InvalidHandle };
+	};
+	struct Stats
+	{
+		uint64_t TotalSize{};
+		uint64_t UsedSize{}; // Includes the wasted size
+		uint64_t WastedSize{}; // Bytes handed out on top of the requested size (tails too small to split)
+		uint64_t FreeSize{};
+		uint64_t LargestFreeRange{};
+		uint32_t AllocationCount{};
+		uint32_t FreeRangeCount{};
+	};
+
+	// Constructors and Destructor
+	explicit FreeListAllocator(uint64_t size, uint64_t minSplitSize = 1);
+	~FreeListAllocator() = default;
+
+	// Copy and Move semantics
+	FreeListAllocator(const FreeListAllocator& other)					= delete;
+	FreeListAllocator& operator=(const FreeListAllocator& other)		= delete;
+	FreeListAllocator(FreeListAllocator&& other) noexcept				= default;
+	FreeListAllocator& operator=(FreeListAllocator&& other) noexcept	= default;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	std::optional<Allocation> Allocate(uint64_t size, uint64_t alignment = 1);
+	void Free(uint32_t handle);
+
+	bool IsEmpty() const { return m_AllocationCount == 0; }
+	uint64_t GetSize() const { return m_Size; }
+	Stats GetStats() const;
+	float GetFragmentation() const; // 0 when all free space is a single range, approaches 1 when it's scattered
+
+
+private:
+	static constexpr uint32_t SecondLevelBits{ 4 };
+	static constexpr uint32_t SecondLevelCount{ 1u << SecondLevelBits };
+	static constexpr uint32_t FirstLevelCount{ 64 - SecondLevelBits + 1 };
+
+	// A node is a range that is either free or allocated, neighbouring free ranges are always merged
+	struct Node
+	{
+		uint64_t Offset{};
+		uint64_t Size{};
+		uint64_t RequestedSize{};
+		uint32_t PrevPhysical{ InvalidHandle };
+		uint32_t NextPhysical{ InvalidHandle };
+		uint32_t PrevFree{ InvalidHandle };
+		uint32_t NextFree{ InvalidHandle };
+		bool IsFree{ false };
+	};
+
+	// Member variables
+	uint64_t m_Size{};
+	uint64_t m_MinSplitSize{};
+
+	std::vector<Node> m_Nodes{};
+	std::vector<uint32_t> m_UnusedNodes{};
+
+	uint64_t m_FirstLevelBitmap{};
+	std::array<uint32_t, FirstLevelCount> m_SecondLevelBitmaps{};
+	std::array<std::array<uint32_t, SecondLevelCount>, FirstLevelCount> m_FreeLists{};
+
+	uint64_t m_UsedSize{};
+	uint64_t m_RequestedSize{};
+	uint32_t m_AllocationCount{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+	static void Mapping(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+	uint32_t FindFreeNode(uint64_t size) const;
+	void InsertFreeNode(uint32_t node);
+	void RemoveFreeNode(uint32_t node);
+
+	uint32_t CreateNode(uint64_t offset, uint64_t size);
+	void ReleaseNode(uint32_t node);
+	uint32_t SplitFront(uint32_t node, uint64_t frontSize);
+	uint32_t SplitBack(uint32_t node, uint64_t frontSize);
+};
+#endif
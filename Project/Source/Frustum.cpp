@@ -0,0 +1,55 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "Frustum.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_access.hpp>
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+Frustum::Frustum(const glm::mat4& viewProjection)
+{
+	// Rows of the matrix combined (Gribb & Hartmann), the near plane is z >= 0 since depth runs from 0 to 1
+	glm::vec4 row0 = glm::row(viewProjection, 0);
+	glm::vec4 row1 = glm::row(viewProjection, 1);
+	glm::vec4 row2 = glm::row(viewProjection, 2);
+	glm::vec4 row3 = glm::row(viewProjection, 3);
+
+	m_Planes[0] = row3 + row0; // Left
+	m_Planes[1] = row3 - row0; // Right
+	m_Planes[2] = row3 + row1; // Bottom
+	m_Planes[3] = row3 - row1; // Top
+	m_Planes[4] = row2; // Near
+	m_Planes[5] = row3 - row2; // Far
+
+	for (glm::vec4& plane : m_Planes)
+	{
+		plane /= glm::length(glm::vec3(plane));
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Destructor
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+bool Frustum::IsSphereVisible(const glm::vec3& center, float radius) const
+{
+	for (const glm::vec4& plane : m_Planes)
+	{
+		if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+	}
+	return true;
+}
+
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+
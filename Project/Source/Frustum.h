@@ -0,0 +1,43 @@
+#ifndef GP2VKT_FRUSTUM_H_
+#define GP2VKT_FRUSTUM_H_
+// Includes
+#include <array>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+// Class Forward Declarations
+
+
+// Planes of a view frustum with a [0, 1] depth range, in the space the matrix transforms from
+// Passing projection * view * model gives model space planes, so bounds can be tested without transforming them
+class Frustum final
+{
+public:
+	// Constructors and Destructor
+	explicit Frustum(const glm::mat4& viewProjection);
+	~Frustum() = default;
+
+	// Copy and Move semantics
+	Frustum(const Frustum& other)					= default;
+	Frustum& operator=(const Frustum& other)		= default;
+	Frustum(Frustum&& other) noexcept				= default;
+	Frustum& operator=(Frustum&& other) noexcept	= default;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	bool IsSphereVisible(const glm::vec3& center, float radius) const; // Conservative, spheres near the corners can pass
+	const std::array<glm::vec4, 6>& GetPlanes() const { return m_Planes; } // Left, right, bottom, top, near & far
+
+
+private:
+	// Member variables
+	std::array<glm::vec4, 6> m_Planes{}; // Normalized, pointing inwards
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+
+};
+#endif
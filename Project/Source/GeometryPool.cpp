@@ -0,0 +1,290 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "GeometryPool.h"
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+#include "RAII/GP2_SingleTimeCommand.h"
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+GeometryPool::GeometryPool(VkDevice device, MemoryAllocator& allocator, uint32_t vertexStride, uint32_t vertexCapacity, uint32_t indexCapacity, bool isReadByMeshShaders)
+	: m_Device{ device }
+	, m_Allocator{ allocator }
+	, m_VertexStride{ vertexStride }
+	, m_VertexCapacity{ vertexCapacity }
+	, m_IndexCapacity{ indexCapacity }
+	, m_IsReadByMeshShaders{ isReadByMeshShaders }
+	, m_VertexRanges{ vertexCapacity }
+	, m_IndexRanges{ indexCapacity }
+{
+	CreateBuffers(m_VertexBuffer, m_VertexBufferMemory, m_IndexBuffer, m_IndexBufferMemory);
+}
+
+
+//-----------------------------------------------------------------
+// Destructor
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+GeometryPool::Handle GeometryPool::Allocate(uint32_t vertexCount, uint32_t indexCount)
+{
+	// Exit early in case of wrong input values
+	if (vertexCount == 0 || indexCount == 0) return InvalidHandle;
+
+	auto vertexRange = m_VertexRanges.Allocate(vertexCount);
+	if (vertexRange.has_value() == false) return InvalidHandle;
+
+	auto indexRange = m_IndexRanges.Allocate(indexCount);
+	if (indexRange.has_value() == false) {
+		m_VertexRanges.Free(vertexRange->Handle);
+		return InvalidHandle;
+	}
+
+	// Reuse a released slot if there is one
+	Handle handle{};
+	if (m_UnusedSlots.empty() == false) {
+		handle = m_UnusedSlots.back();
+		m_UnusedSlots.pop_back();
+	}
+	else {
+		handle = static_cast<Handle>(m_Slots.size());
+		m_Slots.emplace_back();
+	}
+
+	Slot& slot = m_Slots[handle];
+	slot.Range.VertexOffset = static_cast<int32_t>(vertexRange->Offset);
+	slot.Range.FirstIndex = static_cast<uint32_t>(indexRange->Offset);
+	slot.Range.IndexCount = indexCount;
+	slot.Range.VertexCount = vertexCount;
+	slot.VertexHandle = vertexRange->Handle;
+	slot.IndexHandle = indexRange->Handle;
+	slot.IsUsed = true;
+
+	return handle;
+}
+
+void GeometryPool::Free(Handle handle)
+{
+	if (handle >= m_Slots.size() || m_Slots[handle].IsUsed == false) {
+		throw std::invalid_argument("freeing geometry that isn't allocated!");
+	}
+
+	m_VertexRanges.Free(m_Slots[handle].VertexHandle);
+	m_IndexRanges.Free(m_Slots[handle].IndexHandle);
+
+	m_Slots[handle] = Slot{};
+	m_UnusedSlots.push_back(handle);
+}
+
+GeometryPool::Handle GeometryPool::Upload(UploadService& uploadService, const void* pVertices, uint32_t vertexCount, uint32_t vertexStride, const uint32_t* pIndices, uint32_t indexCount)
+{
+	// Copy the data into the staging regions of the ranges
+	StagingRegion vertexRegion{}, indexRegion{};
+	Handle handle = Upload(uploadService, vertexCount, vertexStride, indexCount, vertexRegion, indexRegion);
+	memcpy(vertexRegion.pData, pVertices, vertexRegion.Size);
+	memcpy(indexRegion.pData, pIndices, indexRegion.Size);
+	return handle;
+}
+
+GeometryPool::Handle GeometryPool::Upload(UploadService& uploadService, uint32_t vertexCount, uint32_t vertexStride, uint32_t indexCount, StagingRegion& vertexRegion, StagingRegion& indexRegion)
+{
+	if (vertexStride != m_VertexStride) {
+		throw std::invalid_argument("vertex type doesn't match the geometry pool!");
+	}
+	if (vertexCount == 0 || indexCount == 0) {
+		throw std::invalid_argument("geometry upload has no vertices or indices!");
+	}
+
+	// Reserve ranges in the pool
+	Handle handle = Allocate(vertexCount, indexCount);
+	if (handle == InvalidHandle) {
+		throw std::runtime_error("failed to allocate geometry, pool is full!");
+	}
+
+	// The copies only read the staging memory once the upload service submits
+	vertexRegion = uploadService.AllocateStaging(static_cast<VkDeviceSize>(vertexCount) * m_VertexStride);
+	indexRegion = uploadService.AllocateStaging(static_cast<VkDeviceSize>(indexCount) * sizeof(uint32_t));
+	UploadRanges(uploadService, handle, vertexRegion, indexRegion);
+	return handle;
+}
+
+GeometryPool::Handle GeometryPool::Upload(UploadService& uploadService, uint32_t vertexStride, const StagingRegion& vertexRegion, const StagingRegion& indexRegion)
+{
+	if (vertexStride != m_VertexStride) {
+		throw std::invalid_argument("vertex type doesn't match the geometry pool!");
+	}
+
+	const uint32_t vertexCount{ static_cast<uint32_t>(vertexRegion.Size / vertexStride) };
+	const uint32_t indexCount{ static_cast<uint32_t>(indexRegion.Size / sizeof(uint32_t)) };
+	if (vertexCount == 0 || indexCount == 0) {
+		throw std::invalid_argument("geometry upload has no vertices or indices!");
+	}
+
+	// Reserve ranges in the pool
+	Handle handle = Allocate(vertexCount, indexCount);
+	if (handle == InvalidHandle) {
+		throw std::runtime_error("failed to allocate geometry, pool is full!");
+	}
+
+	UploadRanges(uploadService, handle, vertexRegion, indexRegion);
+	return handle;
+}
+
+bool GeometryPool::Compact(UploadService& uploadService, std::unique_ptr<GP2_SingleTimeCommand> commandBuffer)
+{
+	// Copies into the old buffers have to be done before they are read, including the ones that aren't submitted yet
+	uploadService.Wait(uploadService.Submit());
+	if (IsCompact()) return false;
+
+	// Ranges can't be moved inside of the same buffer with a single copy since they might overlap
+	GP2_VkBuffer vertexBuffer{}, indexBuffer{};
+	MemoryAllocation vertexMemory{}, indexMemory{};
+	CreateBuffers(vertexBuffer, vertexMemory, indexBuffer, indexMemory);
+
+	FreeListAllocator vertexRanges{ m_VertexCapacity };
+	FreeListAllocator indexRanges{ m_IndexCapacity };
+
+	// A fresh allocator hands out ranges back to back
+	std::vector<VkBufferCopy> vertexCopies{}, indexCopies{};
+	for (Slot& slot : m_Slots)
+	{
+		if (slot.IsUsed == false) continue;
+
+		auto vertexRange = vertexRanges.Allocate(slot.Range.VertexCount);
+		auto indexRange = indexRanges.Allocate(slot.Range.IndexCount);
+
+		vertexCopies.push_back(VkBufferCopy{
+			static_cast<VkDeviceSize>(slot.Range.VertexOffset) * m_VertexStride,
+			vertexRange->Offset * m_VertexStride,
+			static_cast<VkDeviceSize>(slot.Range.VertexCount) * m_VertexStride });
+		indexCopies.push_back(VkBufferCopy{
+			static_cast<VkDeviceSize>(slot.Range.FirstIndex) * sizeof(uint32_t),
+			indexRange->Offset * sizeof(uint32_t),
+			static_cast<VkDeviceSize>(slot.Range.IndexCount) * sizeof(uint32_t) });
+
+		slot.Range.VertexOffset = static_cast<int32_t>(vertexRange->Offset);
+		slot.Range.FirstIndex = static_cast<uint32_t>(indexRange->Offset);
+		slot.VertexHandle = vertexRange->Handle;
+		slot.IndexHandle = indexRange->Handle;
+	}
+
+	if (vertexCopies.empty() == false) {
+		vkCmdCopyBuffer(commandBuffer->Get(), m_VertexBuffer, vertexBuffer, static_cast<uint32_t>(vertexCopies.size()), vertexCopies.data());
+		vkCmdCopyBuffer(commandBuffer->Get(), m_IndexBuffer, indexBuffer, static_cast<uint32_t>(indexCopies.size()), indexCopies.data());
+	}
+
+	// Submit & wait for the copies before the old buffers are destroyed
+	commandBuffer = nullptr;
+
+	m_VertexBuffer = std::move(vertexBuffer);
+	m_VertexBufferMemory = std::move(vertexMemory);
+	m_IndexBuffer = std::move(indexBuffer);
+	m_IndexBufferMemory = std::move(indexMemory);
+	m_VertexRanges = std::move(vertexRanges);
+	m_IndexRanges = std::move(indexRanges);
+	return true;
+}
+
+bool GeometryPool::NeedsCompaction(uint32_t vertexCount, uint32_t indexCount) const
+{
+	FreeListAllocator::Stats vertexStats = m_VertexRanges.GetStats();
+	FreeListAllocator::Stats indexStats = m_IndexRanges.GetStats();
+
+	bool fitsTotal = vertexStats.FreeSize >= vertexCount && indexStats.FreeSize >= indexCount;
+	bool fitsRange = vertexStats.LargestFreeRange >= vertexCount && indexStats.LargestFreeRange >= indexCount;
+	return fitsTotal && fitsRange == false;
+}
+
+void GeometryPool::CmdBind(VkCommandBuffer commandBuffer) const
+{
+	// Bind vertex buffer
+	VkBuffer vertexBuffer{ m_VertexBuffer };
+	VkDeviceSize offset{ 0 };
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+
+	// Bind index buffer
+	vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+}
+
+void GeometryPool::CmdDraw(VkCommandBuffer commandBuffer, Handle handle, uint32_t instanceCount) const
+{
+	const GeometryRange& range = GetRange(handle);
+	vkCmdDrawIndexed(commandBuffer, range.IndexCount, instanceCount, range.FirstIndex, range.VertexOffset, 0);
+}
+void GeometryPool::CmdDraw(VkCommandBuffer commandBuffer, Handle handle, uint32_t firstIndex, uint32_t indexCount, uint32_t instanceCount) const
+{
+	const GeometryRange& range = GetRange(handle);
+	vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, range.FirstIndex + firstIndex, range.VertexOffset, 0);
+}
+
+const GeometryRange& GeometryPool::GetRange(Handle handle) const
+{
+	if (handle >= m_Slots.size() || m_Slots[handle].IsUsed == false) {
+		throw std::invalid_argument("geometry handle isn't allocated!");
+	}
+	return m_Slots[handle].Range;
+}
+
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+void GeometryPool::CreateBuffers(GP2_VkBuffer& vertexBuffer, MemoryAllocation& vertexMemory, GP2_VkBuffer& indexBuffer, MemoryAllocation& indexMemory)
+{
+	// Transfer source is needed to copy the ranges during compaction
+	VkBufferUsageFlags vertexUsage{ VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT };
+	if (m_IsReadByMeshShaders) vertexUsage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+	vertexBuffer = GP2_VkBuffer{ m_Device,
+		static_cast<VkDeviceSize>(m_VertexCapacity) * m_VertexStride,
+		vertexUsage,
+		false };
+	vertexMemory = m_Allocator.AllocateAndBind(vertexBuffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+	indexBuffer = GP2_VkBuffer{ m_Device,
+		static_cast<VkDeviceSize>(m_IndexCapacity) * sizeof(uint32_t),
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+		false };
+	indexMemory = m_Allocator.AllocateAndBind(indexBuffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+void GeometryPool::UploadRanges(UploadService& uploadService, Handle handle, const StagingRegion& vertexRegion, const StagingRegion& indexRegion)
+{
+	const GeometryRange& range = GetRange(handle);
+
+	// Copy from the staging regions into the ranges of the pool
+	uploadService.UploadBuffer(
+		m_VertexBuffer,
+		static_cast<VkDeviceSize>(range.VertexOffset) * m_VertexStride,
+		vertexRegion,
+		m_IsReadByMeshShaders ? VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT : VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+		m_IsReadByMeshShaders ? VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_SHADER_READ_BIT : VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+	uploadService.UploadBuffer(
+		m_IndexBuffer,
+		static_cast<VkDeviceSize>(range.FirstIndex) * sizeof(uint32_t),
+		indexRegion,
+		VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+		VK_ACCESS_INDEX_READ_BIT);
+}
+
+bool GeometryPool::IsCompact() const
+{
+	// Without gaps the ranges end exactly where their summed sizes do
+	uint64_t vertexCount{}, indexCount{}, vertexEnd{}, indexEnd{};
+	for (const Slot& slot : m_Slots)
+	{
+		if (slot.IsUsed == false) continue;
+
+		vertexCount += slot.Range.VertexCount;
+		indexCount += slot.Range.IndexCount;
+		vertexEnd = std::max<uint64_t>(vertexEnd, static_cast<uint64_t>(slot.Range.VertexOffset) + slot.Range.VertexCount);
+		indexEnd = std::max<uint64_t>(indexEnd, static_cast<uint64_t>(slot.Range.FirstIndex) + slot.Range.IndexCount);
+	}
+	return vertexEnd == vertexCount && indexEnd == indexCount;
+}
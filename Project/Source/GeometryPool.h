@@ -0,0 +1,117 @@
+#ifndef GP2VKT_GEOMETRYPOOL_H_
+#define GP2VKT_GEOMETRYPOOL_H_
+// Includes
+#include <vulkan/vulkan_core.h>
+#include <vector>
+#include <memory>
+#include "FreeListAllocator.h"
+#include "MemoryAllocator.h"
+#include "UploadService.h"
+#include "RAII/GP2_VkBuffer.h"
+
+// Class Forward Declarations
+class GP2_SingleTimeCommand;
+
+
+// Location of a mesh inside of the pool, matches the arguments of vkCmdDrawIndexed
+struct GeometryRange
+{
+	int32_t VertexOffset{};
+	uint32_t FirstIndex{};
+	uint32_t IndexCount{};
+	uint32_t VertexCount{};
+};
+
+
+// One big vertex buffer and one big index buffer shared by all meshes
+// Binding them once per frame allows every mesh to be drawn with a single vkCmdDrawIndexed
+class GeometryPool final
+{
+public:
+	using Handle = uint32_t;
+	static constexpr Handle InvalidHandle{ UINT32_MAX };
+
+	// Constructors and Destructor
+	explicit GeometryPool(VkDevice device, MemoryAllocator& allocator, uint32_t vertexStride, uint32_t vertexCapacity, uint32_t indexCapacity, bool isReadByMeshShaders = false);
+	~GeometryPool() = default;
+
+	// Copy and Move semantics
+	GeometryPool(const GeometryPool& other)					= delete;
+	GeometryPool& operator=(const GeometryPool& other)		= delete;
+	GeometryPool(GeometryPool&& other) noexcept				= delete;
+	GeometryPool& operator=(GeometryPool&& other) noexcept	= delete;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	Handle Allocate(uint32_t vertexCount, uint32_t indexCount); // InvalidHandle if there is no contiguous space left or a count is 0
+	void Free(Handle handle); // The GPU shouldn't be using the range anymore
+	// Every upload throws if there are no vertices or no indices, and if the pool has no contiguous space left for them
+	template<typename VertexType>
+	Handle Upload(UploadService& uploadService, const std::vector<VertexType>& vertices, const std::vector<uint32_t>& indices); // Usable once the upload is complete
+	Handle Upload(UploadService& uploadService, const void* pVertices, uint32_t vertexCount, uint32_t vertexStride, const uint32_t* pIndices, uint32_t indexCount); // Raw blobs, e.g. straight from a cache file
+	// Staging memory for the vertices & indices is handed back instead, it has to be filled before the upload service submits
+	Handle Upload(UploadService& uploadService, uint32_t vertexCount, uint32_t vertexStride, uint32_t indexCount, StagingRegion& vertexRegion, StagingRegion& indexRegion);
+	Handle Upload(UploadService& uploadService, uint32_t vertexStride, const StagingRegion& vertexRegion, const StagingRegion& indexRegion); // Regions that are already filled, e.g. imported files
+
+	// Moves all ranges to the front of new buffers, handles stay valid but their ranges and the buffers change
+	// Waits for every upload first, the GPU can't be drawing from the pool. False if the ranges already were at the front
+	// Otherwise descriptor sets reading GetVertexBuffer (Mesh::UpdateMeshletDescriptorSet) & copies of the ranges (Mesh::GetObjectData) have to be written again
+	bool Compact(UploadService& uploadService, std::unique_ptr<GP2_SingleTimeCommand> commandBuffer);
+	bool NeedsCompaction(uint32_t vertexCount, uint32_t indexCount) const; // True if the space is there but scattered
+
+	void CmdBind(VkCommandBuffer commandBuffer) const;
+	void CmdDraw(VkCommandBuffer commandBuffer, Handle handle, uint32_t instanceCount = 1) const;
+	void CmdDraw(VkCommandBuffer commandBuffer, Handle handle, uint32_t firstIndex, uint32_t indexCount, uint32_t instanceCount = 1) const; // Part of the indices, relative to the range
+	const GeometryRange& GetRange(Handle handle) const;
+	VkBuffer GetVertexBuffer() const { return m_VertexBuffer; } // Changes when the pool is compacted
+	VkBuffer GetIndexBuffer() const { return m_IndexBuffer; } // Changes when the pool is compacted
+
+
+private:
+	struct Slot
+	{
+		GeometryRange Range{};
+		uint32_t VertexHandle{ FreeListAllocator::InvalidHandle };
+		uint32_t IndexHandle{ FreeListAllocator::InvalidHandle };
+		bool IsUsed{ false };
+	};
+
+	// Member variables
+	VkDevice m_Device{ nullptr };
+	MemoryAllocator& m_Allocator;
+
+	uint32_t m_VertexStride{};
+	uint32_t m_VertexCapacity{};
+	uint32_t m_IndexCapacity{};
+	bool m_IsReadByMeshShaders{ false }; // Vertices are also fetched as a storage buffer
+
+	GP2_VkBuffer m_VertexBuffer{};
+	MemoryAllocation m_VertexBufferMemory{};
+	GP2_VkBuffer m_IndexBuffer{};
+	MemoryAllocation m_IndexBufferMemory{};
+
+	// Ranges are counted in vertices and indices instead of bytes
+	FreeListAllocator m_VertexRanges;
+	FreeListAllocator m_IndexRanges;
+
+	std::vector<Slot> m_Slots{};
+	std::vector<Handle> m_UnusedSlots{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+	void CreateBuffers(GP2_VkBuffer& vertexBuffer, MemoryAllocation& vertexMemory, GP2_VkBuffer& indexBuffer, MemoryAllocation& indexMemory);
+	void UploadRanges(UploadService& uploadService, Handle handle, const StagingRegion& vertexRegion, const StagingRegion& indexRegion);
+	bool IsCompact() const; // Used ranges are back to back from the start of both buffers
+};
+
+//---------------------------
+// Template Member Functions
+//---------------------------
+template<typename VertexType>
+inline GeometryPool::Handle GeometryPool::Upload(UploadService& uploadService, const std::vector<VertexType>& vertices, const std::vector<uint32_t>& indices)
+{
+	return Upload(uploadService, vertices.data(), static_cast<uint32_t>(vertices.size()), sizeof(VertexType), indices.data(), static_cast<uint32_t>(indices.size()));
+}
+#endif
@@ -6,7 +6,14 @@
 #include <GLFW/glfw3.h>
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
-#include <tiny_obj_loader.h>
+#include "MipGenerator.h"
+#include "BlockCompressor.h"
+#include "TextureCache.h"
+#include "AssetPack.h"
+#include "VirtualFileSystem.h"
+#include "AsyncFileReader.h"
+#include "MappedFile.h"
+#include "Frustum.h"
 #include "Utils.h"
 #include "DataTypes.h"
 #include <stdexcept>
@@ -18,7 +25,10 @@
 #include <algorithm>
 #include <chrono>
 #include <numeric>
-#include <unordered_map>
+#include <cmath>
+#include <filesystem>
+#include <random>
+#include <iterator>
 
 #include "RAII/GP2_VkShaderModule.h"
 #include "RAII/GP2_SingleTimeCommand.h"
@@ -27,6 +37,7 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
 
 
 //-----------------------------------------------------------------
@@ -44,6 +55,11 @@
 //-----------------------------------------------------------------
 void HelloTriangleApplication::Run()
 {
+	// Loose files override the pack, so edited assets show up without packing again
+	std::error_code error{};
+	if (std::filesystem::exists(config::ASSET_PACK_PATH, error)) vfs::MountPack(config::ASSET_PACK_PATH, "Resources/");
+	vfs::MountDirectory("Resources", "Resources/");
+
 	InitWindow();
 	InitVulkan();
 	MainLoop();
@@ -79,6 +95,16 @@ void HelloTriangleApplication::InitVulkan()
 	// Physical and logical device setup
 	PickPhysicalDevice();
 	CreateLogicalDevice();
+	m_pAllocator = std::make_unique<MemoryAllocator>(m_PhysicalDevice, *m_pDevice, config::MEMORY_BLOCK_SIZE);
+	m_pStagingRing = std::make_unique<StagingRing>(*m_pDevice, *m_pAllocator, config::STAGING_RING_SIZE);
+	if (m_UseHostMemoryImport) EnableHostMemoryImport();
+	{
+		QueueFamilyIndices indices = FindQueueFamilies(m_PhysicalDevice);
+		m_pUploadService = std::make_unique<UploadService>(*m_pDevice, *m_pStagingRing,
+			indices.TransferFamily.value_or(indices.GraphicsFamily.value()), m_TransferQueue,
+			indices.GraphicsFamily.value(), m_GraphicsQueue);
+	}
+	m_pGeometryPool = std::make_unique<GeometryPool>(*m_pDevice, *m_pAllocator, static_cast<uint32_t>(sizeof(config::VertexType)), config::GEOMETRY_POOL_VERTEX_COUNT, config::GEOMETRY_POOL_INDEX_COUNT, m_UseMeshShaders);
 
 	CreateRenderPass(ChooseSwapSurfaceFormat(QuerySwapChainSupport(m_PhysicalDevice, *m_pSurface).Formats).format);
 
@@ -87,19 +113,62 @@ void HelloTriangleApplication::InitVulkan()
 	CreateDepthResources();
 	CreateFramebuffers();
 
-	m_pDescriptorSetLayout = std::make_unique<GP2_VkDescriptorSetLayout>(*m_pDevice, std::vector{ GetLayoutBindingUBO(), GetLayoutBindingSampler(), GetLayoutBindingModel() });
-	m_pPipelineLayout = std::make_unique<GP2_VkPipelineLayout>(*m_pDevice, std::vector<VkDescriptorSetLayout>{ *m_pDescriptorSetLayout });
-	CreateGraphicsPipeline();
+	VkShaderStageFlags geometryStages = m_UseMeshShaders ? VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_MESH_BIT_EXT : VK_SHADER_STAGE_VERTEX_BIT;
+	m_pDescriptorSetLayout = std::make_unique<GP2_VkDescriptorSetLayout>(*m_pDevice, std::vector{ GetLayoutBindingUBO(geometryStages), GetLayoutBindingSampler() });
+	{
+		// The transforms of every draw, see Mesh::Render
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(DrawConstants);
+		m_pPipelineLayout = std::make_unique<GP2_VkPipelineLayout>(*m_pDevice, std::vector<VkDescriptorSetLayout>{ *m_pDescriptorSetLayout }, std::vector<VkPushConstantRange>{ pushConstantRange });
+	}
+	m_pGraphicsPipeline = CreateGraphicsPipeline(*m_pPipelineLayout, config::VERTEX_SHADER_PATH, VK_SHADER_STAGE_VERTEX_BIT);
+	if (m_UseMeshShaders) CreateMeshletPipeline();
+
+	// Only needs the camera uniform, the instances bring their own transforms
+	m_UseInstancing = config::DRAW_INSTANCED && std::is_same_v<config::VertexType, VertexPBR> && m_UseGpuCulling == false;
+	if (m_UseInstancing) m_pInstancedPipeline = CreateGraphicsPipeline(*m_pPipelineLayout, config::INSTANCED_VERTEX_SHADER_PATH, VK_SHADER_STAGE_VERTEX_BIT, true);
+
+	// The copies don't move, so their objects are uploaded once & only the camera changes from frame to frame
+	if (m_UseGpuCulling) {
+		m_pCullingPass = std::make_unique<CullingPass>(*m_pDevice, *m_pAllocator, config::INSTANCE_COUNT, static_cast<uint32_t>(m_SwapChainImages.size()), m_UseDrawIndirectCount, config::CULL_SHADER_PATH);
+		m_pIndirectPipelineLayout = std::make_unique<GP2_VkPipelineLayout>(*m_pDevice, std::vector<VkDescriptorSetLayout>{ *m_pDescriptorSetLayout, m_pCullingPass->GetObjectSetLayout() });
+		m_pIndirectPipeline = CreateGraphicsPipeline(*m_pIndirectPipelineLayout, config::INDIRECT_VERTEX_SHADER_PATH, VK_SHADER_STAGE_VERTEX_BIT);
+	}
 
+	// Uploads run on the transfer queue while the rest is being set up
+	GeometryPool::Handle compactionHole{ GeometryPool::InvalidHandle };
+	if (config::VALIDATE_GEOMETRY_COMPACTION) compactionHole = m_pGeometryPool->Upload(*m_pUploadService, std::vector<config::VertexType>(1024), std::vector<uint32_t>(3072));
 	LoadVehicleModel();
+	m_Transforms.Update();
+	m_VehicleBoundsIndex = m_SceneBounds.Add(m_pVehicle->GetBounds(), m_pVehicle->GetTransform());
+	m_VisibleObjects.resize(m_SceneBounds.GetSize());
+	if (m_UseMeshShaders) m_pVehicle->UploadMeshlets(*m_pAllocator, *m_pUploadService);
+	if (config::VALIDATE_GEOMETRY_COMPACTION) ValidateGeometryCompaction(compactionHole);
+	std::vector<ObjectData> objects{};
+	if (m_pCullingPass) {
+		objects = CreateObjectGrid();
+		m_pCullingPass->Upload(*m_pUploadService, objects);
+	}
+	UploadToken uploadToken = m_pUploadService->Submit();
 	CreateTextureSampler();
 
-	CreateCameraAndModelUniformBuffers();
+	CreateCameraUniformBuffers();
+	if (config::CULL_MESHLETS && m_UseMeshShaders == false && m_UseInstancing == false && m_UseGpuCulling == false) CreateCulledIndexBuffers();
+	if (m_UseInstancing) m_pInstanceBuffer = std::make_unique<InstanceBuffer>(*m_pDevice, *m_pAllocator, config::INSTANCE_COUNT, static_cast<uint32_t>(m_SwapChainImages.size()));
 	CreateDescriptorSets();
 	UpdateDescriptorSets(m_Textures);
+	if (m_UseMeshShaders) CreateMeshletDescriptorSets();
+
+	PrintMemoryStats();
 
 	CreateCommandPool();
-	RecordCommandBuffers();
+
+	// Meshes & textures have to be uploaded before they are drawn
+	m_pUploadService->Wait(uploadToken);
+	if (m_pCullingPass && config::VALIDATE_GPU_CULLING) ValidateGpuCulling(objects);
+	if (m_UseHostMemoryImport && config::VALIDATE_HOST_MEMORY_IMPORT) ValidateHostMemoryImport();
 
 	CreateSyncObjects();
 }
@@ -120,21 +189,29 @@ void HelloTriangleApplication::Cleanup()
 	DestroySyncObjects();
 
 	m_pCommandBuffers = nullptr;
+	m_pMeshletDescriptorSets = nullptr;
 	m_pDescriptorSets = nullptr;
-	m_pCameraModelBufferMemory = nullptr;
-	m_pCameraModelBuffer = nullptr;
-	m_pUniformBufferMemory = nullptr;
-	m_pUniformBuffer = nullptr;
+	m_pInstanceBuffer = nullptr;
+	m_pCullingPass = nullptr;
+	m_pCulledIndexBufferMemory = nullptr;
+	m_pCulledIndexBuffer = nullptr;
+	m_pCameraBufferMemory = nullptr;
+	m_pCameraBuffer = nullptr;
 
 	m_pTextureSampler = nullptr;
 	m_Textures.clear();
 
-	m_pVertexIndexBufferMemory = nullptr;
-	m_pVertexIndexBuffer = nullptr;
-
 	m_pMeshObject = nullptr;
 	m_pVehicle = nullptr;
-
+	m_Transforms.Clear();
+	m_pGeometryPool = nullptr;
+
+	m_pIndirectPipeline = nullptr;
+	m_pIndirectPipelineLayout = nullptr;
+	m_pInstancedPipeline = nullptr;
+	m_pMeshletPipeline = nullptr;
+	m_pMeshletPipelineLayout = nullptr;
+	m_pMeshletDescriptorSetLayout = nullptr;
 	m_pGraphicsPipeline = nullptr;
 	m_pPipelineLayout = nullptr;
 	m_pDescriptorSetLayout = nullptr;
@@ -143,6 +220,10 @@ void HelloTriangleApplication::Cleanup()
 
 	m_pRenderPass = nullptr;
 
+	// Every allocation should be released before its allocator
+	m_pUploadService = nullptr;
+	m_pStagingRing = nullptr;
+	m_pAllocator = nullptr;
 	m_pDevice = nullptr;
 
 	// Destroyed right before instance to allow for debug messages during cleanup
@@ -176,12 +257,26 @@ void HelloTriangleApplication::DrawFrame()
 		throw std::runtime_error("failed to acquire swap chain image!");
 	}
 
+	// Another frame in flight might still be using this image and its command buffer
+	if (m_ImagesInFlight[imageIndex] != VK_NULL_HANDLE) {
+		vkWaitForFences(*m_pDevice, 1, &m_ImagesInFlight[imageIndex], VK_TRUE, UINT64_MAX);
+	}
+	m_ImagesInFlight[imageIndex] = m_InFlightFences[m_CurrentFrame];
+
 	// Reset fence if an image was succesfully acquired
 	vkResetFences(*m_pDevice, 1, &static_cast<const VkFence&>(m_InFlightFences[m_CurrentFrame]));
 
+	// Recycle resources of uploads that finished in the meantime
+	m_pUploadService->Collect();
+
 	// Update model-view-projection matrices
 	UpdateUniformBuffer(imageIndex);
 
+	// The pushed transforms, the selected levels of detail & the visible objects change from frame to frame
+	// So the command buffer of an image is only recorded right before it's submitted, never ahead of time
+	vkResetCommandBuffer(m_pCommandBuffers->Get()[imageIndex], 0);
+	RecordCommandBuffer(m_pCommandBuffers->Get()[imageIndex], imageIndex);
+
 	// Submit the recorded command buffer to the GPU
 	VkSemaphore waitSemaphores[] = { m_ImageAvailableSemaphores[m_CurrentFrame] };
 	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT }; // corresponds to semaphore with same index
@@ -242,29 +337,65 @@ void HelloTriangleApplication::UpdateUniformBuffer(uint32_t currentImage)
 	auto currentTime = std::chrono::high_resolution_clock::now();
 	float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
 
-	CameraViewProj ubo{};
+	CameraViewProj ubo{ CalculateCamera() };
+
+	// Copy data to the mapped uniform buffer
+	memcpy(m_MappedCameraBuffers[currentImage], &ubo, sizeof(ubo));
+
+	// Recorded into the culling dispatch & multiplied into the MVP matrices the draws of this frame push
+	m_ViewProjection = ubo.viewProj;
+
+	if (m_pVehicle) m_pVehicle->SetRotation(90.f, 0.f, time * 90.0f);
+
+	// Only the transforms that moved since the last frame & their children are recomputed, in one pass over all of them
+	m_Transforms.Update();
+	if (m_pVehicle) m_SceneBounds.Update(m_VehicleBoundsIndex, m_pVehicle->GetBounds(), m_pVehicle->GetTransform());
+
+	// Once every moved mesh has updated its bounds, the draws of the meshes outside of the frustum are skipped in RecordCommandBuffer
+	if (config::CULL_OBJECTS) m_VisibleObjectCount = m_SceneBounds.Cull(Frustum{ m_ViewProjection }, m_VisibleObjects.data());
+
+	if (m_pVehicle) {
+		// Pixels covered by one unit at a distance of one, turns geometric errors into screen space errors
+		float projectionScale = m_SwapChainExtent.height * 0.5f * std::abs(ubo.proj[1][1]);
+		m_pVehicle->SelectLod(ubo.view, projectionScale);
+
+		// The image's previous frame is done, so its slice of the culled indices can be overwritten
+		if (m_MappedCulledIndices.empty() == false && IsObjectVisible(m_VehicleBoundsIndex)) m_pVehicle->CullMeshlets(ubo.view, ubo.proj, m_MappedCulledIndices[currentImage]);
+
+		// Same for its slice of the instances, the copies spin along with the vehicle & share its level of detail
+		if (m_pInstanceBuffer) {
+			const MeshBounds& bounds = m_pVehicle->GetBounds();
+			float spacing = glm::length(bounds.max - bounds.min) * config::INSTANCE_SPACING;
+			InstanceBuffer::WriteGrid(m_pInstanceBuffer->GetSlice(currentImage), m_pInstanceBuffer->GetCapacity(), m_pVehicle->GetTransform(), spacing);
+		}
+	}
+}
+
+bool HelloTriangleApplication::IsObjectVisible(uint32_t boundsIndex) const
+{
+	// Cull writes the indices in ascending order
+	return config::CULL_OBJECTS == false
+		|| std::binary_search(m_VisibleObjects.begin(), m_VisibleObjects.begin() + m_VisibleObjectCount, boundsIndex);
+}
+CameraViewProj HelloTriangleApplication::CalculateCamera() const
+{
+	CameraViewProj camera{};
 
 	// View Matrix
-	ubo.view = glm::lookAt(glm::vec3(0.0f, -50.0f, 5.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+	camera.view = glm::lookAt(glm::vec3(0.0f, -50.0f, 5.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
 
 	// Projection Matrix
-	ubo.proj = glm::perspective(glm::radians(45.0f), m_SwapChainExtent.width / (float)m_SwapChainExtent.height, 0.1f, 100.0f);
+	camera.proj = glm::perspective(glm::radians(45.0f), m_SwapChainExtent.width / (float)m_SwapChainExtent.height, 0.1f, 100.0f);
 
 	// Compensate for inverted Y (GLM) by flipping the sign on Y axis in the projection matrix
-	ubo.proj[1][1] *= -1;
+	camera.proj[1][1] *= -1;
 
 	// Inv View Matrix
-	ubo.invView = glm::inverse(ubo.view);
-
-	// Copy data to the mapped uniform buffer
-	memcpy(m_MappedCameraBuffers[currentImage], &ubo, sizeof(ubo));
+	camera.invView = glm::inverse(camera.view);
 
-	/* TODO: MVP-MATRIX using a UBO this way is not the most efficient way to pass frequently changing values\
-	to the shader. A more efficient way to pass a small buffer of data to shaders are push constants*/
-	if (m_pVehicle) {
-		m_pVehicle->SetRotation(90.f, 0.f, time * 90.0f);
-		m_pVehicle->Update(m_MappedModelBuffers[currentImage]);
-	}
+	// Once here instead of once per vertex
+	camera.viewProj = camera.proj * camera.view;
+	return camera;
 }
 
 void HelloTriangleApplication::FramebufferResizeCallback(GLFWwindow* window, int width, int height)
@@ -288,7 +419,7 @@ void HelloTriangleApplication::CreateInstance()
 	appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
 	appInfo.pEngineName = "No Engine";
 	appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-	appInfo.apiVersion = VK_API_VERSION_1_0;
+	appInfo.apiVersion = VK_API_VERSION_1_2; // Timeline semaphores are core since 1.2
 
 	// Not optional data about extensions & validation layers
 	std::vector<const char*> extensions = GetRequiredExtensions();
@@ -439,6 +570,32 @@ void HelloTriangleApplication::PickPhysicalDevice()
 	if (m_PhysicalDevice == VK_NULL_HANDLE) {
 		throw std::runtime_error("failed to find a suitable GPU!");
 	}
+
+	// Optional, the mesh shader reads the vertices as VertexPBR floats
+	m_UseMeshShaders = config::USE_MESH_SHADERS && std::is_same_v<config::VertexType, VertexPBR> && CheckMeshShaderSupport(m_PhysicalDevice);
+
+	// Optional, the caches are copied into the staging ring otherwise
+	m_UseHostMemoryImport = config::IMPORT_HOST_MEMORY && CheckHostMemoryImportSupport(m_PhysicalDevice);
+
+	// Optional, textures fall back to RGBA8
+	VkPhysicalDeviceFeatures deviceFeatures{};
+	vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &deviceFeatures);
+	m_UseBlockCompression = config::USE_BLOCK_COMPRESSION && deviceFeatures.textureCompressionBC;
+
+	// Optional, the copies are drawn with DRAW_INSTANCED's path or not at all otherwise
+	m_UseGpuCulling = config::GPU_CULLING && std::is_same_v<config::VertexType, VertexPBR>
+		&& deviceFeatures.multiDrawIndirect && deviceFeatures.drawIndirectFirstInstance;
+	if (m_UseGpuCulling) {
+		VkPhysicalDeviceVulkan12Features vulkan12Features{};
+		vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+		VkPhysicalDeviceFeatures2 deviceFeatures2{};
+		deviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		deviceFeatures2.pNext = &vulkan12Features;
+		vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &deviceFeatures2);
+
+		m_UseDrawIndirectCount = vulkan12Features.drawIndirectCount;
+	}
 }
 bool HelloTriangleApplication::IsDeviceSuitable(VkPhysicalDevice device)
 {
@@ -451,6 +608,20 @@ bool HelloTriangleApplication::IsDeviceSuitable(VkPhysicalDevice device)
 	VkPhysicalDeviceFeatures deviceFeatures;
 	vkGetPhysicalDeviceFeatures(device, &deviceFeatures);
 
+	// Uploads are tracked with timeline semaphores
+	bool timelineSemaphoreSupported = false;
+	if (deviceProperties.apiVersion >= VK_API_VERSION_1_2) {
+		VkPhysicalDeviceVulkan12Features vulkan12Features{};
+		vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+		VkPhysicalDeviceFeatures2 deviceFeatures2{};
+		deviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		deviceFeatures2.pNext = &vulkan12Features;
+		vkGetPhysicalDeviceFeatures2(device, &deviceFeatures2);
+
+		timelineSemaphoreSupported = vulkan12Features.timelineSemaphore;
+	}
+
 	QueueFamilyIndices indices = FindQueueFamilies(device);
 
 	bool extensionsSupported = CheckDeviceExtensionSupport(device);
@@ -461,7 +632,7 @@ bool HelloTriangleApplication::IsDeviceSuitable(VkPhysicalDevice device)
 		swapChainAdequate = !swapChainSupport.Formats.empty() && !swapChainSupport.PresentModes.empty();
 	}
 
-	return isGPU && indices.IsComplete() && extensionsSupported && swapChainAdequate && deviceFeatures.samplerAnisotropy;
+	return isGPU && indices.IsComplete() && extensionsSupported && swapChainAdequate && deviceFeatures.samplerAnisotropy && timelineSemaphoreSupported;
 }
 QueueFamilyIndices HelloTriangleApplication::FindQueueFamilies(VkPhysicalDevice device)
 {
@@ -480,17 +651,28 @@ QueueFamilyIndices HelloTriangleApplication::FindQueueFamilies(VkPhysicalDevice
 	int i{ 0 };
 	for (const auto& queueFamily : queueFamilies)
 	{
-		if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
-			indices.GraphicsFamily = i;
+		if (indices.IsComplete() == false) {
+			if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+				indices.GraphicsFamily = i;
+			}
+
+			VkBool32 presentSupport{ false };
+			vkGetPhysicalDeviceSurfaceSupportKHR(device, i, *m_pSurface, &presentSupport);
+			if (presentSupport) {
+				indices.PresentFamily = i;
+			}
 		}
 
-		VkBool32 presentSupport{ false };
-		vkGetPhysicalDeviceSurfaceSupportKHR(device, i, *m_pSurface, &presentSupport);
-		if (presentSupport) {
-			indices.PresentFamily = i;
+		// Transfer only families (DMA engines) run next to graphics work, prefer them over async compute families
+		bool isTransferOnly = (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT)
+			&& (queueFamily.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) == 0;
+		bool isAsyncCompute = (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT)
+			&& (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0;
+		if (isTransferOnly || (isAsyncCompute && indices.TransferFamily.has_value() == false)) {
+			indices.TransferFamily = i;
 		}
 
-		if (indices.IsComplete()) {
+		if (indices.IsComplete() && isTransferOnly) {
 			break;
 		}
 
@@ -521,6 +703,61 @@ bool HelloTriangleApplication::CheckDeviceExtensionSupport(VkPhysicalDevice devi
 
 	return requiredExtensions.empty();
 }
+bool HelloTriangleApplication::CheckMeshShaderSupport(VkPhysicalDevice device)
+{
+	// Get the available extensions
+	uint32_t extensionCount{ 0 };
+	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+	bool isExtensionAvailable = std::any_of(availableExtensions.begin(), availableExtensions.end(), [](const VkExtensionProperties& extension) {
+		return strcmp(extension.extensionName, VK_EXT_MESH_SHADER_EXTENSION_NAME) == 0;
+	});
+	if (isExtensionAvailable == false) return false;
+
+	// The extension can be exposed without the mesh shader feature itself, task shaders aren't used
+	VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures{};
+	meshShaderFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+
+	VkPhysicalDeviceFeatures2 deviceFeatures2{};
+	deviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	deviceFeatures2.pNext = &meshShaderFeatures;
+	vkGetPhysicalDeviceFeatures2(device, &deviceFeatures2);
+
+	return meshShaderFeatures.meshShader;
+}
+bool HelloTriangleApplication::CheckHostMemoryImportSupport(VkPhysicalDevice device)
+{
+	// Get the available extensions
+	uint32_t extensionCount{ 0 };
+	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+	// External memory itself is core since Vulkan 1.1
+	return std::any_of(availableExtensions.begin(), availableExtensions.end(), [](const VkExtensionProperties& extension) {
+		return strcmp(extension.extensionName, VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME) == 0;
+	});
+}
+void HelloTriangleApplication::EnableHostMemoryImport()
+{
+	// Imported pointers & sizes have to be aligned to this, usually the page size
+	VkPhysicalDeviceExternalMemoryHostPropertiesEXT hostProperties{};
+	hostProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+
+	VkPhysicalDeviceProperties2 deviceProperties2{};
+	deviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	deviceProperties2.pNext = &hostProperties;
+	vkGetPhysicalDeviceProperties2(m_PhysicalDevice, &deviceProperties2);
+
+	// Extension functions aren't exported by the loader
+	auto pfnGetMemoryHostPointerProperties = reinterpret_cast<PFN_vkGetMemoryHostPointerPropertiesEXT>(vkGetDeviceProcAddr(*m_pDevice, "vkGetMemoryHostPointerPropertiesEXT"));
+	if (pfnGetMemoryHostPointerProperties == nullptr) {
+		throw std::runtime_error("failed to load vkGetMemoryHostPointerPropertiesEXT!");
+	}
+	m_pStagingRing->EnableFileImport(pfnGetMemoryHostPointerProperties, hostProperties.minImportedHostPointerAlignment);
+}
 
 void HelloTriangleApplication::CreateLogicalDevice()
 {
@@ -529,6 +766,7 @@ void HelloTriangleApplication::CreateLogicalDevice()
 	// Store queue families in a set to ensure unique queues
 	std::vector<VkDeviceQueueCreateInfo> queueCreateInfos{};
 	std::set<uint32_t> uniqueQueueFamilies = { indices.GraphicsFamily.value(), indices.PresentFamily.value() };
+	if (indices.TransferFamily.has_value()) uniqueQueueFamilies.insert(indices.TransferFamily.value());
 
 	// Loop over all unique queue families and create data for each one
 	float queuePriority{ 1.0f };
@@ -549,14 +787,46 @@ void HelloTriangleApplication::CreateLogicalDevice()
 	// Temporarily empty as we currently don't need anything special
 	VkPhysicalDeviceFeatures deviceFeatures{};
 	deviceFeatures.samplerAnisotropy = VK_TRUE; // TODO: match samplerAnisotropy with support for it by physical device through vkGetPhysicalDeviceFeatures
+	deviceFeatures.textureCompressionBC = m_UseBlockCompression ? VK_TRUE : VK_FALSE; // Checked for in PickPhysicalDevice
+	deviceFeatures.multiDrawIndirect = m_UseGpuCulling ? VK_TRUE : VK_FALSE; // Same
+	deviceFeatures.drawIndirectFirstInstance = m_UseGpuCulling ? VK_TRUE : VK_FALSE; // Same, the first instance is the object index
+
+
+	// Checked for in IsDeviceSuitable
+	VkPhysicalDeviceVulkan12Features vulkan12Features{};
+	vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	vulkan12Features.timelineSemaphore = VK_TRUE;
+	vulkan12Features.drawIndirectCount = m_UseDrawIndirectCount ? VK_TRUE : VK_FALSE; // Checked for in PickPhysicalDevice
+
+	// Checked for in CheckMeshShaderSupport
+	std::vector<const char*> deviceExtensions{ config::DeviceExtensions };
+	VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures{};
+	meshShaderFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+	meshShaderFeatures.meshShader = VK_TRUE;
+	if (m_UseMeshShaders) {
+		deviceExtensions.push_back(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+		vulkan12Features.pNext = &meshShaderFeatures;
+	}
+
+	// Checked for in CheckHostMemoryImportSupport
+	if (m_UseHostMemoryImport) deviceExtensions.push_back(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
 
 
 	// Create logical device using specified data
-	m_pDevice = std::make_unique<GP2_VkDevice>(m_PhysicalDevice, queueCreateInfos, config::ValidationLayers, config::DeviceExtensions, deviceFeatures);
+	m_pDevice = std::make_unique<GP2_VkDevice>(m_PhysicalDevice, queueCreateInfos, config::ValidationLayers, deviceExtensions, deviceFeatures, &vulkan12Features);
+
+	// Extension functions aren't exported by the loader
+	if (m_UseMeshShaders) {
+		m_pfnCmdDrawMeshTasks = reinterpret_cast<PFN_vkCmdDrawMeshTasksEXT>(vkGetDeviceProcAddr(*m_pDevice, "vkCmdDrawMeshTasksEXT"));
+		if (m_pfnCmdDrawMeshTasks == nullptr) {
+			throw std::runtime_error("failed to load vkCmdDrawMeshTasksEXT!");
+		}
+	}
 
 	// Retrieve queue handle for queue family (index 0 as there's only one right now)
 	vkGetDeviceQueue(*m_pDevice, indices.GraphicsFamily.value(), 0, &m_GraphicsQueue);
 	vkGetDeviceQueue(*m_pDevice, indices.PresentFamily.value(), 0, &m_PresentQueue);
+	vkGetDeviceQueue(*m_pDevice, indices.TransferFamily.value_or(indices.GraphicsFamily.value()), 0, &m_TransferQueue);
 }
 
 void HelloTriangleApplication::CreateSwapChain()
@@ -680,19 +950,26 @@ void HelloTriangleApplication::RecreateSwapChain()
 
 	// Create swap chain and all of the objects that depend on it
 	CreateSwapChain();
+	m_ImagesInFlight.assign(m_SwapChainImages.size(), VK_NULL_HANDLE);
 	CreateImageViews();
 	CreateDepthResources();
 	CreateFramebuffers();
 
 	// Update data that depends on the amount of images in the swap chain
 	if (m_SwapChainImages.size() != oldSwapChainSize) {
-		CreateUniformBuffers();
+		CreateCameraUniformBuffers();
+		if (m_pCulledIndexBuffer) CreateCulledIndexBuffers();
+		if (m_pCullingPass) m_pCullingPass->Resize(*m_pAllocator, static_cast<uint32_t>(m_SwapChainImages.size()));
+		if (m_pInstanceBuffer) {
+			// Every slice is rewritten in UpdateUniformBuffer before it is drawn, so nothing has to be carried over
+			m_pInstanceBuffer = nullptr;
+			m_pInstanceBuffer = std::make_unique<InstanceBuffer>(*m_pDevice, *m_pAllocator, config::INSTANCE_COUNT, static_cast<uint32_t>(m_SwapChainImages.size()));
+		}
 		CreateDescriptorSets();
 		UpdateDescriptorSets(m_Textures);
 
 		CreateCommandPool();
 	}
-	RecordCommandBuffers();
 }
 void HelloTriangleApplication::CleanupSwapChain()
 {
@@ -889,7 +1166,7 @@ void HelloTriangleApplication::CreateRenderPass(VkFormat format)
 	m_pRenderPass = std::make_unique<GP2_VkRenderPass>(*m_pDevice, std::vector{ colorAttachment, depthAttachment }, std::vector{ subpass }, std::vector{ dependency });
 }
 
-VkDescriptorSetLayoutBinding HelloTriangleApplication::GetLayoutBindingUBO()
+VkDescriptorSetLayoutBinding HelloTriangleApplication::GetLayoutBindingUBO(VkShaderStageFlags geometryStages)
 {
 	// Within 1 descriptor set layout binding has to be the same type of variable
 
@@ -898,7 +1175,7 @@ VkDescriptorSetLayoutBinding HelloTriangleApplication::GetLayoutBindingUBO()
 	uboLayoutBinding.binding = 0;
 	uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
 	uboLayoutBinding.descriptorCount = 1;
-	uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+	uboLayoutBinding.stageFlags = geometryStages | VK_SHADER_STAGE_FRAGMENT_BIT;
 	uboLayoutBinding.pImmutableSamplers = nullptr; // Optional
 
 	return uboLayoutBinding;
@@ -908,34 +1185,26 @@ VkDescriptorSetLayoutBinding HelloTriangleApplication::GetLayoutBindingSampler()
 	VkDescriptorSetLayoutBinding samplerLayoutBinding{};
 	samplerLayoutBinding.binding = 1;
 	samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	samplerLayoutBinding.descriptorCount = 4;
+	samplerLayoutBinding.descriptorCount = config::MATERIAL_TEXTURE_COUNT;
 	samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 	samplerLayoutBinding.pImmutableSamplers = nullptr; // Optional
 
 	return samplerLayoutBinding;
 }
-VkDescriptorSetLayoutBinding HelloTriangleApplication::GetLayoutBindingModel()
+std::unique_ptr<GP2_VkPipeline> HelloTriangleApplication::CreateGraphicsPipeline(VkPipelineLayout layout, const std::string& geometryShaderPath, VkShaderStageFlagBits geometryStage, bool isInstanced)
 {
-	VkDescriptorSetLayoutBinding uboLayoutBinding{};
-	uboLayoutBinding.binding = 2;
-	uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	uboLayoutBinding.descriptorCount = 1;
-	uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-	uboLayoutBinding.pImmutableSamplers = nullptr; // Optional
+	// Both shaders are read in one batch
+	std::vector<AssetData> shaderCode = vfs::ReadAll({ geometryShaderPath, config::FRAGMENT_SHADER_PATH });
 
-	return uboLayoutBinding;
-}
-void HelloTriangleApplication::CreateGraphicsPipeline()
-{
 	// Create shader modules locally (should be destroyed right after pipeline creation)
-	GP2_VkShaderModule vertShaderModule{ *m_pDevice, config::VERTEX_SHADER_PATH };
-	GP2_VkShaderModule fragShaderModule{ *m_pDevice, config::FRAGMENT_SHADER_PATH };
+	GP2_VkShaderModule vertShaderModule{ *m_pDevice, shaderCode[0] };
+	GP2_VkShaderModule fragShaderModule{ *m_pDevice, shaderCode[1] };
 
 	// TODO: Shader read up on .pName and .pSpecializationInfo, interesting for custimization of single shader usage
 	// Assign vertex & fragment shader to a specific pipeline stage
 	VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
 	vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-	vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT; // specify pipeline stage
+	vertShaderStageInfo.stage = geometryStage; // specify pipeline stage, vertex or mesh
 	vertShaderStageInfo.module = vertShaderModule;
 	vertShaderStageInfo.pName = "main"; // function to invoke (entrypoint), allows for multiple shaders in 1 module
 	vertShaderStageInfo.pSpecializationInfo = nullptr; // specify shader constants, allows for shader behavior configured at pipeline creation
@@ -945,7 +1214,12 @@ void HelloTriangleApplication::CreateGraphicsPipeline()
 	fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
 	fragShaderStageInfo.module = fragShaderModule;
 	fragShaderStageInfo.pName = "main";
-	fragShaderStageInfo.pSpecializationInfo = nullptr;
+
+	// constant_id 0 of the fragment shader, tells it how the material textures are laid out
+	const VkBool32 packedSpecularGloss{ config::PACK_SPECULAR_GLOSS ? VK_TRUE : VK_FALSE };
+	VkSpecializationMapEntry specializationEntry{ 0, 0, sizeof(VkBool32) };
+	VkSpecializationInfo fragSpecializationInfo{ 1, &specializationEntry, sizeof(packedSpecularGloss), &packedSpecularGloss };
+	fragShaderStageInfo.pSpecializationInfo = &fragSpecializationInfo;
 
 	std::vector<VkPipelineShaderStageCreateInfo> shaderStages = {
 		vertShaderStageInfo,
@@ -961,6 +1235,13 @@ void HelloTriangleApplication::CreateGraphicsPipeline()
 		vertexAttributeDescriptionsArray.end()
 	};
 
+	// Second binding that advances once per instance instead of once per vertex
+	if (isInstanced) {
+		bindingDescriptions.push_back(InstanceData::GetBindingDescription());
+		auto instanceAttributeDescriptionsArray = InstanceData::GetAttributeDescriptions();
+		attributeDescriptions.insert(attributeDescriptions.end(), instanceAttributeDescriptionsArray.begin(), instanceAttributeDescriptionsArray.end());
+	}
+
 	// Describe the format of vertex data that will be passed to the vertex shader
 	VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
 	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -1081,8 +1362,8 @@ void HelloTriangleApplication::CreateGraphicsPipeline()
 	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 	pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
 	pipelineInfo.pStages = shaderStages.data();
-	pipelineInfo.pVertexInputState = &vertexInputInfo;
-	pipelineInfo.pInputAssemblyState = &inputAssembly;
+	pipelineInfo.pVertexInputState = geometryStage == VK_SHADER_STAGE_VERTEX_BIT ? &vertexInputInfo : nullptr; // Mesh shaders fetch their own vertices
+	pipelineInfo.pInputAssemblyState = geometryStage == VK_SHADER_STAGE_VERTEX_BIT ? &inputAssembly : nullptr;
 	pipelineInfo.pTessellationState = nullptr; // Optional
 	pipelineInfo.pViewportState = &viewportState;
 	pipelineInfo.pRasterizationState = &rasterizer;
@@ -1090,13 +1371,39 @@ void HelloTriangleApplication::CreateGraphicsPipeline()
 	pipelineInfo.pDepthStencilState = &depthStencilState; // Optional (unless renderpass contains a depth stencil attachment)
 	pipelineInfo.pColorBlendState = &colorBlending;
 	pipelineInfo.pDynamicState = &dynamicState;
-	pipelineInfo.layout = *m_pPipelineLayout;
+	pipelineInfo.layout = layout;
 	pipelineInfo.renderPass = *m_pRenderPass;
 	pipelineInfo.subpass = 0; // index of the subpass where this pipeline will be used
 	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional // needs VK_PIPELINE_CREATE_DERIVATIVE_BIT flag
 	pipelineInfo.basePipelineIndex = -1; // Optional // needs VK_PIPELINE_CREATE_DERIVATIVE_BIT flag
 
-	m_pGraphicsPipeline = std::make_unique<GP2_VkPipeline>(*m_pDevice, pipelineInfo);
+	return std::make_unique<GP2_VkPipeline>(*m_pDevice, pipelineInfo);
+}
+void HelloTriangleApplication::CreateMeshletPipeline()
+{
+	// Set 1 holds the vertices of the geometry pool & the meshlet arrays, the push constants select the mesh
+	VkDescriptorSetLayoutBinding storageLayoutBinding{};
+	storageLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	storageLayoutBinding.descriptorCount = 1;
+	storageLayoutBinding.stageFlags = VK_SHADER_STAGE_MESH_BIT_EXT;
+	storageLayoutBinding.pImmutableSamplers = nullptr;
+
+	std::vector<VkDescriptorSetLayoutBinding> bindings(4, storageLayoutBinding);
+	for (uint32_t i{ 0 }; i < bindings.size(); ++i)
+	{
+		bindings[i].binding = i;
+	}
+	m_pMeshletDescriptorSetLayout = std::make_unique<GP2_VkDescriptorSetLayout>(*m_pDevice, bindings);
+
+	VkPushConstantRange pushConstantRange{};
+	pushConstantRange.stageFlags = VK_SHADER_STAGE_MESH_BIT_EXT;
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = sizeof(MeshletDrawConstants);
+
+	m_pMeshletPipelineLayout = std::make_unique<GP2_VkPipelineLayout>(*m_pDevice,
+		std::vector<VkDescriptorSetLayout>{ *m_pDescriptorSetLayout, *m_pMeshletDescriptorSetLayout },
+		std::vector<VkPushConstantRange>{ pushConstantRange });
+	m_pMeshletPipeline = CreateGraphicsPipeline(*m_pMeshletPipelineLayout, config::MESH_SHADER_PATH, VK_SHADER_STAGE_MESH_BIT_EXT);
 }
 VkShaderModule HelloTriangleApplication::CreateShaderModule(const std::vector<char>& code)
 {
@@ -1123,20 +1430,6 @@ void HelloTriangleApplication::CreateCommandPool()
 		FindQueueFamilies(m_PhysicalDevice).GraphicsFamily.value(),
 		static_cast<uint32_t>(m_SwapChainImages.size()));
 }
-void HelloTriangleApplication::RecordCommandBuffers()
-{
-	// Check if there are a correct amount of command buffers
-	if (m_SwapChainImages.size() != m_pCommandBuffers->Get().size()) {
-		throw std::runtime_error("failed to record command buffers due to size difference!");
-	}
-
-	// Record command buffer for each possible image
-	for (int32_t i{}; i < m_SwapChainImages.size(); ++i)
-	{
-		vkResetCommandBuffer(m_pCommandBuffers->Get()[i], 0);
-		RecordCommandBuffer(m_pCommandBuffers->Get()[i], i);
-	}
-}
 void HelloTriangleApplication::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex)
 {
 	// Specifies usage of command buffer
@@ -1150,6 +1443,9 @@ void HelloTriangleApplication::RecordCommandBuffer(VkCommandBuffer commandBuffer
 		throw std::runtime_error("failed to begin recording command buffer!");
 	}
 
+	// Dispatches can't be recorded inside of a render pass, the draws wait on it with a barrier
+	if (m_pCullingPass) m_pCullingPass->CmdCull(commandBuffer, imageIndex, m_ViewProjection);
+
 		
 	// TODO: match clear values in RecordCommandBuffer to the attachments in render pass attachments
 	std::vector<VkClearValue> clearValues{};
@@ -1176,9 +1472,6 @@ void HelloTriangleApplication::RecordCommandBuffer(VkCommandBuffer commandBuffer
 	// Render pass
 	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 	{
-		// Bind graphics pipeline
-		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, *m_pGraphicsPipeline);
-
 		// TODO: DynamicState make a big automatic switch to check the dynamic states of the given pipeline and set those values
 		// SET DYNAMIC STATES !!!!! this will depend on what was chosen as dynamic state
 		{
@@ -1197,8 +1490,46 @@ void HelloTriangleApplication::RecordCommandBuffer(VkCommandBuffer commandBuffer
 			vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 		}
 
-		// Render mesh
-		m_pVehicle->Render(commandBuffer, *m_pPipelineLayout, m_pDescriptorSets->Get()[imageIndex], *m_pTextureSampler, m_MappedModelBuffers[imageIndex]);
+		// The viewport & scissor are dynamic in every pipeline, so they survive the pipeline bind
+		if (m_pIndirectPipeline) {
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, *m_pIndirectPipeline);
+			m_pGeometryPool->CmdBind(commandBuffer);
+
+			// Set 0 for the camera & textures, set 1 for the objects the draws index with their first instance
+			VkDescriptorSet descriptorSets[]{ m_pDescriptorSets->Get()[imageIndex], m_pCullingPass->GetObjectSet() };
+			m_pVehicle->UpdateDescriptorSets(descriptorSets[0], *m_pTextureSampler);
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, *m_pIndirectPipelineLayout, 0, 2, descriptorSets, 0, nullptr);
+			m_pCullingPass->CmdDraw(commandBuffer, imageIndex);
+		}
+		else if (m_pInstancedPipeline) {
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, *m_pInstancedPipeline);
+
+			// Binding 0 holds the vertices of the pool, binding 1 this image's slice of the instances
+			m_pGeometryPool->CmdBind(commandBuffer);
+			m_pInstanceBuffer->CmdBind(commandBuffer, imageIndex);
+			m_pVehicle->RenderInstanced(commandBuffer, *m_pPipelineLayout, m_pDescriptorSets->Get()[imageIndex], *m_pTextureSampler, m_pInstanceBuffer->GetCapacity());
+		}
+		else if (IsObjectVisible(m_VehicleBoundsIndex) == false) {
+			// Outside of the frustum, nothing to draw
+		}
+		else if (m_pMeshletPipeline && m_pVehicle->UsesMeshlets()) {
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, *m_pMeshletPipeline);
+			m_pVehicle->RenderMeshlets(commandBuffer, *m_pMeshletPipelineLayout, m_pDescriptorSets->Get()[imageIndex], m_pMeshletDescriptorSets->Get()[0],
+				*m_pTextureSampler, m_ViewProjection, m_pfnCmdDrawMeshTasks);
+		}
+		else {
+			// Bind graphics pipeline
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, *m_pGraphicsPipeline);
+
+			// Shared by every mesh, only needs to be bound once
+			m_pGeometryPool->CmdBind(commandBuffer);
+
+			// Render mesh, from this image's slice of the culled indices if the meshlets were culled
+			VkBuffer culledIndexBuffer = m_pCulledIndexBuffer ? static_cast<VkBuffer>(*m_pCulledIndexBuffer) : VK_NULL_HANDLE;
+			VkDeviceSize culledIndexOffset = sizeof(uint32_t) * m_pVehicle->GetMeshlets().Triangles.size() * imageIndex;
+			m_pVehicle->Render(commandBuffer, *m_pPipelineLayout, m_pDescriptorSets->Get()[imageIndex], *m_pTextureSampler, m_ViewProjection,
+				culledIndexBuffer, culledIndexOffset);
+		}
 
 	}
 	vkCmdEndRenderPass(commandBuffer);
@@ -1213,7 +1544,7 @@ std::unique_ptr<PoolCommandBuffers> HelloTriangleApplication::BeginSingleTimeCom
 	// Temporary command buffer
 	auto pCommandBuffer = std::make_unique<PoolCommandBuffers>(
 		*m_pDevice,
-		FindQueueFamilies(m_PhysicalDevice).GraphicsFamily.value(), // TODO: use a transfer family queue
+		FindQueueFamilies(m_PhysicalDevice).GraphicsFamily.value(), // Uploads go through the UploadService on the transfer queue
 		1
 	);
 
@@ -1244,53 +1575,9 @@ void HelloTriangleApplication::EndSingleTimeCommands(std::unique_ptr<PoolCommand
 
 void HelloTriangleApplication::LoadModel(const char* filePath)
 {
-	tinyobj::attrib_t attrib{};
-	std::vector<tinyobj::shape_t> shapes{};
-	std::vector<tinyobj::material_t> materials{};
-	std::string warn{}, err{};
-
-	// Load in the data (will triangulate by default)
-	if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filePath)) {
-		throw std::runtime_error(warn + err);
-	}
-
-	// TODO: LoadModel make temporary glm::vec vectors for attrib.vertices and attrib.texcoords
-	uint32_t oldAmountOfVertices{ 0 };
-	std::unordered_map<Vertex3D, uint32_t> uniqueVertices{};
-
-	// Loop over all the OBJ shapes
-	for (const tinyobj::shape_t& shape : shapes)
-	{
-		std::cout << "\tindices: " << shape.mesh.indices.size() << std::endl;
-		std::cout << "\tnum_face_vertices: " << shape.mesh.num_face_vertices.size() << std::endl;
-		// TODO: LoadModel OBJ keep num_face_vertices in account when looping over faces
-		// Loop over all the faces
-		for (const tinyobj::index_t& index : shape.mesh.indices)
-		{
-			// Retrieve vertex data
-			Vertex3D vertex{};
-			vertex.pos = {
-				attrib.vertices[3 * index.vertex_index + 0],
-				attrib.vertices[3 * index.vertex_index + 1],
-				attrib.vertices[3 * index.vertex_index + 2]
-			};
-			vertex.texCoord = {
-				attrib.texcoords[2 * index.texcoord_index + 0],
-				1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-			};
-			vertex.color = { 1.0f, 1.0f, 1.0f };
-
-			// Add vertex with index if it doesn't exist yet
-			if (uniqueVertices.count(vertex) == 0) {
-				uniqueVertices[vertex] = static_cast<uint32_t>(m_ModelVertices.size());
-				m_ModelVertices.push_back(vertex);
-			}
-
-			// Add index data to the list
-			m_ModelIndices.push_back(uniqueVertices[vertex]);
-			++oldAmountOfVertices;
-		}
-	}
+	// Load in the data (faces are triangulated) & deduplicate the vertices
+	Mesh::LoadModel(filePath, m_ModelVertices, m_ModelIndices);
+	size_t oldAmountOfVertices{ m_ModelIndices.size() };
 
 	std::cout << "\tOld amount: " << oldAmountOfVertices << std::endl;
 	std::cout << "\tVertices amount: " << m_ModelVertices.size() << std::endl;
@@ -1301,103 +1588,102 @@ void HelloTriangleApplication::LoadModel(const char* filePath)
 }
 void HelloTriangleApplication::LoadVehicleModel()
 {
-	std::vector<Texture> meshTextures{ };
-	meshTextures.reserve(4);
-	meshTextures.push_back(CreateTextureImage("Resources/Textures/vehicle_diffuse.png", STBI_rgb_alpha));
-	meshTextures.push_back(CreateTextureImage("Resources/Textures/vehicle_normal.png", STBI_rgb_alpha));
-	meshTextures.push_back(CreateTextureImage("Resources/Textures/vehicle_specular.png", STBI_rgb_alpha));
-	meshTextures.push_back(CreateTextureImage("Resources/Textures/vehicle_gloss.png", STBI_rgb_alpha));
+	// Packing puts the specular luminance & the gloss into one RG texture, the shader is specialized to match
+	std::vector<TextureDescription> descriptions{
+		{ "Resources/Textures/vehicle_diffuse.png", TextureSemantic::Color },
+		{ "Resources/Textures/vehicle_normal.png", TextureSemantic::Normal } };
+	if (config::PACK_SPECULAR_GLOSS) {
+		descriptions.push_back({ "Resources/Textures/vehicle_specular.png", TextureSemantic::Mask, "Resources/Textures/vehicle_gloss.png" });
+	}
+	else {
+		descriptions.push_back({ "Resources/Textures/vehicle_specular.png", TextureSemantic::Color });
+		descriptions.push_back({ "Resources/Textures/vehicle_gloss.png", TextureSemantic::Mask });
+	}
+	std::vector<Texture> meshTextures = CreateTextureImages(descriptions);
 
 	m_pVehicle = std::make_unique<Mesh>(
-		*m_pDevice, m_PhysicalDevice,
-		std::make_unique<GP2_SingleTimeCommand>(*m_pDevice, FindQueueFamilies(m_PhysicalDevice).GraphicsFamily.value(), m_GraphicsQueue),
+		*m_pDevice, *m_pGeometryPool, m_Transforms, *m_pUploadService,
 		"Resources/Models/vehicle.obj",
 		std::move(meshTextures));
 }
+bool HelloTriangleApplication::CompactGeometryPool()
+{
+	// Frames in flight might still draw from the old buffers, they're destroyed once the copies are done
+	vkDeviceWaitIdle(*m_pDevice);
+	auto pCommandBuffer = std::make_unique<GP2_SingleTimeCommand>(*m_pDevice, FindQueueFamilies(m_PhysicalDevice).GraphicsFamily.value(), m_GraphicsQueue);
+	if (m_pGeometryPool->Compact(*m_pUploadService, std::move(pCommandBuffer)) == false) return false;
+
+	// The command buffers are recorded every frame, so only the descriptor set & the objects still point at the old ranges
+	if (m_pMeshletDescriptorSets) m_pVehicle->UpdateMeshletDescriptorSet(m_pMeshletDescriptorSets->Get()[0]);
+	if (m_pCullingPass && m_pCullingPass->GetObjectCount() > 0) {
+		m_pCullingPass->Upload(*m_pUploadService, CreateObjectGrid());
+		m_pUploadService->Wait(m_pUploadService->Submit());
+	}
+	return true;
+}
 
-void HelloTriangleApplication::CreateImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, GP2_VkImage& image, GP2_VkDeviceMemory& imageMemory)
+void HelloTriangleApplication::CreateImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, GP2_VkImage& image, MemoryAllocation& imageMemory, uint32_t mipLevels)
 {
 	// Create image resource
-	image = std::move(GP2_VkImage{ *m_pDevice, format, { width, height, 1 } , tiling, usage, false });
-
-	// Create image memory requirements
-	VkMemoryRequirements memRequirements;
-	vkGetImageMemoryRequirements(*m_pDevice, image, &memRequirements);
+	image = std::move(GP2_VkImage{ *m_pDevice, format, { width, height, 1 } , tiling, usage, false, mipLevels });
 
-	// Allocate image memory resource
-	imageMemory = std::move(GP2_VkDeviceMemory{ *m_pDevice, memRequirements.size, FindMemoryType(memRequirements.memoryTypeBits, properties) });
-
-	// Associate memory with image
-	vkBindImageMemory(*m_pDevice, image, imageMemory, 0);
+	// Sub-allocate image memory & associate it with the image
+	imageMemory = m_pAllocator->AllocateAndBind(image, properties, tiling);
 }
-void HelloTriangleApplication::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, GP2_VkBuffer& buffer, GP2_VkDeviceMemory& bufferMemory)
+void HelloTriangleApplication::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, GP2_VkBuffer& buffer, MemoryAllocation& bufferMemory)
 {
 	// Create buffer resource
 	buffer = std::move(GP2_VkBuffer{ *m_pDevice, size, usage, false });
 
-	// Get buffer memory requirements
-	VkMemoryRequirements memRequirements{};
-	vkGetBufferMemoryRequirements(*m_pDevice, buffer, &memRequirements);
-
-	// Allocate buffer memory resource
-	bufferMemory = std::move(GP2_VkDeviceMemory{ *m_pDevice, memRequirements.size, FindMemoryType(memRequirements.memoryTypeBits, properties) });
-
-	// Associate memory with buffer
-	vkBindBufferMemory(*m_pDevice, buffer, bufferMemory, 0);
-
+	// Sub-allocate buffer memory & associate it with the buffer
+	bufferMemory = m_pAllocator->AllocateAndBind(buffer, properties);
 }
-void HelloTriangleApplication::CreateUniformBuffers()
+void HelloTriangleApplication::CreateCameraUniformBuffers()
 {
-	VkDeviceSize bufferSize{ sizeof(UniformBufferObject) };
+	VkDeviceSize cameraSize{ sizeof(CameraViewProj) };
 	size_t bufferCount{ m_SwapChainImages.size() };
 
-	m_pUniformBuffer = std::make_unique<GP2_VkBuffer>();
-	m_pUniformBufferMemory = std::make_unique<GP2_VkDeviceMemory>();
-	m_MappedUniformBuffers.resize(bufferCount);
+	m_pCameraBuffer = std::make_unique<GP2_VkBuffer>();
+	m_pCameraBufferMemory = std::make_unique<MemoryAllocation>();
+	m_MappedCameraBuffers.resize(bufferCount);
 
 	CreateBuffer(
-		bufferSize * bufferCount,
+		cameraSize * bufferCount,
 		VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
 		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		*m_pUniformBuffer,
-		*m_pUniformBufferMemory);
-
-	void* data{};
-	vkMapMemory(*m_pDevice, *m_pUniformBufferMemory, 0, bufferSize * bufferCount, 0, &data);
+		*m_pCameraBuffer,
+		*m_pCameraBufferMemory);
 
-	char* byteData = static_cast<char*>(data);
+	// Host visible memory is persistently mapped by the allocator
+	char* byteData = static_cast<char*>(m_pCameraBufferMemory->GetMappedData());
 	for (size_t i{ 0 }; i < bufferCount; ++i)
 	{
-		m_MappedUniformBuffers[i] = (byteData + bufferSize * i);
+		m_MappedCameraBuffers[i] = (byteData + cameraSize * i);
 	}
 }
-void HelloTriangleApplication::CreateCameraAndModelUniformBuffers()
+void HelloTriangleApplication::CreateCulledIndexBuffers()
 {
-	VkDeviceSize cameraSize{ sizeof(CameraViewProj) };
-	VkDeviceSize modelSize{ sizeof(ModelTrans) };
+	// Every slice can hold all the full detail indices, in case every meshlet is visible
+	size_t sliceIndexCount{ m_pVehicle->GetMeshlets().Triangles.size() };
 	size_t bufferCount{ m_SwapChainImages.size() };
+	if (sliceIndexCount == 0) return;
 
-	m_pCameraModelBuffer = std::make_unique<GP2_VkBuffer>();
-	m_pCameraModelBufferMemory = std::make_unique<GP2_VkDeviceMemory>();
-	m_MappedCameraBuffers.resize(bufferCount);
-	m_MappedModelBuffers.resize(bufferCount);
+	m_pCulledIndexBuffer = std::make_unique<GP2_VkBuffer>();
+	m_pCulledIndexBufferMemory = std::make_unique<MemoryAllocation>();
+	m_MappedCulledIndices.resize(bufferCount);
 
 	CreateBuffer(
-		(cameraSize + modelSize) * bufferCount,
-		VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+		sizeof(uint32_t) * sliceIndexCount * bufferCount,
+		VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
 		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		*m_pCameraModelBuffer,
-		*m_pCameraModelBufferMemory);
-
-	void* data{};
-	vkMapMemory(*m_pDevice, *m_pCameraModelBufferMemory, 0, (cameraSize + modelSize) * bufferCount, 0, &data);
+		*m_pCulledIndexBuffer,
+		*m_pCulledIndexBufferMemory);
 
-	char* byteData = static_cast<char*>(data);
+	// Host visible memory is persistently mapped by the allocator
+	uint32_t* indexData = static_cast<uint32_t*>(m_pCulledIndexBufferMemory->GetMappedData());
 	for (size_t i{ 0 }; i < bufferCount; ++i)
 	{
-		size_t offset{ (cameraSize + modelSize) * i };
-		m_MappedCameraBuffers[i] = (byteData + offset);
-		m_MappedModelBuffers[i] = (byteData + offset + cameraSize);
+		m_MappedCulledIndices[i] = indexData + sliceIndexCount * i;
 	}
 }
 void HelloTriangleApplication::CreateDepthResources()
@@ -1407,7 +1693,7 @@ void HelloTriangleApplication::CreateDepthResources()
 
 	// Create image
 	m_pDepthImage = std::make_unique<GP2_VkImage>();
-	m_pDepthImageMemory = std::make_unique<GP2_VkDeviceMemory>();
+	m_pDepthImageMemory = std::make_unique<MemoryAllocation>();
 	CreateImage(
 		m_SwapChainExtent.width, // Should have the same resolution as the color attachment
 		m_SwapChainExtent.height, // Should have the same resolution as the color attachment
@@ -1424,58 +1710,230 @@ void HelloTriangleApplication::CreateDepthResources()
 	// Completely optional as the render pass will take care of this transition
 	TransitionImageLayout(*m_pDepthImage, depthFormat, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
 }
-void HelloTriangleApplication::CreateTextureImage(const char* filePath, int nrChannels, std::unique_ptr<Texture>& pTexture)
+void HelloTriangleApplication::CreateTextureImage(const char* filePath, TextureSemantic semantic, std::unique_ptr<Texture>& pTexture)
 {
 	pTexture = std::make_unique<Texture>();
-	CreateTextureImage(filePath, nrChannels, *pTexture);
+	CreateTextureImage(filePath, semantic, *pTexture);
+}
+void HelloTriangleApplication::CreateTextureImage(const char* filePath, TextureSemantic semantic, Texture& texture)
+{
+	texture = std::move(CreateTextureImages({ TextureDescription{ filePath, semantic } }).front());
+}
+Texture HelloTriangleApplication::CreateTextureImage(const char* filePath, TextureSemantic semantic)
+{
+	Texture tempText{};
+	CreateTextureImage(filePath, semantic, tempText);
+	return std::move(tempText);
+}
+std::vector<Texture> HelloTriangleApplication::CreateTextureImages(const std::vector<TextureDescription>& descriptions)
+{
+	if (m_UseBlockCompression) return CreateCompressedTextureImages(descriptions);
+
+	std::vector<Texture> textures(descriptions.size());
+	std::vector<ImageUpload> uploads(descriptions.size());
+	std::vector<uint32_t> mipLevels(descriptions.size(), 1);
+	std::vector<VkFormat> formats(descriptions.size());
+	std::vector<AssetData> files = ReadTextureFiles(descriptions, std::vector<bool>(descriptions.size(), true));
+
+	for (size_t i{ 0 }; i < descriptions.size(); ++i)
+	{
+		formats[i] = textures::GetFormat(descriptions[i], false);
+		const uint32_t channelCount{ textures::GetChannelCount(formats[i]) };
+		const bool canBlitMipmaps{ config::FORCE_CPU_MIPMAPS == false && CanBlitMipmaps(formats[i]) };
+
+		// Decode the image that was read, the encoded file isn't needed afterwards
+		uint32_t width{}, height{};
+		std::vector<uint8_t> pixels = LoadTexturePixels(descriptions[i], files[i * 2], files[i * 2 + 1], width, height);
+		files[i * 2] = AssetData{};
+		files[i * 2 + 1] = AssetData{};
+
+		// Create image, the mip levels are blitted from the first one if possible
+		if (config::GENERATE_MIPMAPS) mipLevels[i] = mips::CalculateMipLevels(width, height);
+		CreateImage(
+			width,
+			height,
+			formats[i],
+			VK_IMAGE_TILING_OPTIMAL,
+			VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | (canBlitMipmaps ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0),
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			textures[i].Image,
+			textures[i].ImageMemory,
+			mipLevels[i]);
+
+		// Otherwise every level is filtered on the CPU, the RGBA8 levels are narrowed to the channels of the format afterwards
+		uploads[i] = ImageUpload{ textures[i].Image, { width, height, 1 }, nullptr, 0, mipLevels[i] };
+		if (mipLevels[i] > 1 && canBlitMipmaps == false) {
+			MipChain mipChain = mips::GenerateMipChain(pixels.data(), width, height, descriptions[i].Semantic == TextureSemantic::Color);
+			pixels = std::move(mipChain.Pixels);
+			uploads[i].MipOffsets.clear();
+			for (size_t offset : mipChain.Offsets) uploads[i].MipOffsets.push_back(offset / 4 * channelCount);
+		}
+
+		// Narrowed straight into the staging memory, so only one image is decoded on the heap at a time
+		const size_t pixelCount{ pixels.size() / 4 };
+		uploads[i].Staging = m_pUploadService->AllocateStaging(pixelCount * channelCount);
+		uploads[i].Size = uploads[i].Staging.Size;
+		textures::NarrowChannels(pixels.data(), pixelCount, channelCount, static_cast<uint8_t*>(uploads[i].Staging.pData));
+	}
+
+	// All layout transitions & copies end up in the same command buffer
+	m_pUploadService->UploadImages(uploads);
+
+	// Create image views
+	for (size_t i{ 0 }; i < descriptions.size(); ++i)
+	{
+		textures[i].ImageView = std::move(GP2_VkImageView{ *m_pDevice, textures[i].Image, formats[i], VK_IMAGE_ASPECT_COLOR_BIT, mipLevels[i] });
+	}
+
+	return textures;
 }
-void HelloTriangleApplication::CreateTextureImage(const char* filePath, int nrChannels, Texture& texture)
+std::vector<Texture> HelloTriangleApplication::CreateCompressedTextureImages(const std::vector<TextureDescription>& descriptions)
 {
-	// Load image from the given file path
-	int texWidth, texHeight, texChannels;
-	stbi_uc* pixels = stbi_load(filePath, &texWidth, &texHeight, &texChannels, nrChannels);
-	if (!pixels) {
-		throw std::runtime_error("failed to load texture image!");
+	std::vector<Texture> textures(descriptions.size());
+	std::vector<TextureCache> caches{};
+	std::vector<std::vector<uint8_t>> cookedLevels(descriptions.size()); // Only for textures that missed their cache
+	std::vector<ImageUpload> uploads(descriptions.size());
+	std::vector<VkFormat> formats(descriptions.size());
+	const BlockCompressor compressor{};
+
+	// Warm loads upload the cached levels as they are, the mip chain has to match the current settings
+	std::vector<bool> isCached(descriptions.size());
+	caches.reserve(descriptions.size());
+	for (size_t i{ 0 }; i < descriptions.size(); ++i)
+	{
+		formats[i] = textures::GetFormat(descriptions[i], true);
+		TextureCache& cache = caches.emplace_back(descriptions[i].FilePath, descriptions[i].PackedFilePath);
+		isCached[i] = cache.Open(formats[i]) && cache.GetLevelCount() == (config::GENERATE_MIPMAPS ? mips::CalculateMipLevels(cache.GetWidth(), cache.GetHeight()) : 1);
 	}
 
-	// Calculate amount of pixels (bytes)
-	VkDeviceSize imageSize = texWidth * texHeight * nrChannels;
+	// Only the sources of the textures that missed their cache are read, all in one batch
+	std::vector<bool> isRead(descriptions.size());
+	for (size_t i{ 0 }; i < descriptions.size(); ++i) isRead[i] = isCached[i] == false;
+	std::vector<AssetData> files = ReadTextureFiles(descriptions, isRead);
 
-	// Create staging buffer with assigned data
-	GP2_VkBuffer stagingBuffer{};
-	GP2_VkDeviceMemory stagingBufferMemory{};
-	CreateStagingBuffer(stagingBuffer, stagingBufferMemory,
-		{ imageSize },
-		{ pixels });
+	// Cached levels are imported, or read from disk straight into the staging memory while the misses are encoded
+	AsyncFileReader reader{};
+	reader.RegisterBuffer(m_pUploadService->GetStagingMemory(), static_cast<size_t>(m_pUploadService->GetStagingSize()));
 
-	// Create image
-	CreateImage(
-		texWidth,
-		texHeight,
-		VK_FORMAT_R8G8B8A8_SRGB,
-		VK_IMAGE_TILING_OPTIMAL,
-		VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-		texture.Image,
-		texture.ImageMemory);
+	for (size_t i{ 0 }; i < descriptions.size(); ++i)
+	{
+		TextureCache& cache = caches[i];
+		if (isCached[i]) {
+			uploads[i] = ImageUpload{ VK_NULL_HANDLE, { cache.GetWidth(), cache.GetHeight(), 1 }, nullptr, cache.GetLevelsSize(), cache.GetLevelCount() };
+			uploads[i].MipOffsets = cache.GetLevelOffsets();
+			uploads[i].Staging = cache.ImportLevels(*m_pUploadService);
+			if (uploads[i].Staging.Buffer == VK_NULL_HANDLE) {
+				uploads[i].Staging = m_pUploadService->AllocateStaging(cache.GetLevelsSize());
+				cache.ReadLevels(reader, static_cast<char*>(uploads[i].Staging.pData));
+				reader.Submit();
+			}
+		}
+		else {
+			// Cold loads filter the mip chain on the CPU & encode every level into one blob, which is written to the cache & uploaded
+			uint32_t width{}, height{};
+			std::vector<uint8_t> pixels = LoadTexturePixels(descriptions[i], files[i * 2], files[i * 2 + 1], width, height);
+
+			const uint32_t levelCount{ config::GENERATE_MIPMAPS ? mips::CalculateMipLevels(width, height) : 1 };
+			const BlockFormat blockFormat{ formats[i] == VK_FORMAT_BC4_UNORM_BLOCK ? BlockFormat::BC4 : formats[i] == VK_FORMAT_BC5_UNORM_BLOCK ? BlockFormat::BC5 : BlockFormat::BC7 };
+			MipChain mipChain{};
+			if (levelCount > 1) mipChain = mips::GenerateMipChain(pixels.data(), width, height, descriptions[i].Semantic == TextureSemantic::Color);
+
+			// Block sizes keep every level aligned
+			uploads[i] = ImageUpload{ VK_NULL_HANDLE, { width, height, 1 }, nullptr, 0, levelCount };
+			uploads[i].MipOffsets.clear();
+			for (uint32_t level{ 0 }; level < levelCount; ++level)
+			{
+				uploads[i].MipOffsets.push_back(uploads[i].Size);
+				uploads[i].Size += BlockCompressor::GetCompressedSize(std::max(width >> level, 1u), std::max(height >> level, 1u), blockFormat);
+			}
+			cookedLevels[i].resize(static_cast<size_t>(uploads[i].Size));
+			for (uint32_t level{ 0 }; level < levelCount; ++level)
+			{
+				const uint8_t* pLevel = level == 0 ? pixels.data() : mipChain.Pixels.data() + mipChain.Offsets[level];
+				compressor.CompressInto(pLevel, std::max(width >> level, 1u), std::max(height >> level, 1u), blockFormat, cookedLevels[i].data() + uploads[i].MipOffsets[level]);
+			}
+			cache.Write(formats[i], width, height, cookedLevels[i].data(), uploads[i].MipOffsets);
+			uploads[i].pData = cookedLevels[i].data();
+		}
 
-	// Transfer staging buffer to texture image
-	// TODO: combine operations in a single command buffer instead of waiting for queue to become idle every time
-	TransitionImageLayout(texture.Image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-	CopyBufferToImage(stagingBuffer, texture.Image, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight));
-	TransitionImageLayout(texture.Image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		// Every level is uploaded, nothing is blitted
+		CreateImage(
+			uploads[i].Extent.width,
+			uploads[i].Extent.height,
+			formats[i],
+			VK_IMAGE_TILING_OPTIMAL,
+			VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			textures[i].Image,
+			textures[i].ImageMemory,
+			uploads[i].MipLevels);
+		uploads[i].Image = textures[i].Image;
+	}
 
-	// Create image view
-	texture.ImageView = std::move(GP2_VkImageView{ *m_pDevice, texture.Image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT });
+	// The cooked levels are copied into the staging ring, the cached ones have to be read by then
+	reader.Wait();
+	m_pUploadService->UploadImages(uploads);
+
+	for (size_t i{ 0 }; i < descriptions.size(); ++i)
+	{
+		textures[i].ImageView = std::move(GP2_VkImageView{ *m_pDevice, textures[i].Image, formats[i], VK_IMAGE_ASPECT_COLOR_BIT, uploads[i].MipLevels });
+	}
 
-	// Release resources
-	stbi_image_free(pixels);
+	return textures;
 }
-Texture HelloTriangleApplication::CreateTextureImage(const char* filePath, int nrChannels)
+std::vector<AssetData> HelloTriangleApplication::ReadTextureFiles(const std::vector<TextureDescription>& descriptions, const std::vector<bool>& isRead) const
 {
-	Texture tempText{};
-	CreateTextureImage(filePath, nrChannels, tempText);
-	return std::move(tempText);
+	std::vector<std::string> filePaths{};
+	std::vector<size_t> fileIndices{};
+	for (size_t i{ 0 }; i < descriptions.size(); ++i)
+	{
+		if (isRead[i] == false) continue;
+		filePaths.push_back(descriptions[i].FilePath);
+		fileIndices.push_back(i * 2);
+		if (descriptions[i].PackedFilePath) {
+			filePaths.push_back(descriptions[i].PackedFilePath);
+			fileIndices.push_back(i * 2 + 1);
+		}
+	}
+
+	std::vector<AssetData> readFiles = vfs::ReadAll(filePaths);
+	std::vector<AssetData> files(descriptions.size() * 2);
+	for (size_t i{ 0 }; i < readFiles.size(); ++i)
+	{
+		files[fileIndices[i]] = std::move(readFiles[i]);
+	}
+	return files;
+}
+std::vector<uint8_t> HelloTriangleApplication::LoadTexturePixels(const TextureDescription& description, const AssetData& file, const AssetData& packedFile, uint32_t& width, uint32_t& height) const
+{
+	// Everything is loaded as RGBA8, the mip filter & the block compressor work on 4 channels
+	auto loadPixels = [](const AssetData& file, uint32_t& width, uint32_t& height)
+		{
+			int texWidth, texHeight, texChannels;
+			stbi_uc* pLoaded = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file.GetData()), static_cast<int>(file.GetSize()), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+			if (!pLoaded) {
+				throw std::runtime_error("failed to load texture image!");
+			}
+			width = static_cast<uint32_t>(texWidth);
+			height = static_cast<uint32_t>(texHeight);
+			std::vector<uint8_t> pixels(pLoaded, pLoaded + static_cast<size_t>(width) * height * 4);
+			stbi_image_free(pLoaded);
+			return pixels;
+		};
+
+	std::vector<uint8_t> pixels = loadPixels(file, width, height);
+	if (description.Semantic == TextureSemantic::Mask) {
+		std::vector<uint8_t> packedPixels{};
+		if (description.PackedFilePath) {
+			uint32_t packedWidth{}, packedHeight{};
+			packedPixels = loadPixels(packedFile, packedWidth, packedHeight);
+			if (packedWidth != width || packedHeight != height) {
+				throw std::runtime_error("failed to pack textures of different sizes!");
+			}
+		}
+		textures::ConvertToMask(pixels.data(), packedPixels.empty() ? nullptr : packedPixels.data(), static_cast<size_t>(width) * height);
+	}
+	return pixels;
 }
 void HelloTriangleApplication::CreateTextureSampler()
 {
@@ -1484,7 +1942,8 @@ void HelloTriangleApplication::CreateTextureSampler()
 	vkGetPhysicalDeviceProperties(m_PhysicalDevice, &properties);
 
 	// Create sampler resource
-	m_pTextureSampler = std::make_unique<GP2_VkSampler>(*m_pDevice, VK_SAMPLER_ADDRESS_MODE_REPEAT, properties.limits.maxSamplerAnisotropy);
+	m_pTextureSampler = std::make_unique<GP2_VkSampler>(*m_pDevice, VK_SAMPLER_ADDRESS_MODE_REPEAT, properties.limits.maxSamplerAnisotropy,
+		false, config::GENERATE_MIPMAPS ? VK_LOD_CLAMP_NONE : 0.0f);
 }
 void HelloTriangleApplication::TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout)
 {
@@ -1569,100 +2028,182 @@ void HelloTriangleApplication::TransitionImageLayout(VkImage image, VkFormat for
 	// End recording & execute commands
 	EndSingleTimeCommands(std::move(pCommandBuffer));
 }
-VkDeviceSize HelloTriangleApplication::CreateStagingBuffer(GP2_VkBuffer& stagingBuffer, GP2_VkDeviceMemory& stagingBufferMemory, const std::vector<VkDeviceSize>& sizes, const std::vector<const void*>& datas)
+void HelloTriangleApplication::PrintMemoryStats() const
 {
-	// Exit early in case of wrong input values
-	if (sizes.size() != datas.size() || sizes.empty()) return 0;
-
-	// Calculate total buffer size
-	VkDeviceSize bufferSize = std::accumulate(sizes.begin(), sizes.end(), static_cast<VkDeviceSize>(0));
-
-	// Create staging buffer
-	CreateBuffer(
-		bufferSize,
-		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		stagingBuffer,
-		stagingBufferMemory);
-
-	// Copy datas to staging buffer
-	void* dstData{};
-	VkDeviceSize offset{ 0 };
-	for (size_t i{ 0 }; i < datas.size(); ++i)
+	MemoryAllocatorStats stats = m_pAllocator->GetStats();
+
+	std::cout << "device memory:\n";
+	std::cout << "\tBlocks: " << stats.BlockCount << " (" << stats.DedicatedBlockCount << " dedicated)\n";
+	std::cout << "\tAllocations: " << stats.AllocationCount << '\n';
+	std::cout << "\tReserved: " << stats.ReservedSize << '\n';
+	std::cout << "\tUsed: " << stats.UsedSize << '\n';
+	std::cout << "\tWasted: " << stats.WastedSize << '\n';
+	std::cout << "\tFree: " << stats.FreeSize << " (largest range " << stats.LargestFreeRange << ")\n";
+	std::cout << "\tFragmentation: " << stats.Fragmentation << "\n\n";
+}
+std::vector<ObjectData> HelloTriangleApplication::CreateObjectGrid() const
+{
+	const MeshBounds& bounds = m_pVehicle->GetBounds();
+	float spacing = glm::length(bounds.max - bounds.min) * config::INSTANCE_SPACING;
+	std::vector<InstanceData> instances(config::INSTANCE_COUNT);
+	InstanceBuffer::WriteGrid(instances.data(), config::INSTANCE_COUNT, m_pVehicle->GetTransform(), spacing);
+
+	// The level of detail is picked once for the startup camera, coarsest first so every copy is selected from scratch
+	CameraViewProj camera{ CalculateCamera() };
+	float projectionScale = m_SwapChainExtent.height * 0.5f * std::abs(camera.proj[1][1]);
+	const uint32_t coarsestLod{ static_cast<uint32_t>(std::max<size_t>(m_pVehicle->GetLods().size(), 1)) - 1 };
+
+	std::vector<ObjectData> objects{};
+	objects.reserve(instances.size());
+	for (const InstanceData& instance : instances)
 	{
-		vkMapMemory(*m_pDevice, stagingBufferMemory, offset, sizes[i], 0, &dstData);
-		memcpy(dstData, datas[i], sizes[i]);
-		vkUnmapMemory(*m_pDevice, stagingBufferMemory);
-
-		offset += sizes[i];
+		uint32_t lod = m_pVehicle->CalculateLod(camera.view * instance.model, projectionScale, coarsestLod);
+		objects.push_back(m_pVehicle->GetObjectData(instance.model, lod));
 	}
-
-	// Return the size of the staging buffer
-	return bufferSize;
+	return objects;
 }
-void HelloTriangleApplication::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
+void HelloTriangleApplication::ValidateGpuCulling(const std::vector<ObjectData>& objects)
 {
-	// Temporary command buffer
+	// Culls slice 0 for the startup camera & copies the draws back, nothing has been drawn with that slice yet
+	GP2_VkBuffer readBackBuffer{};
+	MemoryAllocation readBackMemory{};
+	CreateBuffer(m_pCullingPass->GetReadBackSize(), VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, readBackBuffer, readBackMemory);
+
+	CameraViewProj camera{ CalculateCamera() };
+	const glm::mat4& viewProjection{ camera.viewProj };
 	std::unique_ptr<PoolCommandBuffers> pCommandBuffer{ BeginSingleTimeCommands() };
+	m_pCullingPass->CmdCull(pCommandBuffer->Get()[0], 0, viewProjection);
+	m_pCullingPass->CmdReadBack(pCommandBuffer->Get()[0], 0, readBackBuffer);
+	EndSingleTimeCommands(std::move(pCommandBuffer));
 
-	// Copy buffer command
-	VkBufferCopy copyRegion{};
-	copyRegion.srcOffset = 0;
-	copyRegion.dstOffset = 0;
-	copyRegion.size = size;
-	vkCmdCopyBuffer(pCommandBuffer->Get()[0], srcBuffer, dstBuffer, 1, &copyRegion);
+	const uint8_t* pReadBack = static_cast<const uint8_t*>(readBackMemory.GetMappedData());
+	uint32_t drawCount{};
+	memcpy(&drawCount, pReadBack, sizeof(drawCount));
+	std::vector<VkDrawIndexedIndirectCommand> draws(m_pCullingPass->GetObjectCount());
+	memcpy(draws.data(), pReadBack + sizeof(uint32_t), sizeof(VkDrawIndexedIndirectCommand) * draws.size());
+
+	// Reference, the same sphere test on the CPU
+	// Spheres within rounding distance of a plane may go either way on the GPU, only those are allowed to differ
+	Frustum frustum{ viewProjection };
+	std::vector<uint32_t> expectedObjects{}, borderObjects{};
+	for (uint32_t i{ 0 }; i < objects.size(); ++i)
+	{
+		const glm::mat4& model = objects[i].model;
+		glm::vec3 center{ model * glm::vec4(glm::vec3(objects[i].boundingSphere), 1.f) };
+		float scale = std::max({ glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])) });
+		float radius = objects[i].boundingSphere.w * scale;
+		float tolerance = 1e-4f * std::max(1.f, glm::length(center) + radius);
+		if (frustum.IsSphereVisible(center, radius)) expectedObjects.push_back(i);
+		if (frustum.IsSphereVisible(center, radius + tolerance) != frustum.IsSphereVisible(center, radius - tolerance)) borderObjects.push_back(i);
+	}
 
-	// End recording & execute commands
-	EndSingleTimeCommands(std::move(pCommandBuffer));
+	// The atomic makes the order of the draws arbitrary, so they're compared as sets
+	bool isMatching{ drawCount <= draws.size() };
+	std::vector<uint32_t> drawnObjects{};
+	for (uint32_t i{ 0 }; isMatching && i < drawCount; ++i)
+	{
+		const VkDrawIndexedIndirectCommand& draw = draws[i];
+		isMatching = draw.firstInstance < objects.size() && draw.instanceCount == 1;
+		if (isMatching == false) break;
+
+		const ObjectData& object = objects[draw.firstInstance];
+		isMatching = draw.indexCount == object.indexCount && draw.firstIndex == object.firstIndex && draw.vertexOffset == object.vertexOffset;
+		drawnObjects.push_back(draw.firstInstance);
+	}
+	std::sort(drawnObjects.begin(), drawnObjects.end());
+	std::vector<uint32_t> differentObjects{};
+	std::set_symmetric_difference(drawnObjects.begin(), drawnObjects.end(), expectedObjects.begin(), expectedObjects.end(), std::back_inserter(differentObjects));
+	isMatching = isMatching && std::adjacent_find(drawnObjects.begin(), drawnObjects.end()) == drawnObjects.end()
+		&& std::includes(borderObjects.begin(), borderObjects.end(), differentObjects.begin(), differentObjects.end());
+
+	std::cout << "gpu culling:\n";
+	std::cout << '\t' << objects.size() << " objects, " << drawCount << " drawn by Cull.comp, " << expectedObjects.size() << " visible on the CPU"
+		<< ", " << differentObjects.size() << " of " << borderObjects.size() << " on a plane differ\n";
+	std::cout << (isMatching ? "\tMATCHING\n" : "\tMISMATCH\n") << '\n';
+	if (isMatching == false) {
+		throw std::runtime_error("failed to validate gpu culling, Cull.comp doesn't match the CPU reference!");
+	}
 }
-void HelloTriangleApplication::CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
+void HelloTriangleApplication::ValidateGeometryCompaction(GeometryPool::Handle hole)
 {
-	// Temporary command buffer
-	std::unique_ptr<PoolCommandBuffers> pCommandBuffer{ BeginSingleTimeCommands() };
+	const GeometryPool::Handle geometry{ m_pVehicle->GetGeometry() };
 
-	// Image copy info
-	VkBufferImageCopy region{};
-	region.bufferOffset = 0;
-	region.bufferRowLength = 0;
-	region.bufferImageHeight = 0;
-
-	// Indicate in which parts of the image we want to copy pixels
-	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	region.imageSubresource.mipLevel = 0;
-	region.imageSubresource.baseArrayLayer = 0;
-	region.imageSubresource.layerCount = 1;
-	region.imageOffset = { 0, 0, 0 };
-	region.imageExtent = { width, height, 1 };
-
-	// Copy buffer image command
-	vkCmdCopyBufferToImage(
-		pCommandBuffer->Get()[0],
-		buffer,
-		image,
-		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-		1,
-		&region
-	);
+	// Copies the vehicle's vertices & indices out of the pool, one after the other
+	auto readBack = [&](std::vector<uint8_t>& data)
+	{
+		const GeometryRange& range = m_pGeometryPool->GetRange(geometry);
+		const VkDeviceSize vertexSize{ static_cast<VkDeviceSize>(range.VertexCount) * sizeof(config::VertexType) };
+		const VkDeviceSize indexSize{ static_cast<VkDeviceSize>(range.IndexCount) * sizeof(uint32_t) };
+
+		GP2_VkBuffer readBackBuffer{};
+		MemoryAllocation readBackMemory{};
+		CreateBuffer(vertexSize + indexSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, readBackBuffer, readBackMemory);
+
+		VkBufferCopy vertexCopy{ static_cast<VkDeviceSize>(range.VertexOffset) * sizeof(config::VertexType), 0, vertexSize };
+		VkBufferCopy indexCopy{ static_cast<VkDeviceSize>(range.FirstIndex) * sizeof(uint32_t), vertexSize, indexSize };
+		std::unique_ptr<PoolCommandBuffers> pCommandBuffer{ BeginSingleTimeCommands() };
+		vkCmdCopyBuffer(pCommandBuffer->Get()[0], m_pGeometryPool->GetVertexBuffer(), readBackBuffer, 1, &vertexCopy);
+		vkCmdCopyBuffer(pCommandBuffer->Get()[0], m_pGeometryPool->GetIndexBuffer(), readBackBuffer, 1, &indexCopy);
+		EndSingleTimeCommands(std::move(pCommandBuffer));
+
+		const uint8_t* pReadBack = static_cast<const uint8_t*>(readBackMemory.GetMappedData());
+		data.assign(pReadBack, pReadBack + vertexSize + indexSize);
+	};
 
-	// End recording & execute commands
-	EndSingleTimeCommands(std::move(pCommandBuffer));
+	// Freeing the hole leaves a gap in front of the vehicle that the compaction has to close
+	m_pUploadService->Wait(m_pUploadService->Submit());
+	m_pGeometryPool->Free(hole);
+	const GeometryRange before{ m_pGeometryPool->GetRange(geometry) };
+	std::vector<uint8_t> dataBefore{}, dataAfter{};
+	readBack(dataBefore);
+
+	bool hasMoved = CompactGeometryPool();
+	const GeometryRange& after = m_pGeometryPool->GetRange(geometry);
+	readBack(dataAfter);
+
+	// The vehicle is the only geometry left, so it has to start both buffers with the same data
+	bool isMatching = hasMoved && after.VertexOffset == 0 && after.FirstIndex == 0 && dataBefore == dataAfter;
+
+	std::cout << "geometry compaction:\n";
+	std::cout << '\t' << before.VertexCount << " vertices & " << before.IndexCount << " indices moved from vertex " << before.VertexOffset << " & index " << before.FirstIndex
+		<< " to vertex " << after.VertexOffset << " & index " << after.FirstIndex << '\n';
+	std::cout << (isMatching ? "\tMATCHING\n" : "\tMISMATCH\n") << '\n';
 }
-uint32_t HelloTriangleApplication::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
+void HelloTriangleApplication::ValidateHostMemoryImport()
 {
-	// Available types of memory
-	VkPhysicalDeviceMemoryProperties memProperties{};
-	vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &memProperties);
+	// Starts past the first page & off the import alignment, so the rounding of the imported range is covered as well
+	const char* filePath{ "Resources/Models/vehicle.obj" };
+	constexpr uint64_t offset{ 4096 + 123 };
+	MappedFile file{ filePath };
+	std::cout << "host memory import:\n";
+	if (file.IsOpen() == false || file.GetSize() <= offset) {
+		std::cout << '\t' << filePath << " isn't a loose file, skipped\n\n";
+		return;
+	}
+	const VkDeviceSize size{ std::min<VkDeviceSize>(file.GetSize() - offset, 4 * 1024 * 1024) };
 
-	// Find a memory type that is suitable for the buffer
-	for (uint32_t i{ 0 }; i < memProperties.memoryTypeCount; ++i)
-	{
-		if ((typeFilter & (1 << i)) &&
-			(memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-			return i;
-		}
+	// Drivers may refuse file backed pages, the uploads then go through the staging ring
+	StagingRegion region{ m_pUploadService->ImportFile(filePath, offset, size) };
+	if (region.Buffer == VK_NULL_HANDLE) {
+		std::cout << "\tthe driver refused the import, uploads fall back to the staging ring\n\n";
+		return;
 	}
 
-	throw std::runtime_error("failed to find suitable memory type!");
+	// The same copy & queue family hand over the mesh & texture caches go through, read on the host afterwards
+	GP2_VkBuffer readBackBuffer{};
+	MemoryAllocation readBackMemory{};
+	CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, readBackBuffer, readBackMemory);
+	m_pUploadService->UploadBuffer(readBackBuffer, 0, region, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+	m_pUploadService->Wait(m_pUploadService->Submit());
+
+	bool isMatching = memcmp(readBackMemory.GetMappedData(), file.GetData() + offset, size) == 0;
+	std::cout << '\t' << size << " bytes of " << filePath << " from offset " << offset << " copied out of the imported mapping\n";
+	std::cout << (isMatching ? "\tMATCHING\n" : "\tMISMATCH\n") << '\n';
+	if (isMatching == false) {
+		throw std::runtime_error("failed to validate the host memory import, the copy doesn't match the file!");
+	}
 }
 VkFormat HelloTriangleApplication::FindDepthFormat()
 {
@@ -1700,6 +2241,14 @@ bool HelloTriangleApplication::HasStencilComponent(VkFormat format)
 		|| format == VK_FORMAT_D16_UNORM_S8_UINT
 		|| format ==  VK_FORMAT_S8_UINT;
 }
+bool HelloTriangleApplication::CanBlitMipmaps(VkFormat format) const
+{
+	VkFormatProperties props{};
+	vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, format, &props);
+
+	const VkFormatFeatureFlags features{ VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT };
+	return (props.optimalTilingFeatures & features) == features;
+}
 
 void HelloTriangleApplication::CreateDescriptorSets()
 {
@@ -1708,8 +2257,8 @@ void HelloTriangleApplication::CreateDescriptorSets()
 	// TODO: don't use magic numbers for DescriptorPoolSize but link it to DescriptorSetLayout
 	// Describes which descriptor type(s) are used and how many of each type
 	std::vector<VkDescriptorPoolSize> poolSizes{
-		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2 * descriptorSetCount },
-		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 * descriptorSetCount }
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, descriptorSetCount },
+		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, config::MATERIAL_TEXTURE_COUNT * descriptorSetCount }
 	};
 
 	// Create descriptor pool resource
@@ -1726,14 +2275,9 @@ void HelloTriangleApplication::UpdateDescriptorSets(const std::vector<Texture>&
 	{
 		// Descriptors that refer to buffers are configured with a VkDescriptorBufferInfo struct
 		VkDescriptorBufferInfo bufferInfoCam{};
-		bufferInfoCam.buffer = *m_pCameraModelBuffer;
+		bufferInfoCam.buffer = *m_pCameraBuffer;
 		bufferInfoCam.range = sizeof(CameraViewProj);
-		bufferInfoCam.offset = (sizeof(CameraViewProj) + sizeof(ModelTrans)) * i;
-
-		VkDescriptorBufferInfo bufferInfoModel{};
-		bufferInfoModel.buffer = *m_pCameraModelBuffer;
-		bufferInfoModel.range = sizeof(ModelTrans);
-		bufferInfoModel.offset = bufferInfoCam.offset + bufferInfoCam.range;
+		bufferInfoCam.offset = sizeof(CameraViewProj) * i;
 
 		// Image info
 		std::vector<VkDescriptorImageInfo> imageInfos{ textures.size() };
@@ -1745,7 +2289,7 @@ void HelloTriangleApplication::UpdateDescriptorSets(const std::vector<Texture>&
 		}
 
 		// The configuration of descriptors
-		std::vector<VkWriteDescriptorSet> descriptorWrites{ 2 };
+		std::vector<VkWriteDescriptorSet> descriptorWrites{ 1 };
 		descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 		descriptorWrites[0].dstSet = m_pDescriptorSets->Get()[i]; // Descriptor set to update
 		descriptorWrites[0].dstBinding = 0; // Binding index
@@ -1754,29 +2298,35 @@ void HelloTriangleApplication::UpdateDescriptorSets(const std::vector<Texture>&
 		descriptorWrites[0].descriptorCount = 1; // Should match the number of elements in either pImageInfo, pBufferInfo or pTexelBufferView
 		descriptorWrites[0].pBufferInfo = &bufferInfoCam;
 
-		descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptorWrites[1].dstSet = m_pDescriptorSets->Get()[i]; // Descriptor set to update
-		descriptorWrites[1].dstBinding = 2; // Binding index
-		descriptorWrites[1].dstArrayElement = 0; // Descriptors can be arrays, in which case this specifies start idx
-		descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		descriptorWrites[1].descriptorCount = 1; // Should match the number of elements in either pImageInfo, pBufferInfo or pTexelBufferView
-		descriptorWrites[1].pBufferInfo = &bufferInfoModel;
-
 		if (imageInfos.empty() == false) {
 			descriptorWrites.push_back({});
-			descriptorWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[2].dstSet = m_pDescriptorSets->Get()[i]; // Descriptor set to update
-			descriptorWrites[2].dstBinding = 1; // Binding index
-			descriptorWrites[2].dstArrayElement = 0; // Descriptors can be arrays, in which case this specifies start idx
-			descriptorWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-			descriptorWrites[2].descriptorCount = static_cast<uint32_t>(imageInfos.size()); // Should match the number of elements in either pImageInfo, pBufferInfo or pTexelBufferView
-			descriptorWrites[2].pImageInfo = imageInfos.data();
+			descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrites[1].dstSet = m_pDescriptorSets->Get()[i]; // Descriptor set to update
+			descriptorWrites[1].dstBinding = 1; // Binding index
+			descriptorWrites[1].dstArrayElement = 0; // Descriptors can be arrays, in which case this specifies start idx
+			descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			descriptorWrites[1].descriptorCount = static_cast<uint32_t>(imageInfos.size()); // Should match the number of elements in either pImageInfo, pBufferInfo or pTexelBufferView
+			descriptorWrites[1].pImageInfo = imageInfos.data();
 		}
 
 		// Update the configuration of the descriptor(s)
 		vkUpdateDescriptorSets(*m_pDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
 	}
 }
+void HelloTriangleApplication::CreateMeshletDescriptorSets()
+{
+	// Four storage buffers, see CreateMeshletPipeline
+	std::vector<VkDescriptorPoolSize> poolSizes{
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 }
+	};
+
+	m_pMeshletDescriptorSets = std::make_unique<PoolDescriptorSets>(
+		*m_pDevice,
+		poolSizes,
+		*m_pMeshletDescriptorSetLayout,
+		1);
+	m_pVehicle->UpdateMeshletDescriptorSet(m_pMeshletDescriptorSets->Get()[0]);
+}
 
 void HelloTriangleApplication::CreateSyncObjects()
 {
@@ -1799,10 +2349,12 @@ void HelloTriangleApplication::CreateSyncObjects()
 			throw std::runtime_error("failed to create synchronization objects for a frame!");
 		}
 	}
+	m_ImagesInFlight.assign(m_SwapChainImages.size(), VK_NULL_HANDLE);
 }
 void HelloTriangleApplication::DestroySyncObjects()
 {
 	m_ImageAvailableSemaphores.clear();
 	m_RenderFinishedSemaphores.clear();
 	m_InFlightFences.clear();
+	m_ImagesInFlight.clear();
 }
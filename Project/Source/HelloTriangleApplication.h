@@ -5,6 +5,7 @@
 #include <vector>
 #include <optional>
 #include <memory>
+#include <string>
 #include "DataTypes.h"
 #include "RAII/GP2_GLFWwindow.h"
 #include "RAII/GP2_VkFence.h"
@@ -21,22 +22,31 @@
 #include "RAII/GP2_VkInstance.h"
 #include "RAII/GP2_VkDevice.h"
 #include "RAII/GP2_VkBuffer.h"
-#include "RAII/GP2_VkDeviceMemory.h"
 #include "RAII/GP2_VkDescriptorSetLayout.h"
 #include "RAII/GP2_VkDescriptorPool.h"
 #include "RAII/GP2_VkSampler.h"
 #include "RAII/GP2_VkDebugUtilsMessengerEXT.h"
 #include "PoolCommandBuffers.h"
 #include "PoolDescriptorSets.h"
+#include "MemoryAllocator.h"
+#include "StagingRing.h"
+#include "GeometryPool.h"
+#include "UploadService.h"
 #include "Texture.h"
 #include "Mesh.h"
+#include "InstanceBuffer.h"
+#include "CullingPass.h"
+#include "BoundsTable.h"
+#include "TransformStore.h"
 
 // Class Forward Declarations
 struct GLFWwindow;
+class AssetData;
 struct QueueFamilyIndices
 {
 	std::optional<uint32_t> GraphicsFamily;
 	std::optional<uint32_t> PresentFamily;
+	std::optional<uint32_t> TransferFamily; // Family without graphics support, uploads use the graphics family if there is none
 
 	bool IsComplete() const {
 		return GraphicsFamily.has_value()
@@ -81,8 +91,12 @@ private:
 
 	VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
 	std::unique_ptr<GP2_VkDevice> m_pDevice;
+	std::unique_ptr<MemoryAllocator> m_pAllocator;
+	std::unique_ptr<StagingRing> m_pStagingRing; // Every upload goes through this ring
+	std::unique_ptr<UploadService> m_pUploadService;
 	VkQueue m_GraphicsQueue;
 	VkQueue m_PresentQueue;
+	VkQueue m_TransferQueue;
 
 	std::unique_ptr<GP2_VkRenderPass> m_pRenderPass;
 
@@ -93,39 +107,53 @@ private:
 	std::vector<GP2_VkImageView> m_SwapChainImageViews;
 	std::vector<GP2_VkFramebuffer> m_SwapChainFramebuffers;
 	std::unique_ptr<GP2_VkImage> m_pDepthImage;
-	std::unique_ptr<GP2_VkDeviceMemory> m_pDepthImageMemory;
+	std::unique_ptr<MemoryAllocation> m_pDepthImageMemory;
 	std::unique_ptr<GP2_VkImageView> m_pDepthImageView;
 
 	std::unique_ptr<GP2_VkDescriptorSetLayout> m_pDescriptorSetLayout;
 	std::unique_ptr<GP2_VkPipelineLayout> m_pPipelineLayout;
 	std::unique_ptr<GP2_VkPipeline> m_pGraphicsPipeline;
 
-	// TODO: create a mesh object that holds Vertex/Index data
-	// TODO: create a vertexindex buffer per mesh object
-	// TODO: store offset for vertex and index in the buffer
-	// TODO: make a single DeviceMemory for all the meshes
+	bool m_UseMeshShaders = false; // The full detail level is drawn with PBR_Meshlet.mesh instead of the vertex shader
+	PFN_vkCmdDrawMeshTasksEXT m_pfnCmdDrawMeshTasks = nullptr;
+	std::unique_ptr<GP2_VkDescriptorSetLayout> m_pMeshletDescriptorSetLayout;
+	std::unique_ptr<GP2_VkPipelineLayout> m_pMeshletPipelineLayout;
+	std::unique_ptr<GP2_VkPipeline> m_pMeshletPipeline;
+	std::unique_ptr<PoolDescriptorSets> m_pMeshletDescriptorSets; // A single set, the meshlets don't change from frame to frame
+
+	bool m_UseInstancing = false; // The vehicle is drawn config::INSTANCE_COUNT times with PBR_Instanced.vert
+	std::unique_ptr<GP2_VkPipeline> m_pInstancedPipeline;
+	std::unique_ptr<InstanceBuffer> m_pInstanceBuffer; // Transforms of the copies, one slice per swap chain image
+
+	bool m_UseGpuCulling = false; // The copies are culled by Cull.comp & drawn with PBR_Indirect.vert instead
+	bool m_UseDrawIndirectCount = false; // The device supports drawIndirectCount, every slot is drawn otherwise
+	std::unique_ptr<CullingPass> m_pCullingPass;
+	std::unique_ptr<GP2_VkPipelineLayout> m_pIndirectPipelineLayout; // The usual set & the objects of the culling pass
+	std::unique_ptr<GP2_VkPipeline> m_pIndirectPipeline;
+	glm::mat4 m_ViewProjection{ 1.f }; // Of the frame being recorded, set in UpdateUniformBuffer
+
+	std::unique_ptr<GeometryPool> m_pGeometryPool; // Vertex & index data of all the meshes
+	TransformStore m_Transforms{}; // Of all the meshes, updated once per frame in UpdateUniformBuffer
 	std::unique_ptr<Mesh> m_pMeshObject;
 	std::unique_ptr<Mesh> m_pVehicle;
+	BoundsTable m_SceneBounds{}; // Of the meshes drawn on their own, culled in UpdateUniformBuffer
+	std::vector<uint32_t> m_VisibleObjects{}; // Indices into m_SceneBounds, the first m_VisibleObjectCount are valid
+	uint32_t m_VisibleObjectCount = 0;
+	uint32_t m_VehicleBoundsIndex = 0;
 	std::vector<Vertex3D> m_ModelVertices;
 	std::vector<uint32_t> m_ModelIndices;
 
-	std::unique_ptr<GP2_VkBuffer> m_pVertexBuffer;
-	std::unique_ptr<GP2_VkDeviceMemory> m_pVertexBufferMemory;
-	std::unique_ptr<GP2_VkBuffer> m_pIndexBuffer;
-	std::unique_ptr<GP2_VkDeviceMemory> m_pIndexBufferMemory;
-	std::unique_ptr<GP2_VkBuffer> m_pVertexIndexBuffer;
-	std::unique_ptr<GP2_VkDeviceMemory> m_pVertexIndexBufferMemory;
-
+	bool m_UseHostMemoryImport = false; // Cache files are imported as staging memory, the device supports VK_EXT_external_memory_host
+	bool m_UseBlockCompression = false; // Textures with a BC format are uploaded compressed, the device supports textureCompressionBC
 	std::vector<Texture> m_Textures; // Created in CreateTextureImage & referenced in UpdateDescriptorSets
 	std::unique_ptr<GP2_VkSampler> m_pTextureSampler; // Created in CreateTextureSampler & referenced in UpdateDescriptorSets
 
-	std::unique_ptr<GP2_VkBuffer> m_pUniformBuffer; // Created in CreateUniformBuffers & referenced in UpdateDescriptorSets
-	std::unique_ptr<GP2_VkDeviceMemory> m_pUniformBufferMemory; // Only used in CreateUniformBuffers
-	std::vector<void*> m_MappedUniformBuffers; // Created in CreateUniformBuffers & assigned in UpdateUniformBuffer
-	std::unique_ptr<GP2_VkBuffer> m_pCameraModelBuffer;
-	std::unique_ptr<GP2_VkDeviceMemory> m_pCameraModelBufferMemory;
+	std::unique_ptr<GP2_VkBuffer> m_pCameraBuffer; // The model transforms are pushed with every draw instead
+	std::unique_ptr<MemoryAllocation> m_pCameraBufferMemory;
 	std::vector<void*> m_MappedCameraBuffers;
-	std::vector<void*> m_MappedModelBuffers;
+	std::unique_ptr<GP2_VkBuffer> m_pCulledIndexBuffer; // Indices of the visible meshlets, one slice per swap chain image
+	std::unique_ptr<MemoryAllocation> m_pCulledIndexBufferMemory;
+	std::vector<uint32_t*> m_MappedCulledIndices;
 
 	std::unique_ptr<PoolDescriptorSets> m_pDescriptorSets;
 	std::unique_ptr<PoolCommandBuffers> m_pCommandBuffers;
@@ -133,6 +161,7 @@ private:
 	std::vector<GP2_VkSemaphore> m_ImageAvailableSemaphores;
 	std::vector<GP2_VkSemaphore> m_RenderFinishedSemaphores;
 	std::vector<GP2_VkFence> m_InFlightFences;
+	std::vector<VkFence> m_ImagesInFlight; // Fence of the frame that last used every swap chain image, not owned
 
 	uint32_t m_CurrentFrame = 0;
 	bool m_IsFramebufferResized = false;
@@ -148,6 +177,8 @@ private:
 
 	void DrawFrame();
 	void UpdateUniformBuffer(uint32_t currentImage);
+	CameraViewProj CalculateCamera() const;
+	bool IsObjectVisible(uint32_t boundsIndex) const; // In the frustum of the last UpdateUniformBuffer
 
 	static void FramebufferResizeCallback(GLFWwindow* window, int width, int height);
 
@@ -167,6 +198,9 @@ private:
 	bool IsDeviceSuitable(VkPhysicalDevice device);
 	QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device);
 	bool CheckDeviceExtensionSupport(VkPhysicalDevice device);
+	bool CheckMeshShaderSupport(VkPhysicalDevice device);
+	bool CheckHostMemoryImportSupport(VkPhysicalDevice device);
+	void EnableHostMemoryImport(); // Hands the alignment & the extension function to the staging ring
 
 	void CreateLogicalDevice();
 
@@ -182,130 +216,52 @@ private:
 
 	void CreateRenderPass(VkFormat format);
 
-	static VkDescriptorSetLayoutBinding GetLayoutBindingUBO();
+	static VkDescriptorSetLayoutBinding GetLayoutBindingUBO(VkShaderStageFlags geometryStages);
 	static VkDescriptorSetLayoutBinding GetLayoutBindingSampler();
-	static VkDescriptorSetLayoutBinding GetLayoutBindingModel();
-	void CreateGraphicsPipeline();
+	std::unique_ptr<GP2_VkPipeline> CreateGraphicsPipeline(VkPipelineLayout layout, const std::string& geometryShaderPath, VkShaderStageFlagBits geometryStage, bool isInstanced = false); // Instanced pipelines read InstanceData as well
+	void CreateMeshletPipeline();
 	VkShaderModule CreateShaderModule(const std::vector<char>& code);
 
 	void CreateCommandPool();
-	void RecordCommandBuffers();
 	void RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
 	std::unique_ptr<PoolCommandBuffers> BeginSingleTimeCommands();
 	void EndSingleTimeCommands(std::unique_ptr<PoolCommandBuffers> pCommandBuffer);
 
 	void LoadModel(const char* filePath);
 	void LoadVehicleModel();
+	bool CompactGeometryPool(); // Writes everything that holds the pool's buffers or ranges again, false if nothing moved
 
-	void CreateImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, GP2_VkImage& image, GP2_VkDeviceMemory& imageMemory);
-	void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, GP2_VkBuffer& buffer, GP2_VkDeviceMemory& bufferMemory);
-	template <typename VertexType> void CreateVertexBuffer(const std::vector<VertexType>& vertices);
-	template <typename IndexType> void CreateIndexBuffer(const std::vector<IndexType>& indices);
-	template <typename VertexType, typename IndexType> void CreateVertexIndexBuffer(const std::vector<VertexType>& vertices, const std::vector<IndexType>& indices);
-	void CreateUniformBuffers();
-	void CreateCameraAndModelUniformBuffers();
+	void CreateImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, GP2_VkImage& image, MemoryAllocation& imageMemory, uint32_t mipLevels = 1);
+	void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, GP2_VkBuffer& buffer, MemoryAllocation& bufferMemory);
+	void CreateCameraUniformBuffers();
+	void CreateCulledIndexBuffers();
 	void CreateDepthResources();
-	void CreateTextureImage(const char* filePath, int nrChannels, std::unique_ptr<Texture>& pTexture);
-	void CreateTextureImage(const char* filePath, int nrChannels, Texture& texture);
-	Texture CreateTextureImage(const char* filePath, int nrChannels);
+	void CreateTextureImage(const char* filePath, TextureSemantic semantic, std::unique_ptr<Texture>& pTexture);
+	void CreateTextureImage(const char* filePath, TextureSemantic semantic, Texture& texture);
+	Texture CreateTextureImage(const char* filePath, TextureSemantic semantic);
+	// Uploads all textures as one batch, the format of every texture follows from its semantic, see textures::GetFormat
+	// BC4, BC5 & BC7 are used if the device supports them, otherwise R8_UNORM, R8G8_UNORM or R8G8B8A8
+	std::vector<Texture> CreateTextureImages(const std::vector<TextureDescription>& descriptions);
+	std::vector<Texture> CreateCompressedTextureImages(const std::vector<TextureDescription>& descriptions); // Cooked into KTX2 caches on the first run
+	std::vector<AssetData> ReadTextureFiles(const std::vector<TextureDescription>& descriptions, const std::vector<bool>& isRead) const; // Two per description, the file & the packed file
+	std::vector<uint8_t> LoadTexturePixels(const TextureDescription& description, const AssetData& file, const AssetData& packedFile, uint32_t& width, uint32_t& height) const; // RGBA8, masks are converted
 	void CreateTextureSampler();
 	void TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
-	VkDeviceSize CreateStagingBuffer(GP2_VkBuffer& stagingBuffer, GP2_VkDeviceMemory& stagingBufferMemory, const std::vector<VkDeviceSize>& sizes, const std::vector<const void*>& datas);
-	void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
-	void CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
-	uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+	void PrintMemoryStats() const;
+	std::vector<ObjectData> CreateObjectGrid() const; // The instancing grid with the vehicle's rotation at startup
+	void ValidateGpuCulling(const std::vector<ObjectData>& objects);
+	void ValidateGeometryCompaction(GeometryPool::Handle hole); // The hole is a range uploaded in front of the vehicle
+	void ValidateHostMemoryImport();
 	VkFormat FindDepthFormat();
 	VkFormat FindSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 	bool HasStencilComponent(VkFormat format);
+	bool CanBlitMipmaps(VkFormat format) const; // Linear blits from & to optimal tiling images
 
 	void CreateDescriptorSets();
 	void UpdateDescriptorSets(const std::vector<Texture>& textures);
+	void CreateMeshletDescriptorSets();
 
 	void CreateSyncObjects();
 	void DestroySyncObjects();
 };
-
-//---------------------------
-// Template Member Functions
-//---------------------------
-template<typename VertexType>
-inline void HelloTriangleApplication::CreateVertexBuffer(const std::vector<VertexType>& vertices)
-{
-	// Calculate vertex buffer size
-	VkDeviceSize bufferByteSize{ sizeof(vertices[0]) * vertices.size() };
-
-	// Create staging buffer with assigned data
-	GP2_VkBuffer stagingBuffer{};
-	GP2_VkDeviceMemory stagingBufferMemory{};
-	CreateStagingBuffer(stagingBuffer, stagingBufferMemory,
-		{ bufferByteSize },
-		{ vertices.data() });
-
-	// Create vertex buffer
-	m_pVertexBuffer = std::make_unique<GP2_VkBuffer>();
-	m_pVertexBufferMemory = std::make_unique<GP2_VkDeviceMemory>();
-	CreateBuffer(
-		bufferByteSize,
-		VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-		*m_pVertexBuffer,
-		*m_pVertexBufferMemory);
-
-	// Transfer staging buffer to vertex buffer
-	CopyBuffer(stagingBuffer, *m_pVertexBuffer, bufferByteSize);
-}
-template<typename IndexType>
-inline void HelloTriangleApplication::CreateIndexBuffer(const std::vector<IndexType>& indices)
-{
-	// Calculate index buffer size
-	VkDeviceSize bufferByteSize{ sizeof(indices[0]) * indices.size() };
-
-	// Create staging buffer with assigned data
-	GP2_VkBuffer stagingBuffer{};
-	GP2_VkDeviceMemory stagingBufferMemory{};
-	CreateStagingBuffer(stagingBuffer, stagingBufferMemory,
-		{ bufferByteSize },
-		{ indices.data() });
-
-	// Create index buffer
-	m_pIndexBuffer = std::make_unique<GP2_VkBuffer>();
-	m_pIndexBufferMemory = std::make_unique<GP2_VkDeviceMemory>();
-	CreateBuffer(
-		bufferByteSize,
-		VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-		*m_pIndexBuffer,
-		*m_pIndexBufferMemory);
-
-	// Transfer staging buffer to index buffer
-	CopyBuffer(stagingBuffer, *m_pIndexBuffer, bufferByteSize);
-}
-template<typename VertexType, typename IndexType>
-inline void HelloTriangleApplication::CreateVertexIndexBuffer(const std::vector<VertexType>& vertices, const std::vector<IndexType>& indices)
-{
-	// Calculate vertex + index buffer size
-	VkDeviceSize verticesSize{ sizeof(vertices[0]) * vertices.size() };
-	VkDeviceSize indicesSize{ sizeof(indices[0]) * indices.size() };
-	VkDeviceSize bufferSize{};
-
-	// Create staging buffer with assigned data
-	GP2_VkBuffer stagingBuffer{};
-	GP2_VkDeviceMemory stagingBufferMemory{};
-	bufferSize = CreateStagingBuffer(stagingBuffer, stagingBufferMemory,
-		{ verticesSize,		indicesSize },
-		{ vertices.data(),	indices.data() });
-
-	// Create vertex index buffer
-	m_pVertexIndexBuffer = std::make_unique<GP2_VkBuffer>();
-	m_pVertexIndexBufferMemory = std::make_unique<GP2_VkDeviceMemory>();
-	CreateBuffer(
-		bufferSize,
-		VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-		*m_pVertexIndexBuffer,
-		*m_pVertexIndexBufferMemory);
-
-	// Transfer staging buffer to vertex index buffer
-	CopyBuffer(stagingBuffer, *m_pVertexIndexBuffer, bufferSize);
-}
 #endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "InstanceBuffer.h"
+#include <stdexcept>
+#include <cmath>
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+InstanceBuffer::InstanceBuffer(VkDevice device, MemoryAllocator& allocator, uint32_t capacity, uint32_t sliceCount)
+	: m_Capacity{ capacity }
+	, m_SliceCount{ sliceCount }
+{
+	if (capacity == 0 || sliceCount == 0) {
+		throw std::invalid_argument("instance buffer needs at least one instance & one slice!");
+	}
+
+	// Written by the CPU every frame & read once per instance, so it stays in host visible memory
+	m_Buffer = GP2_VkBuffer{ device, sizeof(InstanceData) * capacity * sliceCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, false };
+	m_BufferMemory = allocator.AllocateAndBind(m_Buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+	// Host visible memory is persistently mapped by the allocator
+	m_pMappedData = static_cast<InstanceData*>(m_BufferMemory.GetMappedData());
+}
+
+
+//-----------------------------------------------------------------
+// Destructor
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+InstanceData* InstanceBuffer::GetSlice(uint32_t slice) const
+{
+	if (slice >= m_SliceCount) {
+		throw std::invalid_argument("instance buffer slice is out of range!");
+	}
+	return m_pMappedData + static_cast<size_t>(m_Capacity) * slice;
+}
+
+void InstanceBuffer::CmdBind(VkCommandBuffer commandBuffer, uint32_t slice) const
+{
+	if (slice >= m_SliceCount) {
+		throw std::invalid_argument("instance buffer slice is out of range!");
+	}
+
+	VkBuffer buffer{ m_Buffer };
+	VkDeviceSize offset{ sizeof(InstanceData) * m_Capacity * slice };
+	vkCmdBindVertexBuffers(commandBuffer, InstanceData::Binding, 1, &buffer, &offset);
+}
+
+void InstanceBuffer::WriteGrid(InstanceData* pDst, uint32_t count, const glm::mat4& transform, float spacing)
+{
+	const uint32_t side{ static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(count)))) };
+	const float start{ -0.5f * (side - 1) * spacing };
+
+	// translate(offset) * transform only adds the offset to the last column, the matrices are written front to back for write combined memory
+	uint32_t i{ 0 };
+	for (uint32_t y{ 0 }; y < side && i < count; ++y)
+	{
+		for (uint32_t x{ 0 }; x < side && i < count; ++x, ++i)
+		{
+			InstanceData& instance = pDst[i];
+			instance.model[0] = transform[0];
+			instance.model[1] = transform[1];
+			instance.model[2] = transform[2];
+			instance.model[3] = transform[3] + glm::vec4{ start + x * spacing, start + y * spacing, 0.f, 0.f };
+		}
+	}
+}
@@ -0,0 +1,55 @@
+#ifndef GP2VKT_INSTANCEBUFFER_H_
+#define GP2VKT_INSTANCEBUFFER_H_
+// Includes
+#include <vulkan/vulkan_core.h>
+#include <vector>
+#include "DataTypes.h"
+#include "MemoryAllocator.h"
+#include "RAII/GP2_VkBuffer.h"
+
+// Class Forward Declarations
+
+
+// Per instance data of one instanced draw, one persistently mapped slice per swap chain image
+// The slice of an image is rewritten every frame once the previous frame using that image has finished
+class InstanceBuffer final
+{
+public:
+	// Constructors and Destructor
+	explicit InstanceBuffer(VkDevice device, MemoryAllocator& allocator, uint32_t capacity, uint32_t sliceCount);
+	~InstanceBuffer() = default;
+
+	// Copy and Move semantics
+	InstanceBuffer(const InstanceBuffer& other)					= delete;
+	InstanceBuffer& operator=(const InstanceBuffer& other)		= delete;
+	InstanceBuffer(InstanceBuffer&& other) noexcept				= delete;
+	InstanceBuffer& operator=(InstanceBuffer&& other) noexcept	= delete;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	InstanceData* GetSlice(uint32_t slice) const; // Capacity instances, host coherent so writes need no flush
+	uint32_t GetCapacity() const { return m_Capacity; }
+
+	void CmdBind(VkCommandBuffer commandBuffer, uint32_t slice) const; // To InstanceData::Binding, next to the geometry pool's vertices
+
+	// Square grid of copies of the transform around the origin in the XY plane, spacing is in world units
+	// Only the translation differs between the instances, so every matrix is copied & offset instead of multiplied
+	static void WriteGrid(InstanceData* pDst, uint32_t count, const glm::mat4& transform, float spacing);
+
+
+private:
+	// Member variables
+	uint32_t m_Capacity{};
+	uint32_t m_SliceCount{};
+
+	GP2_VkBuffer m_Buffer{};
+	MemoryAllocation m_BufferMemory{};
+	InstanceData* m_pMappedData{ nullptr };
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+
+};
+#endif
@@ -0,0 +1,189 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "Lz4.h"
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <algorithm>
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	// Limits of the block format
+	constexpr size_t MIN_MATCH{ 4 };
+	constexpr size_t LAST_LITERALS{ 5 }; // The block always ends with at least this many literals
+	constexpr size_t MATCH_FIND_LIMIT{ 12 }; // The last match starts at least this far from the end
+	constexpr size_t MAX_OFFSET{ 65535 };
+	constexpr uint32_t RUN_MASK{ 15 };
+
+	constexpr uint32_t HASH_LOG{ 13 };
+	constexpr uint32_t SKIP_TRIGGER{ 6 }; // Incompressible data is skipped faster after 2^6 misses
+
+	uint32_t Read32(const char* pData)
+	{
+		uint32_t value{};
+		memcpy(&value, pData, sizeof(value));
+		return value;
+	}
+
+	uint32_t Hash(uint32_t sequence)
+	{
+		return (sequence * 2654435761u) >> (32 - HASH_LOG);
+	}
+
+	char* WriteLength(char* pDst, size_t length)
+	{
+		for (; length >= 255; length -= 255) *pDst++ = static_cast<char>(255);
+		*pDst++ = static_cast<char>(length);
+		return pDst;
+	}
+
+	// Token, literals & (unless it's the last sequence) the match, nullptr if it doesn't fit
+	char* WriteSequence(char* pDst, const char* pDstEnd, const char* pLiterals, size_t literalCount, size_t offset, size_t matchLength)
+	{
+		const size_t worstCase{ 1 + literalCount / 255 + 1 + literalCount + 2 + matchLength / 255 + 1 };
+		if (static_cast<size_t>(pDstEnd - pDst) < worstCase) return nullptr;
+
+		char* pToken = pDst++;
+		uint32_t token{ static_cast<uint32_t>(std::min<size_t>(literalCount, RUN_MASK)) << 4 };
+		if (literalCount >= RUN_MASK) pDst = WriteLength(pDst, literalCount - RUN_MASK);
+		memcpy(pDst, pLiterals, literalCount);
+		pDst += literalCount;
+
+		if (matchLength > 0) {
+			*pDst++ = static_cast<char>(offset & 0xFF);
+			*pDst++ = static_cast<char>(offset >> 8);
+			const size_t length{ matchLength - MIN_MATCH };
+			token |= static_cast<uint32_t>(std::min<size_t>(length, RUN_MASK));
+			if (length >= RUN_MASK) pDst = WriteLength(pDst, length - RUN_MASK);
+		}
+		*pToken = static_cast<char>(token);
+		return pDst;
+	}
+
+	// False if the length runs past the end of the block
+	bool ReadLength(const char*& pSrc, const char* pSrcEnd, size_t& length)
+	{
+		uint8_t value{};
+		do
+		{
+			if (pSrc == pSrcEnd) return false;
+			value = static_cast<uint8_t>(*pSrc++);
+			length += value;
+		} while (value == 255);
+		return true;
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Functions
+//-----------------------------------------------------------------
+size_t lz4::GetMaxCompressedSize(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+size_t lz4::Compress(const char* pSrc, size_t srcSize, char* pDst, size_t dstCapacity)
+{
+	char* pOut = pDst;
+	const char* pDstEnd = pDst + dstCapacity;
+	size_t anchor{ 0 };
+
+	if (srcSize > MATCH_FIND_LIMIT) {
+		// Positions of the last sequence with the same hash
+		std::array<uint32_t, size_t{ 1 } << HASH_LOG> table{};
+		const size_t matchEnd{ srcSize - LAST_LITERALS };
+		const size_t searchEnd{ srcSize - MATCH_FIND_LIMIT };
+
+		size_t position{ 1 };
+		uint32_t missCount{ 0 };
+		while (position <= searchEnd)
+		{
+			const uint32_t sequence{ Read32(pSrc + position) };
+			uint32_t& entry = table[Hash(sequence)];
+			size_t candidate{ entry };
+			entry = static_cast<uint32_t>(position);
+
+			if (candidate >= position || position - candidate > MAX_OFFSET || Read32(pSrc + candidate) != sequence) {
+				position += 1 + (missCount++ >> SKIP_TRIGGER);
+				continue;
+			}
+			missCount = 0;
+
+			// Extend the match backwards over the pending literals & forwards up to the last literals
+			while (position > anchor && candidate > 0 && pSrc[position - 1] == pSrc[candidate - 1])
+			{
+				--position;
+				--candidate;
+			}
+			size_t length{ MIN_MATCH };
+			while (position + length < matchEnd && pSrc[candidate + length] == pSrc[position + length]) ++length;
+
+			pOut = WriteSequence(pOut, pDstEnd, pSrc + anchor, position - anchor, position - candidate, length);
+			if (pOut == nullptr) return 0;
+
+			position += length;
+			anchor = position;
+
+			// The positions inside of the match are skipped, remember one close to its end
+			if (position - 2 <= searchEnd) table[Hash(Read32(pSrc + position - 2))] = static_cast<uint32_t>(position - 2);
+		}
+	}
+
+	pOut = WriteSequence(pOut, pDstEnd, pSrc + anchor, srcSize - anchor, 0, 0);
+	if (pOut == nullptr) return 0;
+	return static_cast<size_t>(pOut - pDst);
+}
+
+bool lz4::Decompress(const char* pSrc, size_t srcSize, char* pDst, size_t dstSize)
+{
+	const char* pSrcEnd = pSrc + srcSize;
+	char* pOut = pDst;
+	const char* pDstEnd = pDst + dstSize;
+
+	while (pSrc < pSrcEnd)
+	{
+		const uint32_t token{ static_cast<uint8_t>(*pSrc++) };
+
+		// Literals
+		size_t literalCount{ token >> 4 };
+		if (literalCount == RUN_MASK && ReadLength(pSrc, pSrcEnd, literalCount) == false) return false;
+		if (static_cast<size_t>(pSrcEnd - pSrc) < literalCount || static_cast<size_t>(pDstEnd - pOut) < literalCount) return false;
+		if (literalCount > 0) memcpy(pOut, pSrc, literalCount);
+		pSrc += literalCount;
+		pOut += literalCount;
+
+		// The last sequence doesn't have a match
+		if (pSrc == pSrcEnd) break;
+
+		// Match
+		if (pSrcEnd - pSrc < 2) return false;
+		const size_t offset{ static_cast<size_t>(static_cast<uint8_t>(pSrc[0])) | static_cast<size_t>(static_cast<uint8_t>(pSrc[1])) << 8 };
+		pSrc += 2;
+		if (offset == 0 || offset > static_cast<size_t>(pOut - pDst)) return false;
+
+		size_t length{ token & RUN_MASK };
+		if (length == RUN_MASK && ReadLength(pSrc, pSrcEnd, length) == false) return false;
+		length += MIN_MATCH;
+		if (static_cast<size_t>(pDstEnd - pOut) < length) return false;
+
+		// Overlapping matches repeat the last offset bytes, copies of 8 bytes are only safe if they don't overlap
+		const char* pMatch = pOut - offset;
+		if (offset >= 8) {
+			size_t copied{ 0 };
+			for (; copied + 8 <= length; copied += 8) memcpy(pOut + copied, pMatch + copied, 8);
+			for (; copied < length; ++copied) pOut[copied] = pMatch[copied];
+		}
+		else {
+			for (size_t i{ 0 }; i < length; ++i) pOut[i] = pMatch[i];
+		}
+		pOut += length;
+	}
+
+	return pOut == pDstEnd;
+}
@@ -0,0 +1,21 @@
+#ifndef GP2VKT_LZ4_H_
+#define GP2VKT_LZ4_H_
+// Includes
+#include <cstddef>
+
+// Class Forward Declarations
+
+
+// Encoder & decoder of the LZ4 block format, compatible with the reference implementation
+// Every call handles one independent block, matches never reach into a previous block
+namespace lz4
+{
+	size_t GetMaxCompressedSize(size_t size); // Of incompressible data
+
+	// Greedy matcher with one position per hash, returns the compressed size or 0 if it doesn't fit in dstCapacity
+	size_t Compress(const char* pSrc, size_t srcSize, char* pDst, size_t dstCapacity);
+
+	// False if the block is malformed or doesn't decode to exactly dstSize bytes, never reads or writes out of bounds
+	bool Decompress(const char* pSrc, size_t srcSize, char* pDst, size_t dstSize);
+}
+#endif
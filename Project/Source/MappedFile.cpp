@@ -0,0 +1,145 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "MappedFile.h"
+#include <stdexcept>
+#include <utility>
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+MappedFile::MappedFile(const char* filePath)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error("failed to open file!");
+	}
+	m_File = file;
+
+	LARGE_INTEGER size{};
+	GetFileSizeEx(file, &size);
+	m_Size = static_cast<size_t>(size.QuadPart);
+
+	// Empty files can't be mapped
+	if (m_Size > 0) {
+		m_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_Mapping == nullptr) {
+			Close();
+			throw std::runtime_error("failed to map file!");
+		}
+		m_pData = static_cast<const char*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+	}
+#else
+	m_File = open(filePath, O_RDONLY);
+	if (m_File < 0) {
+		throw std::runtime_error("failed to open file!");
+	}
+
+	struct stat fileStat {};
+	fstat(m_File, &fileStat);
+	m_Size = static_cast<size_t>(fileStat.st_size);
+
+	// Empty files can't be mapped
+	if (m_Size > 0) {
+		void* pData = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_File, 0);
+		if (pData != MAP_FAILED) {
+			m_pData = static_cast<const char*>(pData);
+			madvise(pData, m_Size, MADV_SEQUENTIAL);
+		}
+	}
+#endif
+
+	if (m_Size > 0 && m_pData == nullptr) {
+		Close();
+		throw std::runtime_error("failed to map file!");
+	}
+	m_IsOpen = true;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+	: m_pData{ other.m_pData }
+	, m_Size{ other.m_Size }
+	, m_IsOpen{ other.m_IsOpen }
+	, m_File{ other.m_File }
+#ifdef _WIN32
+	, m_Mapping{ other.m_Mapping }
+#endif
+{
+	// Make other object invalid
+	other.m_pData = nullptr;
+	other.m_Size = 0;
+	other.m_IsOpen = false;
+#ifdef _WIN32
+	other.m_File = nullptr;
+	other.m_Mapping = nullptr;
+#else
+	other.m_File = -1;
+#endif
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	// Exit early if same object
+	if (this != &other)
+	{
+		// Destroy previously owned resource
+		Close();
+
+		// Assign new data
+		std::swap(m_pData, other.m_pData);
+		std::swap(m_Size, other.m_Size);
+		std::swap(m_IsOpen, other.m_IsOpen);
+		std::swap(m_File, other.m_File);
+#ifdef _WIN32
+		std::swap(m_Mapping, other.m_Mapping);
+#endif
+	}
+	return *this;
+}
+
+
+//-----------------------------------------------------------------
+// Destructor
+//-----------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (m_pData) UnmapViewOfFile(m_pData);
+	if (m_Mapping) CloseHandle(m_Mapping);
+	if (m_File) CloseHandle(m_File);
+	m_Mapping = nullptr;
+	m_File = nullptr;
+#else
+	if (m_pData) munmap(const_cast<char*>(m_pData), m_Size);
+	if (m_File >= 0) close(m_File);
+	m_File = -1;
+#endif
+	m_pData = nullptr;
+	m_Size = 0;
+	m_IsOpen = false;
+}
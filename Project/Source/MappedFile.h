@@ -0,0 +1,50 @@
+#ifndef GP2VKT_MAPPEDFILE_H_
+#define GP2VKT_MAPPEDFILE_H_
+// Includes
+#include <cstddef>
+#include <cstdint>
+
+// Class Forward Declarations
+
+
+// Read only view of a whole file, the OS pages the contents in on first access
+class MappedFile final
+{
+public:
+	// Constructors and Destructor
+	MappedFile() = default;
+	explicit MappedFile(const char* filePath);
+	~MappedFile();
+
+	// Copy and Move semantics
+	MappedFile(const MappedFile& other)					= delete;
+	MappedFile& operator=(const MappedFile& other)		= delete;
+	MappedFile(MappedFile&& other) noexcept				;
+	MappedFile& operator=(MappedFile&& other) noexcept	;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	const char* GetData() const { return m_pData; }
+	size_t GetSize() const { return m_Size; }
+	bool IsOpen() const { return m_IsOpen; }
+
+
+private:
+	// Member variables
+	const char* m_pData{ nullptr };
+	size_t m_Size{};
+	bool m_IsOpen{ false };
+#ifdef _WIN32
+	void* m_File{ nullptr };
+	void* m_Mapping{ nullptr };
+#else
+	int m_File{ -1 };
+#endif
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+	void Close();
+};
+#endif
@@ -0,0 +1,233 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "MemoryAllocator.h"
+#include <stdexcept>
+#include <algorithm>
+#include "RAII/GP2_VkBuffer.h"
+#include "RAII/GP2_VkImage.h"
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+MemoryAllocation::MemoryAllocation(MemoryAllocator* pAllocator, MemoryBlock* pBlock, uint32_t handle, VkDeviceSize offset, VkDeviceSize size)
+	: m_pAllocator{ pAllocator }
+	, m_pBlock{ pBlock }
+	, m_Handle{ handle }
+	, m_Offset{ offset }
+	, m_Size{ size }
+{
+}
+
+MemoryAllocation::MemoryAllocation(MemoryAllocation&& other) noexcept
+	: m_pAllocator{ other.m_pAllocator }
+	, m_pBlock{ other.m_pBlock }
+	, m_Handle{ other.m_Handle }
+	, m_Offset{ other.m_Offset }
+	, m_Size{ other.m_Size }
+{
+	// Make other object invalid
+	other.m_pAllocator = nullptr;
+	other.m_pBlock = nullptr;
+	other.m_Handle = FreeListAllocator::InvalidHandle;
+}
+
+MemoryAllocation& MemoryAllocation::operator=(MemoryAllocation&& other) noexcept
+{
+	// Exit early if same object
+	if (this != &other)
+	{
+		// Release previously owned range
+		Release();
+
+		// Assign new data
+		m_pAllocator = other.m_pAllocator;
+		m_pBlock = other.m_pBlock;
+		m_Handle = other.m_Handle;
+		m_Offset = other.m_Offset;
+		m_Size = other.m_Size;
+
+		// Make other object invalid
+		other.m_pAllocator = nullptr;
+		other.m_pBlock = nullptr;
+		other.m_Handle = FreeListAllocator::InvalidHandle;
+	}
+	return *this;
+}
+
+MemoryAllocator::MemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize blockSize)
+	: m_Device{ device }
+	, m_BlockSize{ blockSize }
+{
+	// Available types of memory
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_MemoryProperties);
+
+	// Granularity between linear and non-linear resources that share a memory object
+	VkPhysicalDeviceProperties properties{};
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	m_BufferImageGranularity = properties.limits.bufferImageGranularity;
+}
+
+
+//-----------------------------------------------------------------
+// Destructor
+//-----------------------------------------------------------------
+MemoryAllocation::~MemoryAllocation()
+{
+	Release();
+}
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+VkDeviceMemory MemoryAllocation::GetMemory() const
+{
+	return m_pBlock ? static_cast<VkDeviceMemory>(m_pBlock->Memory) : VK_NULL_HANDLE;
+}
+
+void* MemoryAllocation::GetMappedData() const
+{
+	if (m_pBlock == nullptr || m_pBlock->pMappedData == nullptr) return nullptr;
+	return static_cast<char*>(m_pBlock->pMappedData) + m_Offset;
+}
+
+MemoryAllocation MemoryAllocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool isLinear)
+{
+	uint32_t memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits, properties);
+
+	// Resources of different kinds can share blocks if the device doesn't care about granularity
+	if (m_BufferImageGranularity <= 1) isLinear = true;
+
+	// Big resources get a block of their own
+	if (requirements.size > m_BlockSize / 2) {
+		MemoryBlock& block = CreateBlock(memoryTypeIndex, requirements.size, isLinear, true);
+		auto range = block.Ranges.Allocate(requirements.size, requirements.alignment);
+		return MemoryAllocation{ this, &block, range->Handle, range->Offset, requirements.size };
+	}
+
+	// Look for an existing block with enough space
+	for (const auto& pBlock : m_Blocks)
+	{
+		if (pBlock->IsDedicated || pBlock->MemoryTypeIndex != memoryTypeIndex || pBlock->IsLinear != isLinear) continue;
+
+		auto range = pBlock->Ranges.Allocate(requirements.size, requirements.alignment);
+		if (range.has_value()) {
+			return MemoryAllocation{ this, pBlock.get(), range->Handle, range->Offset, requirements.size };
+		}
+	}
+
+	// Create a new block otherwise
+	MemoryBlock& block = CreateBlock(memoryTypeIndex, m_BlockSize, isLinear, false);
+	auto range = block.Ranges.Allocate(requirements.size, requirements.alignment);
+	if (range.has_value() == false) {
+		throw std::runtime_error("failed to sub-allocate memory!");
+	}
+	return MemoryAllocation{ this, &block, range->Handle, range->Offset, requirements.size };
+}
+
+MemoryAllocation MemoryAllocator::AllocateAndBind(const GP2_VkBuffer& buffer, VkMemoryPropertyFlags properties)
+{
+	// Buffers are always linear resources
+	MemoryAllocation allocation = Allocate(buffer.GetMemoryRequirements(), properties, true);
+	buffer.BindMemory(allocation.GetMemory(), allocation.GetOffset());
+	return allocation;
+}
+
+MemoryAllocation MemoryAllocator::AllocateAndBind(const GP2_VkImage& image, VkMemoryPropertyFlags properties, VkImageTiling tiling)
+{
+	MemoryAllocation allocation = Allocate(image.GetMemoryRequirements(), properties, tiling == VK_IMAGE_TILING_LINEAR);
+	image.BindMemory(allocation.GetMemory(), allocation.GetOffset());
+	return allocation;
+}
+
+uint32_t MemoryAllocator::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+{
+	// Find a memory type that is suitable for the resource
+	for (uint32_t i{ 0 }; i < m_MemoryProperties.memoryTypeCount; ++i)
+	{
+		if ((typeFilter & (1 << i)) &&
+			(m_MemoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+			return i;
+		}
+	}
+
+	throw std::runtime_error("failed to find suitable memory type!");
+}
+
+MemoryAllocatorStats MemoryAllocator::GetStats() const
+{
+	MemoryAllocatorStats stats{};
+	for (const auto& pBlock : m_Blocks)
+	{
+		FreeListAllocator::Stats blockStats = pBlock->Ranges.GetStats();
+
+		++stats.BlockCount;
+		stats.DedicatedBlockCount += pBlock->IsDedicated;
+		stats.AllocationCount += blockStats.AllocationCount;
+		stats.ReservedSize += blockStats.TotalSize;
+		stats.UsedSize += blockStats.UsedSize;
+		stats.WastedSize += blockStats.WastedSize;
+		stats.FreeSize += blockStats.FreeSize;
+		stats.LargestFreeRange = std::max(stats.LargestFreeRange, blockStats.LargestFreeRange);
+	}
+
+	if (stats.FreeSize > 0) {
+		stats.Fragmentation = 1.f - static_cast<float>(static_cast<double>(stats.LargestFreeRange) / static_cast<double>(stats.FreeSize));
+	}
+	return stats;
+}
+
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+void MemoryAllocation::Release()
+{
+	if (m_pAllocator) m_pAllocator->Free(m_pBlock, m_Handle);
+
+	m_pAllocator = nullptr;
+	m_pBlock = nullptr;
+	m_Handle = FreeListAllocator::InvalidHandle;
+}
+
+MemoryBlock& MemoryAllocator::CreateBlock(uint32_t memoryTypeIndex, VkDeviceSize size, bool isLinear, bool isDedicated)
+{
+	auto pBlock = std::make_unique<MemoryBlock>(MemoryBlock{
+		GP2_VkDeviceMemory{ m_Device, size, memoryTypeIndex },
+		FreeListAllocator{ size, 256 },
+		nullptr,
+		memoryTypeIndex,
+		isLinear,
+		isDedicated });
+
+	// Keep host visible memory mapped, mapping it again for every upload is expensive
+	if (m_MemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+		if (vkMapMemory(m_Device, pBlock->Memory, 0, VK_WHOLE_SIZE, 0, &pBlock->pMappedData) != VK_SUCCESS)
+			throw std::runtime_error("failed to map memory!");
+	}
+
+	m_Blocks.push_back(std::move(pBlock));
+	return *m_Blocks.back();
+}
+
+void MemoryAllocator::Free(MemoryBlock* pBlock, uint32_t handle)
+{
+	pBlock->Ranges.Free(handle);
+	if (pBlock->Ranges.IsEmpty() == false) return;
+
+	// Keep one empty block per memory type around to avoid allocating again right away
+	bool hasOtherEmptyBlock = std::any_of(m_Blocks.begin(), m_Blocks.end(), [pBlock](const auto& pOther) {
+		return pOther.get() != pBlock
+			&& pOther->IsDedicated == false
+			&& pOther->MemoryTypeIndex == pBlock->MemoryTypeIndex
+			&& pOther->IsLinear == pBlock->IsLinear
+			&& pOther->Ranges.IsEmpty();
+		});
+
+	if (pBlock->IsDedicated || hasOtherEmptyBlock) {
+		// Freeing the memory also unmaps it
+		std::erase_if(m_Blocks, [pBlock](const auto& pOther) { return pOther.get() == pBlock; });
+	}
+}
@@ -0,0 +1,124 @@
+#ifndef GP2VKT_MEMORYALLOCATOR_H_
+#define GP2VKT_MEMORYALLOCATOR_H_
+// Includes
+#include <vulkan/vulkan_core.h>
+#include <vector>
+#include <memory>
+#include "FreeListAllocator.h"
+#include "RAII/GP2_VkDeviceMemory.h"
+
+// Class Forward Declarations
+class MemoryAllocator;
+class GP2_VkBuffer;
+class GP2_VkImage;
+
+
+// A single VkDeviceMemory that is shared by many resources
+struct MemoryBlock
+{
+	GP2_VkDeviceMemory Memory{};
+	FreeListAllocator Ranges;
+	void* pMappedData{ nullptr }; // Host visible blocks stay mapped for their whole lifetime
+	uint32_t MemoryTypeIndex{};
+	bool IsLinear{ true }; // Linear (buffers) and optimal (images) resources don't share blocks to respect bufferImageGranularity
+	bool IsDedicated{ false };
+};
+struct MemoryAllocatorStats
+{
+	uint32_t BlockCount{};
+	uint32_t DedicatedBlockCount{};
+	uint32_t AllocationCount{};
+	VkDeviceSize ReservedSize{};
+	VkDeviceSize UsedSize{};
+	VkDeviceSize WastedSize{};
+	VkDeviceSize FreeSize{};
+	VkDeviceSize LargestFreeRange{};
+	float Fragmentation{};
+};
+
+
+// Offset + size slice of a MemoryBlock, hands the range back to the allocator when destroyed
+class MemoryAllocation final
+{
+public:
+	// Constructors and Destructor
+	MemoryAllocation() = default;
+	~MemoryAllocation();
+
+	// Copy and Move semantics
+	MemoryAllocation(const MemoryAllocation& other)					= delete;
+	MemoryAllocation& operator=(const MemoryAllocation& other)		= delete;
+	MemoryAllocation(MemoryAllocation&& other) noexcept				;
+	MemoryAllocation& operator=(MemoryAllocation&& other) noexcept	;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	VkDeviceMemory GetMemory() const;
+	VkDeviceSize GetOffset() const { return m_Offset; }
+	VkDeviceSize GetSize() const { return m_Size; }
+	void* GetMappedData() const; // nullptr if the memory isn't host visible
+
+
+private:
+	friend class MemoryAllocator;
+	MemoryAllocation(MemoryAllocator* pAllocator, MemoryBlock* pBlock, uint32_t handle, VkDeviceSize offset, VkDeviceSize size);
+
+	// Member variables
+	MemoryAllocator* m_pAllocator{ nullptr };
+	MemoryBlock* m_pBlock{ nullptr };
+	uint32_t m_Handle{ FreeListAllocator::InvalidHandle };
+	VkDeviceSize m_Offset{};
+	VkDeviceSize m_Size{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+	void Release();
+};
+
+
+// Sub-allocates buffers and images from big memory blocks (one list of blocks per memory type)
+// This keeps the amount of vkAllocateMemory calls far below maxMemoryAllocationCount
+class MemoryAllocator final
+{
+public:
+	// Constructors and Destructor
+	explicit MemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize blockSize);
+	~MemoryAllocator() = default;
+
+	// Copy and Move semantics
+	MemoryAllocator(const MemoryAllocator& other)					= delete;
+	MemoryAllocator& operator=(const MemoryAllocator& other)		= delete;
+	MemoryAllocator(MemoryAllocator&& other) noexcept				= delete;
+	MemoryAllocator& operator=(MemoryAllocator&& other) noexcept	= delete;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	MemoryAllocation Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool isLinear);
+	MemoryAllocation AllocateAndBind(const GP2_VkBuffer& buffer, VkMemoryPropertyFlags properties);
+	MemoryAllocation AllocateAndBind(const GP2_VkImage& image, VkMemoryPropertyFlags properties, VkImageTiling tiling);
+
+	uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+	MemoryAllocatorStats GetStats() const;
+
+
+private:
+	friend class MemoryAllocation;
+
+	// Member variables
+	VkDevice m_Device{ nullptr };
+	VkPhysicalDeviceMemoryProperties m_MemoryProperties{};
+	VkDeviceSize m_BlockSize{};
+	VkDeviceSize m_BufferImageGranularity{};
+
+	std::vector<std::unique_ptr<MemoryBlock>> m_Blocks{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+	MemoryBlock& CreateBlock(uint32_t memoryTypeIndex, VkDeviceSize size, bool isLinear, bool isDedicated);
+	void Free(MemoryBlock* pBlock, uint32_t handle);
+};
+#endif
@@ -3,106 +3,229 @@
 //-----------------------------------------------------------------
 #include "Mesh.h"
 #include <stdexcept>
-#include <unordered_map>
-#include <numeric>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
 #ifndef GLM_FORCE_RADIANS
 #define GLM_FORCE_RADIANS
 #endif
 #include <glm/glm.hpp>
-#ifndef TINYOBJLOADER_IMPLEMENTATION
-#define TINYOBJLOADER_IMPLEMENTATION
-#endif
-#include <tiny_obj_loader.h>
-#include "RAII/GP2_SingleTimeCommand.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include "ObjParser.h"
+#include "VertexDeduplicator.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "TangentGenerator.h"
+#include "VertexQuantizer.h"
+#include "Frustum.h"
+#include "AsyncFileReader.h"
 #include "Utils.h"
 
 
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+    template<typename VertexType>
+    void DeduplicateVertices(const std::vector<VertexType>& corners, std::vector<VertexType>& vertices, std::vector<uint32_t>& indices)
+    {
+        // The flat table wins as long as it mostly fits in the cache, beyond that sorting in parallel is faster
+        if (corners.size() >= config::VERTEX_DEDUPLICATION_SORT_THRESHOLD) {
+            VertexDeduplicator<VertexType>::DeduplicateSorted(corners, vertices, indices);
+        }
+        else {
+            VertexDeduplicator<VertexType>::Deduplicate(corners, vertices, indices);
+        }
+    }
+
+    template<typename VertexType>
+    void OptimizeMesh(std::vector<VertexType>& vertices, std::vector<uint32_t>& indices)
+    {
+        if (vertices.empty()) return;
+        VertexCacheStats before = optimizer::AnalyzeVertexCache(indices, vertices.size(), config::VERTEX_CACHE_SIZE);
+
+        // Triangle order first, the vertex order follows from the final triangle order
+        indices = optimizer::OptimizeVertexCache(indices, vertices.size(), config::VERTEX_CACHE_SIZE);
+        if (config::OPTIMIZE_OVERDRAW) {
+            indices = optimizer::OptimizeOverdraw(indices, &vertices[0].pos.x, sizeof(VertexType), vertices.size(),
+                config::VERTEX_CACHE_SIZE, config::OVERDRAW_THRESHOLD);
+        }
+        optimizer::OptimizeVertexFetch(vertices, indices);
+
+        if (config::REPORT_MESH_OPTIMIZATION) {
+            VertexCacheStats after = optimizer::AnalyzeVertexCache(indices, vertices.size(), config::VERTEX_CACHE_SIZE);
+            std::cout << "Mesh optimizer: ACMR " << before.ACMR << " -> " << after.ACMR
+                << ", ATVR " << before.ATVR << " -> " << after.ATVR << '\n';
+        }
+    }
+
+    // The meshlets take over the triangle order of the full detail level, the vertices follow the new triangle order again
+    template<typename VertexType>
+    void BuildMeshlets(std::vector<VertexType>& vertices, std::vector<uint32_t>& indices, MeshletData& meshlets)
+    {
+        if (vertices.empty()) return;
+        meshlets = optimizer::BuildMeshlets(indices, &vertices[0].pos.x, sizeof(VertexType), vertices.size(),
+            config::MESHLET_MAX_VERTICES, config::MESHLET_MAX_TRIANGLES);
+
+        std::vector<uint32_t> remap = optimizer::BuildVertexFetchRemap(indices, vertices.size());
+        std::vector<VertexType> remappedVertices(vertices.size());
+        for (size_t i{ 0 }; i < vertices.size(); ++i)
+        {
+            remappedVertices[remap[i]] = vertices[i];
+        }
+        vertices = std::move(remappedVertices);
+        for (uint32_t& index : indices) index = remap[index];
+        for (uint32_t& vertex : meshlets.Vertices) vertex = remap[vertex];
+
+        if (config::REPORT_MESHLETS) {
+            size_t coneCount = std::count_if(meshlets.Meshlets.begin(), meshlets.Meshlets.end(), [](const Meshlet& meshlet) { return meshlet.ConeCutoff < 1.f; });
+            std::cout << "Meshlets: " << meshlets.Meshlets.size() << " for " << indices.size() / 3 << " triangles"
+                << ", " << static_cast<float>(meshlets.Vertices.size()) / meshlets.Meshlets.size() << " vertices"
+                << " & " << static_cast<float>(indices.size() / 3) / meshlets.Meshlets.size() << " triangles per meshlet"
+                << ", " << coneCount << " can be back face culled\n";
+        }
+    }
+
+    // Runs on the unwelded corners, welding afterwards with the tangent & its sign in the key splits the vertices of mirrored UVs
+    void GenerateTangents(std::vector<VertexPBR>& corners)
+    {
+        if (corners.empty()) return;
+        auto start = std::chrono::high_resolution_clock::now();
+        TangentData tangents = TangentGenerator{}.GenerateCorners(&corners[0].pos.x, &corners[0].normal.x, &corners[0].texCoord.x,
+            sizeof(VertexPBR), corners.size());
+
+        for (size_t i{ 0 }; i < corners.size(); ++i)
+        {
+            // LoadCorners flips v, which flips the handedness of every triangle
+            const float* pTangent = &tangents.Tangents[4 * i];
+            corners[i].tangent = glm::vec4{ pTangent[0], pTangent[1], pTangent[2], -pTangent[3] };
+        }
+
+        if (config::REPORT_TANGENT_GENERATION) {
+            float milliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            std::cout << "Tangents: " << corners.size() / 3 << " triangles in " << milliseconds << " ms"
+                << ", " << tangents.DegenerateTriangleCount << " with degenerate UVs"
+                << ", " << tangents.SplitVertices.size() << " vertices split for mirrored UVs\n";
+        }
+    }
+
+    // Every level is simplified from the full detail indices, so its error is measured against the original surface
+    template<typename VertexType>
+    void BuildLods(const std::vector<VertexType>& vertices, std::vector<uint32_t>& indices, const MeshBounds& bounds, std::vector<MeshLod>& lods)
+    {
+        const std::vector<uint32_t> fullIndices{ indices };
+        const float maxError = glm::length(bounds.max - bounds.min) * config::LOD_MAX_ERROR;
+
+        lods.assign(1, MeshLod{ 0, static_cast<uint32_t>(fullIndices.size()), 0.f });
+        float targetRatio{ 1.f };
+        while (lods.size() < config::MAX_LOD_COUNT && vertices.empty() == false)
+        {
+            targetRatio *= config::LOD_REDUCTION;
+            size_t targetIndexCount = static_cast<size_t>(fullIndices.size() * targetRatio) / 3 * 3;
+
+            float error{};
+            std::vector<uint32_t> lodIndices = optimizer::Simplify(fullIndices, &vertices[0].pos.x, sizeof(VertexType), vertices.size(), targetIndexCount, maxError, &error);
+
+            // Stop once the simplifier can't get rid of a meaningful amount of triangles anymore
+            if (lodIndices.empty() || lodIndices.size() * 10 > lods.back().IndexCount * 9) break;
+
+            lodIndices = optimizer::OptimizeVertexCache(lodIndices, vertices.size(), config::VERTEX_CACHE_SIZE);
+            lods.push_back(MeshLod{ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lodIndices.size()), std::max(error, lods.back().Error) });
+            indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+        }
+    }
+}
+
+
 //-----------------------------------------------------------------
 // Constructors
 //-----------------------------------------------------------------
-Mesh::Mesh(VkDevice device, VkPhysicalDevice physicalDevice, std::unique_ptr<GP2_SingleTimeCommand> commandBuffer, const char* filePath, std::vector<Texture>&& textures)
+Mesh::Mesh(VkDevice device, GeometryPool& geometryPool, TransformStore& transforms, UploadService& uploadService, const char* filePath, std::vector<Texture>&& textures)
     : m_Device{ device }
+    , m_Transforms{ transforms }
+    , m_Transform{ transforms.Create() }
     , m_Textures{ std::move(textures) }
+    , m_GeometryPool{ geometryPool }
 {
-    // Get vertices & indices data
+    // Warm start, the cached blobs are read from disk straight into the staging ring
+    MeshCache cache{ filePath };
+    if (cache.Open(config::VertexType::LayoutId, sizeof(config::VertexType))) {
+        m_Bounds = cache.GetBounds();
+        m_Lods = cache.GetLods();
+        m_Meshlets = cache.GetMeshlets();
+
+        // Importing the mapped cache skips the read as well, if the device supports it
+        StagingRegion vertexRegion{}, indexRegion{};
+        if (cache.ImportGeometry(uploadService, vertexRegion, indexRegion)) {
+            m_Geometry = m_GeometryPool.Upload(uploadService, sizeof(config::VertexType), vertexRegion, indexRegion);
+            return;
+        }
+
+        m_Geometry = m_GeometryPool.Upload(uploadService, cache.GetVertexCount(), sizeof(config::VertexType), cache.GetIndexCount(), vertexRegion, indexRegion);
+        AsyncFileReader reader{ 2 };
+        cache.ReadGeometry(reader, static_cast<char*>(vertexRegion.pData), static_cast<char*>(indexRegion.pData));
+        reader.Wait();
+        return;
+    }
+
+    // Cold start, get vertices & indices data and keep the result for the next launch
     std::vector<config::VertexType> vertices{};
     std::vector<uint32_t> indices{};
-    LoadModel(filePath, vertices, indices);
+    m_Bounds = LoadModel(filePath, vertices, indices, &m_Lods, &m_Meshlets);
+    cache.Write(config::VertexType::LayoutId, sizeof(config::VertexType), vertices.data(), static_cast<uint32_t>(vertices.size()), indices, m_Bounds, m_Lods, m_Meshlets);
 
-    // Store the data inside of a buffer
-    CreateVertexIndexBuffer(physicalDevice, device, std::move(commandBuffer), vertices, indices);
+    // Store the data inside of the shared geometry buffers, the copy runs once the upload service submits
+    m_Geometry = m_GeometryPool.Upload(uploadService, vertices, indices);
 }
 
 
 //-----------------------------------------------------------------
 // Destructor
 //-----------------------------------------------------------------
+Mesh::~Mesh()
+{
+    if (m_Geometry != GeometryPool::InvalidHandle) m_GeometryPool.Free(m_Geometry);
+}
 
 
 //-----------------------------------------------------------------
 // Public Member Functions
 //-----------------------------------------------------------------
-void Mesh::Update(void* modelDst) const
+void Mesh::Render(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkDescriptorSet descriptorSet, VkSampler sampler, const glm::mat4& viewProjection,
+    VkBuffer culledIndexBuffer, VkDeviceSize culledIndexOffset) const
 {
-    UpdateModelUniformBuffer(modelDst);
-}
-
-void Mesh::Render(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkDescriptorSet descriptorSet, VkSampler sampler, void* modelDst) const
-{
-    UpdateModelUniformBuffer(modelDst);
+    DrawConstants constants = CalculateDrawConstants(viewProjection);
+    vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
     UpdateDescriptorSets(descriptorSet, sampler);
-    CmdBindings(commandBuffer, layout, descriptorSet);
+    CmdBindings(commandBuffer, layout, descriptorSet, culledIndexBuffer, culledIndexOffset);
 }
 
-glm::mat4 Mesh::CalculateTransform() const
-{
-    // Create translation matrix
-    glm::mat4 matTrans = glm::translate(glm::mat4(1.0f), m_Position);
-
-    // Create rotation matrix
-    glm::mat4 matRotX = glm::rotate(glm::mat4(1.0f), glm::radians(m_Rotation.x), glm::vec3(1, 0, 0));
-    glm::mat4 matRotY = glm::rotate(glm::mat4(1.0f), glm::radians(m_Rotation.y), glm::vec3(0, 1, 0));
-    glm::mat4 matRotZ = glm::rotate(glm::mat4(1.0f), glm::radians(m_Rotation.z), glm::vec3(0, 0, 1));
-    glm::mat4 matRot = matRotZ * matRotY * matRotX;
-
-    // Ceate scaling matrix
-    glm::mat4 matScale = glm::scale(glm::mat4(1.0f), m_Scale);
-
-    // Combine into single transformation matrix and return that value
-    return matTrans * matRot * matScale;
-}
-
-void Mesh::SetPosition(float x, float y, float z)
-{
-    m_Position = { x, y, z };
-}
-void Mesh::SetRotation(float pitch, float yaw, float roll)
-{
-    m_Rotation = { pitch, yaw, roll };
-}
-void Mesh::SetScale(float sx, float sy, float sz)
+void Mesh::RenderInstanced(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkDescriptorSet descriptorSet, VkSampler sampler, uint32_t instanceCount) const
 {
-    m_Scale = { sx, sy, sz };
-}
-
+    UpdateDescriptorSets(descriptorSet, sampler);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &descriptorSet, 0, nullptr);
 
-//-----------------------------------------------------------------
-// Private Member Functions
-//-----------------------------------------------------------------
-void Mesh::UpdateModelUniformBuffer(void* modelDst) const
-{
-    glm::mat4 modelSrc = CalculateTransform();
-    memcpy(modelDst, &modelSrc, sizeof(modelSrc));
+    // One draw for all instances, vertex & index buffers are bound once by the geometry pool
+    if (m_Lod < m_Lods.size()) {
+        m_GeometryPool.CmdDraw(commandBuffer, m_Geometry, m_Lods[m_Lod].FirstIndex, m_Lods[m_Lod].IndexCount, instanceCount);
+    }
+    else {
+        m_GeometryPool.CmdDraw(commandBuffer, m_Geometry, instanceCount);
+    }
 }
 
 void Mesh::UpdateDescriptorSets(VkDescriptorSet descriptorSet, VkSampler sampler) const
 {
-    // Images info
-    std::vector<VkDescriptorImageInfo> imageInfos{ m_Textures.size() };
+    if (m_Textures.empty()) return;
+
+    // Images info, every element of the array has to be valid so packed materials repeat their last texture
+    std::vector<VkDescriptorImageInfo> imageInfos{ std::max<size_t>(m_Textures.size(), config::MATERIAL_TEXTURE_COUNT) };
     for (size_t i{ 0 }; i < imageInfos.size(); ++i)
     {
         imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        imageInfos[i].imageView = m_Textures[i].ImageView;
+        imageInfos[i].imageView = m_Textures[std::min(i, m_Textures.size() - 1)].ImageView;
         imageInfos[i].sampler = sampler;
     }
 
@@ -120,226 +243,313 @@ void Mesh::UpdateDescriptorSets(VkDescriptorSet descriptorSet, VkSampler sampler
     vkUpdateDescriptorSets(m_Device, 1, &descriptorWrite, 0, nullptr);
 }
 
-void Mesh::CmdBindings(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkDescriptorSet descriptorSet) const
+ObjectData Mesh::GetObjectData(const glm::mat4& transform, uint32_t lod, uint32_t materialIndex) const
 {
-    // Bind descriptor set
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &descriptorSet, 0, nullptr);
-
-    // Bind vertex buffer
-    std::vector<VkBuffer> vertexBuffers{ m_VertexIndexBuffer };
-    std::vector<VkDeviceSize> offsets{ 0 };
-    vkCmdBindVertexBuffers(commandBuffer, 0, static_cast<uint32_t>(vertexBuffers.size()), vertexBuffers.data(), offsets.data());
+    ObjectData object{};
+    object.model = transform;
+    object.boundingSphere = glm::vec4(m_Bounds.GetCenter(), m_Bounds.radius);
+    object.materialIndex = materialIndex;
+
+    const GeometryRange& range = m_GeometryPool.GetRange(m_Geometry);
+    object.vertexOffset = range.VertexOffset;
+    object.firstIndex = range.FirstIndex;
+    object.indexCount = range.IndexCount;
+    if (lod < m_Lods.size()) {
+        object.firstIndex += m_Lods[lod].FirstIndex;
+        object.indexCount = m_Lods[lod].IndexCount;
+    }
+    return object;
+}
 
-    // Bind index buffer
-    vkCmdBindIndexBuffer(commandBuffer, m_VertexIndexBuffer, m_IndexOffset, VK_INDEX_TYPE_UINT32);
+uint32_t Mesh::SelectLod(const glm::mat4& view, float projectionScale)
+{
+    m_Lod = CalculateLod(view * GetTransform(), projectionScale, m_Lod);
+    return m_Lod;
+}
 
-    // Bind drawing
-    vkCmdDrawIndexed(commandBuffer, m_IndexCount, 1, 0, 0, 0);
+uint32_t Mesh::CalculateLod(const glm::mat4& modelView, float projectionScale, uint32_t currentLod) const
+{
+    return CalculateLod(m_Lods, m_Bounds, modelView, projectionScale, currentLod);
 }
 
-void Mesh::LoadModel(const char* filePath, std::vector<Vertex3D>& vertices, std::vector<uint32_t>& indices)
+uint32_t Mesh::CalculateLod(const std::vector<MeshLod>& lods, const MeshBounds& bounds, const glm::mat4& modelView, float projectionScale, uint32_t currentLod)
 {
-    // Load in the data (will triangulate by default)
-    tinyobj::attrib_t attrib{};
-    std::vector<tinyobj::shape_t> shapes{};
-    std::vector<tinyobj::material_t> materials{};
-    std::string warn{}, err{};
-
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filePath)) {
-        throw std::runtime_error(warn + err);
-    }
+    if (lods.size() <= 1) return 0;
 
-    // TODO: LoadModel make temporary glm::vec vectors for attrib.vertices and attrib.texcoords
-    std::unordered_map<Vertex3D, uint32_t> uniqueVertices{};
+    // Distance to the closest point of the bounding sphere, errors grow with the largest scale of the transform
+    float scale = std::max({ glm::length(glm::vec3(modelView[0])), glm::length(glm::vec3(modelView[1])), glm::length(glm::vec3(modelView[2])) });
+    glm::vec3 center = glm::vec3(modelView * glm::vec4((bounds.min + bounds.max) * 0.5f, 1.f));
+    float radius = glm::length(bounds.max - bounds.min) * 0.5f * scale;
+    float distance = std::max(glm::length(center) - radius, 0.001f);
+    float pixelsPerUnit = projectionScale * scale / distance;
 
-    // Loop over all the OBJ shapes
-    for (const tinyobj::shape_t& shape : shapes)
+    // Coarsest level below the pixel error, levels coarser than the current one have to beat it by the hysteresis margin
+    for (uint32_t lod{ static_cast<uint32_t>(lods.size()) - 1 }; lod > 0; --lod)
     {
-        // TODO: LoadModel OBJ keep num_face_vertices in account when looping over faces
-        // Loop over all the faces
-        for (const tinyobj::index_t& index : shape.mesh.indices)
-        {
-            // Retrieve vertex data
-            Vertex3D vertex{};
-            vertex.pos = {
-                attrib.vertices[3 * index.vertex_index + 0],
-                attrib.vertices[3 * index.vertex_index + 1],
-                attrib.vertices[3 * index.vertex_index + 2]
-            };
-            vertex.texCoord = {
-                attrib.texcoords[2 * index.texcoord_index + 0],
-                1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-            };
-            vertex.color = { 1.0f, 1.0f, 1.0f };
-
-            // Add vertex with index if it doesn't exist yet
-            if (uniqueVertices.count(vertex) == 0) {
-                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-                vertices.push_back(vertex);
-            }
-
-            // Add index data to the list
-            indices.push_back(uniqueVertices[vertex]);
-        }
+        float maxPixelError = lod > currentLod ? config::LOD_PIXEL_ERROR * (1.f - config::LOD_HYSTERESIS) : config::LOD_PIXEL_ERROR;
+        if (lods[lod].Error * pixelsPerUnit <= maxPixelError) return lod;
     }
+    return 0;
 }
 
-void Mesh::LoadModel(const char* filePath, std::vector<VertexPBR>& vertices, std::vector<uint32_t>& indices)
+uint32_t Mesh::CullMeshlets(const glm::mat4& view, const glm::mat4& projection, uint32_t* pIndicesDst)
 {
-    // Load in the data (will triangulate by default)
-    tinyobj::attrib_t attrib{};
-    std::vector<tinyobj::shape_t> shapes{};
-    std::vector<tinyobj::material_t> materials{};
-    std::string warn{}, err{};
-
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filePath)) {
-        throw std::runtime_error(warn + err);
-    }
-
-    // TODO: LoadModel make temporary glm::vec vectors for attrib.vertices and attrib.texcoords
-    std::unordered_map<VertexPBR, uint32_t> uniqueVertices{};
-
-    // Loop over all the OBJ shapes
-    for (const tinyobj::shape_t& shape : shapes)
+    m_CulledIndexCount = 0;
+    m_HasCulledIndices = UsesMeshlets();
+    if (m_HasCulledIndices == false) return 0;
+
+    // Planes & camera in model space, so the bounds don't have to be transformed
+    // The cone test is exact for rotations & uniform scales, non-uniform scales bend the normals
+    const glm::mat4& transform = GetTransform();
+    Frustum frustum{ projection * view * transform };
+    glm::vec3 cameraPosition = glm::vec3(glm::inverse(view * transform)[3]);
+
+    // The surviving triangles are expanded back into indices relative to the first vertex of the mesh
+    for (const Meshlet& meshlet : m_Meshlets.Meshlets)
     {
-        // TODO: LoadModel OBJ keep num_face_vertices in account when looping over faces
-        // Loop over all the faces
-        for (const tinyobj::index_t& index : shape.mesh.indices)
-        {
-            // Retrieve vertex data
-            VertexPBR vertex{};
-            vertex.pos = {
-                attrib.vertices[3 * index.vertex_index + 0],
-                attrib.vertices[3 * index.vertex_index + 1],
-                attrib.vertices[3 * index.vertex_index + 2]
-            };
-            vertex.normal = {
-                attrib.normals[3 * index.normal_index + 0],
-                attrib.normals[3 * index.normal_index + 1],
-                attrib.normals[3 * index.normal_index + 2]
-            };
-            vertex.texCoord = {
-                attrib.texcoords[2 * index.texcoord_index + 0],
-                1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-            };
-
-            // Add vertex with index if it doesn't exist yet
-            if (uniqueVertices.count(vertex) == 0) {
-                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-                vertices.push_back(vertex);
-            }
+        if (frustum.IsSphereVisible(glm::vec3{ meshlet.Center[0], meshlet.Center[1], meshlet.Center[2] }, meshlet.Radius) == false) continue;
+        if (optimizer::IsMeshletBackFacing(meshlet, &cameraPosition.x)) continue;
 
-            // Add index data to the list
-            indices.push_back(uniqueVertices[vertex]);
+        const uint32_t* pVertices = &m_Meshlets.Vertices[meshlet.VertexOffset];
+        const uint8_t* pTriangles = &m_Meshlets.Triangles[static_cast<size_t>(meshlet.TriangleOffset) * 3];
+        for (uint32_t i{ 0 }; i < meshlet.TriangleCount * 3; ++i)
+        {
+            pIndicesDst[m_CulledIndexCount++] = pVertices[pTriangles[i]];
         }
     }
+    return m_CulledIndexCount;
+}
 
-    //Cheap Tangent Calculations
-    for (uint32_t i = 0; i < indices.size(); i += 3)
+void Mesh::UploadMeshlets(MemoryAllocator& allocator, UploadService& uploadService)
+{
+    if (m_Meshlets.Meshlets.empty()) return;
+
+    // One storage buffer for the three arrays, 256 bytes is the largest minStorageBufferOffsetAlignment allowed
+    constexpr VkDeviceSize offsetAlignment{ 256 };
+    auto alignUp = [](VkDeviceSize value) { return (value + offsetAlignment - 1) / offsetAlignment * offsetAlignment; };
+    const VkDeviceSize meshletsSize{ sizeof(Meshlet) * m_Meshlets.Meshlets.size() };
+    const VkDeviceSize verticesSize{ sizeof(uint32_t) * m_Meshlets.Vertices.size() };
+    const VkDeviceSize trianglesSize{ m_Meshlets.Triangles.size() };
+    m_MeshletBufferOffsets[0] = 0;
+    m_MeshletBufferOffsets[1] = alignUp(meshletsSize);
+    m_MeshletBufferOffsets[2] = alignUp(m_MeshletBufferOffsets[1] + verticesSize);
+    m_MeshletBufferOffsets[3] = m_MeshletBufferOffsets[2] + (trianglesSize + 3) / 4 * 4; // The shader reads the triangles as 32 bit words
+
+    m_MeshletBuffer = GP2_VkBuffer{ m_Device, m_MeshletBufferOffsets[3], VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, false };
+    m_MeshletBufferMemory = allocator.AllocateAndBind(m_MeshletBuffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    uploadService.UploadBuffer(m_MeshletBuffer, m_MeshletBufferOffsets[0], m_Meshlets.Meshlets.data(), meshletsSize, VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT, VK_ACCESS_SHADER_READ_BIT);
+    uploadService.UploadBuffer(m_MeshletBuffer, m_MeshletBufferOffsets[1], m_Meshlets.Vertices.data(), verticesSize, VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT, VK_ACCESS_SHADER_READ_BIT);
+    uploadService.UploadBuffer(m_MeshletBuffer, m_MeshletBufferOffsets[2], m_Meshlets.Triangles.data(), trianglesSize, VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT, VK_ACCESS_SHADER_READ_BIT);
+}
+
+void Mesh::UpdateMeshletDescriptorSet(VkDescriptorSet meshletDescriptorSet) const
+{
+    // Vertices of the whole pool, the push constants point the shader at the range of this mesh
+    std::array<VkDescriptorBufferInfo, 4> bufferInfos{};
+    bufferInfos[0] = { m_GeometryPool.GetVertexBuffer(), 0, VK_WHOLE_SIZE };
+    for (size_t i{ 0 }; i < 3; ++i)
     {
-        uint32_t index0 = indices[i];
-        uint32_t index1 = indices[size_t(i) + 1];
-        uint32_t index2 = indices[size_t(i) + 2];
-
-        const glm::vec3& p0 = vertices[index0].pos;
-        const glm::vec3& p1 = vertices[index1].pos;
-        const glm::vec3& p2 = vertices[index2].pos;
-        const glm::vec2& uv0 = vertices[index0].texCoord;
-        const glm::vec2& uv1 = vertices[index1].texCoord;
-        const glm::vec2& uv2 = vertices[index2].texCoord;
-
-        const glm::vec3 edge0 = p1 - p0;
-        const glm::vec3 edge1 = p2 - p0;
-        const glm::vec2 diffX = glm::vec2(uv1.x - uv0.x, uv2.x - uv0.x);
-        const glm::vec2 diffY = glm::vec2(uv1.y - uv0.y, uv2.y - uv0.y);
-        float r = 1.f / (diffX.x * diffY.y - diffX.y * diffY.x);
-
-        glm::vec3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
-        vertices[index0].tangent += tangent;
-        vertices[index1].tangent += tangent;
-        vertices[index2].tangent += tangent;
+        bufferInfos[i + 1] = { m_MeshletBuffer, m_MeshletBufferOffsets[i], m_MeshletBufferOffsets[i + 1] - m_MeshletBufferOffsets[i] };
     }
 
-    //Create the Tangents (reject)
-    for (auto& v : vertices)
+    std::array<VkWriteDescriptorSet, 4> descriptorWrites{};
+    for (uint32_t i{ 0 }; i < descriptorWrites.size(); ++i)
     {
-        v.tangent = glm::normalize(v.tangent - v.normal * (glm::dot(v.tangent, v.normal) / glm::dot(v.normal, v.normal)));
+        descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[i].dstSet = meshletDescriptorSet;
+        descriptorWrites[i].dstBinding = i;
+        descriptorWrites[i].dstArrayElement = 0;
+        descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorWrites[i].descriptorCount = 1;
+        descriptorWrites[i].pBufferInfo = &bufferInfos[i];
     }
+    vkUpdateDescriptorSets(m_Device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
 }
 
-uint32_t Mesh::FindMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties)
+void Mesh::RenderMeshlets(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkDescriptorSet descriptorSet, VkDescriptorSet meshletDescriptorSet,
+    VkSampler sampler, const glm::mat4& viewProjection, PFN_vkCmdDrawMeshTasksEXT pfnCmdDrawMeshTasks) const
 {
-    // Available types of memory
-    VkPhysicalDeviceMemoryProperties memProperties{};
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+    UpdateDescriptorSets(descriptorSet, sampler);
 
-    // Find a memory type that is suitable for the buffer
-    for (uint32_t i{ 0 }; i < memProperties.memoryTypeCount; ++i)
-    {
-        if ((typeFilter & (1 << i)) &&
-            (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
-    }
+    std::array<VkDescriptorSet, 2> descriptorSets{ descriptorSet, meshletDescriptorSet };
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
+
+    DrawConstants drawConstants = CalculateDrawConstants(viewProjection);
+    MeshletDrawConstants constants{};
+    constants.mvp = drawConstants.mvp;
+    constants.model = drawConstants.model;
+    constants.vertexOffset = static_cast<uint32_t>(m_GeometryPool.GetRange(m_Geometry).VertexOffset);
+    constants.meshletCount = static_cast<uint32_t>(m_Meshlets.Meshlets.size());
+    vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_MESH_BIT_EXT, 0, sizeof(constants), &constants);
+
+    // One workgroup per meshlet, every dimension is guaranteed to allow at least 65535 workgroups
+    constexpr uint32_t maxGroupCount{ 65535 };
+    uint32_t groupCountX = std::min(constants.meshletCount, maxGroupCount);
+    uint32_t groupCountY = (constants.meshletCount + maxGroupCount - 1) / maxGroupCount;
+    pfnCmdDrawMeshTasks(commandBuffer, groupCountX, groupCountY, 1);
+}
 
-    throw std::runtime_error("failed to find suitable memory type!");
+void Mesh::SetPosition(float x, float y, float z)
+{
+    m_Transforms.SetPosition(m_Transform, glm::vec3{ x, y, z });
+}
+void Mesh::SetRotation(float pitch, float yaw, float roll)
+{
+    // Same order the rotation matrices used to be multiplied in, Z * Y * X
+    glm::quat rotation = glm::angleAxis(glm::radians(roll), glm::vec3(0, 0, 1))
+        * glm::angleAxis(glm::radians(yaw), glm::vec3(0, 1, 0))
+        * glm::angleAxis(glm::radians(pitch), glm::vec3(1, 0, 0));
+    m_Transforms.SetRotation(m_Transform, rotation);
+}
+void Mesh::SetScale(float sx, float sy, float sz)
+{
+    m_Transforms.SetScale(m_Transform, glm::vec3{ sx, sy, sz });
 }
 
-void Mesh::CreateBuffer(VkPhysicalDevice physicalDevice, VkDevice device, GP2_VkBuffer& buffer, GP2_VkDeviceMemory& bufferMemory, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+DrawConstants Mesh::CalculateDrawConstants(const glm::mat4& viewProjection) const
 {
-    // Create buffer resource
-    buffer = std::move(GP2_VkBuffer{ device, size, usage, false });
+    // Quantized positions are moved by the offset before the model matrix, the scale stays in the shader so the normals don't pick it up
+    glm::mat4 model = GetTransform();
+    if (std::is_same_v<config::VertexType, VertexPBRQuantized>) model = model * glm::translate(glm::mat4(1.0f), m_Bounds.min);
+
+    DrawConstants constants{};
+    constants.mvp = viewProjection * model;
+    constants.model = glm::mat3x4(glm::transpose(model));
+    constants.dequantScale = glm::vec4(m_Bounds.max - m_Bounds.min, 0.f);
+    return constants;
+}
 
-    // Get buffer memory requirements
-    VkMemoryRequirements memRequirements{};
-    vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+void Mesh::CmdBindings(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkDescriptorSet descriptorSet, VkBuffer culledIndexBuffer, VkDeviceSize culledIndexOffset) const
+{
+    // Bind descriptor set
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &descriptorSet, 0, nullptr);
 
-    // Allocate buffer memory resource
-    bufferMemory = std::move(GP2_VkDeviceMemory{ device, memRequirements.size, FindMemoryType(physicalDevice, memRequirements.memoryTypeBits, properties) });
+    // Culled indices are relative to the first vertex of the mesh as well, the shared index buffer is bound again for the next meshes
+    if (culledIndexBuffer != VK_NULL_HANDLE && m_HasCulledIndices) {
+        if (m_CulledIndexCount == 0) return;
+        vkCmdBindIndexBuffer(commandBuffer, culledIndexBuffer, culledIndexOffset, VK_INDEX_TYPE_UINT32);
+        vkCmdDrawIndexed(commandBuffer, m_CulledIndexCount, 1, 0, m_GeometryPool.GetRange(m_Geometry).VertexOffset, 0);
+        m_GeometryPool.CmdBind(commandBuffer);
+        return;
+    }
 
-    // Associate memory with buffer
-    vkBindBufferMemory(device, buffer, bufferMemory, 0);
+    // Vertex & index buffers are bound once by the geometry pool
+    if (m_Lod < m_Lods.size()) {
+        m_GeometryPool.CmdDraw(commandBuffer, m_Geometry, m_Lods[m_Lod].FirstIndex, m_Lods[m_Lod].IndexCount);
+    }
+    else {
+        m_GeometryPool.CmdDraw(commandBuffer, m_Geometry);
+    }
 }
 
-VkDeviceSize Mesh::CreateStagingBuffer(VkPhysicalDevice physicalDevice, VkDevice device, GP2_VkBuffer& stagingBuffer, GP2_VkDeviceMemory& stagingBufferMemory, const std::vector<VkDeviceSize>& sizes, const std::vector<const void*>& datas)
+MeshBounds Mesh::LoadModel(const char* filePath, std::vector<Vertex3D>& vertices, std::vector<uint32_t>& indices, std::vector<MeshLod>* pLods, MeshletData* pMeshlets)
 {
-    // Exit early in case of wrong input values
-    if (sizes.size() != datas.size() || sizes.empty()) return 0;
-
-    // Calculate total buffer size
-    VkDeviceSize bufferSize = std::accumulate(sizes.begin(), sizes.end(), static_cast<VkDeviceSize>(0));
-
-    // Create staging buffer
-    CreateBuffer(
-        physicalDevice, device,
-        stagingBuffer, stagingBufferMemory,
-        bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    // Copy datas to staging buffer
-    void* dstData{};
-    VkDeviceSize offset{ 0 };
-    for (size_t i{ 0 }; i < datas.size(); ++i)
-    {
-        vkMapMemory(device, stagingBufferMemory, offset, sizes[i], 0, &dstData);
-        memcpy(dstData, datas[i], sizes[i]);
-        vkUnmapMemory(device, stagingBufferMemory);
+    std::vector<Vertex3D> corners{};
+    LoadCorners(filePath, corners);
+    DeduplicateVertices(corners, vertices, indices);
+    OptimizeMesh(vertices, indices);
+    if (pMeshlets) BuildMeshlets(vertices, indices, *pMeshlets);
+
+    MeshBounds bounds = CalculateBounds(vertices);
+    if (pLods) BuildLods(vertices, indices, bounds, *pLods);
+    return bounds;
+}
 
-        offset += sizes[i];
-    }
+MeshBounds Mesh::LoadModel(const char* filePath, std::vector<VertexPBR>& vertices, std::vector<uint32_t>& indices, std::vector<MeshLod>* pLods, MeshletData* pMeshlets)
+{
+    std::vector<VertexPBR> corners{};
+    LoadCorners(filePath, corners);
+    GenerateTangents(corners);
+    DeduplicateVertices(corners, vertices, indices);
+    OptimizeMesh(vertices, indices);
+    if (pMeshlets) BuildMeshlets(vertices, indices, *pMeshlets);
+
+    MeshBounds bounds = CalculateBounds(vertices);
+    if (pLods) BuildLods(vertices, indices, bounds, *pLods);
+    return bounds;
+}
 
-    // Return the size of the staging buffer
-    return bufferSize;
+MeshBounds Mesh::LoadModel(const char* filePath, std::vector<VertexPBRQuantized>& vertices, std::vector<uint32_t>& indices, std::vector<MeshLod>* pLods, MeshletData* pMeshlets)
+{
+    // Welding, tangents, reordering, meshlets & simplification all work on the full precision vertices
+    std::vector<VertexPBR> fullVertices{};
+    MeshBounds bounds = LoadModel(filePath, fullVertices, indices, pLods, pMeshlets);
+    quantizer::QuantizeVertices(fullVertices, bounds, vertices);
+
+    if (config::REPORT_VERTEX_QUANTIZATION) {
+        QuantizationError error = quantizer::MeasureError(fullVertices, vertices, bounds);
+        std::cout << "Vertex quantization: " << sizeof(VertexPBR) << " -> " << sizeof(VertexPBRQuantized) << " bytes per vertex"
+            << ", max errors position " << error.Position << " (extent " << glm::length(bounds.max - bounds.min) << ")"
+            << ", normal " << glm::degrees(error.Normal) << " deg"
+            << ", tangent " << glm::degrees(error.Tangent) << " deg"
+            << ", uv " << error.TexCoord << '\n';
+    }
+    return bounds;
 }
 
-void Mesh::CopyBuffer(std::unique_ptr<GP2_SingleTimeCommand> commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
+void Mesh::LoadCorners(const char* filePath, std::vector<Vertex3D>& corners)
 {
-    // Copy buffer command
-    VkBufferCopy copyRegion{};
-    copyRegion.srcOffset = 0;
-    copyRegion.dstOffset = 0;
-    copyRegion.size = size;
-    vkCmdCopyBuffer(commandBuffer->Get(), srcBuffer, dstBuffer, 1, &copyRegion);
+    // Load in the data (faces are triangulated)
+    ObjData obj = ObjParser{}.Parse(filePath);
+
+    // Loop over all the triangle corners
+    corners.resize(obj.Indices.size());
+    for (size_t i{ 0 }; i < obj.Indices.size(); ++i)
+    {
+        const ObjIndex& index = obj.Indices[i];
+
+        // Retrieve vertex data
+        Vertex3D& vertex = corners[i];
+        vertex.pos = {
+            obj.Positions[3 * index.Position + 0],
+            obj.Positions[3 * index.Position + 1],
+            obj.Positions[3 * index.Position + 2]
+        };
+        if (index.TexCoord >= 0) {
+            vertex.texCoord = {
+                obj.TexCoords[2 * index.TexCoord + 0],
+                1.0f - obj.TexCoords[2 * index.TexCoord + 1]
+            };
+        }
+        vertex.color = { 1.0f, 1.0f, 1.0f };
+    }
 }
 
+void Mesh::LoadCorners(const char* filePath, std::vector<VertexPBR>& corners)
+{
+    // Load in the data (faces are triangulated)
+    ObjData obj = ObjParser{}.Parse(filePath);
+
+    // Loop over all the triangle corners
+    corners.resize(obj.Indices.size());
+    for (size_t i{ 0 }; i < obj.Indices.size(); ++i)
+    {
+        const ObjIndex& index = obj.Indices[i];
+
+        // Retrieve vertex data
+        VertexPBR& vertex = corners[i];
+        vertex.pos = {
+            obj.Positions[3 * index.Position + 0],
+            obj.Positions[3 * index.Position + 1],
+            obj.Positions[3 * index.Position + 2]
+        };
+        if (index.Normal >= 0) {
+            vertex.normal = {
+                obj.Normals[3 * index.Normal + 0],
+                obj.Normals[3 * index.Normal + 1],
+                obj.Normals[3 * index.Normal + 2]
+            };
+        }
+        if (index.TexCoord >= 0) {
+            vertex.texCoord = {
+                obj.TexCoords[2 * index.TexCoord + 0],
+                1.0f - obj.TexCoords[2 * index.TexCoord + 1]
+            };
+        }
+    }
+}
@@ -4,15 +4,22 @@
 #include <vulkan/vulkan_core.h>
 #include <vector>
 #include <memory>
+#include <array>
+#include <algorithm>
+#include <cmath>
 #include <glm/vec3.hpp>
 #include <glm/mat4x4.hpp>
 #include "DataTypes.h"
 #include "Texture.h"
+#include "GeometryPool.h"
+#include "TransformStore.h"
+#include "UploadService.h"
+#include "MeshCache.h"
+#include "MeshletBuilder.h"
+#include "MemoryAllocator.h"
 #include "RAII/GP2_VkBuffer.h"
-#include "RAII/GP2_VkDeviceMemory.h"
 
 // Class Forward Declarations
-class GP2_SingleTimeCommand;
 
 
 // Class Declaration
@@ -20,8 +27,8 @@ class Mesh final
 {
 public:
 	// Constructors and Destructor
-	explicit Mesh(VkDevice device, VkPhysicalDevice physicalDevice, std::unique_ptr<GP2_SingleTimeCommand> commandBuffer, const char* filePath, std::vector<Texture>&& textures);
-	~Mesh() = default;
+	explicit Mesh(VkDevice device, GeometryPool& geometryPool, TransformStore& transforms, UploadService& uploadService, const char* filePath, std::vector<Texture>&& textures);
+	~Mesh();
 	
 	// Copy and Move semantics
 	Mesh(const Mesh& other)					= delete;
@@ -32,83 +39,109 @@ public:
 	//---------------------------
 	// Public Member Functions
 	//---------------------------
-	void Update(void* modelDst) const;
-	void Render(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkDescriptorSet descriptorSet, VkSampler sampler, void* modelDst) const;
-
+	// The full detail level is drawn from the culled index buffer if the meshlets were culled for this frame
+	// The transforms are pushed as DrawConstants, so the layout needs a vertex stage push constant range of that size
+	void Render(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkDescriptorSet descriptorSet, VkSampler sampler, const glm::mat4& viewProjection,
+		VkBuffer culledIndexBuffer = VK_NULL_HANDLE, VkDeviceSize culledIndexOffset = 0) const;
+	// Every instance uses the selected level of detail, the transforms come from the bound instance buffer instead of the push constants
+	void RenderInstanced(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkDescriptorSet descriptorSet, VkSampler sampler, uint32_t instanceCount) const;
+	void UpdateDescriptorSets(VkDescriptorSet descriptorSet, VkSampler sampler) const; // Writes the textures of the mesh into the set
+
+	// Entry for the GPU culling pass, the draw range is absolute inside of the geometry pool, so rebuild it after the pool is compacted
+	ObjectData GetObjectData(const glm::mat4& transform, uint32_t lod, uint32_t materialIndex = 0) const;
+
+	// Applied by the next TransformStore::Update, the rotation is in degrees, around X, then Y, then Z
 	void SetPosition(float x, float y, float z);
 	void SetRotation(float pitch, float yaw, float roll);
 	void SetScale(float sx, float sy, float sz);
 
-	glm::mat4 CalculateTransform() const;
+	const glm::mat4& GetTransform() const { return m_Transforms.GetWorld(m_Transform); } // As of the last TransformStore::Update
+	TransformStore::Handle GetTransformHandle() const { return m_Transform; }
+	const MeshBounds& GetBounds() const { return m_Bounds; }
+	GeometryPool::Handle GetGeometry() const { return m_Geometry; }
+
+	// Picks the level of detail the next recorded draws use, projectionScale turns a size at a distance of 1 into pixels
+	uint32_t SelectLod(const glm::mat4& view, float projectionScale);
+	uint32_t CalculateLod(const glm::mat4& modelView, float projectionScale, uint32_t currentLod) const;
+	static uint32_t CalculateLod(const std::vector<MeshLod>& lods, const MeshBounds& bounds, const glm::mat4& modelView, float projectionScale, uint32_t currentLod); // Straight from LoadModel, without a mesh
+	const std::vector<MeshLod>& GetLods() const { return m_Lods; }
+	uint32_t GetLod() const { return m_Lod; }
+
+	// Meshlets of the full detail level, either culled on the CPU into a compacted index list or drawn by PBR_Meshlet.mesh
+	uint32_t CullMeshlets(const glm::mat4& view, const glm::mat4& projection, uint32_t* pIndicesDst); // Returns the index count the next Render draws
+	void UploadMeshlets(MemoryAllocator& allocator, UploadService& uploadService);
+	void UpdateMeshletDescriptorSet(VkDescriptorSet meshletDescriptorSet) const; // Again after the geometry pool is compacted
+	void RenderMeshlets(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkDescriptorSet descriptorSet, VkDescriptorSet meshletDescriptorSet,
+		VkSampler sampler, const glm::mat4& viewProjection, PFN_vkCmdDrawMeshTasksEXT pfnCmdDrawMeshTasks) const;
+	bool UsesMeshlets() const { return m_Lod == 0 && m_Meshlets.Meshlets.empty() == false; }
+	const MeshletData& GetMeshlets() const { return m_Meshlets; }
+
+	// Parses the model file without going through the cache, returns the bounds of the unquantized positions
+	// The levels of detail are appended to the indices if pLods is given, the full detail indices are stored in meshlet order if pMeshlets is given
+	static MeshBounds LoadModel(const char* filePath, std::vector<Vertex3D>& vertices, std::vector<uint32_t>& indices, std::vector<MeshLod>* pLods = nullptr, MeshletData* pMeshlets = nullptr);
+	static MeshBounds LoadModel(const char* filePath, std::vector<VertexPBR>& vertices, std::vector<uint32_t>& indices, std::vector<MeshLod>* pLods = nullptr, MeshletData* pMeshlets = nullptr);
+	static MeshBounds LoadModel(const char* filePath, std::vector<VertexPBRQuantized>& vertices, std::vector<uint32_t>& indices, std::vector<MeshLod>* pLods = nullptr, MeshletData* pMeshlets = nullptr);
+	static void LoadCorners(const char* filePath, std::vector<Vertex3D>& corners); // One vertex per triangle corner, before welding
+	static void LoadCorners(const char* filePath, std::vector<VertexPBR>& corners);
+	template<typename VertexType>
+	static MeshBounds CalculateBounds(const std::vector<VertexType>& vertices);
 
 
 private:
 	// Member variables
-	glm::vec3 m_Position{ 0.f, 0.f, 0.f };
-	glm::vec3 m_Rotation{ 0.f, 0.f, 0.f };
-	glm::vec3 m_Scale{ 1.f, 1.f, 1.f };
-
 	VkDevice m_Device{ nullptr };
 
+	TransformStore& m_Transforms;
+	TransformStore::Handle m_Transform{ TransformStore::InvalidHandle };
+
 	std::vector<Texture> m_Textures{};
 
-	uint32_t m_IndexCount{};
-	VkDeviceSize m_IndexOffset{};
-	GP2_VkBuffer m_VertexIndexBuffer{};
-	GP2_VkDeviceMemory m_VertexIndexBufferMemory{};
+	GeometryPool& m_GeometryPool;
+	GeometryPool::Handle m_Geometry{ GeometryPool::InvalidHandle }; // Vertex & index ranges inside of the pool
+	MeshBounds m_Bounds{};
+	std::vector<MeshLod> m_Lods{}; // Finest first
+	uint32_t m_Lod{ 0 };
+
+	MeshletData m_Meshlets{}; // Of the full detail level
+	GP2_VkBuffer m_MeshletBuffer{}; // Meshlets, their vertices & their triangles for the mesh shader
+	MemoryAllocation m_MeshletBufferMemory{};
+	std::array<VkDeviceSize, 4> m_MeshletBufferOffsets{}; // Start of every array, the last one is the size of the buffer
+	uint32_t m_CulledIndexCount{ 0 };
+	bool m_HasCulledIndices{ false }; // CullMeshlets ran for the selected level of detail
 
 
 	//---------------------------
 	// Private Member Functions
 	//---------------------------
-	void UpdateModelUniformBuffer(void* modelDst) const;
-	void UpdateDescriptorSets(VkDescriptorSet descriptorSet, VkSampler sampler) const;
-	void CmdBindings(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkDescriptorSet descriptorSet) const;
-
-	template<typename VertexType, typename IndexType>
-	void CreateVertexIndexBuffer(VkPhysicalDevice physicalDevice, VkDevice device, std::unique_ptr<GP2_SingleTimeCommand> commandBuffer, const std::vector<VertexType>& vertices, const std::vector<IndexType>& indices);
-
-	// Init static helper functions
-	void LoadModel(const char* filePath, std::vector<Vertex3D>& vertices, std::vector<uint32_t>& indices);
-	void LoadModel(const char* filePath, std::vector<VertexPBR>& vertices, std::vector<uint32_t>& indices);
-
-	uint32_t FindMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties);
-	void CreateBuffer(VkPhysicalDevice physicalDevice, VkDevice device, GP2_VkBuffer& buffer, GP2_VkDeviceMemory& bufferMemory, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
-	VkDeviceSize CreateStagingBuffer(VkPhysicalDevice physicalDevice, VkDevice device, GP2_VkBuffer& stagingBuffer, GP2_VkDeviceMemory& stagingBufferMemory, const std::vector<VkDeviceSize>& sizes, const std::vector<const void*>& datas);
-	void CopyBuffer(std::unique_ptr<GP2_SingleTimeCommand> commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+	DrawConstants CalculateDrawConstants(const glm::mat4& viewProjection) const;
+	void CmdBindings(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkDescriptorSet descriptorSet, VkBuffer culledIndexBuffer, VkDeviceSize culledIndexOffset) const;
 
 };
 
-template<typename VertexType, typename IndexType>
-inline void Mesh::CreateVertexIndexBuffer(VkPhysicalDevice physicalDevice, VkDevice device, std::unique_ptr<GP2_SingleTimeCommand> commandBuffer, const std::vector<VertexType>& vertices, const std::vector<IndexType>& indices)
+//---------------------------
+// Template Member Functions
+//---------------------------
+template<typename VertexType>
+inline MeshBounds Mesh::CalculateBounds(const std::vector<VertexType>& vertices)
 {
-	// Calculate vertex + index buffer size
-	VkDeviceSize verticesSize{ sizeof(vertices[0]) * vertices.size() };
-	VkDeviceSize indicesSize{ sizeof(indices[0]) * indices.size() };
-	VkDeviceSize bufferSize{};
-
-	// Create staging buffer with assigned data
-	GP2_VkBuffer stagingBuffer{};
-	GP2_VkDeviceMemory stagingBufferMemory{};
-	bufferSize = CreateStagingBuffer(
-		physicalDevice, device,
-		stagingBuffer, stagingBufferMemory,
-		{ verticesSize,		indicesSize },
-		{ vertices.data(),	indices.data() });
-
-	// Create vertex index buffer
-	CreateBuffer(
-		physicalDevice, device,
-		m_VertexIndexBuffer, m_VertexIndexBufferMemory,
-		bufferSize,
-		VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-	// Transfer staging buffer to vertex index buffer
-	CopyBuffer(std::move(commandBuffer), stagingBuffer, m_VertexIndexBuffer, bufferSize);
-
-	// Set index count & offset
-	m_IndexCount = static_cast<uint32_t>(indices.size());
-	m_IndexOffset = verticesSize;
+	if (vertices.empty()) return MeshBounds{};
+
+	MeshBounds bounds{ vertices[0].pos, vertices[0].pos };
+	for (const VertexType& vertex : vertices)
+	{
+		bounds.min = glm::min(bounds.min, vertex.pos);
+		bounds.max = glm::max(bounds.max, vertex.pos);
+	}
+
+	// Tighter than half the diagonal unless vertices sit in opposite corners of the box
+	const glm::vec3 center{ bounds.GetCenter() };
+	float radiusSquared{ 0.f };
+	for (const VertexType& vertex : vertices)
+	{
+		const glm::vec3 offset{ vertex.pos - center };
+		radiusSquared = std::max(radiusSquared, offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+	}
+	bounds.radius = std::sqrt(radiusSquared);
+	return bounds;
 }
 #endif
\ No newline at end of file
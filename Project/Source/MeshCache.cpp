@@ -0,0 +1,218 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "MeshCache.h"
+#include "SourceStamp.h"
+#include "AsyncFileReader.h"
+#include "UploadService.h"
+#include <stdexcept>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+
+//-----------------------------------------------------------------
+// File Layout
+//-----------------------------------------------------------------
+namespace
+{
+	constexpr uint32_t FILE_MAGIC{ 0x4853454D }; // "MESH"
+	constexpr uint64_t BLOB_ALIGNMENT{ 16 };
+
+	// Followed by the vertex, index, meshlet, meshlet vertex & meshlet triangle blobs
+	struct FileHeader
+	{
+		uint32_t Magic{ FILE_MAGIC };
+		uint32_t Version{ MeshCache::Version };
+		uint32_t VertexLayoutId{};
+		uint32_t VertexStride{};
+
+		SourceStamp Source{}; // Of the file the cache was made from
+
+		uint32_t VertexCount{};
+		uint32_t IndexCount{};
+		uint64_t VertexOffset{};
+		uint64_t IndexOffset{};
+
+		MeshBounds Bounds{};
+
+		// Ranges inside of the index blob
+		uint32_t LodCount{};
+		MeshLod Lods[MeshCache::MaxLodCount]{};
+
+		uint32_t MeshletCount{};
+		uint32_t MeshletVertexCount{};
+		uint32_t MeshletTriangleCount{};
+		uint64_t MeshletOffset{};
+		uint64_t MeshletVertexOffset{};
+		uint64_t MeshletTriangleOffset{};
+	};
+
+	uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+MeshCache::MeshCache(const char* sourcePath)
+	: m_SourcePath{ sourcePath }
+	, m_CachePath{ std::string{ sourcePath } + ".meshcache" }
+{
+}
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+bool MeshCache::Open(uint32_t vertexLayoutId, uint32_t vertexStride)
+{
+	m_File = AssetData{};
+	m_LoosePath.clear();
+	if (vfs::Exists(m_CachePath) == false) return false;
+
+	AssetData file = vfs::Read(m_CachePath);
+	if (file.GetSize() < sizeof(FileHeader)) return false;
+
+	FileHeader header{};
+	memcpy(&header, file.GetData(), sizeof(header));
+
+	// Written by another build of the application
+	if (header.Magic != FILE_MAGIC || header.Version != Version) return false;
+	if (header.VertexLayoutId != vertexLayoutId || header.VertexStride != vertexStride) return false;
+
+	// Truncated file
+	uint64_t vertexEnd = header.VertexOffset + static_cast<uint64_t>(header.VertexCount) * header.VertexStride;
+	uint64_t indexEnd = header.IndexOffset + static_cast<uint64_t>(header.IndexCount) * sizeof(uint32_t);
+	if (vertexEnd > header.IndexOffset || indexEnd > file.GetSize()) return false;
+	if (header.LodCount > MaxLodCount) return false;
+	for (uint32_t i{ 0 }; i < header.LodCount; ++i)
+	{
+		if (static_cast<uint64_t>(header.Lods[i].FirstIndex) + header.Lods[i].IndexCount > header.IndexCount) return false;
+	}
+	uint64_t meshletEnd = header.MeshletOffset + static_cast<uint64_t>(header.MeshletCount) * sizeof(Meshlet);
+	uint64_t meshletVertexEnd = header.MeshletVertexOffset + static_cast<uint64_t>(header.MeshletVertexCount) * sizeof(uint32_t);
+	uint64_t meshletTriangleEnd = header.MeshletTriangleOffset + static_cast<uint64_t>(header.MeshletTriangleCount) * 3;
+	if (indexEnd > header.MeshletOffset || meshletEnd > header.MeshletVertexOffset
+		|| meshletVertexEnd > header.MeshletTriangleOffset || meshletTriangleEnd > file.GetSize()) return false;
+
+	if (stamps::MatchesSourceStamp(m_SourcePath, header.Source) == false) return false;
+
+	m_File = std::move(file);
+	m_LoosePath = vfs::FindLooseFile(m_CachePath);
+	m_VertexOffset = header.VertexOffset;
+	m_IndexOffset = header.IndexOffset;
+	m_VertexStride = header.VertexStride;
+	m_VertexCount = header.VertexCount;
+	m_IndexCount = header.IndexCount;
+	m_Bounds = header.Bounds;
+	m_Lods.assign(header.Lods, header.Lods + header.LodCount);
+	m_MeshletOffset = header.MeshletOffset;
+	m_MeshletVertexOffset = header.MeshletVertexOffset;
+	m_MeshletTriangleOffset = header.MeshletTriangleOffset;
+	m_MeshletCount = header.MeshletCount;
+	m_MeshletVertexCount = header.MeshletVertexCount;
+	m_MeshletTriangleCount = header.MeshletTriangleCount;
+	return true;
+}
+
+MeshletData MeshCache::GetMeshlets() const
+{
+	MeshletData meshlets{};
+	meshlets.Meshlets.resize(m_MeshletCount);
+	meshlets.Vertices.resize(m_MeshletVertexCount);
+	meshlets.Triangles.resize(static_cast<size_t>(m_MeshletTriangleCount) * 3);
+
+	// Culling keeps using them after the cache file is closed
+	memcpy(meshlets.Meshlets.data(), m_File.GetData() + m_MeshletOffset, meshlets.Meshlets.size() * sizeof(Meshlet));
+	memcpy(meshlets.Vertices.data(), m_File.GetData() + m_MeshletVertexOffset, meshlets.Vertices.size() * sizeof(uint32_t));
+	memcpy(meshlets.Triangles.data(), m_File.GetData() + m_MeshletTriangleOffset, meshlets.Triangles.size());
+	return meshlets;
+}
+
+void MeshCache::ReadGeometry(AsyncFileReader& reader, char* pVertices, char* pIndices) const
+{
+	const size_t verticesSize{ static_cast<size_t>(m_VertexCount) * m_VertexStride };
+	const size_t indicesSize{ static_cast<size_t>(m_IndexCount) * sizeof(uint32_t) };
+	if (m_LoosePath.empty()) {
+		memcpy(pVertices, GetVertices(), verticesSize);
+		memcpy(pIndices, GetIndices(), indicesSize);
+		return;
+	}
+	reader.ReadRangeInto(m_LoosePath.c_str(), m_VertexOffset, verticesSize, pVertices, nullptr);
+	reader.ReadRangeInto(m_LoosePath.c_str(), m_IndexOffset, indicesSize, pIndices, nullptr);
+}
+
+bool MeshCache::ImportGeometry(UploadService& uploadService, StagingRegion& vertexRegion, StagingRegion& indexRegion) const
+{
+	if (m_LoosePath.empty()) return false;
+
+	// One import for both blobs, the indices follow the vertices
+	const VkDeviceSize verticesSize{ static_cast<VkDeviceSize>(m_VertexCount) * m_VertexStride };
+	const VkDeviceSize indicesSize{ static_cast<VkDeviceSize>(m_IndexCount) * sizeof(uint32_t) };
+	StagingRegion region = uploadService.ImportFile(m_LoosePath.c_str(), m_VertexOffset, m_IndexOffset + indicesSize - m_VertexOffset);
+	if (region.Buffer == VK_NULL_HANDLE) return false;
+
+	vertexRegion = StagingRegion{ region.Buffer, region.Offset, verticesSize, nullptr };
+	indexRegion = StagingRegion{ region.Buffer, region.Offset + (m_IndexOffset - m_VertexOffset), indicesSize, nullptr };
+	return true;
+}
+
+bool MeshCache::Write(uint32_t vertexLayoutId, uint32_t vertexStride, const void* pVertices, uint32_t vertexCount, const std::vector<uint32_t>& indices, const MeshBounds& bounds,
+	const std::vector<MeshLod>& lods, const MeshletData& meshlets) const
+{
+	if (lods.size() > MaxLodCount) return false;
+
+	FileHeader header{};
+	header.VertexLayoutId = vertexLayoutId;
+	header.VertexStride = vertexStride;
+	if (stamps::ReadSourceStamp(m_SourcePath, header.Source) == false) return false;
+
+	header.VertexCount = vertexCount;
+	header.IndexCount = static_cast<uint32_t>(indices.size());
+	header.VertexOffset = AlignUp(sizeof(FileHeader), BLOB_ALIGNMENT);
+	header.IndexOffset = AlignUp(header.VertexOffset + static_cast<uint64_t>(vertexCount) * vertexStride, BLOB_ALIGNMENT);
+	header.Bounds = bounds;
+	header.LodCount = static_cast<uint32_t>(lods.size());
+	std::copy(lods.begin(), lods.end(), header.Lods);
+
+	header.MeshletCount = static_cast<uint32_t>(meshlets.Meshlets.size());
+	header.MeshletVertexCount = static_cast<uint32_t>(meshlets.Vertices.size());
+	header.MeshletTriangleCount = static_cast<uint32_t>(meshlets.Triangles.size() / 3);
+	header.MeshletOffset = AlignUp(header.IndexOffset + indices.size() * sizeof(uint32_t), BLOB_ALIGNMENT);
+	header.MeshletVertexOffset = AlignUp(header.MeshletOffset + meshlets.Meshlets.size() * sizeof(Meshlet), BLOB_ALIGNMENT);
+	header.MeshletTriangleOffset = AlignUp(header.MeshletVertexOffset + meshlets.Vertices.size() * sizeof(uint32_t), BLOB_ALIGNMENT);
+
+	// Write to a temporary file first so a crash never leaves a half written cache behind
+	std::string tempPath{ m_CachePath + ".tmp" };
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) return false;
+
+		const char padding[BLOB_ALIGNMENT]{};
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(padding, header.VertexOffset - sizeof(header));
+		file.write(static_cast<const char*>(pVertices), static_cast<std::streamsize>(vertexCount) * vertexStride);
+		file.write(padding, header.IndexOffset - (header.VertexOffset + static_cast<uint64_t>(vertexCount) * vertexStride));
+		file.write(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(uint32_t));
+		file.write(padding, header.MeshletOffset - (header.IndexOffset + indices.size() * sizeof(uint32_t)));
+		file.write(reinterpret_cast<const char*>(meshlets.Meshlets.data()), meshlets.Meshlets.size() * sizeof(Meshlet));
+		file.write(padding, header.MeshletVertexOffset - (header.MeshletOffset + meshlets.Meshlets.size() * sizeof(Meshlet)));
+		file.write(reinterpret_cast<const char*>(meshlets.Vertices.data()), meshlets.Vertices.size() * sizeof(uint32_t));
+		file.write(padding, header.MeshletTriangleOffset - (header.MeshletVertexOffset + meshlets.Vertices.size() * sizeof(uint32_t)));
+		file.write(reinterpret_cast<const char*>(meshlets.Triangles.data()), meshlets.Triangles.size());
+		if (!file.good()) return false;
+	}
+
+	std::error_code error{};
+	std::filesystem::rename(tempPath, m_CachePath, error);
+	if (error) {
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+	return true;
+}
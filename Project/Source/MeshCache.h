@@ -0,0 +1,86 @@
+#ifndef GP2VKT_MESHCACHE_H_
+#define GP2VKT_MESHCACHE_H_
+// Includes
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "DataTypes.h"
+#include "VirtualFileSystem.h"
+#include "MeshletBuilder.h"
+
+// Class Forward Declarations
+class AsyncFileReader;
+class UploadService;
+struct StagingRegion;
+
+
+// Binary copy of the processed vertices & indices of a model file, stored next to it
+// Warm loads map the cache and hand the blobs to the GPU without touching a single vertex
+class MeshCache final
+{
+public:
+	static constexpr uint32_t Version{ 7 }; // Bump when the file layout or the mesh processing changes
+	static constexpr uint32_t MaxLodCount{ 8 };
+
+	// Constructors and Destructor
+	explicit MeshCache(const char* sourcePath);
+	~MeshCache() = default;
+
+	// Copy and Move semantics
+	MeshCache(const MeshCache& other)					= delete;
+	MeshCache& operator=(const MeshCache& other)		= delete;
+	MeshCache(MeshCache&& other) noexcept				= default;
+	MeshCache& operator=(MeshCache&& other) noexcept	= default;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	// False if there is no cache or it belongs to another version of the source or vertex layout
+	bool Open(uint32_t vertexLayoutId, uint32_t vertexStride);
+	bool Write(uint32_t vertexLayoutId, uint32_t vertexStride, const void* pVertices, uint32_t vertexCount, const std::vector<uint32_t>& indices, const MeshBounds& bounds,
+		const std::vector<MeshLod>& lods, const MeshletData& meshlets) const; // False if the cache couldn't be written
+
+	// Only valid after a successful Open
+	const void* GetVertices() const { return m_File.GetData() + m_VertexOffset; }
+	uint32_t GetVertexCount() const { return m_VertexCount; }
+	const uint32_t* GetIndices() const { return reinterpret_cast<const uint32_t*>(m_File.GetData() + m_IndexOffset); }
+	uint32_t GetIndexCount() const { return m_IndexCount; }
+	const MeshBounds& GetBounds() const { return m_Bounds; }
+	const std::vector<MeshLod>& GetLods() const { return m_Lods; }
+	MeshletData GetMeshlets() const;
+	// Same bytes as GetVertices & GetIndices, loose caches are read straight into the destinations without paging in the mapping, done once the reader has waited
+	void ReadGeometry(AsyncFileReader& reader, char* pVertices, char* pIndices) const;
+	// Loose caches are imported as a transfer source, false if that isn't possible, see StagingRing::ImportFile
+	bool ImportGeometry(UploadService& uploadService, StagingRegion& vertexRegion, StagingRegion& indexRegion) const;
+
+	const std::string& GetCachePath() const { return m_CachePath; }
+
+
+private:
+	// Member variables
+	std::string m_SourcePath{};
+	std::string m_CachePath{};
+	AssetData m_File{}; // Loose or from an asset pack
+	std::string m_LoosePath{}; // Empty if the cache is read from an asset pack
+
+	// Copied from the header of the mapped file
+	uint64_t m_VertexOffset{};
+	uint64_t m_IndexOffset{};
+	uint32_t m_VertexStride{};
+	uint32_t m_VertexCount{};
+	uint32_t m_IndexCount{};
+	MeshBounds m_Bounds{};
+	std::vector<MeshLod> m_Lods{};
+	uint64_t m_MeshletOffset{};
+	uint64_t m_MeshletVertexOffset{};
+	uint64_t m_MeshletTriangleOffset{};
+	uint32_t m_MeshletCount{};
+	uint32_t m_MeshletVertexCount{};
+	uint32_t m_MeshletTriangleCount{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+
+};
+#endif
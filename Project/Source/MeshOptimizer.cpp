@@ -0,0 +1,272 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "MeshOptimizer.h"
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	constexpr uint32_t INVALID_INDEX{ UINT32_MAX };
+
+	// FIFO cache as found on most GPUs, a hit doesn't move the vertex to the front
+	class FifoCache final
+	{
+	public:
+		FifoCache(size_t vertexCount, uint32_t cacheSize)
+			: m_Timestamps(vertexCount, 0)
+			, m_CacheSize{ cacheSize }
+		{
+		}
+
+		bool Access(uint32_t vertex) // True on a miss
+		{
+			if (m_Timestamps[vertex] != 0 && m_Time - m_Timestamps[vertex] < m_CacheSize) return false;
+
+			m_Timestamps[vertex] = ++m_Time;
+			return true;
+		}
+		void Clear()
+		{
+			m_Time += m_CacheSize;
+		}
+
+	private:
+		std::vector<uint32_t> m_Timestamps{};
+		uint32_t m_Time{ 0 };
+		uint32_t m_CacheSize{};
+	};
+
+	struct Float3
+	{
+		float X{}, Y{}, Z{};
+	};
+	Float3 GetPosition(const float* pPositions, size_t positionStride, uint32_t vertex)
+	{
+		const float* pPosition = reinterpret_cast<const float*>(reinterpret_cast<const char*>(pPositions) + vertex * positionStride);
+		return Float3{ pPosition[0], pPosition[1], pPosition[2] };
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Functions
+//-----------------------------------------------------------------
+VertexCacheStats optimizer::AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize)
+{
+	if (indices.empty()) return VertexCacheStats{};
+
+	FifoCache cache{ vertexCount, cacheSize };
+	std::vector<bool> isUsed(vertexCount, false);
+	size_t missCount{ 0 }, usedCount{ 0 };
+	for (uint32_t index : indices)
+	{
+		missCount += cache.Access(index);
+		if (isUsed[index] == false) {
+			isUsed[index] = true;
+			++usedCount;
+		}
+	}
+
+	VertexCacheStats stats{};
+	stats.ACMR = static_cast<float>(missCount) / (indices.size() / 3);
+	stats.ATVR = static_cast<float>(missCount) / usedCount;
+	return stats;
+}
+
+std::vector<uint32_t> optimizer::OptimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize)
+{
+	// Exit early in case of wrong input values
+	if (indices.size() % 3 != 0) {
+		throw std::invalid_argument("index count isn't a multiple of 3!");
+	}
+	const size_t triangleCount{ indices.size() / 3 };
+
+	// Triangles that use every vertex, stored back to back
+	std::vector<uint32_t> liveTriangles(vertexCount, 0);
+	for (uint32_t index : indices) ++liveTriangles[index];
+
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+	std::partial_sum(liveTriangles.begin(), liveTriangles.end(), adjacencyOffsets.begin() + 1);
+	std::vector<uint32_t> adjacency(indices.size());
+	std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (size_t i{ 0 }; i < indices.size(); ++i)
+	{
+		adjacency[adjacencyFill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+	}
+
+	std::vector<uint32_t> cacheTimes(vertexCount, 0);
+	std::vector<bool> isEmitted(triangleCount, false);
+	std::vector<uint32_t> deadEnds{};
+	std::vector<uint32_t> candidates{};
+	std::vector<uint32_t> result{};
+	result.reserve(indices.size());
+
+	uint32_t time{ cacheSize + 1 };
+	uint32_t scanCursor{ 0 };
+	uint32_t fanVertex{ 0 };
+	while (fanVertex != INVALID_INDEX)
+	{
+		// Emit every remaining triangle around the fanning vertex
+		candidates.clear();
+		for (uint32_t i{ adjacencyOffsets[fanVertex] }; i < adjacencyOffsets[fanVertex + 1]; ++i)
+		{
+			uint32_t triangle = adjacency[i];
+			if (isEmitted[triangle]) continue;
+
+			for (uint32_t corner{ 0 }; corner < 3; ++corner)
+			{
+				uint32_t vertex = indices[3 * triangle + corner];
+				result.push_back(vertex);
+				deadEnds.push_back(vertex);
+				candidates.push_back(vertex);
+				--liveTriangles[vertex];
+
+				if (time - cacheTimes[vertex] > cacheSize) cacheTimes[vertex] = time++;
+			}
+			isEmitted[triangle] = true;
+		}
+
+		// Continue with the candidate that is in the cache the longest & still will be after its fan
+		uint32_t nextVertex{ INVALID_INDEX };
+		int64_t bestPriority{ -1 };
+		for (uint32_t vertex : candidates)
+		{
+			if (liveTriangles[vertex] == 0) continue;
+
+			int64_t priority{ 0 };
+			if (time - cacheTimes[vertex] + 2 * liveTriangles[vertex] <= cacheSize) priority = time - cacheTimes[vertex];
+			if (priority > bestPriority) {
+				bestPriority = priority;
+				nextVertex = vertex;
+			}
+		}
+
+		// Dead end, go back to a recently used vertex or scan for any vertex with triangles left
+		if (nextVertex == INVALID_INDEX) {
+			while (deadEnds.empty() == false && nextVertex == INVALID_INDEX)
+			{
+				if (liveTriangles[deadEnds.back()] > 0) nextVertex = deadEnds.back();
+				deadEnds.pop_back();
+			}
+			while (nextVertex == INVALID_INDEX && scanCursor < vertexCount)
+			{
+				if (liveTriangles[scanCursor] > 0) nextVertex = scanCursor;
+				++scanCursor;
+			}
+		}
+		fanVertex = nextVertex;
+	}
+	return result;
+}
+
+std::vector<uint32_t> optimizer::OptimizeOverdraw(const std::vector<uint32_t>& indices, const float* pPositions, size_t positionStride, size_t vertexCount, uint32_t cacheSize, float threshold)
+{
+	const size_t triangleCount{ indices.size() / 3 };
+	if (triangleCount == 0) return indices;
+
+	// Close a cluster as soon as it's as cache efficient on its own as the threshold allows, it can then be drawn in any order
+	float maxAcmr = AnalyzeVertexCache(indices, vertexCount, cacheSize).ACMR * threshold;
+	FifoCache cache{ vertexCount, cacheSize };
+	std::vector<uint32_t> splitClusters{ 0 };
+	size_t missCount{ 0 };
+	size_t clusterBegin{ 0 };
+	for (size_t triangle{ 0 }; triangle < triangleCount; ++triangle)
+	{
+		for (size_t corner{ 0 }; corner < 3; ++corner) missCount += cache.Access(indices[3 * triangle + corner]);
+
+		size_t clusterSize = triangle + 1 - clusterBegin;
+		if (triangle + 1 < triangleCount && static_cast<float>(missCount) / clusterSize <= maxAcmr) {
+			clusterBegin = triangle + 1;
+			missCount = 0;
+			cache.Clear();
+			splitClusters.push_back(static_cast<uint32_t>(clusterBegin));
+		}
+	}
+
+	// The leftover triangles at the end didn't get efficient enough on their own, keep them with the previous cluster
+	if (clusterBegin != 0 && static_cast<float>(missCount) / (triangleCount - clusterBegin) > maxAcmr) splitClusters.pop_back();
+
+	// Centroid of the whole mesh, area weighted
+	struct ClusterInfo
+	{
+		uint32_t Begin{};
+		uint32_t End{};
+		float SortKey{};
+	};
+	std::vector<ClusterInfo> clusterInfos(splitClusters.size());
+	double meshCenter[3]{}, meshArea{ 0.0 };
+	std::vector<double> clusterCenters(splitClusters.size() * 3, 0.0), clusterNormals(splitClusters.size() * 3, 0.0), clusterAreas(splitClusters.size(), 0.0);
+	for (size_t cluster{ 0 }; cluster < splitClusters.size(); ++cluster)
+	{
+		clusterInfos[cluster].Begin = splitClusters[cluster];
+		clusterInfos[cluster].End = cluster + 1 < splitClusters.size() ? splitClusters[cluster + 1] : static_cast<uint32_t>(triangleCount);
+
+		for (uint32_t triangle{ clusterInfos[cluster].Begin }; triangle < clusterInfos[cluster].End; ++triangle)
+		{
+			Float3 p0 = GetPosition(pPositions, positionStride, indices[3 * triangle + 0]);
+			Float3 p1 = GetPosition(pPositions, positionStride, indices[3 * triangle + 1]);
+			Float3 p2 = GetPosition(pPositions, positionStride, indices[3 * triangle + 2]);
+
+			// Cross product is twice the area in the direction of the face normal
+			double e0[3]{ p1.X - p0.X, p1.Y - p0.Y, p1.Z - p0.Z };
+			double e1[3]{ p2.X - p0.X, p2.Y - p0.Y, p2.Z - p0.Z };
+			double normal[3]{ e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0] };
+			double area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			double center[3]{ (p0.X + p1.X + p2.X) / 3.0, (p0.Y + p1.Y + p2.Y) / 3.0, (p0.Z + p1.Z + p2.Z) / 3.0 };
+
+			for (int axis{ 0 }; axis < 3; ++axis)
+			{
+				clusterCenters[cluster * 3 + axis] += center[axis] * area;
+				clusterNormals[cluster * 3 + axis] += normal[axis];
+				meshCenter[axis] += center[axis] * area;
+			}
+			clusterAreas[cluster] += area;
+			meshArea += area;
+		}
+	}
+	for (double& axis : meshCenter) axis = meshArea > 0.0 ? axis / meshArea : 0.0;
+
+	// Clusters far out along their own normal are likely to occlude the rest of the mesh
+	for (size_t cluster{ 0 }; cluster < clusterInfos.size(); ++cluster)
+	{
+		double sortKey{ 0.0 };
+		if (clusterAreas[cluster] > 0.0) {
+			for (int axis{ 0 }; axis < 3; ++axis)
+			{
+				sortKey += (clusterCenters[cluster * 3 + axis] / clusterAreas[cluster] - meshCenter[axis]) * clusterNormals[cluster * 3 + axis];
+			}
+		}
+		clusterInfos[cluster].SortKey = static_cast<float>(sortKey);
+	}
+	std::stable_sort(clusterInfos.begin(), clusterInfos.end(), [](const ClusterInfo& a, const ClusterInfo& b) { return a.SortKey > b.SortKey; });
+
+	std::vector<uint32_t> result{};
+	result.reserve(indices.size());
+	for (const ClusterInfo& cluster : clusterInfos)
+	{
+		result.insert(result.end(), indices.begin() + 3 * cluster.Begin, indices.begin() + 3 * cluster.End);
+	}
+	return result;
+}
+
+std::vector<uint32_t> optimizer::BuildVertexFetchRemap(const std::vector<uint32_t>& indices, size_t vertexCount)
+{
+	std::vector<uint32_t> remap(vertexCount, INVALID_INDEX);
+	uint32_t nextVertex{ 0 };
+	for (uint32_t index : indices)
+	{
+		if (remap[index] == INVALID_INDEX) remap[index] = nextVertex++;
+	}
+	for (uint32_t& location : remap)
+	{
+		if (location == INVALID_INDEX) location = nextVertex++;
+	}
+	return remap;
+}
@@ -0,0 +1,58 @@
+#ifndef GP2VKT_MESHOPTIMIZER_H_
+#define GP2VKT_MESHOPTIMIZER_H_
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+// Class Forward Declarations
+
+
+// Post-transform vertex cache efficiency of an index buffer, simulated with a FIFO cache
+struct VertexCacheStats
+{
+	float ACMR{}; // Average cache miss ratio, transformed vertices per triangle (0.5 - 3, lower is better)
+	float ATVR{}; // Average transform to vertex ratio, transformed vertices per unique vertex (1 is optimal)
+};
+
+
+// Reorders indexed triangle lists for the GPU, all functions run on the CPU
+namespace optimizer
+{
+	VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize);
+
+	// Tipsify (Sander et al. 2007), fans around the vertex that stays in the cache the longest
+	std::vector<uint32_t> OptimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize);
+
+	// Expects cache optimized indices, splits them into clusters with an ACMR below threshold * ACMR of the whole mesh,
+	// then draws the clusters facing away from the center of the mesh first so they occlude the rest (Sander et al. 2007)
+	std::vector<uint32_t> OptimizeOverdraw(const std::vector<uint32_t>& indices, const float* pPositions, size_t positionStride, size_t vertexCount, uint32_t cacheSize, float threshold);
+
+	// New location of every vertex so they are stored in the order they are first used, unused vertices end up at the back
+	std::vector<uint32_t> BuildVertexFetchRemap(const std::vector<uint32_t>& indices, size_t vertexCount);
+
+	template<typename VertexType>
+	void OptimizeVertexFetch(std::vector<VertexType>& vertices, std::vector<uint32_t>& indices);
+}
+
+//---------------------------
+// Template Functions
+//---------------------------
+template<typename VertexType>
+inline void optimizer::OptimizeVertexFetch(std::vector<VertexType>& vertices, std::vector<uint32_t>& indices)
+{
+	std::vector<uint32_t> remap = BuildVertexFetchRemap(indices, vertices.size());
+
+	std::vector<VertexType> remappedVertices(vertices.size());
+	for (size_t i{ 0 }; i < vertices.size(); ++i)
+	{
+		remappedVertices[remap[i]] = vertices[i];
+	}
+	for (uint32_t& index : indices)
+	{
+		index = remap[index];
+	}
+	vertices = std::move(remappedVertices);
+}
+#endif
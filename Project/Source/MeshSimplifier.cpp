@@ -0,0 +1,329 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "MeshSimplifier.h"
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cfloat>
+#include "VertexDeduplicator.h"
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	struct Position
+	{
+		float X{}, Y{}, Z{};
+	};
+	Position GetPosition(const float* pPositions, size_t positionStride, uint32_t vertex)
+	{
+		const float* pPosition = reinterpret_cast<const float*>(reinterpret_cast<const char*>(pPositions) + vertex * positionStride);
+		return Position{ pPosition[0], pPosition[1], pPosition[2] };
+	}
+
+	// Sum of squared distances to a set of planes, weighted by the area the planes came from
+	struct Quadric
+	{
+		double A2{}, B2{}, C2{}, AB{}, AC{}, BC{}, AD{}, BD{}, CD{}, D2{};
+		double Weight{};
+
+		void AddPlane(double a, double b, double c, double d, double weight)
+		{
+			A2 += weight * a * a; B2 += weight * b * b; C2 += weight * c * c;
+			AB += weight * a * b; AC += weight * a * c; BC += weight * b * c;
+			AD += weight * a * d; BD += weight * b * d; CD += weight * c * d;
+			D2 += weight * d * d;
+			Weight += weight;
+		}
+		Quadric& operator+=(const Quadric& other)
+		{
+			A2 += other.A2; B2 += other.B2; C2 += other.C2;
+			AB += other.AB; AC += other.AC; BC += other.BC;
+			AD += other.AD; BD += other.BD; CD += other.CD;
+			D2 += other.D2;
+			Weight += other.Weight;
+			return *this;
+		}
+		double Evaluate(const Position& p) const // Squared distance, averaged over the weight
+		{
+			double x{ p.X }, y{ p.Y }, z{ p.Z };
+			double error = A2 * x * x + B2 * y * y + C2 * z * z + 2.0 * (AB * x * y + AC * x * z + BC * y * z + AD * x + BD * y + CD * z) + D2;
+			return Weight > 0.0 ? std::max(error, 0.0) / Weight : 0.0;
+		}
+	};
+
+	enum class VertexKind : uint8_t
+	{
+		Manifold, // Can collapse onto any neighbour
+		Border, // On an open border or attribute seam, can only collapse along it
+		Locked // Where borders & seams meet, or on non-manifold geometry
+	};
+
+	struct Collapse
+	{
+		uint32_t From{};
+		uint32_t To{};
+		float Cost{};
+	};
+
+	uint64_t MakeEdgeKey(uint32_t a, uint32_t b)
+	{
+		return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+	}
+
+	void CalculateNormal(const Position& p0, const Position& p1, const Position& p2, double normal[3])
+	{
+		double e0[3]{ p1.X - p0.X, p1.Y - p0.Y, p1.Z - p0.Z };
+		double e1[3]{ p2.X - p0.X, p2.Y - p0.Y, p2.Z - p0.Z };
+		normal[0] = e0[1] * e1[2] - e0[2] * e1[1];
+		normal[1] = e0[2] * e1[0] - e0[0] * e1[2];
+		normal[2] = e0[0] * e1[1] - e0[1] * e1[0];
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Functions
+//-----------------------------------------------------------------
+std::vector<uint32_t> optimizer::Simplify(const std::vector<uint32_t>& indices, const float* pPositions, size_t positionStride, size_t vertexCount,
+	size_t targetIndexCount, float targetError, float* pResultError)
+{
+	// Exit early in case of wrong input values
+	if (indices.size() % 3 != 0) {
+		throw std::invalid_argument("index count isn't a multiple of 3!");
+	}
+	if (pResultError) *pResultError = 0.f;
+	if (indices.size() <= targetIndexCount) return indices;
+
+	// Vertices that only differ in their attributes share a position, the topology is built on positions
+	std::vector<uint32_t> positionIds(vertexCount);
+	std::vector<Position> positions{};
+	{
+		VertexDeduplicator<Position> deduplicator{ vertexCount };
+		for (uint32_t vertex{ 0 }; vertex < vertexCount; ++vertex)
+		{
+			positionIds[vertex] = deduplicator.FindOrInsert(GetPosition(pPositions, positionStride, vertex));
+		}
+		positions = std::move(deduplicator.GetVertices());
+	}
+
+	// Border edges have one triangle, seam edges have two that don't agree on the vertices, more than two is non-manifold
+	struct Edge
+	{
+		uint64_t Key{};
+		uint32_t VertexA{}; // Vertex at the lower position id
+		uint32_t VertexB{};
+	};
+	std::vector<Edge> edges{};
+	edges.reserve(indices.size());
+	for (size_t i{ 0 }; i < indices.size(); i += 3)
+	{
+		for (size_t corner{ 0 }; corner < 3; ++corner)
+		{
+			uint32_t a = indices[i + corner], b = indices[i + (corner + 1) % 3];
+			if (positionIds[a] > positionIds[b]) std::swap(a, b);
+			edges.push_back(Edge{ MakeEdgeKey(positionIds[a], positionIds[b]), a, b });
+		}
+	}
+	std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return a.Key < b.Key; });
+
+	std::vector<uint64_t> constrainedEdges{};
+	std::vector<uint8_t> constrainedEdgeCounts(positions.size(), 0);
+	std::vector<bool> isNonManifold(positions.size(), false);
+	for (size_t begin{ 0 }, end{ 0 }; begin < edges.size(); begin = end)
+	{
+		end = begin + 1;
+		while (end < edges.size() && edges[end].Key == edges[begin].Key) ++end;
+
+		uint32_t a = static_cast<uint32_t>(edges[begin].Key >> 32), b = static_cast<uint32_t>(edges[begin].Key & 0xFFFFFFFF);
+		if (end - begin > 2) {
+			isNonManifold[a] = isNonManifold[b] = true;
+			continue;
+		}
+		bool isSeam = end - begin == 2 && (edges[begin].VertexA != edges[begin + 1].VertexA || edges[begin].VertexB != edges[begin + 1].VertexB);
+		if (end - begin == 1 || isSeam) {
+			constrainedEdges.push_back(edges[begin].Key);
+			++constrainedEdgeCounts[a];
+			++constrainedEdgeCounts[b];
+		}
+	}
+
+	// Vertices on a single border or seam line slide along it, where lines meet or split the vertex stays in place
+	std::vector<VertexKind> kinds(positions.size(), VertexKind::Manifold);
+	for (size_t position{ 0 }; position < positions.size(); ++position)
+	{
+		if (isNonManifold[position] || (constrainedEdgeCounts[position] != 0 && constrainedEdgeCounts[position] != 2)) kinds[position] = VertexKind::Locked;
+		else if (constrainedEdgeCounts[position] == 2) kinds[position] = VertexKind::Border;
+	}
+
+	// Plane of every triangle, plus a plane through every border & seam edge perpendicular to its triangle so those lines keep their shape
+	constexpr double BORDER_WEIGHT{ 10.0 };
+	std::vector<Quadric> quadrics(positions.size());
+	for (size_t i{ 0 }; i < indices.size(); i += 3)
+	{
+		uint32_t ids[3]{ positionIds[indices[i]], positionIds[indices[i + 1]], positionIds[indices[i + 2]] };
+		double normal[3]{};
+		CalculateNormal(positions[ids[0]], positions[ids[1]], positions[ids[2]], normal);
+		double area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		if (area <= 0.0) continue;
+		for (double& axis : normal) axis /= area;
+
+		const Position& p0 = positions[ids[0]];
+		double d = -(normal[0] * p0.X + normal[1] * p0.Y + normal[2] * p0.Z);
+		for (uint32_t id : ids) quadrics[id].AddPlane(normal[0], normal[1], normal[2], d, area * 0.5);
+
+		for (size_t corner{ 0 }; corner < 3; ++corner)
+		{
+			uint32_t a = ids[corner], b = ids[(corner + 1) % 3];
+			if (std::binary_search(constrainedEdges.begin(), constrainedEdges.end(), MakeEdgeKey(a, b)) == false) continue;
+
+			double edge[3]{ positions[b].X - positions[a].X, positions[b].Y - positions[a].Y, positions[b].Z - positions[a].Z };
+			double edgeNormal[3]{ edge[1] * normal[2] - edge[2] * normal[1], edge[2] * normal[0] - edge[0] * normal[2], edge[0] * normal[1] - edge[1] * normal[0] };
+			double length = std::sqrt(edgeNormal[0] * edgeNormal[0] + edgeNormal[1] * edgeNormal[1] + edgeNormal[2] * edgeNormal[2]);
+			if (length <= 0.0) continue;
+			for (double& axis : edgeNormal) axis /= length;
+
+			double edgeD = -(edgeNormal[0] * positions[a].X + edgeNormal[1] * positions[a].Y + edgeNormal[2] * positions[a].Z);
+			quadrics[a].AddPlane(edgeNormal[0], edgeNormal[1], edgeNormal[2], edgeD, length * BORDER_WEIGHT);
+			quadrics[b].AddPlane(edgeNormal[0], edgeNormal[1], edgeNormal[2], edgeD, length * BORDER_WEIGHT);
+		}
+	}
+
+	// Every pass collapses a set of independent edges, cheapest first
+	// Collapses work on positions, every vertex at the collapsed position moves to the vertex at the other end of its edge
+	const double maxCost{ static_cast<double>(targetError) * targetError };
+	double resultCost{ 0.0 };
+	std::vector<uint32_t> result{ indices };
+	std::vector<uint32_t> adjacencyOffsets(positions.size() + 1), adjacency{}, collapseTargets(vertexCount);
+	std::vector<Collapse> collapses{};
+	std::vector<std::pair<uint32_t, uint32_t>> moves{};
+	std::vector<bool> isLocked(positions.size());
+	while (result.size() > targetIndexCount)
+	{
+		// Triangles around every position
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+		for (uint32_t index : result) ++adjacencyOffsets[positionIds[index] + 1];
+		std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+		adjacency.resize(result.size());
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i{ 0 }; i < result.size(); ++i) adjacency[fill[positionIds[result[i]]]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		// Both directions of every edge the vertex kinds allow
+		collapses.clear();
+		for (size_t i{ 0 }; i < result.size(); i += 3)
+		{
+			for (size_t corner{ 0 }; corner < 3; ++corner)
+			{
+				uint32_t a = positionIds[result[i + corner]], b = positionIds[result[i + (corner + 1) % 3]];
+				bool isConstrainedEdge = std::binary_search(constrainedEdges.begin(), constrainedEdges.end(), MakeEdgeKey(a, b));
+
+				for (auto [from, to] : { std::pair{ a, b }, std::pair{ b, a } })
+				{
+					if (kinds[from] == VertexKind::Locked || (kinds[from] == VertexKind::Border && isConstrainedEdge == false)) continue;
+
+					Quadric quadric = quadrics[from];
+					quadric += quadrics[to];
+					collapses.push_back(Collapse{ from, to, static_cast<float>(quadric.Evaluate(positions[to])) });
+				}
+			}
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.Cost < b.Cost; });
+
+		std::iota(collapseTargets.begin(), collapseTargets.end(), 0);
+		std::fill(isLocked.begin(), isLocked.end(), false);
+		size_t removedIndexCount{ 0 };
+		const size_t passIndexBudget{ result.size() - targetIndexCount };
+
+		// Cheap collapses go first, a pass doesn't reach far beyond the median so the expensive ones see the updated mesh
+		const double passMaxCost{ collapses.empty() ? 0.0 : std::min(maxCost, collapses[collapses.size() / 2].Cost * 1.5 + DBL_MIN) };
+		for (const Collapse& collapse : collapses)
+		{
+			if (collapse.Cost > passMaxCost || removedIndexCount >= passIndexBudget) break;
+			if (isLocked[collapse.From] || isLocked[collapse.To]) continue;
+
+			// Every vertex at the collapsed position needs a vertex at the target it shares an edge with
+			moves.clear();
+			size_t collapsedCount{ 0 };
+			bool isValid{ true };
+			for (uint32_t i{ adjacencyOffsets[collapse.From] }; i < adjacencyOffsets[collapse.From + 1] && isValid; ++i)
+			{
+				const uint32_t* pTriangle = &result[3 * adjacency[i]];
+				uint32_t fromVertex{ UINT32_MAX }, toVertex{ UINT32_MAX };
+				for (size_t corner{ 0 }; corner < 3; ++corner)
+				{
+					if (positionIds[pTriangle[corner]] == collapse.From) fromVertex = pTriangle[corner];
+					if (positionIds[pTriangle[corner]] == collapse.To) toVertex = pTriangle[corner];
+				}
+				if (toVertex == UINT32_MAX) continue;
+
+				++collapsedCount;
+				auto move = std::find_if(moves.begin(), moves.end(), [fromVertex](const auto& move) { return move.first == fromVertex; });
+				if (move == moves.end()) moves.emplace_back(fromVertex, toVertex);
+				else isValid = move->second == toVertex;
+			}
+
+			// Reject collapses that leave a vertex behind or flip a remaining triangle around
+			for (uint32_t i{ adjacencyOffsets[collapse.From] }; i < adjacencyOffsets[collapse.From + 1] && isValid; ++i)
+			{
+				const uint32_t* pTriangle = &result[3 * adjacency[i]];
+				Position before[3]{}, after[3]{};
+				bool hasTarget{ false };
+				for (size_t corner{ 0 }; corner < 3; ++corner)
+				{
+					uint32_t position = positionIds[pTriangle[corner]];
+					if (position == collapse.To) hasTarget = true;
+					if (position == collapse.From) {
+						isValid = std::any_of(moves.begin(), moves.end(), [pTriangle, corner](const auto& move) { return move.first == pTriangle[corner]; });
+						position = collapse.To;
+					}
+					before[corner] = positions[positionIds[pTriangle[corner]]];
+					after[corner] = positions[position];
+				}
+				if (hasTarget || isValid == false) continue;
+
+				double normalBefore[3]{}, normalAfter[3]{};
+				CalculateNormal(before[0], before[1], before[2], normalBefore);
+				CalculateNormal(after[0], after[1], after[2], normalAfter);
+				isValid = normalBefore[0] * normalAfter[0] + normalBefore[1] * normalAfter[1] + normalBefore[2] * normalAfter[2] > 0.0;
+			}
+			if (isValid == false || collapsedCount == 0) continue;
+
+			// Neighbours can't collapse in the same pass, their triangles just changed
+			for (uint32_t position : { collapse.From, collapse.To })
+			{
+				for (uint32_t i{ adjacencyOffsets[position] }; i < adjacencyOffsets[position + 1]; ++i)
+				{
+					for (size_t corner{ 0 }; corner < 3; ++corner) isLocked[positionIds[result[3 * adjacency[i] + corner]]] = true;
+				}
+			}
+
+			for (const auto& [fromVertex, toVertex] : moves) collapseTargets[fromVertex] = toVertex;
+			quadrics[collapse.To] += quadrics[collapse.From];
+			removedIndexCount += 3 * collapsedCount;
+			resultCost = std::max(resultCost, static_cast<double>(collapse.Cost));
+		}
+		if (removedIndexCount == 0) break;
+
+		// Drop the triangles that lost an edge
+		size_t writeIndex{ 0 };
+		for (size_t i{ 0 }; i < result.size(); i += 3)
+		{
+			uint32_t v0 = collapseTargets[result[i]], v1 = collapseTargets[result[i + 1]], v2 = collapseTargets[result[i + 2]];
+			if (positionIds[v0] == positionIds[v1] || positionIds[v1] == positionIds[v2] || positionIds[v2] == positionIds[v0]) continue;
+
+			result[writeIndex++] = v0;
+			result[writeIndex++] = v1;
+			result[writeIndex++] = v2;
+		}
+		result.resize(writeIndex);
+	}
+
+	if (pResultError) *pResultError = static_cast<float>(std::sqrt(resultCost));
+	return result;
+}
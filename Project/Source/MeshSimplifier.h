@@ -0,0 +1,21 @@
+#ifndef GP2VKT_MESHSIMPLIFIER_H_
+#define GP2VKT_MESHSIMPLIFIER_H_
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Class Forward Declarations
+
+
+namespace optimizer
+{
+	// Quadric error edge collapse (Garland & Heckbert 1997) that only moves vertices onto existing ones,
+	// so the result indexes the same vertex buffer. Vertices on attribute seams and open borders only slide along them,
+	// seam junctions and non-manifold edges are kept in place.
+	// Stops at targetIndexCount or once the next collapse would exceed targetError (in model units),
+	// the error of the result is written to pResultError.
+	std::vector<uint32_t> Simplify(const std::vector<uint32_t>& indices, const float* pPositions, size_t positionStride, size_t vertexCount,
+		size_t targetIndexCount, float targetError, float* pResultError = nullptr);
+}
+#endif
@@ -0,0 +1,327 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "MeshletBuilder.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include "VertexDeduplicator.h"
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	constexpr uint32_t INVALID_TRIANGLE{ UINT32_MAX };
+	constexpr uint8_t NOT_IN_MESHLET{ UINT8_MAX };
+	constexpr uint32_t FALLBACK_SEARCH_COUNT{ 64 }; // Unused triangles looked at when a meshlet has no neighbours left
+	constexpr float CONE_WEIGHT{ 0.5f }; // New vertices a triangle facing the opposite way of the meshlet counts as
+
+	struct Position
+	{
+		float X{}, Y{}, Z{};
+	};
+	Position GetPosition(const float* pPositions, size_t positionStride, uint32_t vertex)
+	{
+		const float* pPosition = reinterpret_cast<const float*>(reinterpret_cast<const char*>(pPositions) + vertex * positionStride);
+		return Position{ pPosition[0], pPosition[1], pPosition[2] };
+	}
+
+	// Triangles around every vertex, stored back to back
+	struct TriangleAdjacency
+	{
+		std::vector<uint32_t> Offsets{}; // vertexCount + 1 entries
+		std::vector<uint32_t> Triangles{};
+	};
+	TriangleAdjacency BuildAdjacency(const std::vector<uint32_t>& indices, size_t vertexCount)
+	{
+		TriangleAdjacency adjacency{};
+		adjacency.Offsets.assign(vertexCount + 1, 0);
+		for (uint32_t index : indices)
+		{
+			++adjacency.Offsets[index + 1];
+		}
+		for (size_t i{ 0 }; i < vertexCount; ++i)
+		{
+			adjacency.Offsets[i + 1] += adjacency.Offsets[i];
+		}
+
+		std::vector<uint32_t> fill{ adjacency.Offsets.begin(), adjacency.Offsets.end() - 1 };
+		adjacency.Triangles.resize(indices.size());
+		for (size_t i{ 0 }; i < indices.size(); ++i)
+		{
+			adjacency.Triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+		return adjacency;
+	}
+
+	// Bounding sphere around the center of the box & a cone around the averaged triangle normals
+	void CalculateBounds(Meshlet& meshlet, const MeshletData& data, const float* pPositions, size_t positionStride)
+	{
+		Position min{ FLT_MAX, FLT_MAX, FLT_MAX };
+		Position max{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		for (uint32_t i{ 0 }; i < meshlet.VertexCount; ++i)
+		{
+			Position p = GetPosition(pPositions, positionStride, data.Vertices[meshlet.VertexOffset + i]);
+			min = Position{ std::min(min.X, p.X), std::min(min.Y, p.Y), std::min(min.Z, p.Z) };
+			max = Position{ std::max(max.X, p.X), std::max(max.Y, p.Y), std::max(max.Z, p.Z) };
+		}
+		meshlet.Center[0] = (min.X + max.X) * 0.5f;
+		meshlet.Center[1] = (min.Y + max.Y) * 0.5f;
+		meshlet.Center[2] = (min.Z + max.Z) * 0.5f;
+
+		float radiusSquared{ 0.f };
+		for (uint32_t i{ 0 }; i < meshlet.VertexCount; ++i)
+		{
+			Position p = GetPosition(pPositions, positionStride, data.Vertices[meshlet.VertexOffset + i]);
+			float dx{ p.X - meshlet.Center[0] }, dy{ p.Y - meshlet.Center[1] }, dz{ p.Z - meshlet.Center[2] };
+			radiusSquared = std::max(radiusSquared, dx * dx + dy * dy + dz * dz);
+		}
+		meshlet.Radius = std::sqrt(radiusSquared);
+
+		// Unit normals, so big triangles don't hide the small ones facing another way
+		std::vector<Position> normals{};
+		normals.reserve(meshlet.TriangleCount);
+		Position axis{};
+		for (uint32_t i{ 0 }; i < meshlet.TriangleCount; ++i)
+		{
+			const uint8_t* pTriangle = &data.Triangles[(static_cast<size_t>(meshlet.TriangleOffset) + i) * 3];
+			Position p0 = GetPosition(pPositions, positionStride, data.Vertices[meshlet.VertexOffset + pTriangle[0]]);
+			Position p1 = GetPosition(pPositions, positionStride, data.Vertices[meshlet.VertexOffset + pTriangle[1]]);
+			Position p2 = GetPosition(pPositions, positionStride, data.Vertices[meshlet.VertexOffset + pTriangle[2]]);
+
+			Position e0{ p1.X - p0.X, p1.Y - p0.Y, p1.Z - p0.Z };
+			Position e1{ p2.X - p0.X, p2.Y - p0.Y, p2.Z - p0.Z };
+			Position normal{ e0.Y * e1.Z - e0.Z * e1.Y, e0.Z * e1.X - e0.X * e1.Z, e0.X * e1.Y - e0.Y * e1.X };
+			float length = std::sqrt(normal.X * normal.X + normal.Y * normal.Y + normal.Z * normal.Z);
+			if (length <= 0.f) continue;
+
+			normal = Position{ normal.X / length, normal.Y / length, normal.Z / length };
+			normals.push_back(normal);
+			axis = Position{ axis.X + normal.X, axis.Y + normal.Y, axis.Z + normal.Z };
+		}
+
+		float axisLength = std::sqrt(axis.X * axis.X + axis.Y * axis.Y + axis.Z * axis.Z);
+		if (axisLength <= FLT_EPSILON) {
+			meshlet.ConeCutoff = 1.f;
+			return;
+		}
+		axis = Position{ axis.X / axisLength, axis.Y / axisLength, axis.Z / axisLength };
+		meshlet.ConeAxis[0] = axis.X;
+		meshlet.ConeAxis[1] = axis.Y;
+		meshlet.ConeAxis[2] = axis.Z;
+
+		float minDot{ 1.f };
+		for (const Position& normal : normals)
+		{
+			minDot = std::min(minDot, normal.X * axis.X + normal.Y * axis.Y + normal.Z * axis.Z);
+		}
+
+		// Cones wider than ~85 degrees would almost never cull anything
+		meshlet.ConeCutoff = minDot <= 0.1f ? 1.f : std::sqrt(1.f - minDot * minDot);
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Functions
+//-----------------------------------------------------------------
+MeshletData optimizer::BuildMeshlets(std::vector<uint32_t>& indices, const float* pPositions, size_t positionStride, size_t vertexCount,
+	uint32_t maxVertices, uint32_t maxTriangles)
+{
+	// Local vertices have to fit in a byte
+	if (maxVertices < 3 || maxVertices >= NOT_IN_MESHLET || maxTriangles == 0) {
+		throw std::invalid_argument("meshlet limits are out of range!");
+	}
+
+	MeshletData data{};
+	const size_t triangleCount{ indices.size() / 3 };
+	if (triangleCount == 0) return data;
+
+	// Hard edges & UV seams split vertices, neighbours are found through the positions so meshlets grow across them
+	std::vector<uint32_t> positionIds(vertexCount);
+	size_t positionCount{};
+	{
+		VertexDeduplicator<Position> deduplicator{ vertexCount };
+		for (uint32_t vertex{ 0 }; vertex < vertexCount; ++vertex)
+		{
+			positionIds[vertex] = deduplicator.FindOrInsert(GetPosition(pPositions, positionStride, vertex));
+		}
+		positionCount = deduplicator.GetVertices().size();
+	}
+	std::vector<uint32_t> positionIndices(indices.size());
+	for (size_t i{ 0 }; i < indices.size(); ++i)
+	{
+		positionIndices[i] = positionIds[indices[i]];
+	}
+
+	TriangleAdjacency adjacency = BuildAdjacency(positionIndices, positionCount);
+	std::vector<uint32_t> liveTriangles(positionCount); // Triangles around every position that aren't in a meshlet yet
+	for (size_t i{ 0 }; i < positionCount; ++i)
+	{
+		liveTriangles[i] = adjacency.Offsets[i + 1] - adjacency.Offsets[i];
+	}
+
+	std::vector<bool> isEmitted(triangleCount, false);
+	std::vector<uint8_t> localVertex(vertexCount, NOT_IN_MESHLET);
+	std::vector<uint32_t> reorderedIndices{};
+	reorderedIndices.reserve(indices.size());
+
+	// Unit normals of every triangle, degenerate ones are zero
+	std::vector<Position> triangleNormals(triangleCount);
+	for (size_t i{ 0 }; i < triangleCount; ++i)
+	{
+		Position p0 = GetPosition(pPositions, positionStride, indices[i * 3]);
+		Position p1 = GetPosition(pPositions, positionStride, indices[i * 3 + 1]);
+		Position p2 = GetPosition(pPositions, positionStride, indices[i * 3 + 2]);
+		Position e0{ p1.X - p0.X, p1.Y - p0.Y, p1.Z - p0.Z };
+		Position e1{ p2.X - p0.X, p2.Y - p0.Y, p2.Z - p0.Z };
+		Position normal{ e0.Y * e1.Z - e0.Z * e1.Y, e0.Z * e1.X - e0.X * e1.Z, e0.X * e1.Y - e0.Y * e1.X };
+		float length = std::sqrt(normal.X * normal.X + normal.Y * normal.Y + normal.Z * normal.Z);
+		if (length > 0.f) triangleNormals[i] = Position{ normal.X / length, normal.Y / length, normal.Z / length };
+	}
+
+	Meshlet meshlet{};
+	Position centroidSum{};
+	Position normalSum{};
+	size_t scanCursor{ 0 }; // Triangles before it have all been emitted
+
+	auto countNewVertices = [&](uint32_t triangle)
+		{
+			uint32_t count{ 0 };
+			for (uint32_t k{ 0 }; k < 3; ++k)
+			{
+				if (localVertex[indices[triangle * 3 + k]] == NOT_IN_MESHLET) ++count;
+			}
+			return count;
+		};
+	auto emitTriangle = [&](uint32_t triangle)
+		{
+			for (uint32_t k{ 0 }; k < 3; ++k)
+			{
+				uint32_t vertex{ indices[triangle * 3 + k] };
+				if (localVertex[vertex] == NOT_IN_MESHLET) {
+					localVertex[vertex] = static_cast<uint8_t>(meshlet.VertexCount++);
+					data.Vertices.push_back(vertex);
+
+					Position p = GetPosition(pPositions, positionStride, vertex);
+					centroidSum = Position{ centroidSum.X + p.X, centroidSum.Y + p.Y, centroidSum.Z + p.Z };
+				}
+				data.Triangles.push_back(localVertex[vertex]);
+				reorderedIndices.push_back(vertex);
+				--liveTriangles[positionIds[vertex]];
+			}
+			const Position& normal = triangleNormals[triangle];
+			normalSum = Position{ normalSum.X + normal.X, normalSum.Y + normal.Y, normalSum.Z + normal.Z };
+			isEmitted[triangle] = true;
+			++meshlet.TriangleCount;
+		};
+	auto finishMeshlet = [&]()
+		{
+			CalculateBounds(meshlet, data, pPositions, positionStride);
+			for (uint32_t i{ 0 }; i < meshlet.VertexCount; ++i)
+			{
+				localVertex[data.Vertices[meshlet.VertexOffset + i]] = NOT_IN_MESHLET;
+			}
+			data.Meshlets.push_back(meshlet);
+
+			meshlet = Meshlet{};
+			meshlet.VertexOffset = static_cast<uint32_t>(data.Vertices.size());
+			meshlet.TriangleOffset = static_cast<uint32_t>(data.Triangles.size() / 3);
+			centroidSum = Position{};
+			normalSum = Position{};
+		};
+
+	while (true)
+	{
+		// Neighbour that adds the fewest vertices, triangles facing away from the meshlet count extra so its normal cone stays narrow
+		// Ties go to the triangle that leaves the fewest open triangles behind
+		float normalLength = std::sqrt(normalSum.X * normalSum.X + normalSum.Y * normalSum.Y + normalSum.Z * normalSum.Z);
+		Position axis = normalLength > 0.f ? Position{ normalSum.X / normalLength, normalSum.Y / normalLength, normalSum.Z / normalLength } : Position{};
+
+		uint32_t best{ INVALID_TRIANGLE };
+		float bestScore{ FLT_MAX };
+		uint32_t bestLiveTriangles{ UINT32_MAX };
+		for (uint32_t i{ 0 }; i < meshlet.VertexCount; ++i)
+		{
+			uint32_t position{ positionIds[data.Vertices[meshlet.VertexOffset + i]] };
+			if (liveTriangles[position] == 0) continue;
+
+			for (uint32_t a{ adjacency.Offsets[position] }; a < adjacency.Offsets[position + 1]; ++a)
+			{
+				uint32_t triangle{ adjacency.Triangles[a] };
+				if (isEmitted[triangle]) continue;
+
+				uint32_t newVertices = countNewVertices(triangle);
+				if (meshlet.VertexCount + newVertices > maxVertices) continue;
+
+				const Position& normal = triangleNormals[triangle];
+				float spread = 1.f - (normal.X * axis.X + normal.Y * axis.Y + normal.Z * axis.Z);
+				float score = newVertices + spread * CONE_WEIGHT;
+				uint32_t live = liveTriangles[positionIndices[triangle * 3]] + liveTriangles[positionIndices[triangle * 3 + 1]] + liveTriangles[positionIndices[triangle * 3 + 2]];
+				if (score < bestScore || (score == bestScore && live < bestLiveTriangles)) {
+					best = triangle;
+					bestScore = score;
+					bestLiveTriangles = live;
+				}
+			}
+		}
+
+		if (best == INVALID_TRIANGLE) {
+			while (scanCursor < triangleCount && isEmitted[scanCursor]) ++scanCursor;
+			if (scanCursor == triangleCount) break;
+
+			// A meshlet that is at least half full is closed instead of jumping to a disconnected part of the mesh
+			if (meshlet.TriangleCount * 2 >= maxTriangles) {
+				finishMeshlet();
+				continue;
+			}
+
+			// Otherwise take the closest of the next unused triangles, the vertex cache order keeps those nearby
+			best = static_cast<uint32_t>(scanCursor);
+			if (meshlet.TriangleCount > 0) {
+				Position centroid{ centroidSum.X / meshlet.VertexCount, centroidSum.Y / meshlet.VertexCount, centroidSum.Z / meshlet.VertexCount };
+				float bestDistance{ FLT_MAX };
+				uint32_t searched{ 0 };
+				for (size_t triangle{ scanCursor }; triangle < triangleCount && searched < FALLBACK_SEARCH_COUNT; ++triangle)
+				{
+					if (isEmitted[triangle]) continue;
+					++searched;
+
+					Position p = GetPosition(pPositions, positionStride, indices[triangle * 3]);
+					float dx{ p.X - centroid.X }, dy{ p.Y - centroid.Y }, dz{ p.Z - centroid.Z };
+					float distance{ dx * dx + dy * dy + dz * dz };
+					if (distance < bestDistance) {
+						bestDistance = distance;
+						best = static_cast<uint32_t>(triangle);
+					}
+				}
+
+				if (meshlet.VertexCount + countNewVertices(best) > maxVertices) {
+					finishMeshlet();
+					continue;
+				}
+			}
+		}
+
+		emitTriangle(best);
+		if (meshlet.TriangleCount == maxTriangles) finishMeshlet();
+	}
+	if (meshlet.TriangleCount > 0) finishMeshlet();
+
+	indices = std::move(reorderedIndices);
+	return data;
+}
+
+bool optimizer::IsMeshletBackFacing(const Meshlet& meshlet, const float cameraPosition[3])
+{
+	float dx{ meshlet.Center[0] - cameraPosition[0] };
+	float dy{ meshlet.Center[1] - cameraPosition[1] };
+	float dz{ meshlet.Center[2] - cameraPosition[2] };
+	float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+	// Every triangle faces away once the camera is outside of the cone behind the meshlet (no apex needed, the sphere covers it)
+	return dx * meshlet.ConeAxis[0] + dy * meshlet.ConeAxis[1] + dz * meshlet.ConeAxis[2] >= meshlet.ConeCutoff * distance + meshlet.Radius;
+}
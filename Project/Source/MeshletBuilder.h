@@ -0,0 +1,43 @@
+#ifndef GP2VKT_MESHLETBUILDER_H_
+#define GP2VKT_MESHLETBUILDER_H_
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Class Forward Declarations
+
+
+// Small cluster of triangles with its own vertex list, laid out like the std430 buffer in PBR_Meshlet.mesh
+struct Meshlet
+{
+	float Center[3]{}; // Bounding sphere, in model space
+	float Radius{};
+	float ConeAxis[3]{}; // Average facing direction of the triangles
+	float ConeCutoff{ 1.f }; // Sine of the half angle of the normal cone, 1 if the meshlet can't be back face culled
+	uint32_t VertexOffset{}; // Into MeshletData::Vertices
+	uint32_t TriangleOffset{}; // In triangles, also the first triangle of the meshlet in the reordered index buffer
+	uint32_t VertexCount{};
+	uint32_t TriangleCount{};
+};
+
+// Meshlets of one index range, the local triangles index the vertex list of their meshlet
+struct MeshletData
+{
+	std::vector<Meshlet> Meshlets{};
+	std::vector<uint32_t> Vertices{}; // Vertices of the mesh, VertexCount per meshlet
+	std::vector<uint8_t> Triangles{}; // 3 local vertices per triangle, TriangleCount per meshlet
+};
+
+
+namespace optimizer
+{
+	// Greedily grows every meshlet with the neighbouring triangle that adds the fewest new vertices,
+	// then reorders the indices so every meshlet is a contiguous range starting at index 3 * TriangleOffset
+	MeshletData BuildMeshlets(std::vector<uint32_t>& indices, const float* pPositions, size_t positionStride, size_t vertexCount,
+		uint32_t maxVertices, uint32_t maxTriangles);
+
+	// True if the whole meshlet faces away from the camera, all positions in the space of the meshlet
+	bool IsMeshletBackFacing(const Meshlet& meshlet, const float cameraPosition[3]);
+}
+#endif
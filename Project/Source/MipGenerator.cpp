@@ -0,0 +1,202 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "MipGenerator.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GP2VKT_MIP_SSE2
+#include <emmintrin.h>
+#endif
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	constexpr uint32_t CHANNEL_COUNT{ 4 };
+	constexpr size_t ENCODE_TABLE_SIZE{ 65536 }; // Fine enough to round the darkest sRGB values correctly
+
+	// Byte to linear float & linear float (scaled to the table size) to byte, [0] is linear & [1] sRGB
+	struct ConversionTables
+	{
+		float Decode[2][256]{};
+		uint8_t Encode[2][ENCODE_TABLE_SIZE]{};
+	};
+
+	float SrgbToLinear(float value)
+	{
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+	float LinearToSrgb(float value)
+	{
+		return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+	}
+
+	const ConversionTables& GetConversionTables()
+	{
+		static const std::unique_ptr<const ConversionTables> pTables = []()
+			{
+				auto pNewTables = std::make_unique<ConversionTables>();
+				for (int value{ 0 }; value < 256; ++value)
+				{
+					pNewTables->Decode[0][value] = value / 255.f;
+					pNewTables->Decode[1][value] = SrgbToLinear(value / 255.f);
+				}
+				for (size_t i{ 0 }; i < ENCODE_TABLE_SIZE; ++i)
+				{
+					float value{ static_cast<float>(i) / (ENCODE_TABLE_SIZE - 1) };
+					pNewTables->Encode[0][i] = static_cast<uint8_t>(std::lround(value * 255.f));
+					pNewTables->Encode[1][i] = static_cast<uint8_t>(std::lround(std::clamp(LinearToSrgb(value), 0.f, 1.f) * 255.f));
+				}
+				return pNewTables;
+			}();
+		return *pTables;
+	}
+
+	// dst += src, both count floats
+	void AddRow(const float* pSrc, size_t count, float* pDst)
+	{
+		size_t i{ 0 };
+#ifdef GP2VKT_MIP_SSE2
+		for (; i + 4 <= count; i += 4)
+		{
+			_mm_storeu_ps(pDst + i, _mm_add_ps(_mm_loadu_ps(pDst + i), _mm_loadu_ps(pSrc + i)));
+		}
+#endif
+		for (; i < count; ++i) pDst[i] += pSrc[i];
+	}
+
+	void DecodeRow(const uint8_t* pSrc, uint32_t width, const float* const (&pDecode)[CHANNEL_COUNT], float* pDst)
+	{
+		for (uint32_t i{ 0 }; i < width * CHANNEL_COUNT; i += CHANNEL_COUNT)
+		{
+			for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+			{
+				pDst[i + channel] = pDecode[channel][pSrc[i + channel]];
+			}
+		}
+	}
+
+	// Average of the 1 to 3 source columns every destination pixel covers, the source row is already summed over its rows
+	void FilterRow(const float* pRowSum, uint32_t srcWidth, uint32_t dstWidth, float rowCount, float* pDst)
+	{
+		for (uint32_t x{ 0 }; x < dstWidth; ++x)
+		{
+			uint32_t first{ std::min(2 * x, srcWidth - 1) };
+			uint32_t last{ std::min(x + 1 == dstWidth ? srcWidth - 1 : 2 * x + 1, srcWidth - 1) };
+			float scale{ 1.f / ((last - first + 1) * rowCount) };
+#ifdef GP2VKT_MIP_SSE2
+			__m128 sum{ _mm_setzero_ps() };
+			for (uint32_t column{ first }; column <= last; ++column)
+			{
+				sum = _mm_add_ps(sum, _mm_loadu_ps(pRowSum + column * CHANNEL_COUNT));
+			}
+			_mm_storeu_ps(pDst + x * CHANNEL_COUNT, _mm_mul_ps(sum, _mm_set1_ps(scale)));
+#else
+			for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+			{
+				float sum{ 0.f };
+				for (uint32_t column{ first }; column <= last; ++column) sum += pRowSum[column * CHANNEL_COUNT + channel];
+				pDst[x * CHANNEL_COUNT + channel] = sum * scale;
+			}
+#endif
+		}
+	}
+
+	void EncodePixels(const float* pSrc, size_t pixelCount, const uint8_t* const (&pEncode)[CHANNEL_COUNT], uint8_t* pDst)
+	{
+		constexpr float tableScale{ ENCODE_TABLE_SIZE - 1 };
+		for (size_t i{ 0 }; i < pixelCount * CHANNEL_COUNT; i += CHANNEL_COUNT)
+		{
+			alignas(16) int32_t indices[CHANNEL_COUNT];
+#ifdef GP2VKT_MIP_SSE2
+			__m128 value{ _mm_min_ps(_mm_max_ps(_mm_loadu_ps(pSrc + i), _mm_setzero_ps()), _mm_set1_ps(1.f)) };
+			_mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(tableScale)), _mm_set1_ps(0.5f))));
+#else
+			for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+			{
+				indices[channel] = static_cast<int32_t>(std::clamp(pSrc[i + channel], 0.f, 1.f) * tableScale + 0.5f);
+			}
+#endif
+			for (uint32_t channel{ 0 }; channel < CHANNEL_COUNT; ++channel)
+			{
+				pDst[i + channel] = pEncode[channel][indices[channel]];
+			}
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Functions
+//-----------------------------------------------------------------
+uint32_t mips::CalculateMipLevels(uint32_t width, uint32_t height)
+{
+	uint32_t levelCount{ 1 };
+	for (uint32_t size{ std::max(width, height) }; size > 1; size /= 2) ++levelCount;
+	return levelCount;
+}
+
+MipChain mips::GenerateMipChain(const uint8_t* pPixels, uint32_t width, uint32_t height, bool isSrgb)
+{
+	if (pPixels == nullptr || width == 0 || height == 0) {
+		throw std::invalid_argument("can't generate mip levels for an empty image!");
+	}
+
+	// Level sizes, halved & rounded down like the Vulkan mip levels
+	MipChain chain{};
+	const uint32_t levelCount{ CalculateMipLevels(width, height) };
+	size_t size{ 0 };
+	for (uint32_t level{ 0 }; level < levelCount; ++level)
+	{
+		chain.Offsets.push_back(size);
+		size += static_cast<size_t>(std::max(width >> level, 1u)) * std::max(height >> level, 1u) * CHANNEL_COUNT;
+	}
+	chain.Pixels.resize(size);
+	std::copy(pPixels, pPixels + static_cast<size_t>(width) * height * CHANNEL_COUNT, chain.Pixels.begin());
+
+	const ConversionTables& tables = GetConversionTables();
+	const int colorTable{ isSrgb ? 1 : 0 };
+	const float* const pDecode[CHANNEL_COUNT]{ tables.Decode[colorTable], tables.Decode[colorTable], tables.Decode[colorTable], tables.Decode[0] };
+	const uint8_t* const pEncode[CHANNEL_COUNT]{ tables.Encode[colorTable], tables.Encode[colorTable], tables.Encode[colorTable], tables.Encode[0] };
+
+	// Level 1 decodes the source a row at a time, deeper levels read the linear floats of the previous level
+	std::vector<float> decodedRow(static_cast<size_t>(width) * CHANNEL_COUNT);
+	std::vector<float> rowSum(static_cast<size_t>(width) * CHANNEL_COUNT);
+	std::vector<float> previousLevel{}, currentLevel{};
+	uint32_t srcWidth{ width }, srcHeight{ height };
+	for (uint32_t level{ 1 }; level < levelCount; ++level)
+	{
+		const uint32_t dstWidth{ std::max(srcWidth / 2, 1u) }, dstHeight{ std::max(srcHeight / 2, 1u) };
+		const size_t srcRowSize{ static_cast<size_t>(srcWidth) * CHANNEL_COUNT };
+		currentLevel.resize(static_cast<size_t>(dstWidth) * dstHeight * CHANNEL_COUNT);
+
+		for (uint32_t y{ 0 }; y < dstHeight; ++y)
+		{
+			// The last row of an odd level is folded into the last destination row
+			uint32_t firstRow{ std::min(2 * y, srcHeight - 1) };
+			uint32_t lastRow{ std::min(y + 1 == dstHeight ? srcHeight - 1 : 2 * y + 1, srcHeight - 1) };
+
+			std::fill(rowSum.begin(), rowSum.begin() + srcRowSize, 0.f);
+			for (uint32_t row{ firstRow }; row <= lastRow; ++row)
+			{
+				if (level == 1) {
+					DecodeRow(pPixels + row * srcRowSize, srcWidth, pDecode, decodedRow.data());
+					AddRow(decodedRow.data(), srcRowSize, rowSum.data());
+				}
+				else AddRow(previousLevel.data() + row * srcRowSize, srcRowSize, rowSum.data());
+			}
+			FilterRow(rowSum.data(), srcWidth, dstWidth, static_cast<float>(lastRow - firstRow + 1), currentLevel.data() + static_cast<size_t>(y) * dstWidth * CHANNEL_COUNT);
+		}
+
+		EncodePixels(currentLevel.data(), static_cast<size_t>(dstWidth) * dstHeight, pEncode, chain.Pixels.data() + chain.Offsets[level]);
+		std::swap(previousLevel, currentLevel);
+		srcWidth = dstWidth;
+		srcHeight = dstHeight;
+	}
+	return chain;
+}
@@ -0,0 +1,29 @@
+#ifndef GP2VKT_MIPGENERATOR_H_
+#define GP2VKT_MIPGENERATOR_H_
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Class Forward Declarations
+
+
+// Every mip level of an RGBA8 image, tightly packed one after another
+struct MipChain
+{
+	std::vector<uint8_t> Pixels{};
+	std::vector<size_t> Offsets{}; // Start of every level in Pixels, level 0 is a copy of the source image
+};
+
+
+// CPU fallback for formats the GPU can't blit with linear filtering
+namespace mips
+{
+	uint32_t CalculateMipLevels(uint32_t width, uint32_t height); // Down to 1x1
+
+	// 2x2 box filter, every level is filtered from the full precision previous level
+	// sRGB color channels are averaged in linear space, alpha is always linear
+	// Odd sizes fold their last row or column into the last pixel, so every source texel contributes
+	MipChain GenerateMipChain(const uint8_t* pPixels, uint32_t width, uint32_t height, bool isSrgb);
+}
+#endif
@@ -0,0 +1,332 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "ObjParser.h"
+#include <stdexcept>
+#include <algorithm>
+#include <future>
+#include <functional>
+#include <thread>
+#include <cstring>
+#include <cmath>
+#include "VirtualFileSystem.h"
+
+
+//-----------------------------------------------------------------
+// Text Parsing Helpers
+//-----------------------------------------------------------------
+namespace
+{
+	constexpr size_t MIN_CHUNK_SIZE{ 1024 * 1024 }; // Smaller files aren't worth the thread overhead
+	constexpr int MAX_MANTISSA_DIGITS{ 19 }; // Still fits in an uint64_t
+
+	constexpr uint8_t RELATIVE_POSITION{ 1 << 0 };
+	constexpr uint8_t RELATIVE_TEXCOORD{ 1 << 1 };
+	constexpr uint8_t RELATIVE_NORMAL{ 1 << 2 };
+
+	constexpr double POWERS_OF_TEN[]{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 }; // Exactly representable as a double
+
+	bool IsSpace(char c) { return c == ' ' || c == '\t'; }
+	bool IsDigit(char c) { return static_cast<unsigned char>(c - '0') < 10; }
+
+	void SkipSpaces(const char*& p, const char* pEnd)
+	{
+		while (p < pEnd && IsSpace(*p)) ++p;
+	}
+	void SkipLine(const char*& p, const char* pEnd)
+	{
+		p = static_cast<const char*>(memchr(p, '\n', pEnd - p));
+		p = p ? p + 1 : pEnd;
+	}
+
+	// SWAR (SIMD within a register): 8 characters are checked & converted at once, assumes a little endian CPU
+	bool IsEightDigits(uint64_t chars)
+	{
+		return (((chars + 0x4646464646464646ull) | (chars - 0x3030303030303030ull)) & 0x8080808080808080ull) == 0;
+	}
+	uint32_t ParseEightDigits(uint64_t chars)
+	{
+		chars -= 0x3030303030303030ull;
+		chars = (chars * 10) + (chars >> 8); // Pairs of digits
+		chars = (((chars & 0x000000FF000000FFull) * 0x000F424000000064ull)
+			+ (((chars >> 16) & 0x000000FF000000FFull) * 0x0000271000000001ull)) >> 32; // Combine the pairs
+		return static_cast<uint32_t>(chars);
+	}
+
+	// Appends the digits at p to the mantissa, returns the amount of digits that didn't fit
+	int ParseDigits(const char*& p, const char* pEnd, uint64_t& mantissa, int& digitCount)
+	{
+		uint64_t chars{};
+		while (pEnd - p >= 8 && digitCount + 8 <= MAX_MANTISSA_DIGITS)
+		{
+			memcpy(&chars, p, sizeof(chars));
+			if (IsEightDigits(chars) == false) break;
+
+			mantissa = mantissa * 100000000 + ParseEightDigits(chars);
+			digitCount += 8;
+			p += 8;
+		}
+
+		int droppedCount{ 0 };
+		for (; p < pEnd && IsDigit(*p); ++p)
+		{
+			if (digitCount < MAX_MANTISSA_DIGITS) {
+				mantissa = mantissa * 10 + (*p - '0');
+				digitCount += mantissa != 0; // Leading zeros don't take up precision
+			}
+			else {
+				++droppedCount;
+			}
+		}
+		return droppedCount;
+	}
+
+	float ParseFloat(const char*& p, const char* pEnd)
+	{
+		SkipSpaces(p, pEnd);
+
+		bool isNegative = p < pEnd && *p == '-';
+		if (p < pEnd && (*p == '-' || *p == '+')) ++p;
+
+		// Integer & fraction digits end up in a single mantissa
+		uint64_t mantissa{ 0 };
+		int digitCount{ 0 };
+		int exponent = ParseDigits(p, pEnd, mantissa, digitCount);
+		if (p < pEnd && *p == '.') {
+			++p;
+			const char* pFraction = p;
+			int droppedCount = ParseDigits(p, pEnd, mantissa, digitCount);
+			exponent -= static_cast<int>(p - pFraction) - droppedCount;
+		}
+
+		if (p < pEnd && (*p == 'e' || *p == 'E')) {
+			++p;
+			bool isExponentNegative = p < pEnd && *p == '-';
+			if (p < pEnd && (*p == '-' || *p == '+')) ++p;
+
+			int explicitExponent{ 0 };
+			for (; p < pEnd && IsDigit(*p); ++p)
+			{
+				if (explicitExponent < 10000) explicitExponent = explicitExponent * 10 + (*p - '0');
+			}
+			exponent += isExponentNegative ? -explicitExponent : explicitExponent;
+		}
+
+		// A single multiply or divide by an exact power of ten is correctly rounded in all common cases
+		double value = static_cast<double>(mantissa);
+		if (exponent < 0) {
+			value = -exponent <= 22 ? value / POWERS_OF_TEN[-exponent] : value * std::pow(10.0, exponent);
+		}
+		else if (exponent > 0) {
+			value = exponent <= 22 ? value * POWERS_OF_TEN[exponent] : value * std::pow(10.0, exponent);
+		}
+		return static_cast<float>(isNegative ? -value : value);
+	}
+
+	// Positive OBJ indices are absolute & 1 based, negative ones count back from the last attribute read so far
+	int32_t ParseIndex(const char*& p, const char* pEnd, size_t attributeCount, uint8_t relativeBit, uint8_t& relativeMask)
+	{
+		bool isNegative = p < pEnd && *p == '-';
+		if (isNegative) ++p;
+
+		int64_t value{ 0 };
+		for (; p < pEnd && IsDigit(*p); ++p)
+		{
+			value = value * 10 + (*p - '0');
+		}
+
+		if (value == 0) return -1;
+		if (isNegative == false) return static_cast<int32_t>(value - 1);
+
+		// Relative to the start of the chunk, might point into an earlier chunk
+		relativeMask |= relativeBit;
+		return static_cast<int32_t>(static_cast<int64_t>(attributeCount) - value);
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+ObjParser::ObjParser(uint32_t threadCount)
+	: m_ThreadCount{ threadCount }
+{
+	if (m_ThreadCount == 0) m_ThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+ObjData ObjParser::Parse(const char* filePath) const
+{
+	AssetData file = vfs::Read(filePath);
+	const char* pFileBegin = file.GetData();
+	const char* pFileEnd = pFileBegin + file.GetSize();
+
+	// Split into chunks of roughly the same size that end right after a line break
+	size_t chunkCount = std::clamp<size_t>(file.GetSize() / MIN_CHUNK_SIZE, 1, m_ThreadCount);
+	std::vector<Chunk> chunks(chunkCount);
+	const char* pBegin = pFileBegin;
+	for (size_t i{ 0 }; i < chunkCount; ++i)
+	{
+		const char* pEnd = pFileEnd;
+		if (i + 1 < chunkCount) {
+			pEnd = std::max(pBegin, pFileBegin + file.GetSize() * (i + 1) / chunkCount);
+			SkipLine(pEnd, pFileEnd);
+		}
+
+		chunks[i].pBegin = pBegin;
+		chunks[i].pEnd = pEnd;
+		pBegin = pEnd;
+	}
+
+	// The first chunk is parsed on the calling thread, exceptions are passed on by the futures
+	std::vector<std::future<void>> parseTasks{};
+	for (size_t i{ 1 }; i < chunkCount; ++i)
+	{
+		parseTasks.push_back(std::async(std::launch::async, ParseChunk, std::ref(chunks[i])));
+	}
+	ParseChunk(chunks[0]);
+	for (std::future<void>& task : parseTasks) task.get();
+
+	// Offsets of every chunk inside of the merged arrays
+	ObjData data{};
+	size_t positionCount{ 0 }, texCoordCount{ 0 }, normalCount{ 0 }, indexCount{ 0 };
+	for (Chunk& chunk : chunks)
+	{
+		chunk.PositionBase = positionCount;
+		chunk.TexCoordBase = texCoordCount;
+		chunk.NormalBase = normalCount;
+		chunk.IndexBase = indexCount;
+
+		positionCount += chunk.Data.Positions.size() / 3;
+		texCoordCount += chunk.Data.TexCoords.size() / 2;
+		normalCount += chunk.Data.Normals.size() / 3;
+		indexCount += chunk.Data.Indices.size();
+	}
+	data.Positions.resize(positionCount * 3);
+	data.TexCoords.resize(texCoordCount * 2);
+	data.Normals.resize(normalCount * 3);
+	data.Indices.resize(indexCount);
+
+	// Every chunk writes to its own part of the arrays
+	std::vector<std::future<void>> mergeTasks{};
+	for (size_t i{ 1 }; i < chunkCount; ++i)
+	{
+		mergeTasks.push_back(std::async(std::launch::async, MergeChunk, std::cref(chunks[i]), std::ref(data)));
+	}
+	MergeChunk(chunks[0], data);
+	for (std::future<void>& task : mergeTasks) task.get();
+
+	return data;
+}
+
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+void ObjParser::ParseChunk(Chunk& chunk)
+{
+	const char* p = chunk.pBegin;
+	const char* pEnd = chunk.pEnd;
+	ObjData& data = chunk.Data;
+
+	// Guess the amount of attributes to avoid most reallocations, around 30 characters per line
+	size_t lineEstimate = static_cast<size_t>(pEnd - p) / 30;
+	data.Positions.reserve(lineEstimate);
+	data.Indices.reserve(lineEstimate);
+
+	std::vector<std::pair<ObjIndex, uint8_t>> face{};
+	while (p < pEnd)
+	{
+		SkipSpaces(p, pEnd);
+		if (pEnd - p < 2) break;
+
+		if (p[0] == 'v' && IsSpace(p[1])) {
+			p += 2;
+			for (int i{ 0 }; i < 3; ++i) data.Positions.push_back(ParseFloat(p, pEnd));
+		}
+		else if (p[0] == 'v' && p[1] == 't' && pEnd - p > 2 && IsSpace(p[2])) {
+			p += 3;
+			for (int i{ 0 }; i < 2; ++i) data.TexCoords.push_back(ParseFloat(p, pEnd));
+		}
+		else if (p[0] == 'v' && p[1] == 'n' && pEnd - p > 2 && IsSpace(p[2])) {
+			p += 3;
+			for (int i{ 0 }; i < 3; ++i) data.Normals.push_back(ParseFloat(p, pEnd));
+		}
+		else if (p[0] == 'f' && IsSpace(p[1])) {
+			p += 2;
+
+			// Corners are v, v/vt, v//vn or v/vt/vn
+			face.clear();
+			while (true)
+			{
+				SkipSpaces(p, pEnd);
+				if (p == pEnd || (IsDigit(*p) == false && *p != '-')) break;
+
+				ObjIndex corner{};
+				uint8_t relativeMask{ 0 };
+				corner.Position = ParseIndex(p, pEnd, data.Positions.size() / 3, RELATIVE_POSITION, relativeMask);
+				if (p < pEnd && *p == '/') {
+					++p;
+					if (p < pEnd && *p != '/') corner.TexCoord = ParseIndex(p, pEnd, data.TexCoords.size() / 2, RELATIVE_TEXCOORD, relativeMask);
+					if (p < pEnd && *p == '/') {
+						++p;
+						corner.Normal = ParseIndex(p, pEnd, data.Normals.size() / 3, RELATIVE_NORMAL, relativeMask);
+					}
+				}
+				face.emplace_back(corner, relativeMask);
+			}
+
+			// Triangulate as a fan around the first corner
+			for (size_t i{ 1 }; i + 1 < face.size(); ++i)
+			{
+				for (size_t cornerIndex : { size_t{ 0 }, i, i + 1 })
+				{
+					if (face[cornerIndex].second != 0) {
+						chunk.RelativeIndices.emplace_back(static_cast<uint32_t>(data.Indices.size()), face[cornerIndex].second);
+					}
+					data.Indices.push_back(face[cornerIndex].first);
+				}
+			}
+		}
+
+		// Comments, groups, materials, ... & the rest of the current statement
+		SkipLine(p, pEnd);
+	}
+}
+
+void ObjParser::MergeChunk(const Chunk& chunk, ObjData& data)
+{
+	std::copy(chunk.Data.Positions.begin(), chunk.Data.Positions.end(), data.Positions.begin() + chunk.PositionBase * 3);
+	std::copy(chunk.Data.TexCoords.begin(), chunk.Data.TexCoords.end(), data.TexCoords.begin() + chunk.TexCoordBase * 2);
+	std::copy(chunk.Data.Normals.begin(), chunk.Data.Normals.end(), data.Normals.begin() + chunk.NormalBase * 3);
+
+	ObjIndex* pIndices = data.Indices.data() + chunk.IndexBase;
+	std::copy(chunk.Data.Indices.begin(), chunk.Data.Indices.end(), pIndices);
+
+	// Negative indices only know their position inside of the chunk
+	for (const auto& [corner, relativeMask] : chunk.RelativeIndices)
+	{
+		if (relativeMask & RELATIVE_POSITION) pIndices[corner].Position += static_cast<int32_t>(chunk.PositionBase);
+		if (relativeMask & RELATIVE_TEXCOORD) pIndices[corner].TexCoord += static_cast<int32_t>(chunk.TexCoordBase);
+		if (relativeMask & RELATIVE_NORMAL) pIndices[corner].Normal += static_cast<int32_t>(chunk.NormalBase);
+	}
+
+	// Catch broken files here instead of reading out of bounds later on
+	int32_t positionCount = static_cast<int32_t>(data.Positions.size() / 3);
+	int32_t texCoordCount = static_cast<int32_t>(data.TexCoords.size() / 2);
+	int32_t normalCount = static_cast<int32_t>(data.Normals.size() / 3);
+	for (size_t i{ 0 }; i < chunk.Data.Indices.size(); ++i)
+	{
+		const ObjIndex& index = pIndices[i];
+		if (index.Position < 0 || index.Position >= positionCount
+			|| index.TexCoord < -1 || index.TexCoord >= texCoordCount
+			|| index.Normal < -1 || index.Normal >= normalCount) {
+			throw std::runtime_error("failed to load model, index out of range!");
+		}
+	}
+}
@@ -0,0 +1,77 @@
+#ifndef GP2VKT_OBJPARSER_H_
+#define GP2VKT_OBJPARSER_H_
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+// Class Forward Declarations
+
+
+// Corner of a triangle, 0 based indices into the attribute arrays (-1 if the face doesn't have the attribute)
+struct ObjIndex
+{
+	int32_t Position{ -1 };
+	int32_t TexCoord{ -1 };
+	int32_t Normal{ -1 };
+};
+
+// Flat attribute arrays of all objects & groups in the file, faces are triangulated as a fan
+struct ObjData
+{
+	std::vector<float> Positions{}; // xyz
+	std::vector<float> TexCoords{}; // uv
+	std::vector<float> Normals{}; // xyz
+	std::vector<ObjIndex> Indices{}; // 3 per triangle
+};
+
+
+// Reads the geometry of Wavefront OBJ files, materials & other statements are skipped
+// The file is split into line aligned chunks that are parsed on separate threads and merged afterwards
+class ObjParser final
+{
+public:
+	// Constructors and Destructor
+	explicit ObjParser(uint32_t threadCount = 0); // 0 uses all hardware threads
+	~ObjParser() = default;
+
+	// Copy and Move semantics
+	ObjParser(const ObjParser& other)					= delete;
+	ObjParser& operator=(const ObjParser& other)		= delete;
+	ObjParser(ObjParser&& other) noexcept				= delete;
+	ObjParser& operator=(ObjParser&& other) noexcept	= delete;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	ObjData Parse(const char* filePath) const; // Read through vfs, so loose or from an asset pack
+
+
+private:
+	// Result of a single chunk, indices are only resolved once all chunks are done
+	struct Chunk
+	{
+		const char* pBegin{ nullptr };
+		const char* pEnd{ nullptr };
+
+		ObjData Data{};
+		std::vector<std::pair<uint32_t, uint8_t>> RelativeIndices{}; // Corner & attribute mask of negative OBJ indices
+
+		// Attributes of all chunks before this one
+		size_t PositionBase{};
+		size_t TexCoordBase{};
+		size_t NormalBase{};
+		size_t IndexBase{};
+	};
+
+	// Member variables
+	uint32_t m_ThreadCount{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+	static void ParseChunk(Chunk& chunk);
+	static void MergeChunk(const Chunk& chunk, ObjData& data);
+};
+#endif
@@ -8,13 +8,14 @@
 //-----------------------------------------------------------------
 // Constructors
 //-----------------------------------------------------------------
-GP2_VkBuffer::GP2_VkBuffer(const VkDevice& device, VkDeviceSize size, VkBufferUsageFlags usage, bool isShared)
+GP2_VkBuffer::GP2_VkBuffer(const VkDevice& device, VkDeviceSize size, VkBufferUsageFlags usage, bool isShared, const void* pNext)
 	: m_Device{ device }
 	, m_Buffer{}
 {
 	// Create info
 	VkBufferCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	createInfo.pNext = pNext;
 	createInfo.size = size; // Size of buffer in bytes
 	createInfo.usage = usage; // Which purposes the data is going to be used for
 	// Specify if the buffer is shared between queue families
@@ -64,6 +65,19 @@ GP2_VkBuffer::~GP2_VkBuffer()
 //-----------------------------------------------------------------
 // Public Member Functions
 //-----------------------------------------------------------------
+VkMemoryRequirements GP2_VkBuffer::GetMemoryRequirements() const
+{
+	VkMemoryRequirements memRequirements{};
+	vkGetBufferMemoryRequirements(m_Device, m_Buffer, &memRequirements);
+	return memRequirements;
+}
+
+void GP2_VkBuffer::BindMemory(VkDeviceMemory memory, VkDeviceSize offset) const
+{
+	// Associate memory with buffer
+	if (vkBindBufferMemory(m_Device, m_Buffer, memory, offset) != VK_SUCCESS)
+		throw std::runtime_error("failed to bind buffer memory!");
+}
 
 
 //-----------------------------------------------------------------
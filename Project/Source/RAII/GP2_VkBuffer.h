@@ -12,7 +12,7 @@ class GP2_VkBuffer final
 public:
 	// Constructors and Destructor
 	GP2_VkBuffer() = default;
-	GP2_VkBuffer(const VkDevice& device, VkDeviceSize size, VkBufferUsageFlags usage, bool isShared = false);
+	GP2_VkBuffer(const VkDevice& device, VkDeviceSize size, VkBufferUsageFlags usage, bool isShared = false, const void* pNext = nullptr); // pNext e.g. for external memory
 	~GP2_VkBuffer();
 	
 	// Copy and Move semantics
@@ -27,6 +27,9 @@ public:
 	operator VkBuffer() const { return m_Buffer; }
 	explicit operator const VkBuffer& () const { return m_Buffer; }
 
+	VkMemoryRequirements GetMemoryRequirements() const;
+	void BindMemory(VkDeviceMemory memory, VkDeviceSize offset) const; // Memory can be a slice of a bigger allocation
+
 
 private:
 	// Member variables
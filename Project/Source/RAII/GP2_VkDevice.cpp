@@ -8,12 +8,13 @@
 //-----------------------------------------------------------------
 // Constructors
 //-----------------------------------------------------------------
-GP2_VkDevice::GP2_VkDevice(const VkPhysicalDevice& physicalDevice, const std::vector<VkDeviceQueueCreateInfo>& queueCreateInfos, const std::vector<const char*>& enabledLayers, const std::vector<const char*>& enabledExtensions, const VkPhysicalDeviceFeatures& deviceFeatures)
+GP2_VkDevice::GP2_VkDevice(const VkPhysicalDevice& physicalDevice, const std::vector<VkDeviceQueueCreateInfo>& queueCreateInfos, const std::vector<const char*>& enabledLayers, const std::vector<const char*>& enabledExtensions, const VkPhysicalDeviceFeatures& deviceFeatures, const void* pNext)
 	: m_Device{}
 {
 	// Create info
 	VkDeviceCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	createInfo.pNext = pNext;
 	createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 	createInfo.pQueueCreateInfos = queueCreateInfos.data();
 	createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
@@ -17,7 +17,8 @@ public:
 		const std::vector<VkDeviceQueueCreateInfo>& queueCreateInfos,
 		const std::vector<const char*>& enabledLayers,
 		const std::vector<const char*>& enabledExtensions,
-		const VkPhysicalDeviceFeatures& deviceFeatures);
+		const VkPhysicalDeviceFeatures& deviceFeatures,
+		const void* pNext = nullptr); // Chain of extra feature structures
 	~GP2_VkDevice();
 	
 	// Copy and Move semantics
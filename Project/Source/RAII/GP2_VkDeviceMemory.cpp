@@ -8,13 +8,14 @@
 //-----------------------------------------------------------------
 // Constructors
 //-----------------------------------------------------------------
-GP2_VkDeviceMemory::GP2_VkDeviceMemory(const VkDevice& device, VkDeviceSize allocationSize, uint32_t memoryTypeIndex)
+GP2_VkDeviceMemory::GP2_VkDeviceMemory(const VkDevice& device, VkDeviceSize allocationSize, uint32_t memoryTypeIndex, const void* pNext)
 	: m_Device{ device }
 	, m_Memory{}
 {
 	// Create info
 	VkMemoryAllocateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	createInfo.pNext = pNext;
 	createInfo.allocationSize = allocationSize;
 	createInfo.memoryTypeIndex = memoryTypeIndex;
 
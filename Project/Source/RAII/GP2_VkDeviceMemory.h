@@ -12,7 +12,7 @@ class GP2_VkDeviceMemory final
 public:
 	// Constructors and Destructor
 	GP2_VkDeviceMemory() = default;
-	GP2_VkDeviceMemory(const VkDevice& device, VkDeviceSize allocationSize, uint32_t memoryTypeIndex);
+	GP2_VkDeviceMemory(const VkDevice& device, VkDeviceSize allocationSize, uint32_t memoryTypeIndex, const void* pNext = nullptr); // pNext e.g. to import memory
 	~GP2_VkDeviceMemory();
 	
 	// Copy and Move semantics
@@ -8,7 +8,7 @@
 //-----------------------------------------------------------------
 // Constructors
 //-----------------------------------------------------------------
-GP2_VkImage::GP2_VkImage(const VkDevice& device, VkFormat format, VkExtent3D extent, VkImageTiling tiling, VkImageUsageFlags usage, bool isShared)
+GP2_VkImage::GP2_VkImage(const VkDevice& device, VkFormat format, VkExtent3D extent, VkImageTiling tiling, VkImageUsageFlags usage, bool isShared, uint32_t mipLevels)
 	: m_Device{ device }
 	, m_Image{}
 {
@@ -20,7 +20,7 @@ GP2_VkImage::GP2_VkImage(const VkDevice& device, VkFormat format, VkExtent3D ext
 	createInfo.imageType = VK_IMAGE_TYPE_2D; // Specifies coordinate system
 	createInfo.format = format; // Should be the same format as the pixels in the buffer
 	createInfo.extent = extent;
-	createInfo.mipLevels = 1;
+	createInfo.mipLevels = mipLevels;
 	createInfo.arrayLayers = 1;
 	createInfo.samples = VK_SAMPLE_COUNT_1_BIT; // Only relevant for images used as attachments
 	createInfo.tiling = tiling; // This can not be changed at a later time
@@ -72,6 +72,19 @@ GP2_VkImage::~GP2_VkImage()
 //-----------------------------------------------------------------
 // Public Member Functions
 //-----------------------------------------------------------------
+VkMemoryRequirements GP2_VkImage::GetMemoryRequirements() const
+{
+	VkMemoryRequirements memRequirements{};
+	vkGetImageMemoryRequirements(m_Device, m_Image, &memRequirements);
+	return memRequirements;
+}
+
+void GP2_VkImage::BindMemory(VkDeviceMemory memory, VkDeviceSize offset) const
+{
+	// Associate memory with image
+	if (vkBindImageMemory(m_Device, m_Image, memory, offset) != VK_SUCCESS)
+		throw std::runtime_error("failed to bind image memory!");
+}
 
 
 //-----------------------------------------------------------------
@@ -17,7 +17,8 @@ public:
 		VkExtent3D extent,
 		VkImageTiling tiling,
 		VkImageUsageFlags usage,
-		bool isShared);
+		bool isShared,
+		uint32_t mipLevels = 1);
 	~GP2_VkImage();
 	
 	// Copy and Move semantics
@@ -32,6 +33,9 @@ public:
 	operator VkImage() const { return m_Image; }
 	explicit operator const VkImage& () const { return m_Image; }
 
+	VkMemoryRequirements GetMemoryRequirements() const;
+	void BindMemory(VkDeviceMemory memory, VkDeviceSize offset) const; // Memory can be a slice of a bigger allocation
+
 
 private:
 	// Member variables
@@ -8,7 +8,7 @@
 //-----------------------------------------------------------------
 // Constructors
 //-----------------------------------------------------------------
-GP2_VkImageView::GP2_VkImageView(const VkDevice& device, const VkImage& image, const VkFormat& format, const VkImageAspectFlags& aspectFlags)
+GP2_VkImageView::GP2_VkImageView(const VkDevice& device, const VkImage& image, const VkFormat& format, const VkImageAspectFlags& aspectFlags, uint32_t mipLevels)
 	: m_Device{ device }
 	, m_ImageView{}
 {
@@ -30,7 +30,7 @@ GP2_VkImageView::GP2_VkImageView(const VkDevice& device, const VkImage& image, c
 	// Describe the image purpose & which part to access
 	createInfo.subresourceRange.aspectMask = aspectFlags;
 	createInfo.subresourceRange.baseMipLevel = 0;
-	createInfo.subresourceRange.levelCount = 1;
+	createInfo.subresourceRange.levelCount = mipLevels;
 	createInfo.subresourceRange.baseArrayLayer = 0;
 	createInfo.subresourceRange.layerCount = 1;
 
@@ -17,6 +17,15 @@ GP2_VkPipeline::GP2_VkPipeline(const VkDevice& device, const VkGraphicsPipelineC
 		throw std::runtime_error("failed to create graphics pipeline!");
 }
 
+GP2_VkPipeline::GP2_VkPipeline(const VkDevice& device, const VkComputePipelineCreateInfo& createInfo)
+	: m_Device{ device }
+	, m_Pipeline{}
+{
+	// Create compute pipeline
+	if (vkCreateComputePipelines(m_Device, VK_NULL_HANDLE, 1, &createInfo, nullptr, &m_Pipeline) != VK_SUCCESS)
+		throw std::runtime_error("failed to create compute pipeline!");
+}
+
 GP2_VkPipeline::GP2_VkPipeline(GP2_VkPipeline&& other) noexcept
 	: m_Device{ other.m_Device }
 	, m_Pipeline{ other.m_Pipeline }
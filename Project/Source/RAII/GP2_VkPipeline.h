@@ -13,6 +13,7 @@ public:
 	// Constructors and Destructor
 	GP2_VkPipeline() = default;
 	GP2_VkPipeline(const VkDevice& device, const VkGraphicsPipelineCreateInfo& createInfo);
+	GP2_VkPipeline(const VkDevice& device, const VkComputePipelineCreateInfo& createInfo);
 	~GP2_VkPipeline();
 	
 	// Copy and Move semantics
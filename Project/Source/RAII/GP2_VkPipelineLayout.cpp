@@ -8,7 +8,7 @@
 //-----------------------------------------------------------------
 // Constructors
 //-----------------------------------------------------------------
-GP2_VkPipelineLayout::GP2_VkPipelineLayout(const VkDevice& device, const std::vector<VkDescriptorSetLayout>& setLayouts)
+GP2_VkPipelineLayout::GP2_VkPipelineLayout(const VkDevice& device, const std::vector<VkDescriptorSetLayout>& setLayouts, const std::vector<VkPushConstantRange>& pushConstantRanges)
 	: m_Device{ device }
 	, m_PipelineLayout{}
 {
@@ -18,8 +18,8 @@ GP2_VkPipelineLayout::GP2_VkPipelineLayout(const VkDevice& device, const std::ve
 	createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
 	createInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
 	createInfo.pSetLayouts = setLayouts.data();
-	createInfo.pushConstantRangeCount = 0;
-	createInfo.pPushConstantRanges = nullptr;
+	createInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+	createInfo.pPushConstantRanges = pushConstantRanges.data();
 
 	// Create pipeline layout
 	if (vkCreatePipelineLayout(m_Device, &createInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
@@ -13,7 +13,7 @@ class GP2_VkPipelineLayout final
 public:
 	// Constructors and Destructor
 	GP2_VkPipelineLayout() = default;
-	GP2_VkPipelineLayout(const VkDevice& device, const std::vector<VkDescriptorSetLayout>& setLayouts);
+	GP2_VkPipelineLayout(const VkDevice& device, const std::vector<VkDescriptorSetLayout>& setLayouts, const std::vector<VkPushConstantRange>& pushConstantRanges = {});
 	~GP2_VkPipelineLayout();
 	
 	// Copy and Move semantics
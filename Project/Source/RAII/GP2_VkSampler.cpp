@@ -8,7 +8,7 @@
 //-----------------------------------------------------------------
 // Constructors
 //-----------------------------------------------------------------
-GP2_VkSampler::GP2_VkSampler(const VkDevice& device, VkSamplerAddressMode addressMode, float maxAnisotropy, bool unnormalizedCoordinates)
+GP2_VkSampler::GP2_VkSampler(const VkDevice& device, VkSamplerAddressMode addressMode, float maxAnisotropy, bool unnormalizedCoordinates, float maxLod)
 	: m_Device{ device }
 	, m_Sampler{}
 {
@@ -22,10 +22,10 @@ GP2_VkSampler::GP2_VkSampler(const VkDevice& device, VkSamplerAddressMode addres
 	createInfo.addressModeV = addressMode;
 	createInfo.addressModeW = addressMode;
 
-	createInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	createInfo.mipmapMode = maxLod > 0.0f ? VK_SAMPLER_MIPMAP_MODE_LINEAR : VK_SAMPLER_MIPMAP_MODE_NEAREST;
 	createInfo.mipLodBias = 0.0f;
 	createInfo.minLod = 0.0f;
-	createInfo.maxLod = 0.0f;
+	createInfo.maxLod = maxLod; // Has to be 0 for unnormalized coordinates
 
 	// TODO: match anisotropyEnable with VkPhysicalDeviceFeatures::samplerAnisotropy in logical device
 	createInfo.anisotropyEnable = static_cast<VkBool32>(maxAnisotropy >= 1.0f); // Disabling will lead to better performance
@@ -15,7 +15,8 @@ public:
 	GP2_VkSampler(const VkDevice& device,
 		VkSamplerAddressMode addressMode,
 		float maxAnisotropy,
-		bool unnormalizedCoordinates = false);
+		bool unnormalizedCoordinates = false,
+		float maxLod = 0.0f); // Above 0 blends between mip levels (trilinear), VK_LOD_CLAMP_NONE uses all of them
 	~GP2_VkSampler();
 	
 	// Copy and Move semantics
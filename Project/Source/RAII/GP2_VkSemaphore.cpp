@@ -21,6 +21,25 @@ GP2_VkSemaphore::GP2_VkSemaphore(const VkDevice& device)
 		throw std::runtime_error("failed to create semaphore!");
 }
 
+GP2_VkSemaphore::GP2_VkSemaphore(const VkDevice& device, uint64_t initialValue)
+	: m_Device{ device }
+	, m_Semaphore{}
+{
+	// Counter that only ever increases, can be waited on and signaled by both the host & the device
+	VkSemaphoreTypeCreateInfo typeCreateInfo{};
+	typeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	typeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	typeCreateInfo.initialValue = initialValue;
+
+	VkSemaphoreCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	createInfo.pNext = &typeCreateInfo;
+
+	// Create semaphore
+	if (vkCreateSemaphore(m_Device, &createInfo, nullptr, &m_Semaphore) != VK_SUCCESS)
+		throw std::runtime_error("failed to create timeline semaphore!");
+}
+
 GP2_VkSemaphore::GP2_VkSemaphore(GP2_VkSemaphore&& other) noexcept
 	: m_Device{ other.m_Device }
 	, m_Semaphore{ other.m_Semaphore }
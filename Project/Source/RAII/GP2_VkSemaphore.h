@@ -13,6 +13,7 @@ public:
 	// Constructors and Destructor
 	GP2_VkSemaphore() = default;
 	GP2_VkSemaphore(const VkDevice& device);
+	GP2_VkSemaphore(const VkDevice& device, uint64_t initialValue); // Timeline semaphore
 	~GP2_VkSemaphore();
 	
 	// Copy and Move semantics
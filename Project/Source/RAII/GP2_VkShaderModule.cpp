@@ -2,7 +2,7 @@
 // Includes
 //-----------------------------------------------------------------
 #include "GP2_VkShaderModule.h"
-#include "Utils.h"
+#include "Source/VirtualFileSystem.h"
 #include <stdexcept>
 
 
@@ -10,17 +10,24 @@
 // Constructors
 //-----------------------------------------------------------------
 GP2_VkShaderModule::GP2_VkShaderModule(const VkDevice& device, const std::string& path)
+	: GP2_VkShaderModule{ device, vfs::Read(path) }
+{
+}
+
+GP2_VkShaderModule::GP2_VkShaderModule(const VkDevice& device, const AssetData& shaderCode)
+	: GP2_VkShaderModule{ device, shaderCode.GetData(), shaderCode.GetSize() }
+{
+}
+
+GP2_VkShaderModule::GP2_VkShaderModule(const VkDevice& device, const char* pCode, size_t codeSize)
 	: m_Device{ device }
 	, m_ShaderModule{}
 {
-	// Load bytecode for the shader
-	auto shaderCode = util::ReadFile(path);
-
-	// Specify bytecode and size
+	// Specify bytecode and size, mappings & buffers are aligned well enough to be read as 32 bit words
 	VkShaderModuleCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-	createInfo.codeSize = shaderCode.size();
-	createInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.data());
+	createInfo.codeSize = codeSize;
+	createInfo.pCode = reinterpret_cast<const uint32_t*>(pCode);
 
 	// Create shader module using specified data
 	if (vkCreateShaderModule(m_Device, &createInfo, nullptr, &m_ShaderModule) != VK_SUCCESS)
@@ -5,6 +5,7 @@
 #include <string>
 
 // Class Forward Declarations
+class AssetData;
 
 
 // RAII wrapper for VkShaderModule 
@@ -14,6 +15,8 @@ public:
 	// Constructors and Destructor
 	GP2_VkShaderModule() = default;
 	GP2_VkShaderModule(const VkDevice& device, const std::string& path);
+	GP2_VkShaderModule(const VkDevice& device, const AssetData& shaderCode); // SPIR-V that was already read, e.g. through vfs::ReadAll
+	GP2_VkShaderModule(const VkDevice& device, const char* pCode, size_t codeSize);
 	~GP2_VkShaderModule();
 	
 	// Copy and Move semantics
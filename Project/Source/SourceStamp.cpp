@@ -0,0 +1,69 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "SourceStamp.h"
+#include "MappedFile.h"
+#include <filesystem>
+#include <cstring>
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	bool GetSizeAndTime(const std::string& sourcePath, uint64_t& size, int64_t& time)
+	{
+		std::error_code error{};
+		size = std::filesystem::file_size(sourcePath, error);
+		if (error) return false;
+
+		time = std::filesystem::last_write_time(sourcePath, error).time_since_epoch().count();
+		return !error;
+	}
+
+	uint64_t HashFile(const std::string& filePath)
+	{
+		MappedFile file{ filePath.c_str() };
+		const char* pData = file.GetData();
+		size_t size = file.GetSize();
+
+		// FNV-1a on 8 bytes at a time
+		uint64_t hash{ 0xcbf29ce484222325ull };
+		size_t i{ 0 };
+		for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+		{
+			uint64_t word{};
+			memcpy(&word, pData + i, sizeof(word));
+			hash = (hash ^ word) * 0x100000001b3ull;
+		}
+		for (; i < size; ++i)
+		{
+			hash = (hash ^ static_cast<uint8_t>(pData[i])) * 0x100000001b3ull;
+		}
+		return hash;
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Functions
+//-----------------------------------------------------------------
+bool stamps::ReadSourceStamp(const std::string& sourcePath, SourceStamp& stamp)
+{
+	if (GetSizeAndTime(sourcePath, stamp.Size, stamp.Time) == false) return false;
+	stamp.Hash = HashFile(sourcePath);
+	return true;
+}
+
+bool stamps::MatchesSourceStamp(const std::string& sourcePath, const SourceStamp& stamp)
+{
+	std::error_code error{};
+	if (std::filesystem::exists(sourcePath, error) == false) return true;
+
+	uint64_t size{};
+	int64_t time{};
+	if (GetSizeAndTime(sourcePath, size, time) == false) return false;
+	if (size != stamp.Size) return false;
+	return time == stamp.Time || HashFile(sourcePath) == stamp.Hash;
+}
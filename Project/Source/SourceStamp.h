@@ -0,0 +1,27 @@
+#ifndef GP2VKT_SOURCESTAMP_H_
+#define GP2VKT_SOURCESTAMP_H_
+// Includes
+#include <cstdint>
+#include <string>
+
+// Class Forward Declarations
+
+
+// Identifies the version of a source file a cache was made from
+struct SourceStamp
+{
+	uint64_t Size{};
+	int64_t Time{}; // Last write time
+	uint64_t Hash{}; // FNV-1a of the contents, only used to detect changed files, not as a checksum
+};
+
+
+namespace stamps
+{
+	bool ReadSourceStamp(const std::string& sourcePath, SourceStamp& stamp); // False if the file can't be read
+
+	// A matching size & write time is trusted, the content hash only has to be checked when the time changed (e.g. a fresh checkout)
+	// Missing sources match too, caches read from an asset pack are shipped without them
+	bool MatchesSourceStamp(const std::string& sourcePath, const SourceStamp& stamp);
+}
+#endif
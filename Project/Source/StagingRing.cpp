@@ -0,0 +1,207 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "StagingRing.h"
+#include <stdexcept>
+#include <numeric>
+#include <algorithm>
+#include <cstring>
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+StagingRing::StagingRing(VkDevice device, MemoryAllocator& allocator, VkDeviceSize size)
+	: m_Device{ device }
+	, m_Allocator{ allocator }
+	, m_Size{ size }
+{
+	// Create the ring buffer, host visible memory stays mapped for the lifetime of the allocation
+	m_Buffer = GP2_VkBuffer{ m_Device, m_Size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, false };
+	m_Memory = m_Allocator.AllocateAndBind(m_Buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	m_pData = static_cast<char*>(m_Memory.GetMappedData());
+}
+
+
+//-----------------------------------------------------------------
+// Destructor
+//-----------------------------------------------------------------
+StagingRing::~StagingRing()
+{
+	// The GPU might still be reading from the buffers
+	for (const Batch& batch : m_InFlightBatches)
+	{
+		vkWaitForFences(m_Device, 1, &static_cast<const VkFence&>(batch.Fence), VK_TRUE, UINT64_MAX);
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+StagingRegion StagingRing::Allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+	// Uploads bigger than the ring can never fit
+	if (size > m_Size) return AllocateDedicated(size);
+
+	Reclaim();
+
+	// Wait for the oldest upload to finish until there is enough space
+	StagingRegion region{};
+	while (TryAllocate(size, alignment, region) == false)
+	{
+		// Space is taken by regions that weren't submitted yet, waiting would never end
+		if (m_InFlightBatches.empty()) return AllocateDedicated(size);
+
+		vkWaitForFences(m_Device, 1, &static_cast<const VkFence&>(m_InFlightBatches.front().Fence), VK_TRUE, UINT64_MAX);
+		Reclaim();
+	}
+	return region;
+}
+
+StagingRegion StagingRing::Write(const std::vector<VkDeviceSize>& sizes, const std::vector<const void*>& datas, VkDeviceSize alignment)
+{
+	// Exit early in case of wrong input values
+	if (sizes.size() != datas.size() || sizes.empty()) return StagingRegion{};
+
+	// Copy datas right after each other
+	StagingRegion region = Allocate(std::accumulate(sizes.begin(), sizes.end(), static_cast<VkDeviceSize>(0)), alignment);
+	VkDeviceSize offset{ 0 };
+	for (size_t i{ 0 }; i < datas.size(); ++i)
+	{
+		memcpy(static_cast<char*>(region.pData) + offset, datas[i], sizes[i]);
+
+		offset += sizes[i];
+	}
+
+	return region;
+}
+
+StagingRegion StagingRing::ImportFile(const char* filePath, uint64_t offset, VkDeviceSize size)
+{
+	if (CanImportFiles() == false || size == 0) return StagingRegion{};
+
+	ImportedFile imported{};
+	imported.File = MappedFile{ filePath };
+	if (imported.File.IsOpen() == false || offset > imported.File.GetSize() || size > imported.File.GetSize() - offset) return StagingRegion{};
+
+	// The imported range starts & ends on the import alignment, the mapping has to start on it as well to stay inside of its pages
+	if (reinterpret_cast<uintptr_t>(imported.File.GetData()) % m_ImportAlignment != 0) return StagingRegion{};
+	const VkDeviceSize importOffset{ offset % m_ImportAlignment };
+	const VkDeviceSize importSize{ (importOffset + size + m_ImportAlignment - 1) / m_ImportAlignment * m_ImportAlignment };
+	void* pImport = const_cast<char*>(imported.File.GetData() + (offset - importOffset));
+
+	VkMemoryHostPointerPropertiesEXT hostPointerProperties{};
+	hostPointerProperties.sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+	if (m_pfnGetMemoryHostPointerProperties(m_Device, VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT, pImport, &hostPointerProperties) != VK_SUCCESS) return StagingRegion{};
+
+	VkExternalMemoryBufferCreateInfo externalInfo{};
+	externalInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+	externalInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+
+	VkImportMemoryHostPointerInfoEXT importInfo{};
+	importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+	importInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+	importInfo.pHostPointer = pImport;
+
+	// Drivers may refuse file backed or read only pages, that isn't an error
+	try {
+		imported.Buffer = GP2_VkBuffer{ m_Device, importSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, false, &externalInfo };
+		VkMemoryRequirements requirements{};
+		vkGetBufferMemoryRequirements(m_Device, imported.Buffer, &requirements);
+		const uint32_t memoryTypeBits{ requirements.memoryTypeBits & hostPointerProperties.memoryTypeBits };
+		if (memoryTypeBits == 0 || requirements.size > importSize) return StagingRegion{};
+
+		uint32_t memoryTypeIndex{ 0 };
+		while ((memoryTypeBits & (1u << memoryTypeIndex)) == 0) ++memoryTypeIndex;
+		imported.Memory = GP2_VkDeviceMemory{ m_Device, importSize, memoryTypeIndex, &importInfo };
+		if (vkBindBufferMemory(m_Device, imported.Buffer, imported.Memory, 0) != VK_SUCCESS) return StagingRegion{};
+	}
+	catch (const std::runtime_error&) {
+		return StagingRegion{};
+	}
+
+	// Kept alive until the batch it's part of has finished
+	StagingRegion region{ imported.Buffer, importOffset, size, nullptr };
+	m_OpenImportedFiles.push_back(std::move(imported));
+	return region;
+}
+
+void StagingRing::EnableFileImport(PFN_vkGetMemoryHostPointerPropertiesEXT pfnGetMemoryHostPointerProperties, VkDeviceSize alignment)
+{
+	m_pfnGetMemoryHostPointerProperties = pfnGetMemoryHostPointerProperties;
+	m_ImportAlignment = std::max<VkDeviceSize>(alignment, 1);
+}
+
+VkFence StagingRing::Submit()
+{
+	Reclaim();
+
+	// Reuse the fence of a finished batch if possible
+	GP2_VkFence fence{};
+	if (m_FreeFences.empty()) {
+		fence = GP2_VkFence{ m_Device };
+	}
+	else {
+		fence = std::move(m_FreeFences.back());
+		m_FreeFences.pop_back();
+		vkResetFences(m_Device, 1, &static_cast<const VkFence&>(fence));
+	}
+
+	m_InFlightBatches.push_back(Batch{ std::move(fence), m_Head, std::move(m_OpenDedicatedBuffers), std::move(m_OpenImportedFiles) });
+	m_OpenDedicatedBuffers.clear();
+	m_OpenImportedFiles.clear();
+
+	return m_InFlightBatches.back().Fence;
+}
+
+void StagingRing::Reclaim()
+{
+	// Batches finish in submission order
+	while (m_InFlightBatches.empty() == false && vkGetFenceStatus(m_Device, m_InFlightBatches.front().Fence) == VK_SUCCESS)
+	{
+		m_Tail = m_InFlightBatches.front().End;
+		m_FreeFences.push_back(std::move(m_InFlightBatches.front().Fence));
+		m_InFlightBatches.pop_front();
+	}
+
+	// Start at the beginning again when everything is free to avoid wrapping around big uploads
+	if (m_InFlightBatches.empty() && m_Head == m_Tail) {
+		m_Head = 0;
+		m_Tail = 0;
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+bool StagingRing::TryAllocate(VkDeviceSize size, VkDeviceSize alignment, StagingRegion& region)
+{
+	alignment = std::max<VkDeviceSize>(alignment, 1);
+
+	// Regions can't wrap around, skip to the start of the buffer if it doesn't fit before the end
+	uint64_t start = (m_Head + alignment - 1) / alignment * alignment;
+	if (start % m_Size + size > m_Size) {
+		start = (start / m_Size + 1) * m_Size;
+	}
+
+	// Would overwrite regions that are still in use
+	if (start + size - m_Tail > m_Size) return false;
+
+	m_Head = start + size;
+	region = StagingRegion{ m_Buffer, start % m_Size, size, m_pData + start % m_Size };
+	return true;
+}
+
+StagingRegion StagingRing::AllocateDedicated(VkDeviceSize size)
+{
+	DedicatedBuffer dedicated{};
+	dedicated.Buffer = GP2_VkBuffer{ m_Device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, false };
+	dedicated.Memory = m_Allocator.AllocateAndBind(dedicated.Buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+	// Kept alive until the batch it's part of has finished
+	StagingRegion region{ dedicated.Buffer, 0, size, dedicated.Memory.GetMappedData() };
+	m_OpenDedicatedBuffers.push_back(std::move(dedicated));
+	return region;
+}
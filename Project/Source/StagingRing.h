@@ -0,0 +1,110 @@
+#ifndef GP2VKT_STAGINGRING_H_
+#define GP2VKT_STAGINGRING_H_
+// Includes
+#include <vulkan/vulkan_core.h>
+#include <vector>
+#include <deque>
+#include "MemoryAllocator.h"
+#include "MappedFile.h"
+#include "RAII/GP2_VkBuffer.h"
+#include "RAII/GP2_VkFence.h"
+#include "RAII/GP2_VkDeviceMemory.h"
+
+// Class Forward Declarations
+
+
+// Part of a staging buffer that can be written to from the CPU and copied from on the GPU
+struct StagingRegion
+{
+	VkBuffer Buffer{ VK_NULL_HANDLE };
+	VkDeviceSize Offset{};
+	VkDeviceSize Size{};
+	void* pData{ nullptr };
+};
+
+
+// Single persistently mapped staging buffer that is handed out in a ring
+// Regions are reclaimed once the fence of the submit that reads from them is signaled
+class StagingRing final
+{
+public:
+	// Constructors and Destructor
+	explicit StagingRing(VkDevice device, MemoryAllocator& allocator, VkDeviceSize size);
+	~StagingRing();
+
+	// Copy and Move semantics
+	StagingRing(const StagingRing& other)					= delete;
+	StagingRing& operator=(const StagingRing& other)		= delete;
+	StagingRing(StagingRing&& other) noexcept				= delete;
+	StagingRing& operator=(StagingRing&& other) noexcept	= delete;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	// Waits for older uploads when the ring is full, falls back to a dedicated buffer if waiting can't help
+	StagingRegion Allocate(VkDeviceSize size, VkDeviceSize alignment = 16);
+	StagingRegion Write(const std::vector<VkDeviceSize>& sizes, const std::vector<const void*>& datas, VkDeviceSize alignment = 16);
+
+	// Maps part of a file & imports the mapping as a transfer source with VK_EXT_external_memory_host, nothing is copied on the CPU
+	// The region is read only (no pData), empty if importing isn't enabled or the driver refuses the mapping, fall back to Allocate then
+	StagingRegion ImportFile(const char* filePath, uint64_t offset, VkDeviceSize size);
+	void EnableFileImport(PFN_vkGetMemoryHostPointerPropertiesEXT pfnGetMemoryHostPointerProperties, VkDeviceSize alignment); // minImportedHostPointerAlignment
+	bool CanImportFiles() const { return m_pfnGetMemoryHostPointerProperties != nullptr; }
+
+	// Closes the current batch of regions, the returned fence has to be signaled by the submit that reads from them
+	VkFence Submit();
+	void Reclaim();
+
+	VkDeviceSize GetSize() const { return m_Size; }
+	char* GetMappedData() const { return m_pData; } // Whole ring, e.g. to register it for file reads
+
+
+private:
+	struct DedicatedBuffer
+	{
+		GP2_VkBuffer Buffer;
+		MemoryAllocation Memory;
+	};
+	struct ImportedFile
+	{
+		MappedFile File; // Unmapped after the memory is freed
+		GP2_VkDeviceMemory Memory;
+		GP2_VkBuffer Buffer;
+	};
+	struct Batch
+	{
+		GP2_VkFence Fence;
+		uint64_t End{}; // Ring position right after the last region of the batch
+		std::vector<DedicatedBuffer> DedicatedBuffers;
+		std::vector<ImportedFile> ImportedFiles;
+	};
+
+	// Member variables
+	VkDevice m_Device{ nullptr };
+	MemoryAllocator& m_Allocator;
+
+	VkDeviceSize m_Size{};
+	GP2_VkBuffer m_Buffer{};
+	MemoryAllocation m_Memory{};
+	char* m_pData{ nullptr };
+
+	// Ever increasing positions, the offset in the buffer is position % size
+	uint64_t m_Head{};
+	uint64_t m_Tail{};
+
+	std::vector<DedicatedBuffer> m_OpenDedicatedBuffers{};
+	std::vector<ImportedFile> m_OpenImportedFiles{};
+	std::deque<Batch> m_InFlightBatches{};
+	std::vector<GP2_VkFence> m_FreeFences{};
+
+	// Host memory import, only set if the device has VK_EXT_external_memory_host
+	PFN_vkGetMemoryHostPointerPropertiesEXT m_pfnGetMemoryHostPointerProperties{ nullptr };
+	VkDeviceSize m_ImportAlignment{ 1 };
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+	bool TryAllocate(VkDeviceSize size, VkDeviceSize alignment, StagingRegion& region);
+	StagingRegion AllocateDedicated(VkDeviceSize size);
+};
+#endif
@@ -0,0 +1,422 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "TangentGenerator.h"
+#include "VertexDeduplicator.h"
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <thread>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GP2VKT_TANGENT_SSE2
+#include <emmintrin.h>
+#endif
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	constexpr size_t BLOCK_SIZE{ 64 }; // Triangles gathered into SoA arrays at a time, a multiple of the SIMD width
+	constexpr size_t MIN_RANGE_SIZE{ 65536 }; // Triangles or vertices per thread, smaller ranges don't make up for starting the thread
+	constexpr float DEGENERATE_EPSILON{ 1e-6f }; // UV determinants this small compared to their terms are rounding noise
+	constexpr uint8_t MIRRORED_FLAG{ 1 }; // Negative UV determinant
+	constexpr uint8_t DEGENERATE_FLAG{ 2 };
+
+	struct Vector
+	{
+		float X{}, Y{}, Z{};
+	};
+	Vector operator+(const Vector& a, const Vector& b) { return Vector{ a.X + b.X, a.Y + b.Y, a.Z + b.Z }; }
+	Vector operator-(const Vector& a, const Vector& b) { return Vector{ a.X - b.X, a.Y - b.Y, a.Z - b.Z }; }
+	Vector operator*(const Vector& a, float s) { return Vector{ a.X * s, a.Y * s, a.Z * s }; }
+	float Dot(const Vector& a, const Vector& b) { return a.X * b.X + a.Y * b.Y + a.Z * b.Z; }
+	Vector Cross(const Vector& a, const Vector& b) { return Vector{ a.Y * b.Z - a.Z * b.Y, a.Z * b.X - a.X * b.Z, a.X * b.Y - a.Y * b.X }; }
+
+	const float* GetAttribute(const float* pAttributes, size_t vertexStride, uint32_t vertex)
+	{
+		return reinterpret_cast<const float*>(reinterpret_cast<const char*>(pAttributes) + vertex * vertexStride);
+	}
+
+	// Splits [0, count) into at most threadCount ranges, the first one runs on the calling thread
+	size_t GetRangeCount(size_t count, uint32_t threadCount)
+	{
+		return std::clamp<size_t>(count / MIN_RANGE_SIZE, 1, threadCount);
+	}
+	template<typename Function>
+	void ForEachRange(size_t count, size_t rangeCount, const Function& function)
+	{
+		std::vector<std::future<void>> tasks{};
+		for (size_t range{ 1 }; range < rangeCount; ++range)
+		{
+			size_t begin{ count * range / rangeCount }, end{ count * (range + 1) / rangeCount };
+			tasks.push_back(std::async(std::launch::async, [&function, begin, end, range]() { function(begin, end, range); }));
+		}
+		function(size_t{ 0 }, count / rangeCount, size_t{ 0 });
+		for (std::future<void>& task : tasks) task.get();
+	}
+
+	// Corners of BLOCK_SIZE triangles & their results, indexed [corner][axis][triangle]
+	struct TriangleBlock
+	{
+		alignas(16) float Positions[3][3][BLOCK_SIZE];
+		alignas(16) float TexCoords[3][2][BLOCK_SIZE];
+
+		alignas(16) float Tangents[3][BLOCK_SIZE]; // Normalized, zero for degenerate triangles
+		alignas(16) float CornerCosines[3][BLOCK_SIZE]; // 1 if an edge of the corner has no length, so its angle is 0
+		uint8_t Flags[BLOCK_SIZE];
+	};
+
+	// Per triangle results of the whole mesh
+	struct TriangleFrames
+	{
+		std::vector<float> Tangents[3]{};
+		std::vector<float> CornerCosines[3]{};
+		std::vector<uint8_t> Flags{};
+	};
+
+	// dP/du without the division by the determinant, only its sign matters once it is normalized
+	void ComputeFramesScalar(TriangleBlock& block, size_t begin, size_t end)
+	{
+		for (size_t i{ begin }; i < end; ++i)
+		{
+			Vector p0{ block.Positions[0][0][i], block.Positions[0][1][i], block.Positions[0][2][i] };
+			Vector p1{ block.Positions[1][0][i], block.Positions[1][1][i], block.Positions[1][2][i] };
+			Vector p2{ block.Positions[2][0][i], block.Positions[2][1][i], block.Positions[2][2][i] };
+			Vector e1{ p1 - p0 }, e2{ p2 - p0 }, e3{ p2 - p1 };
+
+			float du1{ block.TexCoords[1][0][i] - block.TexCoords[0][0][i] }, dv1{ block.TexCoords[1][1][i] - block.TexCoords[0][1][i] };
+			float du2{ block.TexCoords[2][0][i] - block.TexCoords[0][0][i] }, dv2{ block.TexCoords[2][1][i] - block.TexCoords[0][1][i] };
+			float determinant{ du1 * dv2 - du2 * dv1 };
+			bool isValid{ std::abs(determinant) > DEGENERATE_EPSILON * (std::abs(du1 * dv2) + std::abs(du2 * dv1)) };
+			float sign{ determinant < 0.f ? -1.f : 1.f };
+
+			Vector tangent{ e1 * dv2 - e2 * dv1 };
+			float tangentLength{ std::sqrt(Dot(tangent, tangent)) };
+			tangent = isValid && tangentLength > 0.f ? tangent * (sign / tangentLength) : Vector{};
+
+			block.Tangents[0][i] = tangent.X;
+			block.Tangents[1][i] = tangent.Y;
+			block.Tangents[2][i] = tangent.Z;
+
+			float length1{ std::sqrt(Dot(e1, e1)) }, length2{ std::sqrt(Dot(e2, e2)) }, length3{ std::sqrt(Dot(e3, e3)) };
+			block.CornerCosines[0][i] = length1 > 0.f && length2 > 0.f ? Dot(e1, e2) / (length1 * length2) : 1.f;
+			block.CornerCosines[1][i] = length1 > 0.f && length3 > 0.f ? -Dot(e1, e3) / (length1 * length3) : 1.f;
+			block.CornerCosines[2][i] = length2 > 0.f && length3 > 0.f ? Dot(e2, e3) / (length2 * length3) : 1.f;
+
+			block.Flags[i] = static_cast<uint8_t>((determinant < 0.f ? MIRRORED_FLAG : 0) | (isValid ? 0 : DEGENERATE_FLAG));
+		}
+	}
+
+#ifdef GP2VKT_TANGENT_SSE2
+	struct Vector4
+	{
+		__m128 X, Y, Z;
+	};
+	Vector4 Load(const float (&axes)[3][BLOCK_SIZE], size_t i)
+	{
+		return Vector4{ _mm_load_ps(&axes[0][i]), _mm_load_ps(&axes[1][i]), _mm_load_ps(&axes[2][i]) };
+	}
+	void Store(float (&axes)[3][BLOCK_SIZE], size_t i, const Vector4& v)
+	{
+		_mm_store_ps(&axes[0][i], v.X);
+		_mm_store_ps(&axes[1][i], v.Y);
+		_mm_store_ps(&axes[2][i], v.Z);
+	}
+	Vector4 Subtract(const Vector4& a, const Vector4& b) { return Vector4{ _mm_sub_ps(a.X, b.X), _mm_sub_ps(a.Y, b.Y), _mm_sub_ps(a.Z, b.Z) }; }
+	Vector4 Scale(const Vector4& a, __m128 s) { return Vector4{ _mm_mul_ps(a.X, s), _mm_mul_ps(a.Y, s), _mm_mul_ps(a.Z, s) }; }
+	__m128 Dot(const Vector4& a, const Vector4& b)
+	{
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.X, b.X), _mm_mul_ps(a.Y, b.Y)), _mm_mul_ps(a.Z, b.Z));
+	}
+	__m128 Abs(__m128 value) { return _mm_andnot_ps(_mm_set1_ps(-0.f), value); }
+	__m128 Select(__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+	// 1 / length, 0 where the mask is cleared or the length is 0
+	__m128 InverseLength(__m128 lengthSquared, __m128 mask)
+	{
+		mask = _mm_and_ps(mask, _mm_cmpgt_ps(lengthSquared, _mm_setzero_ps()));
+		return _mm_and_ps(mask, _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(lengthSquared)));
+	}
+
+	// Same math as ComputeFramesScalar, 4 triangles per iteration
+	void ComputeFrames(TriangleBlock& block, size_t count)
+	{
+		const __m128 signMask{ _mm_set1_ps(-0.f) };
+		const __m128 one{ _mm_set1_ps(1.f) };
+
+		size_t i{ 0 };
+		for (; i + 4 <= count; i += 4)
+		{
+			Vector4 p0{ Load(block.Positions[0], i) }, p1{ Load(block.Positions[1], i) }, p2{ Load(block.Positions[2], i) };
+			Vector4 e1{ Subtract(p1, p0) }, e2{ Subtract(p2, p0) }, e3{ Subtract(p2, p1) };
+
+			__m128 u0{ _mm_load_ps(&block.TexCoords[0][0][i]) }, v0{ _mm_load_ps(&block.TexCoords[0][1][i]) };
+			__m128 du1{ _mm_sub_ps(_mm_load_ps(&block.TexCoords[1][0][i]), u0) }, dv1{ _mm_sub_ps(_mm_load_ps(&block.TexCoords[1][1][i]), v0) };
+			__m128 du2{ _mm_sub_ps(_mm_load_ps(&block.TexCoords[2][0][i]), u0) }, dv2{ _mm_sub_ps(_mm_load_ps(&block.TexCoords[2][1][i]), v0) };
+			__m128 term1{ _mm_mul_ps(du1, dv2) }, term2{ _mm_mul_ps(du2, dv1) };
+			__m128 determinant{ _mm_sub_ps(term1, term2) };
+			__m128 isValid{ _mm_cmpgt_ps(Abs(determinant), _mm_mul_ps(_mm_set1_ps(DEGENERATE_EPSILON), _mm_add_ps(Abs(term1), Abs(term2)))) };
+			__m128 sign{ _mm_and_ps(determinant, signMask) };
+
+			Vector4 tangent{ Subtract(Scale(e1, dv2), Scale(e2, dv1)) };
+			Store(block.Tangents, i, Scale(tangent, _mm_xor_ps(InverseLength(Dot(tangent, tangent), isValid), sign)));
+
+			__m128 allLanes{ _mm_cmpeq_ps(one, one) };
+			__m128 inverseLength1{ InverseLength(Dot(e1, e1), allLanes) };
+			__m128 inverseLength2{ InverseLength(Dot(e2, e2), allLanes) };
+			__m128 inverseLength3{ InverseLength(Dot(e3, e3), allLanes) };
+			__m128 cosine0{ _mm_mul_ps(Dot(e1, e2), _mm_mul_ps(inverseLength1, inverseLength2)) };
+			__m128 cosine1{ _mm_xor_ps(_mm_mul_ps(Dot(e1, e3), _mm_mul_ps(inverseLength1, inverseLength3)), signMask) };
+			__m128 cosine2{ _mm_mul_ps(Dot(e2, e3), _mm_mul_ps(inverseLength2, inverseLength3)) };
+			__m128 zero{ _mm_setzero_ps() };
+			_mm_store_ps(&block.CornerCosines[0][i], Select(_mm_and_ps(_mm_cmpneq_ps(inverseLength1, zero), _mm_cmpneq_ps(inverseLength2, zero)), cosine0, one));
+			_mm_store_ps(&block.CornerCosines[1][i], Select(_mm_and_ps(_mm_cmpneq_ps(inverseLength1, zero), _mm_cmpneq_ps(inverseLength3, zero)), cosine1, one));
+			_mm_store_ps(&block.CornerCosines[2][i], Select(_mm_and_ps(_mm_cmpneq_ps(inverseLength2, zero), _mm_cmpneq_ps(inverseLength3, zero)), cosine2, one));
+
+			int mirroredBits{ _mm_movemask_ps(_mm_cmplt_ps(determinant, zero)) };
+			int validBits{ _mm_movemask_ps(isValid) };
+			for (int lane{ 0 }; lane < 4; ++lane)
+			{
+				block.Flags[i + lane] = static_cast<uint8_t>(((mirroredBits >> lane) & 1 ? MIRRORED_FLAG : 0) | ((validBits >> lane) & 1 ? 0 : DEGENERATE_FLAG));
+			}
+		}
+		ComputeFramesScalar(block, i, count);
+	}
+#else
+	void ComputeFrames(TriangleBlock& block, size_t count)
+	{
+		ComputeFramesScalar(block, 0, count);
+	}
+#endif
+
+	// Angle weighted sum of the tangents of some corners around a vertex
+	Vector SumCorners(const TriangleFrames& frames, const uint32_t* pCorners, uint32_t cornerCount)
+	{
+		Vector sum{};
+		for (uint32_t i{ 0 }; i < cornerCount; ++i)
+		{
+			uint32_t triangle{ pCorners[i] / 3 }, corner{ pCorners[i] % 3 };
+			float weight{ std::acos(std::clamp(frames.CornerCosines[corner][triangle], -1.f, 1.f)) };
+			sum = sum + Vector{ frames.Tangents[0][triangle], frames.Tangents[1][triangle], frames.Tangents[2][triangle] } * weight;
+		}
+		return sum;
+	}
+
+	// Gram-Schmidt against the normal, vertices without a usable tangent get any vector perpendicular to it
+	// Like MikkTSpace the sign comes from the orientation of the UV mapping, mirrored triangles get -1
+	void ResolveFrame(const Vector& sum, const Vector& normal, bool isMirrored, float* pTangent)
+	{
+		Vector tangent{ sum - normal * Dot(normal, sum) };
+		float lengthSquared{ Dot(tangent, tangent) };
+		if (lengthSquared <= 1e-12f || std::isfinite(lengthSquared) == false) {
+			tangent = Cross(normal, std::abs(normal.X) < 0.9f ? Vector{ 1.f, 0.f, 0.f } : Vector{ 0.f, 1.f, 0.f });
+			lengthSquared = Dot(tangent, tangent);
+			if (lengthSquared <= 0.f) {
+				tangent = Vector{ 1.f, 0.f, 0.f };
+				lengthSquared = 1.f;
+			}
+		}
+		tangent = tangent * (1.f / std::sqrt(lengthSquared));
+
+		pTangent[0] = tangent.X;
+		pTangent[1] = tangent.Y;
+		pTangent[2] = tangent.Z;
+		pTangent[3] = isMirrored ? -1.f : 1.f;
+	}
+
+	struct Split
+	{
+		uint32_t Vertex{};
+		float Tangent[4]{};
+	};
+
+	// The attributes the tangent depends on, welded byte by byte so it can't contain padding
+	struct CornerKey
+	{
+		float Position[3]{};
+		float Normal[3]{};
+		float TexCoord[2]{};
+	};
+	static_assert(sizeof(CornerKey) == 8 * sizeof(float));
+}
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+TangentGenerator::TangentGenerator(uint32_t threadCount)
+	: m_ThreadCount{ threadCount }
+{
+	if (m_ThreadCount == 0) m_ThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+
+//-----------------------------------------------------------------
+// Destructor
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+TangentData TangentGenerator::Generate(std::vector<uint32_t>& indices, const float* pPositions, const float* pNormals, const float* pTexCoords,
+	size_t vertexStride, size_t vertexCount) const
+{
+	const size_t triangleCount{ indices.size() / 3 };
+
+	// Per triangle frames, gathered & computed one block at a time
+	TriangleFrames frames{};
+	for (int axis{ 0 }; axis < 3; ++axis)
+	{
+		frames.Tangents[axis].resize(triangleCount);
+		frames.CornerCosines[axis].resize(triangleCount);
+	}
+	frames.Flags.resize(triangleCount);
+
+	const size_t triangleRangeCount{ GetRangeCount(triangleCount, m_ThreadCount) };
+	std::vector<uint32_t> degenerateCounts(triangleRangeCount, 0);
+	ForEachRange(triangleCount, triangleRangeCount, [&](size_t begin, size_t end, size_t range)
+		{
+			auto pBlock = std::make_unique<TriangleBlock>();
+			TriangleBlock& block = *pBlock;
+			for (size_t first{ begin }; first < end; first += BLOCK_SIZE)
+			{
+				size_t count{ std::min(BLOCK_SIZE, end - first) };
+				for (size_t i{ 0 }; i < count; ++i)
+				{
+					for (int corner{ 0 }; corner < 3; ++corner)
+					{
+						uint32_t vertex{ indices[3 * (first + i) + corner] };
+						const float* pPosition = GetAttribute(pPositions, vertexStride, vertex);
+						const float* pTexCoord = GetAttribute(pTexCoords, vertexStride, vertex);
+						block.Positions[corner][0][i] = pPosition[0];
+						block.Positions[corner][1][i] = pPosition[1];
+						block.Positions[corner][2][i] = pPosition[2];
+						block.TexCoords[corner][0][i] = pTexCoord[0];
+						block.TexCoords[corner][1][i] = pTexCoord[1];
+					}
+				}
+				ComputeFrames(block, count);
+
+				for (size_t i{ 0 }; i < count; ++i)
+				{
+					size_t triangle{ first + i };
+					for (int axis{ 0 }; axis < 3; ++axis)
+					{
+						frames.Tangents[axis][triangle] = block.Tangents[axis][i];
+						frames.CornerCosines[axis][triangle] = block.CornerCosines[axis][i];
+					}
+					frames.Flags[triangle] = block.Flags[i];
+					if (block.Flags[i] & DEGENERATE_FLAG) ++degenerateCounts[range];
+				}
+			}
+		});
+
+	// Corners grouped per vertex & handedness, degenerate triangles are left out
+	std::vector<uint32_t> groupOffsets(2 * vertexCount + 1, 0);
+	for (size_t corner{ 0 }; corner < 3 * triangleCount; ++corner)
+	{
+		uint8_t flags{ frames.Flags[corner / 3] };
+		if ((flags & DEGENERATE_FLAG) == 0) ++groupOffsets[2 * indices[corner] + (flags & MIRRORED_FLAG) + 1];
+	}
+	for (size_t group{ 0 }; group < 2 * vertexCount; ++group)
+	{
+		groupOffsets[group + 1] += groupOffsets[group];
+	}
+	std::vector<uint32_t> groupCorners(groupOffsets.back());
+	{
+		std::vector<uint32_t> fill{ groupOffsets.begin(), groupOffsets.end() - 1 };
+		for (size_t corner{ 0 }; corner < 3 * triangleCount; ++corner)
+		{
+			uint8_t flags{ frames.Flags[corner / 3] };
+			if ((flags & DEGENERATE_FLAG) == 0) groupCorners[fill[2 * indices[corner] + (flags & MIRRORED_FLAG)]++] = static_cast<uint32_t>(corner);
+		}
+	}
+
+	// Every vertex only reads its own corners, a vertex used by both mirrored & unmirrored triangles is split
+	TangentData data{};
+	data.Tangents.resize(4 * vertexCount);
+	const size_t vertexRangeCount{ GetRangeCount(vertexCount, m_ThreadCount) };
+	std::vector<std::vector<Split>> rangeSplits(vertexRangeCount);
+	ForEachRange(vertexCount, vertexRangeCount, [&](size_t begin, size_t end, size_t range)
+		{
+			for (size_t vertex{ begin }; vertex < end; ++vertex)
+			{
+				const float* pNormal = GetAttribute(pNormals, vertexStride, static_cast<uint32_t>(vertex));
+				Vector normal{ pNormal[0], pNormal[1], pNormal[2] };
+				float normalLength{ std::sqrt(Dot(normal, normal)) };
+				normal = normalLength > 0.f ? normal * (1.f / normalLength) : Vector{};
+
+				const size_t group{ 2 * vertex };
+				const uint32_t cornerCount{ groupOffsets[group + 1] - groupOffsets[group] };
+				const uint32_t mirroredCornerCount{ groupOffsets[group + 2] - groupOffsets[group + 1] };
+				Vector sum{ SumCorners(frames, groupCorners.data() + groupOffsets[group], cornerCount) };
+				Vector mirroredSum{ SumCorners(frames, groupCorners.data() + groupOffsets[group + 1], mirroredCornerCount) };
+
+				float* pTangent = &data.Tangents[4 * vertex];
+				if (cornerCount > 0 && mirroredCornerCount > 0) {
+					Split split{ static_cast<uint32_t>(vertex) };
+					ResolveFrame(mirroredSum, normal, true, split.Tangent);
+					rangeSplits[range].push_back(split);
+					ResolveFrame(sum, normal, false, pTangent);
+				}
+				else ResolveFrame(sum + mirroredSum, normal, mirroredCornerCount > 0, pTangent);
+			}
+		});
+
+	// The mirrored corners of split vertices move to the new vertex
+	for (const std::vector<Split>& splits : rangeSplits)
+	{
+		for (const Split& split : splits)
+		{
+			uint32_t newVertex{ static_cast<uint32_t>(vertexCount + data.SplitVertices.size()) };
+			data.SplitVertices.push_back(split.Vertex);
+			data.Tangents.insert(data.Tangents.end(), std::begin(split.Tangent), std::end(split.Tangent));
+
+			size_t group{ 2 * static_cast<size_t>(split.Vertex) + 1 };
+			for (uint32_t i{ groupOffsets[group] }; i < groupOffsets[group + 1]; ++i)
+			{
+				indices[groupCorners[i]] = newVertex;
+			}
+		}
+	}
+
+	for (uint32_t count : degenerateCounts) data.DegenerateTriangleCount += count;
+	return data;
+}
+
+TangentData TangentGenerator::GenerateCorners(const float* pPositions, const float* pNormals, const float* pTexCoords, size_t vertexStride, size_t cornerCount) const
+{
+	// Corners that would weld without their tangent are summed together, like the shared vertices of MikkTSpace
+	std::vector<CornerKey> keys(cornerCount);
+	for (size_t corner{ 0 }; corner < cornerCount; ++corner)
+	{
+		const float* pPosition = GetAttribute(pPositions, vertexStride, static_cast<uint32_t>(corner));
+		const float* pNormal = GetAttribute(pNormals, vertexStride, static_cast<uint32_t>(corner));
+		const float* pTexCoord = GetAttribute(pTexCoords, vertexStride, static_cast<uint32_t>(corner));
+		keys[corner] = CornerKey{ { pPosition[0], pPosition[1], pPosition[2] }, { pNormal[0], pNormal[1], pNormal[2] }, { pTexCoord[0], pTexCoord[1] } };
+	}
+	std::vector<CornerKey> vertices{};
+	std::vector<uint32_t> indices{};
+	VertexDeduplicator<CornerKey>::DeduplicateSorted(keys, vertices, indices, m_ThreadCount);
+	if (vertices.empty()) return TangentData{};
+
+	// The mirrored corners of split vertices point at the split vertex, so every corner reads the frame of its own handedness
+	TangentData data = Generate(indices, vertices[0].Position, vertices[0].Normal, vertices[0].TexCoord, sizeof(CornerKey), vertices.size());
+	std::vector<float> cornerTangents(4 * cornerCount);
+	for (size_t corner{ 0 }; corner < cornerCount; ++corner)
+	{
+		std::copy_n(&data.Tangents[4 * static_cast<size_t>(indices[corner])], 4, &cornerTangents[4 * corner]);
+	}
+	data.Tangents = std::move(cornerTangents);
+	return data;
+}
+
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+
@@ -0,0 +1,57 @@
+#ifndef GP2VKT_TANGENTGENERATOR_H_
+#define GP2VKT_TANGENTGENERATOR_H_
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Class Forward Declarations
+
+
+// Tangent frames of an indexed mesh, vertices created by splits come after the original vertices
+struct TangentData
+{
+	std::vector<float> Tangents{}; // xyz & the sign of the bitangent, bitangent = sign * cross(normal, tangent)
+	std::vector<uint32_t> SplitVertices{}; // Original vertex of every vertex created by a split, in order, welded vertices for corner streams
+	uint32_t DegenerateTriangleCount{}; // Triangles without a usable UV mapping, they don't contribute
+};
+
+
+// MikkTSpace style tangents: the per triangle tangents are calculated 4 at a time over SoA blocks,
+// every vertex then sums the tangents of its corners weighted by their angle, orthogonalized against its normal
+// Vertices whose triangles disagree on the handedness of the UV mapping are split, the indices are updated to match
+class TangentGenerator final
+{
+public:
+	// Constructors and Destructor
+	explicit TangentGenerator(uint32_t threadCount = 0); // 0 uses all hardware threads
+	~TangentGenerator() = default;
+
+	// Copy and Move semantics
+	TangentGenerator(const TangentGenerator& other)					= delete;
+	TangentGenerator& operator=(const TangentGenerator& other)		= delete;
+	TangentGenerator(TangentGenerator&& other) noexcept				= delete;
+	TangentGenerator& operator=(TangentGenerator&& other) noexcept	= delete;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	// All attributes are read with the same stride in bytes, positions & normals are xyz, texture coordinates uv
+	TangentData Generate(std::vector<uint32_t>& indices, const float* pPositions, const float* pNormals, const float* pTexCoords,
+		size_t vertexStride, size_t vertexCount) const;
+	// Unwelded triangle corners, 3 per triangle, one tangent per corner
+	// Corners with the same position, normal & texture coordinate share their tangent unless their handedness differs,
+	// so welding the corners afterwards with the tangent in the key splits exactly the vertices that need it
+	TangentData GenerateCorners(const float* pPositions, const float* pNormals, const float* pTexCoords, size_t vertexStride, size_t cornerCount) const;
+
+
+private:
+	// Member variables
+	uint32_t m_ThreadCount{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+
+};
+#endif
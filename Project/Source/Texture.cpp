@@ -2,6 +2,67 @@
 // Includes
 //-----------------------------------------------------------------
 #include "Texture.h"
+#include <stdexcept>
+#include <cstring>
+
+
+//-----------------------------------------------------------------
+// Functions
+//-----------------------------------------------------------------
+VkFormat textures::GetFormat(const TextureDescription& description, bool isBlockCompressed)
+{
+	if (description.PackedFilePath != nullptr && description.Semantic != TextureSemantic::Mask) {
+		throw std::invalid_argument("only masks can be packed together!");
+	}
+
+	switch (description.Semantic)
+	{
+	case TextureSemantic::Color: return isBlockCompressed ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_R8G8B8A8_SRGB;
+	case TextureSemantic::Normal: return isBlockCompressed ? VK_FORMAT_BC5_UNORM_BLOCK : VK_FORMAT_R8G8_UNORM;
+	case TextureSemantic::Linear: return isBlockCompressed ? VK_FORMAT_BC7_UNORM_BLOCK : VK_FORMAT_R8G8B8A8_UNORM;
+	case TextureSemantic::Mask:
+		if (description.PackedFilePath != nullptr) return isBlockCompressed ? VK_FORMAT_BC5_UNORM_BLOCK : VK_FORMAT_R8G8_UNORM;
+		return isBlockCompressed ? VK_FORMAT_BC4_UNORM_BLOCK : VK_FORMAT_R8_UNORM;
+	}
+	throw std::invalid_argument("unknown texture semantic!");
+}
+
+uint32_t textures::GetChannelCount(VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_R8_UNORM: return 1;
+	case VK_FORMAT_R8G8_UNORM: return 2;
+	default: return 4;
+	}
+}
+
+void textures::ConvertToMask(uint8_t* pPixels, const uint8_t* pPackedPixels, size_t pixelCount)
+{
+	// Rec. 709 weights in 8 bit fixed point, grayscale files keep their exact values
+	auto luminance = [](const uint8_t* pTexel) { return static_cast<uint8_t>((54 * pTexel[0] + 183 * pTexel[1] + 19 * pTexel[2] + 128) >> 8); };
+	for (size_t i{ 0 }; i < pixelCount * 4; i += 4)
+	{
+		pPixels[i] = luminance(pPixels + i);
+		pPixels[i + 1] = pPackedPixels ? luminance(pPackedPixels + i) : 0;
+		pPixels[i + 2] = 0;
+		pPixels[i + 3] = 255;
+	}
+}
+
+void textures::NarrowChannels(const uint8_t* pPixels, size_t pixelCount, uint32_t channelCount, uint8_t* pDst)
+{
+	if (channelCount == 4) {
+		if (pDst != pPixels) memcpy(pDst, pPixels, pixelCount * 4);
+		return;
+	}
+
+	// Packed texels only ever move to the front, so narrowing in place is safe
+	for (size_t pixel{ 0 }; pixel < pixelCount; ++pixel)
+	{
+		for (uint32_t channel{ 0 }; channel < channelCount; ++channel) pDst[pixel * channelCount + channel] = pPixels[pixel * 4 + channel];
+	}
+}
 
 
 //-----------------------------------------------------------------
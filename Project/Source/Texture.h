@@ -2,12 +2,42 @@
 #define GP2VKT_TEXTURE_H_
 // Includes
 #include "RAII/GP2_VkImage.h"
-#include "RAII/GP2_VkDeviceMemory.h"
+#include "MemoryAllocator.h"
 #include "RAII/GP2_VkImageView.h"
+#include <cstdint>
+#include <cstddef>
 
 // Class Forward Declarations
 
 
+// What the texels of a texture mean, decides the format it's stored in
+enum class TextureSemantic
+{
+	Color,  // sRGB RGBA: R8G8B8A8_SRGB or BC7 sRGB
+	Normal, // Tangent space XY, Z is reconstructed in the shader: R8G8_UNORM or BC5
+	Mask,   // One linear value (e.g. gloss) taken from the luminance of the file: R8_UNORM or BC4
+	Linear  // Linear RGBA data: R8G8B8A8_UNORM or BC7
+};
+
+struct TextureDescription
+{
+	const char* FilePath{ nullptr };
+	TextureSemantic Semantic{ TextureSemantic::Color };
+	const char* PackedFilePath{ nullptr }; // Masks only, a second mask stored in the green channel: R8G8_UNORM or BC5
+};
+
+
+namespace textures
+{
+	VkFormat GetFormat(const TextureDescription& description, bool isBlockCompressed);
+	uint32_t GetChannelCount(VkFormat format); // Of the uncompressed formats, 4 for the block compressed ones since they're encoded from RGBA8
+
+	// Turns RGBA8 pixels into a mask: the luminance in red, the luminance of the packed pixels (if any) in green
+	void ConvertToMask(uint8_t* pPixels, const uint8_t* pPackedPixels, size_t pixelCount);
+	void NarrowChannels(const uint8_t* pPixels, size_t pixelCount, uint32_t channelCount, uint8_t* pDst); // Keeps the first channels of every RGBA8 texel, pDst may be pPixels
+}
+
+
 // TODO: put functionality inside of Texture class instead of treating it like a data class
 // The Texture class wraps all the variables needed for a texture (Image, ImageMemory & ImageView)
 class Texture final
@@ -36,14 +66,14 @@ public:
 	// Public Member Functions
 	//---------------------------
 	GP2_VkImage Image{};
-	GP2_VkDeviceMemory ImageMemory{};
+	MemoryAllocation ImageMemory{};
 	GP2_VkImageView ImageView{};
 
 
 private:
 	// Member variables
 	/*GP2_VkImage m_Image{};
-	GP2_VkDeviceMemory m_ImageMemory{};
+	MemoryAllocation m_ImageMemory{};
 	GP2_VkImageView m_ImageView{};*/
 
 	//---------------------------
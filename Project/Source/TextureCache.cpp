@@ -0,0 +1,312 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "TextureCache.h"
+#include "SourceStamp.h"
+#include "AsyncFileReader.h"
+#include "UploadService.h"
+#include <stdexcept>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+
+//-----------------------------------------------------------------
+// File Layout
+//-----------------------------------------------------------------
+namespace
+{
+	// KTX 2.0 identifier, followed by the header, the index & the level index
+	constexpr uint8_t FILE_IDENTIFIER[12]{ 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+	constexpr char SOURCE_KEY[]{ "GP2VKTsource" }; // Custom key/value entry with the version & source stamp
+	constexpr char WRITER_KEY[]{ "KTXwriter" };
+	constexpr char WRITER_VALUE[]{ "GP2VKT TextureCache" };
+
+	struct FileHeader
+	{
+		uint8_t Identifier[12]{};
+		uint32_t Format{}; // VkFormat
+		uint32_t TypeSize{ 1 }; // 1 for block compressed formats
+		uint32_t PixelWidth{};
+		uint32_t PixelHeight{};
+		uint32_t PixelDepth{ 0 };
+		uint32_t LayerCount{ 0 }; // Not an array
+		uint32_t FaceCount{ 1 };
+		uint32_t LevelCount{};
+		uint32_t SupercompressionScheme{ 0 };
+
+		uint32_t DfdByteOffset{};
+		uint32_t DfdByteLength{};
+		uint32_t KvdByteOffset{};
+		uint32_t KvdByteLength{};
+		uint64_t SgdByteOffset{ 0 };
+		uint64_t SgdByteLength{ 0 };
+	};
+	static_assert(sizeof(FileHeader) == 80, "the KTX2 header has to be tightly packed");
+
+	struct LevelIndex
+	{
+		uint64_t ByteOffset{};
+		uint64_t ByteLength{};
+		uint64_t UncompressedByteLength{};
+	};
+
+	struct SourceValue
+	{
+		uint32_t Version{ TextureCache::Version };
+		uint32_t Padding{};
+		SourceStamp Source{}; // Of the image the cache was made from
+		SourceStamp PackedSource{}; // Empty for textures made from a single image
+	};
+
+	// What the data format descriptor needs to describe a block compressed format
+	struct FormatInfo
+	{
+		uint32_t BlockSize{}; // In bytes
+		uint8_t ColorModel{}; // KHR_DF_MODEL_BC4, BC5 or BC7
+		uint8_t TransferFunction{}; // KHR_DF_TRANSFER_LINEAR or SRGB
+		uint8_t ChannelCount{}; // Samples, BC7 is described as a single color sample
+	};
+
+	FormatInfo GetFormatInfo(VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_BC4_UNORM_BLOCK: return FormatInfo{ 8, 131, 1, 1 };
+		case VK_FORMAT_BC5_UNORM_BLOCK: return FormatInfo{ 16, 132, 1, 2 };
+		case VK_FORMAT_BC7_UNORM_BLOCK: return FormatInfo{ 16, 134, 1, 1 };
+		case VK_FORMAT_BC7_SRGB_BLOCK: return FormatInfo{ 16, 134, 2, 1 };
+		default: throw std::invalid_argument("texture cache format isn't supported!");
+		}
+	}
+
+	uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	uint64_t GetLevelSize(uint32_t width, uint32_t height, uint32_t level, uint32_t blockSize)
+	{
+		uint64_t blockColumns{ (std::max(width >> level, 1u) + 3) / 4 }, blockRows{ (std::max(height >> level, 1u) + 3) / 4 };
+		return blockColumns * blockRows * blockSize;
+	}
+
+	template<typename T>
+	void Append(std::vector<uint8_t>& bytes, const T& value)
+	{
+		const uint8_t* pValue = reinterpret_cast<const uint8_t*>(&value);
+		bytes.insert(bytes.end(), pValue, pValue + sizeof(T));
+	}
+
+	// Basic data format descriptor block, one sample per channel
+	std::vector<uint8_t> CreateDataFormatDescriptor(const FormatInfo& info)
+	{
+		const uint16_t blockSize{ static_cast<uint16_t>(24 + 16 * info.ChannelCount) };
+		std::vector<uint8_t> dfd{};
+		Append(dfd, static_cast<uint32_t>(4 + blockSize)); // dfdTotalSize
+		Append(dfd, uint32_t{ 0 }); // Khronos vendor, basic descriptor type
+		Append(dfd, static_cast<uint32_t>(2 | (blockSize << 16))); // Version 1.3 & descriptor block size
+		Append(dfd, info.ColorModel);
+		Append(dfd, uint8_t{ 1 }); // BT.709 primaries
+		Append(dfd, info.TransferFunction);
+		Append(dfd, uint8_t{ 0 }); // Straight alpha
+		const uint8_t texelBlockDimensions[4]{ 3, 3, 0, 0 }; // 4x4x1x1, stored minus one
+		for (uint8_t dimension : texelBlockDimensions) Append(dfd, dimension);
+		Append(dfd, static_cast<uint8_t>(info.BlockSize));
+		for (int plane{ 1 }; plane < 8; ++plane) Append(dfd, uint8_t{ 0 });
+
+		const uint32_t channelBits{ info.BlockSize * 8 / info.ChannelCount };
+		for (uint8_t channel{ 0 }; channel < info.ChannelCount; ++channel)
+		{
+			Append(dfd, static_cast<uint16_t>(channel * channelBits)); // Bit offset
+			Append(dfd, static_cast<uint8_t>(channelBits - 1)); // Bit length
+			Append(dfd, channel); // Red, then green, BC7 uses the 0 color channel
+			Append(dfd, uint32_t{ 0 }); // Sample position
+			Append(dfd, uint32_t{ 0 }); // Lower
+			Append(dfd, uint32_t{ 0xFFFFFFFF }); // Upper
+		}
+		return dfd;
+	}
+
+	// Key/value entries sorted by key, every entry is padded to 4 bytes
+	void AppendKeyValue(std::vector<uint8_t>& kvd, const char* key, const void* pValue, uint32_t valueSize)
+	{
+		const uint32_t keySize{ static_cast<uint32_t>(strlen(key) + 1) };
+		Append(kvd, keySize + valueSize);
+		kvd.insert(kvd.end(), key, key + keySize);
+		kvd.insert(kvd.end(), static_cast<const uint8_t*>(pValue), static_cast<const uint8_t*>(pValue) + valueSize);
+		kvd.resize(AlignUp(kvd.size(), 4));
+	}
+
+	bool FindSourceValue(const char* pKvd, uint32_t kvdSize, SourceValue& value)
+	{
+		const uint32_t keySize{ sizeof(SOURCE_KEY) };
+		for (uint32_t offset{ 0 }; offset + sizeof(uint32_t) <= kvdSize;)
+		{
+			uint32_t entrySize{};
+			memcpy(&entrySize, pKvd + offset, sizeof(entrySize));
+			offset += sizeof(uint32_t);
+			if (entrySize > kvdSize - offset) return false;
+
+			if (entrySize == keySize + sizeof(SourceValue) && memcmp(pKvd + offset, SOURCE_KEY, keySize) == 0) {
+				memcpy(&value, pKvd + offset + keySize, sizeof(value));
+				return true;
+			}
+			offset += static_cast<uint32_t>(AlignUp(entrySize, 4));
+		}
+		return false;
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+TextureCache::TextureCache(const char* sourcePath, const char* packedSourcePath)
+	: m_SourcePath{ sourcePath }
+	, m_PackedSourcePath{ packedSourcePath ? packedSourcePath : "" }
+{
+	// Packed caches are named after both images so they don't replace the cache of the first one
+	std::filesystem::path cachePath{ sourcePath };
+	if (packedSourcePath) cachePath.replace_filename(cachePath.stem().string() + "_" + std::filesystem::path{ packedSourcePath }.stem().string());
+	m_CachePath = cachePath.replace_extension(".ktx2").string();
+}
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+bool TextureCache::Open(VkFormat format)
+{
+	m_File = AssetData{};
+	m_LoosePath.clear();
+	if (vfs::Exists(m_CachePath) == false) return false;
+
+	AssetData file = vfs::Read(m_CachePath);
+	if (file.GetSize() < sizeof(FileHeader)) return false;
+
+	FileHeader header{};
+	memcpy(&header, file.GetData(), sizeof(header));
+
+	// Another kind of KTX2 file than the ones written below
+	if (memcmp(header.Identifier, FILE_IDENTIFIER, sizeof(FILE_IDENTIFIER)) != 0) return false;
+	if (header.Format != static_cast<uint32_t>(format) || header.SupercompressionScheme != 0) return false;
+	if (header.PixelWidth == 0 || header.PixelHeight == 0 || header.PixelDepth != 0 || header.LayerCount != 0 || header.FaceCount != 1) return false;
+	if (header.LevelCount == 0 || header.LevelCount > 32) return false;
+
+	// Truncated file
+	const uint64_t levelIndexEnd{ sizeof(FileHeader) + static_cast<uint64_t>(header.LevelCount) * sizeof(LevelIndex) };
+	if (levelIndexEnd > file.GetSize() || static_cast<uint64_t>(header.KvdByteOffset) + header.KvdByteLength > file.GetSize()) return false;
+
+	std::vector<LevelIndex> levels(header.LevelCount);
+	memcpy(levels.data(), file.GetData() + sizeof(FileHeader), levels.size() * sizeof(LevelIndex));
+	const uint32_t blockSize{ GetFormatInfo(format).BlockSize };
+	uint64_t levelsBegin{ file.GetSize() }, levelsEnd{ 0 };
+	for (uint32_t level{ 0 }; level < header.LevelCount; ++level)
+	{
+		if (levels[level].ByteLength != GetLevelSize(header.PixelWidth, header.PixelHeight, level, blockSize)) return false;
+		if (levels[level].ByteOffset % blockSize != 0 || levels[level].ByteOffset + levels[level].ByteLength > file.GetSize()) return false;
+		levelsBegin = std::min(levelsBegin, levels[level].ByteOffset);
+		levelsEnd = std::max(levelsEnd, levels[level].ByteOffset + levels[level].ByteLength);
+	}
+
+	// Written by another build of the application or for another version of the source
+	SourceValue value{};
+	if (FindSourceValue(file.GetData() + header.KvdByteOffset, header.KvdByteLength, value) == false) return false;
+	if (value.Version != Version) return false;
+	if (stamps::MatchesSourceStamp(m_SourcePath, value.Source) == false) return false;
+	if (m_PackedSourcePath.empty() == false && stamps::MatchesSourceStamp(m_PackedSourcePath, value.PackedSource) == false) return false;
+
+	m_File = std::move(file);
+	m_LoosePath = vfs::FindLooseFile(m_CachePath);
+	m_Width = header.PixelWidth;
+	m_Height = header.PixelHeight;
+	m_LevelsOffset = levelsBegin;
+	m_LevelsSize = levelsEnd - levelsBegin;
+	m_LevelOffsets.resize(header.LevelCount);
+	for (uint32_t level{ 0 }; level < header.LevelCount; ++level) m_LevelOffsets[level] = levels[level].ByteOffset - levelsBegin;
+	return true;
+}
+
+bool TextureCache::Write(VkFormat format, uint32_t width, uint32_t height, const uint8_t* pLevels, const std::vector<VkDeviceSize>& levelOffsets) const
+{
+	const FormatInfo info{ GetFormatInfo(format) };
+	std::vector<uint64_t> levelSizes(levelOffsets.size());
+	for (uint32_t level{ 0 }; level < levelOffsets.size(); ++level) levelSizes[level] = GetLevelSize(width, height, level, info.BlockSize);
+
+	SourceValue value{};
+	if (stamps::ReadSourceStamp(m_SourcePath, value.Source) == false) return false;
+	if (m_PackedSourcePath.empty() == false && stamps::ReadSourceStamp(m_PackedSourcePath, value.PackedSource) == false) return false;
+
+	FileHeader header{};
+	memcpy(header.Identifier, FILE_IDENTIFIER, sizeof(FILE_IDENTIFIER));
+	header.Format = static_cast<uint32_t>(format);
+	header.PixelWidth = width;
+	header.PixelHeight = height;
+	header.LevelCount = static_cast<uint32_t>(levelOffsets.size());
+
+	const std::vector<uint8_t> dfd{ CreateDataFormatDescriptor(info) };
+	std::vector<uint8_t> kvd{};
+	AppendKeyValue(kvd, SOURCE_KEY, &value, sizeof(value));
+	AppendKeyValue(kvd, WRITER_KEY, WRITER_VALUE, sizeof(WRITER_VALUE));
+
+	header.DfdByteOffset = static_cast<uint32_t>(sizeof(FileHeader) + levelOffsets.size() * sizeof(LevelIndex));
+	header.DfdByteLength = static_cast<uint32_t>(dfd.size());
+	header.KvdByteOffset = header.DfdByteOffset + header.DfdByteLength;
+	header.KvdByteLength = static_cast<uint32_t>(kvd.size());
+
+	// The levels are stored smallest first, every one aligned to its block size
+	std::vector<LevelIndex> levelIndices(levelOffsets.size());
+	uint64_t offset{ static_cast<uint64_t>(header.KvdByteOffset) + header.KvdByteLength };
+	for (size_t level{ levelOffsets.size() }; level-- > 0;)
+	{
+		offset = AlignUp(offset, info.BlockSize);
+		levelIndices[level] = LevelIndex{ offset, levelSizes[level], levelSizes[level] };
+		offset += levelSizes[level];
+	}
+
+	// Write to a temporary file first so a crash never leaves a half written cache behind
+	std::string tempPath{ m_CachePath + ".tmp" };
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) return false;
+
+		const char padding[16]{};
+		uint64_t position{ static_cast<uint64_t>(header.KvdByteOffset) + header.KvdByteLength };
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(levelIndices.data()), levelIndices.size() * sizeof(LevelIndex));
+		file.write(reinterpret_cast<const char*>(dfd.data()), dfd.size());
+		file.write(reinterpret_cast<const char*>(kvd.data()), kvd.size());
+		for (size_t level{ levelOffsets.size() }; level-- > 0;)
+		{
+			file.write(padding, levelIndices[level].ByteOffset - position);
+			file.write(reinterpret_cast<const char*>(pLevels + levelOffsets[level]), levelSizes[level]);
+			position = levelIndices[level].ByteOffset + levelSizes[level];
+		}
+		if (!file.good()) return false;
+	}
+
+	std::error_code error{};
+	std::filesystem::rename(tempPath, m_CachePath, error);
+	if (error) {
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+	return true;
+}
+
+void TextureCache::ReadLevels(AsyncFileReader& reader, char* pDst) const
+{
+	if (m_LoosePath.empty()) {
+		memcpy(pDst, GetLevels(), m_LevelsSize);
+		return;
+	}
+	reader.ReadRangeInto(m_LoosePath.c_str(), m_LevelsOffset, m_LevelsSize, pDst, nullptr);
+}
+
+StagingRegion TextureCache::ImportLevels(UploadService& uploadService) const
+{
+	if (m_LoosePath.empty()) return StagingRegion{};
+	return uploadService.ImportFile(m_LoosePath.c_str(), m_LevelsOffset, m_LevelsSize);
+}
@@ -0,0 +1,76 @@
+#ifndef GP2VKT_TEXTURECACHE_H_
+#define GP2VKT_TEXTURECACHE_H_
+// Includes
+#include <vulkan/vulkan_core.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "VirtualFileSystem.h"
+
+// Class Forward Declarations
+class AsyncFileReader;
+class UploadService;
+struct StagingRegion;
+
+
+// Block compressed mip chain of an image file, stored next to it as a KTX2 file
+// Warm loads map the file and hand the levels to the GPU without decoding or encoding a single texel
+class TextureCache final
+{
+public:
+	static constexpr uint32_t Version{ 2 }; // Bump when the stored data, the encoder or the mip filter changes
+
+	// Constructors and Destructor
+	explicit TextureCache(const char* sourcePath, const char* packedSourcePath = nullptr); // Packed textures are made from two images
+	~TextureCache() = default;
+
+	// Copy and Move semantics
+	TextureCache(const TextureCache& other)					= delete;
+	TextureCache& operator=(const TextureCache& other)		= delete;
+	TextureCache(TextureCache&& other) noexcept				= default;
+	TextureCache& operator=(TextureCache&& other) noexcept	= default;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	// False if there is no cache or it belongs to another version of the source or another format
+	bool Open(VkFormat format);
+	// Every level holds the tightly packed blocks of one mip level at its offset inside of pLevels, largest first, only BC4, BC5 & BC7 are supported
+	bool Write(VkFormat format, uint32_t width, uint32_t height, const uint8_t* pLevels, const std::vector<VkDeviceSize>& levelOffsets) const; // False if the cache couldn't be written
+
+	// Only valid after a successful Open
+	uint32_t GetWidth() const { return m_Width; }
+	uint32_t GetHeight() const { return m_Height; }
+	uint32_t GetLevelCount() const { return static_cast<uint32_t>(m_LevelOffsets.size()); }
+	const void* GetLevels() const { return m_File.GetData() + m_LevelsOffset; } // All levels, smallest first
+	VkDeviceSize GetLevelsSize() const { return m_LevelsSize; }
+	const std::vector<VkDeviceSize>& GetLevelOffsets() const { return m_LevelOffsets; } // Start of every level inside of GetLevels, largest first
+	// Same bytes as GetLevels, loose caches are read straight into pDst without paging in the mapping, done once the reader has waited
+	void ReadLevels(AsyncFileReader& reader, char* pDst) const;
+	// Loose caches are imported as a transfer source, empty if that isn't possible, see StagingRing::ImportFile
+	StagingRegion ImportLevels(UploadService& uploadService) const;
+
+	const std::string& GetCachePath() const { return m_CachePath; }
+
+
+private:
+	// Member variables
+	std::string m_SourcePath{};
+	std::string m_PackedSourcePath{};
+	std::string m_CachePath{};
+	AssetData m_File{}; // Loose or from an asset pack
+	std::string m_LoosePath{}; // Empty if the cache is read from an asset pack
+
+	// Copied from the header & level index of the mapped file
+	uint32_t m_Width{};
+	uint32_t m_Height{};
+	uint64_t m_LevelsOffset{};
+	VkDeviceSize m_LevelsSize{};
+	std::vector<VkDeviceSize> m_LevelOffsets{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+
+};
+#endif
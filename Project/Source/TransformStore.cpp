@@ -0,0 +1,236 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "TransformStore.h"
+#include <stdexcept>
+#include <algorithm>
+#include <bit>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GP2VKT_TRANSFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	constexpr uint32_t LANE_COUNT{ 4 }; // Transforms per iteration of the local matrix pass
+
+	struct Columns
+	{
+		const float* pPosition[3]{};
+		const float* pRotation[4]{};
+		const float* pScale[3]{};
+	};
+
+	// Rotation matrix of the quaternion (same as glm::mat4_cast) with the scale applied to its columns, then the translation
+	// Only the lanes in laneBits are written
+#ifdef GP2VKT_TRANSFORM_SSE2
+	void ComputeLocalMatrices(const Columns& columns, uint32_t first, uint32_t laneBits, glm::mat4* pDst)
+	{
+		const __m128 x{ _mm_loadu_ps(columns.pRotation[0] + first) }, y{ _mm_loadu_ps(columns.pRotation[1] + first) };
+		const __m128 z{ _mm_loadu_ps(columns.pRotation[2] + first) }, w{ _mm_loadu_ps(columns.pRotation[3] + first) };
+		const __m128 xx{ _mm_mul_ps(x, x) }, yy{ _mm_mul_ps(y, y) }, zz{ _mm_mul_ps(z, z) };
+		const __m128 xy{ _mm_mul_ps(x, y) }, xz{ _mm_mul_ps(x, z) }, yz{ _mm_mul_ps(y, z) };
+		const __m128 wx{ _mm_mul_ps(w, x) }, wy{ _mm_mul_ps(w, y) }, wz{ _mm_mul_ps(w, z) };
+		const __m128 sx{ _mm_loadu_ps(columns.pScale[0] + first) }, sy{ _mm_loadu_ps(columns.pScale[1] + first) }, sz{ _mm_loadu_ps(columns.pScale[2] + first) };
+		const __m128 one{ _mm_set1_ps(1.f) }, two{ _mm_set1_ps(2.f) };
+
+		// One register per matrix element, the lanes are the transforms
+		__m128 elements[4][4]{};
+		elements[0][0] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+		elements[0][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+		elements[0][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+		elements[0][3] = _mm_setzero_ps();
+		elements[1][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+		elements[1][1] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+		elements[1][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+		elements[1][3] = _mm_setzero_ps();
+		elements[2][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+		elements[2][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+		elements[2][2] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+		elements[2][3] = _mm_setzero_ps();
+		elements[3][0] = _mm_loadu_ps(columns.pPosition[0] + first);
+		elements[3][1] = _mm_loadu_ps(columns.pPosition[1] + first);
+		elements[3][2] = _mm_loadu_ps(columns.pPosition[2] + first);
+		elements[3][3] = one;
+
+		// After the transpose every register holds one column of one transform
+		for (int column{ 0 }; column < 4; ++column)
+		{
+			__m128* pColumn = elements[column];
+			_MM_TRANSPOSE4_PS(pColumn[0], pColumn[1], pColumn[2], pColumn[3]);
+			for (uint32_t lane{ 0 }; lane < LANE_COUNT; ++lane)
+			{
+				if ((laneBits >> lane) & 1) _mm_storeu_ps(&pDst[first + lane][column][0], pColumn[lane]);
+			}
+		}
+	}
+#else
+	void ComputeLocalMatrixScalar(const Columns& columns, uint32_t i, glm::mat4& dst)
+	{
+		const float x{ columns.pRotation[0][i] }, y{ columns.pRotation[1][i] }, z{ columns.pRotation[2][i] }, w{ columns.pRotation[3][i] };
+		const float xx{ x * x }, yy{ y * y }, zz{ z * z };
+		const float xy{ x * y }, xz{ x * z }, yz{ y * z };
+		const float wx{ w * x }, wy{ w * y }, wz{ w * z };
+		const float sx{ columns.pScale[0][i] }, sy{ columns.pScale[1][i] }, sz{ columns.pScale[2][i] };
+
+		dst[0] = glm::vec4{ (1.f - 2.f * (yy + zz)) * sx, 2.f * (xy + wz) * sx, 2.f * (xz - wy) * sx, 0.f };
+		dst[1] = glm::vec4{ 2.f * (xy - wz) * sy, (1.f - 2.f * (xx + zz)) * sy, 2.f * (yz + wx) * sy, 0.f };
+		dst[2] = glm::vec4{ 2.f * (xz + wy) * sz, 2.f * (yz - wx) * sz, (1.f - 2.f * (xx + yy)) * sz, 0.f };
+		dst[3] = glm::vec4{ columns.pPosition[0][i], columns.pPosition[1][i], columns.pPosition[2][i], 1.f };
+	}
+
+	void ComputeLocalMatrices(const Columns& columns, uint32_t first, uint32_t laneBits, glm::mat4* pDst)
+	{
+		for (uint32_t lane{ 0 }; lane < LANE_COUNT; ++lane)
+		{
+			if ((laneBits >> lane) & 1) ComputeLocalMatrixScalar(columns, first + lane, pDst[first + lane]);
+		}
+	}
+#endif
+}
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Destructor
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+TransformStore::Handle TransformStore::Create(Handle parent)
+{
+	if (parent != InvalidHandle) CheckHandle(parent);
+
+	const Handle handle{ m_Size++ };
+	const size_t paddedSize{ (static_cast<size_t>(m_Size) + LANE_COUNT - 1) / LANE_COUNT * LANE_COUNT };
+	for (std::vector<float>* pColumn : { &m_PositionX, &m_PositionY, &m_PositionZ, &m_RotationX, &m_RotationY, &m_RotationZ, &m_RotationW, &m_ScaleX, &m_ScaleY, &m_ScaleZ })
+	{
+		pColumn->resize(paddedSize, 0.f);
+	}
+	m_RotationW[handle] = 1.f;
+	m_ScaleX[handle] = m_ScaleY[handle] = m_ScaleZ[handle] = 1.f;
+
+	// Parents always have a lower handle than their children, which is what lets Update work in a single pass
+	m_Parents.push_back(parent);
+	if (parent != InvalidHandle) m_Children.push_back(handle);
+	m_WorldMatrices.emplace_back(1.f);
+	m_DirtyBits.resize((static_cast<size_t>(m_Size) + 63) / 64, 0);
+	SetDirty(handle);
+	return handle;
+}
+
+void TransformStore::Clear()
+{
+	for (std::vector<float>* pColumn : { &m_PositionX, &m_PositionY, &m_PositionZ, &m_RotationX, &m_RotationY, &m_RotationZ, &m_RotationW, &m_ScaleX, &m_ScaleY, &m_ScaleZ })
+	{
+		pColumn->clear();
+	}
+	m_Parents.clear();
+	m_Children.clear();
+	m_WorldMatrices.clear();
+	m_DirtyBits.clear();
+	m_Size = 0;
+}
+
+void TransformStore::SetPosition(Handle handle, const glm::vec3& position)
+{
+	CheckHandle(handle);
+	m_PositionX[handle] = position.x;
+	m_PositionY[handle] = position.y;
+	m_PositionZ[handle] = position.z;
+	SetDirty(handle);
+}
+
+void TransformStore::SetRotation(Handle handle, const glm::quat& rotation)
+{
+	CheckHandle(handle);
+	m_RotationX[handle] = rotation.x;
+	m_RotationY[handle] = rotation.y;
+	m_RotationZ[handle] = rotation.z;
+	m_RotationW[handle] = rotation.w;
+	SetDirty(handle);
+}
+
+void TransformStore::SetScale(Handle handle, const glm::vec3& scale)
+{
+	CheckHandle(handle);
+	m_ScaleX[handle] = scale.x;
+	m_ScaleY[handle] = scale.y;
+	m_ScaleZ[handle] = scale.z;
+	SetDirty(handle);
+}
+
+glm::vec3 TransformStore::GetPosition(Handle handle) const
+{
+	CheckHandle(handle);
+	return glm::vec3{ m_PositionX[handle], m_PositionY[handle], m_PositionZ[handle] };
+}
+
+glm::quat TransformStore::GetRotation(Handle handle) const
+{
+	CheckHandle(handle);
+	return glm::quat{ m_RotationW[handle], m_RotationX[handle], m_RotationY[handle], m_RotationZ[handle] };
+}
+
+glm::vec3 TransformStore::GetScale(Handle handle) const
+{
+	CheckHandle(handle);
+	return glm::vec3{ m_ScaleX[handle], m_ScaleY[handle], m_ScaleZ[handle] };
+}
+
+uint32_t TransformStore::Update()
+{
+	// Parents come before their children, so a single pass carries the dirty bits down the whole hierarchy
+	for (Handle child : m_Children)
+	{
+		if (IsDirty(m_Parents[child])) SetDirty(child);
+	}
+
+	// Local matrices first, written in place of the world matrices, clean words of 64 transforms are skipped as a whole
+	const Columns columns{ { m_PositionX.data(), m_PositionY.data(), m_PositionZ.data() },
+		{ m_RotationX.data(), m_RotationY.data(), m_RotationZ.data(), m_RotationW.data() },
+		{ m_ScaleX.data(), m_ScaleY.data(), m_ScaleZ.data() } };
+	uint32_t updateCount{ 0 };
+	for (size_t word{ 0 }; word < m_DirtyBits.size(); ++word)
+	{
+		const uint64_t dirtyBits{ m_DirtyBits[word] };
+		if (dirtyBits == 0) continue;
+
+		updateCount += static_cast<uint32_t>(std::popcount(dirtyBits));
+		for (uint32_t lane{ 0 }; lane < 64; lane += LANE_COUNT)
+		{
+			const uint32_t laneBits{ static_cast<uint32_t>(dirtyBits >> lane) & ((1u << LANE_COUNT) - 1) };
+			if (laneBits != 0) ComputeLocalMatrices(columns, static_cast<uint32_t>(word * 64 + lane), laneBits, m_WorldMatrices.data());
+		}
+	}
+
+	// The parent of a child is final by the time the child comes up
+	for (Handle child : m_Children)
+	{
+		if (IsDirty(child)) m_WorldMatrices[child] = m_WorldMatrices[m_Parents[child]] * m_WorldMatrices[child];
+	}
+
+	std::fill(m_DirtyBits.begin(), m_DirtyBits.end(), 0);
+	return updateCount;
+}
+
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+void TransformStore::CheckHandle(Handle handle) const
+{
+	if (handle >= m_Size) {
+		throw std::invalid_argument("transform handle is out of range!");
+	}
+}
@@ -0,0 +1,73 @@
+#ifndef GP2VKT_TRANSFORMSTORE_H_
+#define GP2VKT_TRANSFORMSTORE_H_
+// Includes
+#include <vector>
+#include <cstdint>
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Class Forward Declarations
+
+
+// Positions, rotations & scales of all transforms, one array per component, relative to an optional parent transform
+// Setters only mark a transform as dirty, Update recomputes the world matrices of the dirty transforms & their descendants
+// Handles stay valid until Clear, slots aren't reused
+class TransformStore final
+{
+public:
+	using Handle = uint32_t;
+	static constexpr Handle InvalidHandle{ UINT32_MAX };
+
+	// Constructors and Destructor
+	explicit TransformStore() = default;
+	~TransformStore() = default;
+
+	// Copy and Move semantics
+	TransformStore(const TransformStore& other)					= delete;
+	TransformStore& operator=(const TransformStore& other)		= delete;
+	TransformStore(TransformStore&& other) noexcept				= delete;
+	TransformStore& operator=(TransformStore&& other) noexcept	= delete;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	Handle Create(Handle parent = InvalidHandle); // Identity, the parent has to exist already
+	void Clear();
+	uint32_t GetSize() const { return m_Size; }
+
+	void SetPosition(Handle handle, const glm::vec3& position);
+	void SetRotation(Handle handle, const glm::quat& rotation); // Normalized
+	void SetScale(Handle handle, const glm::vec3& scale);
+	glm::vec3 GetPosition(Handle handle) const;
+	glm::quat GetRotation(Handle handle) const;
+	glm::vec3 GetScale(Handle handle) const;
+	Handle GetParent(Handle handle) const { return m_Parents[handle]; }
+
+	uint32_t Update(); // Returns how many world matrices were recomputed
+	const glm::mat4& GetWorld(Handle handle) const { return m_WorldMatrices[handle]; } // As of the last Update
+	const std::vector<glm::mat4>& GetWorldMatrices() const { return m_WorldMatrices; } // Indexed by handle, for copying them in bulk
+
+
+private:
+	// Member variables
+	uint32_t m_Size{ 0 };
+
+	// Padded to a multiple of 4 transforms, so the last ones can be loaded as a whole
+	std::vector<float> m_PositionX{}, m_PositionY{}, m_PositionZ{};
+	std::vector<float> m_RotationX{}, m_RotationY{}, m_RotationZ{}, m_RotationW{};
+	std::vector<float> m_ScaleX{}, m_ScaleY{}, m_ScaleZ{};
+
+	std::vector<Handle> m_Parents{};
+	std::vector<Handle> m_Children{}; // Every transform with a parent, in ascending order
+	std::vector<uint64_t> m_DirtyBits{}; // One bit per transform
+	std::vector<glm::mat4> m_WorldMatrices{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+	void SetDirty(Handle handle) { m_DirtyBits[handle / 64] |= uint64_t{ 1 } << (handle % 64); }
+	bool IsDirty(Handle handle) const { return (m_DirtyBits[handle / 64] >> (handle % 64)) & 1; }
+	void CheckHandle(Handle handle) const;
+};
+#endif
@@ -0,0 +1,376 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "UploadService.h"
+#include <stdexcept>
+#include <algorithm>
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+UploadService::UploadService(VkDevice device, StagingRing& stagingRing, uint32_t transferFamily, VkQueue transferQueue, uint32_t graphicsFamily, VkQueue graphicsQueue)
+	: m_Device{ device }
+	, m_StagingRing{ stagingRing }
+	, m_TransferFamily{ transferFamily }
+	, m_GraphicsFamily{ graphicsFamily }
+	, m_TransferQueue{ transferQueue }
+	, m_GraphicsQueue{ graphicsQueue }
+	, m_TransferCommandPool{ device, transferFamily }
+	, m_GraphicsCommandPool{ device, graphicsFamily }
+	, m_Timeline{ device, 0 }
+{
+}
+
+
+//-----------------------------------------------------------------
+// Destructor
+//-----------------------------------------------------------------
+UploadService::~UploadService()
+{
+	// Command buffers can't be freed while they are executing
+	Wait(m_LastToken);
+}
+
+
+//-----------------------------------------------------------------
+// Public Member Functions
+//-----------------------------------------------------------------
+StagingRegion UploadService::AllocateStaging(VkDeviceSize size, VkDeviceSize alignment)
+{
+	return m_StagingRing.Allocate(size, alignment);
+}
+
+void UploadService::UploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* pData, VkDeviceSize size, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+	UploadBuffer(dstBuffer, dstOffset, m_StagingRing.Write({ size }, { pData }), dstStage, dstAccess);
+}
+
+void UploadService::UploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const StagingRegion& stagingRegion, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+	VkCommandBuffer commandBuffer = GetOpenCommandBuffer();
+	const VkDeviceSize size{ stagingRegion.Size };
+
+	// Copy buffer command
+	VkBufferCopy copyRegion{};
+	copyRegion.srcOffset = stagingRegion.Offset;
+	copyRegion.dstOffset = dstOffset;
+	copyRegion.size = size;
+	vkCmdCopyBuffer(commandBuffer, stagingRegion.Buffer, dstBuffer, 1, &copyRegion);
+
+	// Make the range available to the graphics queue at the end of the batch
+	VkBufferMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = dstAccess;
+	barrier.srcQueueFamilyIndex = HasDedicatedQueue() ? m_TransferFamily : VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = HasDedicatedQueue() ? m_GraphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+	barrier.buffer = dstBuffer;
+	barrier.offset = dstOffset;
+	barrier.size = size;
+
+	m_PendingBufferBarriers.push_back(barrier);
+	m_PendingDstStages |= dstStage;
+}
+
+void UploadService::UploadImage(VkImage dstImage, VkExtent3D extent, const void* pData, VkDeviceSize size)
+{
+	UploadImages({ ImageUpload{ dstImage, extent, pData, size } });
+}
+
+void UploadService::UploadImages(const std::vector<ImageUpload>& uploads)
+{
+	// Exit early in case of wrong input values
+	if (uploads.empty()) return;
+
+	VkCommandBuffer commandBuffer = GetOpenCommandBuffer();
+
+	// Whole images are overwritten, so the previous contents (and owner) don't matter
+	std::vector<VkImageMemoryBarrier> barriers(uploads.size());
+	for (size_t i{ 0 }; i < uploads.size(); ++i)
+	{
+		VkImageMemoryBarrier& barrier = barriers[i];
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = uploads[i].Image;
+		barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, uploads[i].MipLevels, 0, 1 };
+	}
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+
+	// Copy buffer image commands, one staging region per image keeps every copy aligned
+	std::vector<VkBufferImageCopy> regions{};
+	for (const ImageUpload& upload : uploads)
+	{
+		StagingRegion stagingRegion = upload.Staging.Buffer != VK_NULL_HANDLE ? upload.Staging : m_StagingRing.Write({ upload.Size }, { upload.pData });
+
+		regions.resize(upload.MipOffsets.size());
+		for (uint32_t level{ 0 }; level < regions.size(); ++level)
+		{
+			VkBufferImageCopy& region = regions[level];
+			region = VkBufferImageCopy{};
+			region.bufferOffset = stagingRegion.Offset + upload.MipOffsets[level];
+			region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 };
+			region.imageOffset = { 0, 0, 0 };
+			region.imageExtent = { std::max(upload.Extent.width >> level, 1u), std::max(upload.Extent.height >> level, 1u), 1 };
+		}
+		vkCmdCopyBufferToImage(commandBuffer, stagingRegion.Buffer, upload.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+	}
+
+	// Transition to shader read layout at the end of the batch, together with the ownership transfer
+	for (size_t i{ 0 }; i < uploads.size(); ++i)
+	{
+		VkImageMemoryBarrier& barrier = barriers[i];
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcQueueFamilyIndex = HasDedicatedQueue() ? m_TransferFamily : VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = HasDedicatedQueue() ? m_GraphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+
+		// Images with missing levels stay in transfer layout until the graphics queue has blitted them
+		const ImageUpload& upload = uploads[i];
+		if (upload.MipOffsets.size() < upload.MipLevels) {
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			m_PendingMipGenerations.push_back(MipGeneration{ upload.Image, upload.Extent, static_cast<uint32_t>(upload.MipOffsets.size()), upload.MipLevels });
+			m_PendingDstStages |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+		}
+	}
+
+	m_PendingImageBarriers.insert(m_PendingImageBarriers.end(), barriers.begin(), barriers.end());
+	m_PendingDstStages |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+}
+
+UploadToken UploadService::Submit()
+{
+	// Nothing was recorded since the last submit
+	if (m_OpenCommands == VK_NULL_HANDLE) return m_LastToken;
+
+	Batch batch{};
+	batch.TransferCommands = m_OpenCommands;
+	m_OpenCommands = VK_NULL_HANDLE;
+
+	// A dedicated transfer queue can only release ownership, the graphics queue has to acquire it
+	CmdHandOverBarriers(batch.TransferCommands, HasDedicatedQueue());
+	if (HasDedicatedQueue() == false) CmdGenerateMipmaps(batch.TransferCommands);
+	if (vkEndCommandBuffer(batch.TransferCommands) != VK_SUCCESS) {
+		throw std::runtime_error("failed to record upload command buffer!");
+	}
+
+	// Staging regions of this batch are reclaimed once the transfer has finished
+	UploadToken transferToken = ++m_LastToken;
+	SubmitToQueue(m_TransferQueue, batch.TransferCommands, 0, 0, transferToken, m_StagingRing.Submit());
+
+	if (HasDedicatedQueue()) {
+		batch.AcquireCommands = BeginCommandBuffer(m_GraphicsCommandPool, m_FreeAcquireCommands);
+		CmdHandOverBarriers(batch.AcquireCommands, false);
+		CmdGenerateMipmaps(batch.AcquireCommands);
+		if (vkEndCommandBuffer(batch.AcquireCommands) != VK_SUCCESS) {
+			throw std::runtime_error("failed to record upload command buffer!");
+		}
+
+		// Runs on the graphics queue right after the transfer
+		UploadToken acquireToken = ++m_LastToken;
+		SubmitToQueue(m_GraphicsQueue, batch.AcquireCommands, transferToken, m_PendingDstStages, acquireToken, VK_NULL_HANDLE);
+	}
+
+	m_PendingBufferBarriers.clear();
+	m_PendingImageBarriers.clear();
+	m_PendingMipGenerations.clear();
+	m_PendingDstStages = 0;
+
+	batch.Token = m_LastToken;
+	m_InFlightBatches.push_back(batch);
+	return batch.Token;
+}
+
+bool UploadService::IsComplete(UploadToken token) const
+{
+	uint64_t value{};
+	vkGetSemaphoreCounterValue(m_Device, m_Timeline, &value);
+	return value >= token;
+}
+
+void UploadService::Wait(UploadToken token) const
+{
+	VkSemaphore semaphore{ m_Timeline };
+	VkSemaphoreWaitInfo waitInfo{};
+	waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+	waitInfo.semaphoreCount = 1;
+	waitInfo.pSemaphores = &semaphore;
+	waitInfo.pValues = &token;
+
+	if (vkWaitSemaphores(m_Device, &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+		throw std::runtime_error("failed to wait for upload!");
+	}
+}
+
+void UploadService::Collect()
+{
+	// Batches finish in submission order
+	while (m_InFlightBatches.empty() == false && IsComplete(m_InFlightBatches.front().Token))
+	{
+		const Batch& batch = m_InFlightBatches.front();
+		m_FreeTransferCommands.push_back(batch.TransferCommands);
+		if (batch.AcquireCommands != VK_NULL_HANDLE) m_FreeAcquireCommands.push_back(batch.AcquireCommands);
+
+		m_InFlightBatches.pop_front();
+	}
+
+	// Staging regions of finished batches can be reused as well
+	m_StagingRing.Reclaim();
+}
+
+
+//-----------------------------------------------------------------
+// Private Member Functions
+//-----------------------------------------------------------------
+VkCommandBuffer UploadService::GetOpenCommandBuffer()
+{
+	if (m_OpenCommands == VK_NULL_HANDLE) {
+		Collect();
+		m_OpenCommands = BeginCommandBuffer(m_TransferCommandPool, m_FreeTransferCommands);
+	}
+	return m_OpenCommands;
+}
+
+VkCommandBuffer UploadService::BeginCommandBuffer(VkCommandPool commandPool, std::vector<VkCommandBuffer>& freeCommandBuffers)
+{
+	// Reuse a finished command buffer if possible
+	VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
+	if (freeCommandBuffers.empty() == false) {
+		commandBuffer = freeCommandBuffers.back();
+		freeCommandBuffers.pop_back();
+		vkResetCommandBuffer(commandBuffer, 0);
+	}
+	else {
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = commandPool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+
+		if (vkAllocateCommandBuffers(m_Device, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("failed to allocate command buffers!");
+		}
+	}
+
+	// Specify command buffer usage
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+		throw std::runtime_error("failed to begin recording command buffer!");
+	}
+	return commandBuffer;
+}
+
+void UploadService::CmdHandOverBarriers(VkCommandBuffer commandBuffer, bool isRelease) const
+{
+	std::vector<VkBufferMemoryBarrier> bufferBarriers{ m_PendingBufferBarriers };
+	std::vector<VkImageMemoryBarrier> imageBarriers{ m_PendingImageBarriers };
+	VkPipelineStageFlags srcStage{ VK_PIPELINE_STAGE_TRANSFER_BIT };
+	VkPipelineStageFlags dstStage{ m_PendingDstStages };
+
+	if (isRelease) {
+		// Release only makes the writes available, the graphics stages don't exist on a transfer queue
+		for (VkBufferMemoryBarrier& barrier : bufferBarriers) barrier.dstAccessMask = 0;
+		for (VkImageMemoryBarrier& barrier : imageBarriers) barrier.dstAccessMask = 0;
+		dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+	}
+	else if (HasDedicatedQueue()) {
+		// Acquire only makes the writes visible, waiting for the transfer is done by the semaphore
+		// The semaphore only blocks the stages it waits at, so the barrier has to start from those same stages to be ordered after it
+		for (VkBufferMemoryBarrier& barrier : bufferBarriers) barrier.srcAccessMask = 0;
+		for (VkImageMemoryBarrier& barrier : imageBarriers) barrier.srcAccessMask = 0;
+		srcStage = m_PendingDstStages;
+	}
+
+	vkCmdPipelineBarrier(
+		commandBuffer,
+		srcStage, dstStage,
+		0,
+		0, nullptr,
+		static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+		static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data()
+	);
+}
+
+void UploadService::CmdGenerateMipmaps(VkCommandBuffer commandBuffer) const
+{
+	for (const MipGeneration& generation : m_PendingMipGenerations)
+	{
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = generation.Image;
+		barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+		// Every level is blitted from the previous one, which is done being written to & can be sampled afterwards
+		for (uint32_t level{ generation.FirstLevel }; level < generation.LevelCount; ++level)
+		{
+			barrier.subresourceRange.baseMipLevel = level - 1;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+			VkImageBlit blit{};
+			blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1 };
+			blit.srcOffsets[1] = { static_cast<int32_t>(std::max(generation.Extent.width >> (level - 1), 1u)), static_cast<int32_t>(std::max(generation.Extent.height >> (level - 1), 1u)), 1 };
+			blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 };
+			blit.dstOffsets[1] = { static_cast<int32_t>(std::max(generation.Extent.width >> level, 1u)), static_cast<int32_t>(std::max(generation.Extent.height >> level, 1u)), 1 };
+			vkCmdBlitImage(commandBuffer, generation.Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, generation.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		}
+
+		// The last level is only ever written to
+		barrier.subresourceRange.baseMipLevel = generation.LevelCount - 1;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+}
+
+void UploadService::SubmitToQueue(VkQueue queue, VkCommandBuffer commandBuffer, UploadToken waitToken, VkPipelineStageFlags waitStage, UploadToken signalToken, VkFence fence)
+{
+	VkSemaphore timeline{ m_Timeline };
+
+	// Values to wait for & signal on the timeline semaphore
+	VkTimelineSemaphoreSubmitInfo timelineInfo{};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timelineInfo.waitSemaphoreValueCount = waitToken > 0 ? 1 : 0;
+	timelineInfo.pWaitSemaphoreValues = &waitToken;
+	timelineInfo.signalSemaphoreValueCount = 1;
+	timelineInfo.pSignalSemaphoreValues = &signalToken;
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = &timelineInfo;
+	submitInfo.waitSemaphoreCount = waitToken > 0 ? 1 : 0;
+	submitInfo.pWaitSemaphores = &timeline;
+	submitInfo.pWaitDstStageMask = &waitStage;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &timeline;
+
+	if (vkQueueSubmit(queue, 1, &submitInfo, fence) != VK_SUCCESS) {
+		throw std::runtime_error("failed to submit upload command buffer!");
+	}
+}
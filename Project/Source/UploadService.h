@@ -0,0 +1,123 @@
+#ifndef GP2VKT_UPLOADSERVICE_H_
+#define GP2VKT_UPLOADSERVICE_H_
+// Includes
+#include <vulkan/vulkan_core.h>
+#include <vector>
+#include <deque>
+#include "StagingRing.h"
+#include "RAII/GP2_VkCommandPool.h"
+#include "RAII/GP2_VkSemaphore.h"
+
+// Class Forward Declarations
+
+
+// Value of the upload timeline semaphore that is reached once the upload has finished
+using UploadToken = uint64_t;
+
+// Tightly packed pixels for the first mip levels of an image
+// Levels missing from the data are blitted from the last one that is there, the format has to support linear blits
+struct ImageUpload
+{
+	VkImage Image{ VK_NULL_HANDLE };
+	VkExtent3D Extent{};
+	const void* pData{ nullptr };
+	VkDeviceSize Size{};
+	uint32_t MipLevels{ 1 }; // Of the image
+	std::vector<VkDeviceSize> MipOffsets{ 0 }; // Start of every level inside of the data
+	StagingRegion Staging{}; // Used instead of pData if it has a buffer, see UploadService::AllocateStaging
+};
+
+
+// Records copies on the transfer queue without waiting for them
+// Resources are handed over to the graphics queue family at the end of every batch
+class UploadService final
+{
+public:
+	// Constructors and Destructor
+	explicit UploadService(VkDevice device, StagingRing& stagingRing,
+		uint32_t transferFamily, VkQueue transferQueue,
+		uint32_t graphicsFamily, VkQueue graphicsQueue);
+	~UploadService();
+
+	// Copy and Move semantics
+	UploadService(const UploadService& other)					= delete;
+	UploadService& operator=(const UploadService& other)		= delete;
+	UploadService(UploadService&& other) noexcept				= delete;
+	UploadService& operator=(UploadService&& other) noexcept	= delete;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	// Staging memory the caller fills before the next Submit, so files can be read & images decoded straight into it
+	StagingRegion AllocateStaging(VkDeviceSize size, VkDeviceSize alignment = 16);
+	StagingRegion ImportFile(const char* filePath, uint64_t offset, VkDeviceSize size) { return m_StagingRing.ImportFile(filePath, offset, size); } // See StagingRing::ImportFile
+	char* GetStagingMemory() const { return m_StagingRing.GetMappedData(); }
+	VkDeviceSize GetStagingSize() const { return m_StagingRing.GetSize(); }
+
+	// The stage & access flags describe how the graphics queue will use the data
+	void UploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* pData, VkDeviceSize size, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+	void UploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const StagingRegion& stagingRegion, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess); // The whole region
+	void UploadImage(VkImage dstImage, VkExtent3D extent, const void* pData, VkDeviceSize size); // Ends in SHADER_READ_ONLY_OPTIMAL
+	void UploadImages(const std::vector<ImageUpload>& uploads); // Same as UploadImage, but transitions all images with a single barrier
+
+	UploadToken Submit(); // Doesn't block, everything recorded so far is done once the token is reached
+	bool IsComplete(UploadToken token) const;
+	void Wait(UploadToken token) const;
+	void Collect(); // Recycles the command buffers of finished uploads
+
+	bool HasDedicatedQueue() const { return m_TransferFamily != m_GraphicsFamily; }
+
+
+private:
+	// Blit chain recorded on the graphics queue once it owns the image
+	struct MipGeneration
+	{
+		VkImage Image{ VK_NULL_HANDLE };
+		VkExtent3D Extent{};
+		uint32_t FirstLevel{}; // First level that is blitted
+		uint32_t LevelCount{}; // Of the image
+	};
+
+	struct Batch
+	{
+		UploadToken Token{};
+		VkCommandBuffer TransferCommands{ VK_NULL_HANDLE };
+		VkCommandBuffer AcquireCommands{ VK_NULL_HANDLE };
+	};
+
+	// Member variables
+	VkDevice m_Device{ nullptr };
+	StagingRing& m_StagingRing;
+
+	uint32_t m_TransferFamily{};
+	uint32_t m_GraphicsFamily{};
+	VkQueue m_TransferQueue{ nullptr };
+	VkQueue m_GraphicsQueue{ nullptr };
+
+	GP2_VkCommandPool m_TransferCommandPool;
+	GP2_VkCommandPool m_GraphicsCommandPool; // Only used for acquiring ownership
+	std::vector<VkCommandBuffer> m_FreeTransferCommands{};
+	std::vector<VkCommandBuffer> m_FreeAcquireCommands{};
+
+	GP2_VkSemaphore m_Timeline;
+	UploadToken m_LastToken{ 0 };
+
+	// Batch that is being recorded
+	VkCommandBuffer m_OpenCommands{ VK_NULL_HANDLE };
+	std::vector<VkBufferMemoryBarrier> m_PendingBufferBarriers{};
+	std::vector<VkImageMemoryBarrier> m_PendingImageBarriers{};
+	std::vector<MipGeneration> m_PendingMipGenerations{};
+	VkPipelineStageFlags m_PendingDstStages{};
+
+	std::deque<Batch> m_InFlightBatches{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+	VkCommandBuffer GetOpenCommandBuffer();
+	VkCommandBuffer BeginCommandBuffer(VkCommandPool commandPool, std::vector<VkCommandBuffer>& freeCommandBuffers);
+	void CmdHandOverBarriers(VkCommandBuffer commandBuffer, bool isRelease) const;
+	void CmdGenerateMipmaps(VkCommandBuffer commandBuffer) const; // Needs a graphics queue
+	void SubmitToQueue(VkQueue queue, VkCommandBuffer commandBuffer, UploadToken waitToken, VkPipelineStageFlags waitStage, UploadToken signalToken, VkFence fence);
+};
+#endif
@@ -0,0 +1,254 @@
+#ifndef GP2VKT_VERTEXDEDUPLICATOR_H_
+#define GP2VKT_VERTEXDEDUPLICATOR_H_
+// Includes
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <future>
+#include <thread>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// Class Forward Declarations
+
+
+// wyhash style hash over raw bytes, every input bit affects all output bits
+inline uint64_t HashMix(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+	__uint128_t product = static_cast<__uint128_t>(a) * b;
+	return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	uint64_t high{};
+	uint64_t low = _umul128(a, b, &high);
+	return low ^ high;
+#else
+	// 64 x 64 -> 128 bit multiply out of 32 bit halves
+	uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32, bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+	uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh, highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+	uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFF) + (highLow & 0xFFFFFFFF);
+	uint64_t low = (lowLow & 0xFFFFFFFF) | (middle << 32);
+	uint64_t high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+	return low ^ high;
+#endif
+}
+inline uint64_t HashBytes(const void* pData, size_t size)
+{
+	constexpr uint64_t secret0{ 0xa0761d6478bd642full }, secret1{ 0xe7037ed1a0b428dbull }, secret2{ 0x8ebc6af09c88c6e3ull };
+	const char* pBytes = static_cast<const char*>(pData);
+
+	uint64_t hash{ secret0 ^ size };
+	size_t i{ 0 };
+	for (; i + 16 <= size; i += 16)
+	{
+		uint64_t words[2]{};
+		memcpy(words, pBytes + i, sizeof(words));
+		hash = HashMix(words[0] ^ secret1, words[1] ^ hash);
+	}
+	if (i < size) {
+		uint64_t words[2]{};
+		memcpy(words, pBytes + i, size - i);
+		hash = HashMix(words[0] ^ secret1, words[1] ^ hash);
+	}
+	return HashMix(hash ^ secret1, size ^ secret2);
+}
+
+
+// Welds identical vertices, vertices are compared byte by byte so the vertex type can't contain padding
+// Deduplicate streams the vertices through a flat open addressing table, DeduplicateSorted scales better on huge meshes
+template<typename VertexType>
+class VertexDeduplicator final
+{
+public:
+	// Constructors and Destructor
+	explicit VertexDeduplicator(size_t expectedCount); // Upper bound of unique vertices, the table grows if it's exceeded
+	~VertexDeduplicator() = default;
+
+	// Copy and Move semantics
+	VertexDeduplicator(const VertexDeduplicator& other)					= delete;
+	VertexDeduplicator& operator=(const VertexDeduplicator& other)		= delete;
+	VertexDeduplicator(VertexDeduplicator&& other) noexcept				= default;
+	VertexDeduplicator& operator=(VertexDeduplicator&& other) noexcept	= default;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	uint32_t FindOrInsert(const VertexType& vertex); // Index of the vertex in the unique vertices
+	std::vector<VertexType>& GetVertices() { return m_Vertices; }
+
+	// Keep the first occurrence of every vertex, in order, and write one index per corner
+	static void Deduplicate(const std::vector<VertexType>& corners, std::vector<VertexType>& vertices, std::vector<uint32_t>& indices);
+	static void DeduplicateSorted(const std::vector<VertexType>& corners, std::vector<VertexType>& vertices, std::vector<uint32_t>& indices, uint32_t threadCount = 0);
+
+
+private:
+	static constexpr uint32_t EmptySlot{ UINT32_MAX };
+	struct Slot
+	{
+		uint32_t Hash{}; // Part of the hash that isn't used for the position, skips most vertex compares
+		uint32_t Index{ EmptySlot };
+	};
+
+	// Member variables
+	std::vector<Slot> m_Slots{};
+	std::vector<VertexType> m_Vertices{};
+	size_t m_Mask{};
+
+	//---------------------------
+	// Private Member Functions
+	//---------------------------
+	void Grow();
+};
+
+//---------------------------
+// Template Member Functions
+//---------------------------
+template<typename VertexType>
+inline VertexDeduplicator<VertexType>::VertexDeduplicator(size_t expectedCount)
+{
+	// Power of two size with a load factor of at most 2/3 when the expectation holds
+	size_t capacity{ 16 };
+	while (capacity < expectedCount + expectedCount / 2) capacity *= 2;
+
+	m_Slots.resize(capacity);
+	m_Mask = capacity - 1;
+	m_Vertices.reserve(expectedCount);
+}
+
+template<typename VertexType>
+inline uint32_t VertexDeduplicator<VertexType>::FindOrInsert(const VertexType& vertex)
+{
+	uint64_t hash = HashBytes(&vertex, sizeof(VertexType));
+	uint32_t hashTag = static_cast<uint32_t>(hash >> 32);
+
+	// Linear probing, neighbouring slots share cache lines
+	for (size_t position = hash & m_Mask; ; position = (position + 1) & m_Mask)
+	{
+		Slot& slot = m_Slots[position];
+		if (slot.Index == EmptySlot) {
+			slot.Hash = hashTag;
+			slot.Index = static_cast<uint32_t>(m_Vertices.size());
+			m_Vertices.push_back(vertex);
+
+			uint32_t index = slot.Index;
+			if (m_Vertices.size() * 10 > m_Slots.size() * 7) Grow();
+			return index;
+		}
+		if (slot.Hash == hashTag && memcmp(&m_Vertices[slot.Index], &vertex, sizeof(VertexType)) == 0) {
+			return slot.Index;
+		}
+	}
+}
+
+template<typename VertexType>
+inline void VertexDeduplicator<VertexType>::Deduplicate(const std::vector<VertexType>& corners, std::vector<VertexType>& vertices, std::vector<uint32_t>& indices)
+{
+	VertexDeduplicator deduplicator{ corners.size() };
+
+	indices.resize(corners.size());
+	for (size_t i{ 0 }; i < corners.size(); ++i)
+	{
+		indices[i] = deduplicator.FindOrInsert(corners[i]);
+	}
+	vertices = std::move(deduplicator.GetVertices());
+}
+
+template<typename VertexType>
+inline void VertexDeduplicator<VertexType>::DeduplicateSorted(const std::vector<VertexType>& corners, std::vector<VertexType>& vertices, std::vector<uint32_t>& indices, uint32_t threadCount)
+{
+	if (threadCount == 0) threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	const size_t cornerCount{ corners.size() };
+	const size_t rangeCount{ std::clamp<size_t>(cornerCount / 65536, 1, threadCount) };
+
+	auto forEachRange = [&](auto&& function)
+		{
+			std::vector<std::future<void>> tasks{};
+			for (size_t range{ 1 }; range < rangeCount; ++range)
+			{
+				tasks.push_back(std::async(std::launch::async, function, cornerCount * range / rangeCount, cornerCount * (range + 1) / rangeCount));
+			}
+			function(size_t{ 0 }, cornerCount / rangeCount);
+			for (std::future<void>& task : tasks) task.get();
+		};
+
+	// Sort the corners by hash, ties are kept in corner order so the first occurrence leads every group
+	std::vector<uint64_t> hashes(cornerCount);
+	std::vector<uint32_t> order(cornerCount);
+	std::iota(order.begin(), order.end(), 0);
+	auto compare = [&hashes](uint32_t a, uint32_t b) { return hashes[a] < hashes[b] || (hashes[a] == hashes[b] && a < b); };
+
+	forEachRange([&](size_t begin, size_t end)
+		{
+			for (size_t i{ begin }; i < end; ++i) hashes[i] = HashBytes(&corners[i], sizeof(VertexType));
+			std::sort(order.begin() + begin, order.begin() + end, compare);
+		});
+	for (size_t width{ 1 }; width < rangeCount; width *= 2)
+	{
+		for (size_t range{ 0 }; range + width < rangeCount; range += 2 * width)
+		{
+			size_t begin = cornerCount * range / rangeCount;
+			size_t middle = cornerCount * (range + width) / rangeCount;
+			size_t end = cornerCount * std::min(range + 2 * width, rangeCount) / rangeCount;
+			std::inplace_merge(order.begin() + begin, order.begin() + middle, order.begin() + end, compare);
+		}
+	}
+
+	// Every corner points at the first corner with the same vertex, collisions are split by comparing the vertices
+	std::vector<uint32_t> leaders(cornerCount);
+	for (size_t groupBegin{ 0 }, groupEnd{ 0 }; groupBegin < cornerCount; groupBegin = groupEnd)
+	{
+		groupEnd = groupBegin + 1;
+		while (groupEnd < cornerCount && hashes[order[groupEnd]] == hashes[order[groupBegin]]) ++groupEnd;
+
+		for (size_t i{ groupBegin }; i < groupEnd; ++i)
+		{
+			uint32_t corner = order[i];
+			leaders[corner] = corner;
+			for (size_t j{ groupBegin }; j < i; ++j)
+			{
+				uint32_t candidate = order[j];
+				if (leaders[candidate] == candidate && memcmp(&corners[candidate], &corners[corner], sizeof(VertexType)) == 0) {
+					leaders[corner] = candidate;
+					break;
+				}
+			}
+		}
+	}
+
+	// Leaders always come before their followers, so their index is known by then
+	vertices.clear();
+	indices.resize(cornerCount);
+	for (size_t i{ 0 }; i < cornerCount; ++i)
+	{
+		if (leaders[i] == i) {
+			indices[i] = static_cast<uint32_t>(vertices.size());
+			vertices.push_back(corners[i]);
+		}
+		else {
+			indices[i] = indices[leaders[i]];
+		}
+	}
+}
+
+template<typename VertexType>
+inline void VertexDeduplicator<VertexType>::Grow()
+{
+	std::vector<Slot> slots(m_Slots.size() * 2);
+	m_Mask = slots.size() - 1;
+
+	// Hashes are recalculated instead of stored, growing only happens when the expected count was too low
+	for (const Slot& oldSlot : m_Slots)
+	{
+		if (oldSlot.Index == EmptySlot) continue;
+
+		uint64_t hash = HashBytes(&m_Vertices[oldSlot.Index], sizeof(VertexType));
+		size_t position = hash & m_Mask;
+		while (slots[position].Index != EmptySlot) position = (position + 1) & m_Mask;
+		slots[position] = oldSlot;
+	}
+	m_Slots = std::move(slots);
+}
+#endif
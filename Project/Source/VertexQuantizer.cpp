@@ -0,0 +1,152 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "VertexQuantizer.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <glm/packing.hpp>
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	// PBR_Quantized.vert mirrors the decoding
+	constexpr float TWO_PI{ 6.28318530718f };
+
+	uint32_t QuantizeUnorm(float value, int bits)
+	{
+		float maxValue = static_cast<float>((1u << bits) - 1);
+		return static_cast<uint32_t>(std::lround(glm::clamp(value, 0.f, 1.f) * maxValue));
+	}
+
+	glm::vec2 EncodeOctahedral(glm::vec3 normal) // [-1, 1]
+	{
+		normal /= std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+		glm::vec2 encoded{ normal.x, normal.y };
+		if (normal.z < 0.f) {
+			encoded.x = (1.f - std::abs(normal.y)) * (normal.x >= 0.f ? 1.f : -1.f);
+			encoded.y = (1.f - std::abs(normal.x)) * (normal.y >= 0.f ? 1.f : -1.f);
+		}
+		return encoded;
+	}
+	glm::vec3 DecodeOctahedral(glm::vec2 encoded) // [0, 1]
+	{
+		encoded = encoded * 2.f - 1.f;
+		glm::vec3 normal{ encoded.x, encoded.y, 1.f - std::abs(encoded.x) - std::abs(encoded.y) };
+		float fold = glm::max(-normal.z, 0.f);
+		normal.x += normal.x >= 0.f ? -fold : fold;
+		normal.y += normal.y >= 0.f ? -fold : fold;
+		return glm::normalize(normal);
+	}
+
+	// Orthonormal basis around the normal the tangent angle is measured in (Duff et al. 2017)
+	void BuildBasis(const glm::vec3& normal, glm::vec3& axisX, glm::vec3& axisY)
+	{
+		float s = normal.z >= 0.f ? 1.f : -1.f;
+		float a = -1.f / (s + normal.z);
+		float b = normal.x * normal.y * a;
+		axisX = glm::vec3{ 1.f + s * normal.x * normal.x * a, s * b, -s * normal.x };
+		axisY = glm::vec3{ b, s + normal.y * normal.y * a, -normal.y };
+	}
+
+	float GetAngle(const glm::vec3& a, const glm::vec3& b) // Both normalized
+	{
+		return std::acos(glm::clamp(glm::dot(a, b), -1.f, 1.f));
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Functions
+//-----------------------------------------------------------------
+void quantizer::QuantizeVertices(const std::vector<VertexPBR>& vertices, const MeshBounds& bounds, std::vector<VertexPBRQuantized>& quantizedVertices)
+{
+	const glm::vec3 extent{ bounds.max - bounds.min };
+	const glm::vec3 inverseExtent{
+		extent.x > 0.f ? 1.f / extent.x : 0.f,
+		extent.y > 0.f ? 1.f / extent.y : 0.f,
+		extent.z > 0.f ? 1.f / extent.z : 0.f
+	};
+
+	quantizedVertices.resize(vertices.size());
+	for (size_t i{ 0 }; i < vertices.size(); ++i)
+	{
+		const VertexPBR& vertex = vertices[i];
+		VertexPBRQuantized& quantizedVertex = quantizedVertices[i];
+
+		// Positions relative to the bounds, the shader scales them back
+		glm::vec3 normalizedPosition = (vertex.pos - bounds.min) * inverseExtent;
+		for (int axis{ 0 }; axis < 3; ++axis)
+		{
+			quantizedVertex.pos[axis] = static_cast<uint16_t>(QuantizeUnorm(normalizedPosition[axis], 16));
+		}
+
+		// The tangent angle is measured around the decoded normal, so the shader rebuilds the exact same basis
+		glm::vec3 normal = glm::dot(vertex.normal, vertex.normal) > 0.f ? glm::normalize(vertex.normal) : glm::vec3{ 0.f, 0.f, 1.f };
+		glm::vec2 octahedral = EncodeOctahedral(normal) * 0.5f + 0.5f;
+		uint32_t octahedralX = QuantizeUnorm(octahedral.x, 10);
+		uint32_t octahedralY = QuantizeUnorm(octahedral.y, 10);
+		glm::vec3 decodedNormal = DecodeOctahedral(glm::vec2{ octahedralX / 1023.f, octahedralY / 1023.f });
+
+		glm::vec3 axisX{}, axisY{};
+		BuildBasis(decodedNormal, axisX, axisY);
+		glm::vec3 tangent{ vertex.tangent };
+		float angle = std::atan2(glm::dot(tangent, axisY), glm::dot(tangent, axisX));
+		if (std::isfinite(angle) == false) angle = 0.f;
+		if (angle < 0.f) angle += TWO_PI;
+		uint32_t angleBits = static_cast<uint32_t>(std::lround(angle / TWO_PI * 1024.f)) & 1023;
+
+		uint32_t handedness{ vertex.tangent.w < 0.f ? 0u : 3u };
+		quantizedVertex.normalTangent = octahedralX | (octahedralY << 10) | (angleBits << 20) | (handedness << 30);
+
+		quantizedVertex.texCoord = glm::packHalf2x16(vertex.texCoord);
+	}
+}
+
+VertexPBR quantizer::DecodeVertex(const VertexPBRQuantized& vertex, const MeshBounds& bounds)
+{
+	VertexPBR decodedVertex{};
+	decodedVertex.pos = bounds.min + glm::vec3{ vertex.pos[0], vertex.pos[1], vertex.pos[2] } / 65535.f * (bounds.max - bounds.min);
+
+	const uint32_t octahedralX{ vertex.normalTangent & 1023 }, octahedralY{ (vertex.normalTangent >> 10) & 1023 };
+	const uint32_t angleBits{ (vertex.normalTangent >> 20) & 1023 }, handedness{ vertex.normalTangent >> 30 };
+	decodedVertex.normal = DecodeOctahedral(glm::vec2{ octahedralX / 1023.f, octahedralY / 1023.f });
+
+	glm::vec3 axisX{}, axisY{};
+	BuildBasis(decodedVertex.normal, axisX, axisY);
+	const float angle{ angleBits / 1024.f * TWO_PI };
+	decodedVertex.tangent = glm::vec4{ std::cos(angle) * axisX + std::sin(angle) * axisY, handedness / 3.f > 0.5f ? 1.f : -1.f };
+
+	decodedVertex.texCoord = glm::unpackHalf2x16(vertex.texCoord);
+	return decodedVertex;
+}
+
+QuantizationError quantizer::MeasureError(const std::vector<VertexPBR>& vertices, const std::vector<VertexPBRQuantized>& quantizedVertices, const MeshBounds& bounds)
+{
+	if (vertices.size() != quantizedVertices.size()) {
+		throw std::invalid_argument("quantized vertices don't match the vertices!");
+	}
+
+	// Vertices without a normal or tangent don't have a direction to compare against
+	QuantizationError error{};
+	for (size_t i{ 0 }; i < vertices.size(); ++i)
+	{
+		const VertexPBR& vertex = vertices[i];
+		const VertexPBR decodedVertex = DecodeVertex(quantizedVertices[i], bounds);
+
+		error.Position = glm::max(error.Position, glm::length(decodedVertex.pos - vertex.pos));
+		if (glm::dot(vertex.normal, vertex.normal) > 0.f) {
+			error.Normal = glm::max(error.Normal, GetAngle(decodedVertex.normal, glm::normalize(vertex.normal)));
+		}
+		const glm::vec3 tangent{ vertex.tangent };
+		if (glm::dot(tangent, tangent) > 0.f) {
+			error.Tangent = glm::max(error.Tangent, GetAngle(glm::vec3{ decodedVertex.tangent }, glm::normalize(tangent)));
+		}
+		error.TexCoord = glm::max(error.TexCoord, glm::length(decodedVertex.texCoord - vertex.texCoord));
+	}
+	return error;
+}
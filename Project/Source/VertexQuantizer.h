@@ -0,0 +1,28 @@
+#ifndef GP2VKT_VERTEXQUANTIZER_H_
+#define GP2VKT_VERTEXQUANTIZER_H_
+// Includes
+#include <vector>
+#include "DataTypes.h"
+
+// Class Forward Declarations
+
+
+// Largest differences between vertices & what PBR_Quantized.vert decodes from their quantized versions, angles in radians
+struct QuantizationError
+{
+	float Position{};
+	float Normal{};
+	float Tangent{};
+	float TexCoord{};
+};
+
+
+// Packs VertexPBR into VertexPBRQuantized: 16 bit positions inside of the mesh bounds, a 10:10 octahedral normal,
+// the tangent as a 10 bit angle around the decoded normal with its handedness, and half float texture coordinates
+namespace quantizer
+{
+	void QuantizeVertices(const std::vector<VertexPBR>& vertices, const MeshBounds& bounds, std::vector<VertexPBRQuantized>& quantizedVertices);
+	VertexPBR DecodeVertex(const VertexPBRQuantized& vertex, const MeshBounds& bounds); // Same math as PBR_Quantized.vert
+	QuantizationError MeasureError(const std::vector<VertexPBR>& vertices, const std::vector<VertexPBRQuantized>& quantizedVertices, const MeshBounds& bounds);
+}
+#endif
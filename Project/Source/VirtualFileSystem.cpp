@@ -0,0 +1,203 @@
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "VirtualFileSystem.h"
+#include "AssetPack.h"
+#include "AsyncFileReader.h"
+#include <stdexcept>
+#include <filesystem>
+#include <string_view>
+#include <memory>
+#include <algorithm>
+
+
+//-----------------------------------------------------------------
+// Helper Functions
+//-----------------------------------------------------------------
+namespace
+{
+	// Either a directory or a pack
+	struct Mount
+	{
+		std::string MountPoint{};
+		std::string Directory{};
+		std::unique_ptr<AssetPack> pPack{};
+	};
+
+	std::vector<Mount>& GetMounts()
+	{
+		static std::vector<Mount> mounts{};
+		return mounts;
+	}
+
+	// Forward slashes without a leading "./", the way the packer names files
+	std::string NormalizePath(const std::string& path)
+	{
+		std::string normalized{ path };
+		std::replace(normalized.begin(), normalized.end(), '\\', '/');
+		while (normalized.rfind("./", 0) == 0) normalized.erase(0, 2);
+		return normalized;
+	}
+
+	std::string NormalizeMountPoint(const std::string& mountPoint)
+	{
+		std::string normalized{ NormalizePath(mountPoint) };
+		if (normalized.empty() == false && normalized.back() != '/') normalized += '/';
+		return normalized;
+	}
+
+	bool IsLooseFile(const std::string& path)
+	{
+		std::error_code error{};
+		return std::filesystem::is_regular_file(path, error);
+	}
+
+	// Calls function with the mount & the path relative to it until it returns true, most recent mount first
+	template<typename Function>
+	bool ForEachMount(const std::string& path, const Function& function)
+	{
+		const std::string normalized{ NormalizePath(path) };
+		const std::vector<Mount>& mounts = GetMounts();
+		for (auto it = mounts.rbegin(); it != mounts.rend(); ++it)
+		{
+			if (normalized.rfind(it->MountPoint, 0) != 0) continue;
+			if (function(*it, std::string_view{ normalized }.substr(it->MountPoint.size()))) return true;
+		}
+		return false;
+	}
+
+	AssetData ReadFromPack(const AssetPack& pack, const PackEntry& entry)
+	{
+		// Stored files are used straight from the mapping of the pack
+		if (pack.IsStored(entry)) {
+			return AssetData{ pack.GetStoredData(entry), static_cast<size_t>(entry.Size) };
+		}
+
+		std::vector<char> buffer(static_cast<size_t>(entry.Size));
+		pack.Read(entry, buffer.data());
+		return AssetData{ std::move(buffer) };
+	}
+}
+
+
+//-----------------------------------------------------------------
+// Constructors
+//-----------------------------------------------------------------
+AssetData::AssetData(MappedFile&& file)
+	: m_File{ std::move(file) }
+	, m_pData{ m_File.GetData() }
+	, m_Size{ m_File.GetSize() }
+{
+}
+
+AssetData::AssetData(std::vector<char>&& buffer)
+	: m_Buffer{ std::move(buffer) }
+	, m_pData{ m_Buffer.data() }
+	, m_Size{ m_Buffer.size() }
+{
+}
+
+AssetData::AssetData(const char* pData, size_t size)
+	: m_pData{ pData }
+	, m_Size{ size }
+{
+}
+
+
+//-----------------------------------------------------------------
+// Functions
+//-----------------------------------------------------------------
+void vfs::MountDirectory(const std::string& directory, const std::string& mountPoint)
+{
+	GetMounts().push_back({ NormalizeMountPoint(mountPoint), directory, nullptr });
+}
+
+void vfs::MountPack(const std::string& packPath, const std::string& mountPoint, uint32_t threadCount)
+{
+	GetMounts().push_back({ NormalizeMountPoint(mountPoint), {}, std::make_unique<AssetPack>(packPath.c_str(), threadCount) });
+}
+
+void vfs::UnmountAll()
+{
+	GetMounts().clear();
+}
+
+bool vfs::Exists(const std::string& path)
+{
+	bool isMounted = ForEachMount(path, [](const Mount& mount, std::string_view relativePath)
+		{
+			if (mount.pPack) return mount.pPack->Find(relativePath) != nullptr;
+			return IsLooseFile((std::filesystem::path{ mount.Directory } / relativePath).string());
+		});
+	return isMounted || IsLooseFile(path);
+}
+
+std::string vfs::FindLooseFile(const std::string& path)
+{
+	std::string loosePath{};
+	bool isMounted = ForEachMount(path, [&loosePath](const Mount& mount, std::string_view relativePath)
+		{
+			if (mount.pPack) return mount.pPack->Find(relativePath) != nullptr;
+
+			std::string mountedPath{ (std::filesystem::path{ mount.Directory } / relativePath).string() };
+			if (IsLooseFile(mountedPath) == false) return false;
+			loosePath = std::move(mountedPath);
+			return true;
+		});
+	if (isMounted == false && IsLooseFile(path)) loosePath = path;
+	return loosePath;
+}
+
+AssetData vfs::Read(const std::string& path)
+{
+	AssetData data{};
+	bool isMounted = ForEachMount(path, [&data](const Mount& mount, std::string_view relativePath)
+		{
+			if (mount.pPack == nullptr) {
+				std::string loosePath{ (std::filesystem::path{ mount.Directory } / relativePath).string() };
+				if (IsLooseFile(loosePath) == false) return false;
+				data = AssetData{ MappedFile{ loosePath.c_str() } };
+				return true;
+			}
+
+			const PackEntry* pEntry = mount.pPack->Find(relativePath);
+			if (pEntry == nullptr) return false;
+			data = ReadFromPack(*mount.pPack, *pEntry);
+			return true;
+		});
+
+	if (isMounted == false) data = AssetData{ MappedFile{ path.c_str() } };
+	return data;
+}
+
+std::vector<AssetData> vfs::ReadAll(const std::vector<std::string>& paths)
+{
+	std::vector<AssetData> data(paths.size());
+	AsyncFileReader reader{};
+	for (size_t index{ 0 }; index < paths.size(); ++index)
+	{
+		std::string loosePath{};
+		bool isMounted = ForEachMount(paths[index], [&](const Mount& mount, std::string_view relativePath)
+			{
+				if (mount.pPack == nullptr) {
+					loosePath = (std::filesystem::path{ mount.Directory } / relativePath).string();
+					if (IsLooseFile(loosePath)) return true;
+					loosePath.clear();
+					return false;
+				}
+
+				const PackEntry* pEntry = mount.pPack->Find(relativePath);
+				if (pEntry == nullptr) return false;
+				data[index] = ReadFromPack(*mount.pPack, *pEntry);
+				return true;
+			});
+		if (isMounted == false) loosePath = paths[index];
+
+		// Loose files are read together in one batch
+		if (loosePath.empty() == false) {
+			reader.Read(loosePath.c_str(), [&data, index](std::vector<char>&& buffer) { data[index] = AssetData{ std::move(buffer) }; });
+		}
+	}
+	reader.Wait();
+	return data;
+}
@@ -0,0 +1,61 @@
+#ifndef GP2VKT_VIRTUALFILESYSTEM_H_
+#define GP2VKT_VIRTUALFILESYSTEM_H_
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+// Class Forward Declarations
+
+
+// Contents of one asset: a mapped loose file, a view into the mapping of a pack or the blocks decompressed into a buffer
+class AssetData final
+{
+public:
+	// Constructors and Destructor
+	AssetData() = default;
+	explicit AssetData(MappedFile&& file);
+	explicit AssetData(std::vector<char>&& buffer);
+	AssetData(const char* pData, size_t size); // Has to outlive the view, packs stay mounted until vfs::UnmountAll
+	~AssetData() = default;
+
+	// Copy and Move semantics
+	AssetData(const AssetData& other)					= delete;
+	AssetData& operator=(const AssetData& other)		= delete;
+	AssetData(AssetData&& other) noexcept				= default;
+	AssetData& operator=(AssetData&& other) noexcept	= default;
+
+	//---------------------------
+	// Public Member Functions
+	//---------------------------
+	const char* GetData() const { return m_pData; }
+	size_t GetSize() const { return m_Size; }
+
+
+private:
+	// Member variables
+	MappedFile m_File{};
+	std::vector<char> m_Buffer{};
+	const char* m_pData{ nullptr };
+	size_t m_Size{};
+};
+
+
+// Resolves asset paths against the mounted directories & packs, the most recent mount that has the file wins
+// Paths no mount resolves are read as loose files relative to the working directory
+// Mounting isn't synchronized, mount everything before the assets are loaded, reads are safe from any thread
+namespace vfs
+{
+	// The mount point is stripped from the path before it's looked up, e.g. "Resources/" for a pack of the Resources directory
+	void MountDirectory(const std::string& directory, const std::string& mountPoint);
+	void MountPack(const std::string& packPath, const std::string& mountPoint, uint32_t threadCount = 0); // Throws if the pack can't be read
+	void UnmountAll();
+
+	bool Exists(const std::string& path);
+	std::string FindLooseFile(const std::string& path); // Empty if the file comes from a pack or doesn't exist, loose files can be read in parts without mapping them
+	AssetData Read(const std::string& path); // Throws if the file can't be found
+	std::vector<AssetData> ReadAll(const std::vector<std::string>& paths); // Same order as paths, the loose files in one batch of asynchronous reads
+}
+#endif
@@ -0,0 +1,154 @@
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Source/BoundsTable.h"
+#include "Source/Frustum.h"
+
+// Checks the SIMD culling against the scalar reference, it doesn't touch Vulkan so it runs without a GPU
+namespace
+{
+    int g_FailureCount{ 0 };
+
+    void Check(bool condition, const char* description)
+    {
+        if (condition) return;
+        std::cerr << "FAILED: " << description << std::endl;
+        ++g_FailureCount;
+    }
+
+    // Same camera as the application before the swap chain exists, looking at the origin from 50 units away
+    Frustum CreateFrustum()
+    {
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, -50.0f, 5.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+        glm::mat4 proj = glm::perspective(glm::radians(45.0f), 800 / 600.f, 0.1f, 100.0f);
+        proj[1][1] *= -1;
+        return Frustum{ proj * view };
+    }
+
+    MeshBounds CreateBounds()
+    {
+        MeshBounds bounds{ glm::vec3{ -1.f, -2.f, -0.5f }, glm::vec3{ 1.f, 2.f, 0.5f } };
+        bounds.radius = glm::length(bounds.max - bounds.min) * 0.5f;
+        return bounds;
+    }
+
+    // Both cull functions write the same indices in the same order
+    bool CullsEqual(const BoundsTable& table, const Frustum& frustum, uint32_t* pVisibleCount = nullptr)
+    {
+        std::vector<uint32_t> visible(table.GetSize()), expected(table.GetSize());
+        const uint32_t visibleCount = table.Cull(frustum, visible.data());
+        const uint32_t expectedCount = table.CullScalar(frustum, expected.data());
+        if (pVisibleCount) *pVisibleCount = visibleCount;
+        return visibleCount == expectedCount && std::equal(visible.begin(), visible.begin() + visibleCount, expected.begin());
+    }
+
+    void TestKnownObjects()
+    {
+        const Frustum frustum{ CreateFrustum() };
+        const MeshBounds bounds{ CreateBounds() };
+
+        // In front of the camera, behind it, past the far plane & far off to the side
+        BoundsTable table{};
+        table.Add(bounds, glm::mat4(1.0f));
+        table.Add(bounds, glm::translate(glm::mat4(1.0f), glm::vec3(0.f, -60.f, 5.f)));
+        table.Add(bounds, glm::translate(glm::mat4(1.0f), glm::vec3(0.f, 200.f, 0.f)));
+        table.Add(bounds, glm::translate(glm::mat4(1.0f), glm::vec3(100.f, 0.f, 0.f)));
+
+        std::vector<uint32_t> visible(table.GetSize());
+        Check(table.Cull(frustum, visible.data()) == 1 && visible[0] == 0, "only the object in front of the camera is visible");
+        Check(table.CullScalar(frustum, visible.data()) == 1 && visible[0] == 0, "only the object in front of the camera is visible to the scalar reference");
+
+        // Moving objects in & out of view
+        table.Update(0, bounds, glm::translate(glm::mat4(1.0f), glm::vec3(0.f, -60.f, 5.f)));
+        table.Update(3, bounds, glm::translate(glm::mat4(1.0f), glm::vec3(5.f, 10.f, 0.f)));
+        Check(table.Cull(frustum, visible.data()) == 1 && visible[0] == 3, "updated objects are culled at their new place");
+
+        bool hasThrown{ false };
+        try { table.Update(table.GetSize(), bounds, glm::mat4(1.0f)); }
+        catch (const std::invalid_argument&) { hasThrown = true; }
+        Check(hasThrown, "updating past the end throws");
+    }
+
+    void TestRandomTable()
+    {
+        const Frustum frustum{ CreateFrustum() };
+        const MeshBounds bounds{ CreateBounds() };
+        std::mt19937 generator{ 5489u };
+        std::uniform_real_distribution<float> positionDistribution{ -100.f, 100.f };
+        std::uniform_real_distribution<float> angleDistribution{ 0.f, glm::two_pi<float>() };
+        std::uniform_real_distribution<float> axisDistribution{ -1.f, 1.f };
+        std::uniform_real_distribution<float> scaleDistribution{ 0.25f, 4.f };
+
+        // Turned around any axis & scaled unevenly, an odd count so the last block is partly padding
+        constexpr uint32_t objectCount{ 100'003 };
+        BoundsTable table{};
+        for (uint32_t i{ 0 }; i < objectCount; ++i)
+        {
+            glm::vec3 position{ positionDistribution(generator), positionDistribution(generator), positionDistribution(generator) };
+            glm::vec3 axis{ axisDistribution(generator), axisDistribution(generator), axisDistribution(generator) + 2.f };
+            glm::vec3 scale{ scaleDistribution(generator), scaleDistribution(generator), scaleDistribution(generator) };
+            glm::mat4 transform = glm::translate(glm::mat4(1.0f), position);
+            transform = glm::rotate(transform, angleDistribution(generator), axis);
+            table.Add(bounds, glm::scale(transform, scale));
+        }
+
+        uint32_t visibleCount{};
+        Check(CullsEqual(table, frustum, &visibleCount), "SIMD & scalar culling agree on a random table");
+        Check(visibleCount > 0 && visibleCount < objectCount, "the random table is partly visible");
+
+        table.Clear();
+        Check(table.GetSize() == 0 && CullsEqual(table, frustum, &visibleCount) && visibleCount == 0, "nothing is visible once cleared");
+    }
+
+    void TestSmallTables()
+    {
+        const Frustum frustum{ CreateFrustum() };
+        const MeshBounds bounds{ CreateBounds() };
+        std::mt19937 generator{ 5489u };
+        std::uniform_real_distribution<float> positionDistribution{ -20.f, 20.f };
+
+        // Every count up to two blocks, partly visible
+        for (uint32_t count{ 0 }; count <= 16; ++count)
+        {
+            BoundsTable table{};
+            for (uint32_t i{ 0 }; i < count; ++i)
+            {
+                glm::vec3 position{ positionDistribution(generator), positionDistribution(generator), positionDistribution(generator) };
+                table.Add(bounds, glm::translate(glm::mat4(1.0f), position));
+            }
+            Check(CullsEqual(table, frustum), "SIMD & scalar culling agree on a small table");
+        }
+
+        // The padding sits at the origin, which is in view, so only the real objects behind the camera may be tested
+        for (uint32_t count{ 1 }; count <= 16; ++count)
+        {
+            BoundsTable table{};
+            for (uint32_t i{ 0 }; i < count; ++i) table.Add(bounds, glm::translate(glm::mat4(1.0f), glm::vec3(0.f, -60.f - i, 5.f)));
+
+            std::vector<uint32_t> visible(count);
+            Check(table.Cull(frustum, visible.data()) == 0, "the padding of the last block is never visible");
+        }
+    }
+}
+
+int main()
+{
+    TestKnownObjects();
+    TestRandomTable();
+    TestSmallTables();
+
+    if (g_FailureCount > 0) {
+        std::cerr << g_FailureCount << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "all bounds table checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
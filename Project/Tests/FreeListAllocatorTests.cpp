@@ -0,0 +1,174 @@
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+#include "Source/FreeListAllocator.h"
+
+// Checks the free-list logic on its own, it doesn't touch Vulkan so it runs without a GPU
+namespace
+{
+    int g_FailureCount{ 0 };
+
+    void Check(bool condition, const char* description)
+    {
+        if (condition) return;
+        std::cerr << "FAILED: " << description << std::endl;
+        ++g_FailureCount;
+    }
+
+    bool Overlaps(const std::vector<FreeListAllocator::Allocation>& allocations)
+    {
+        std::vector<FreeListAllocator::Allocation> sorted{ allocations };
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.Offset < b.Offset; });
+        for (size_t i{ 1 }; i < sorted.size(); ++i)
+        {
+            if (sorted[i - 1].Offset + sorted[i - 1].Size > sorted[i].Offset) return true;
+        }
+        return false;
+    }
+
+    void TestAlignment()
+    {
+        FreeListAllocator allocator{ 1 << 20 };
+
+        // An odd sized allocation first, so the next free range doesn't start aligned
+        Check(allocator.Allocate(3).has_value(), "allocating 3 bytes");
+        for (uint64_t alignment : { 1, 2, 4, 16, 64, 256, 4096 })
+        {
+            auto allocation = allocator.Allocate(100, alignment);
+            Check(allocation.has_value(), "allocating with an alignment");
+            if (allocation.has_value() == false) continue;
+            Check(allocation->Offset % alignment == 0, "offset is a multiple of the alignment");
+            Check(allocation->Size >= 100, "allocation is at least the requested size");
+            Check(allocation->Offset + allocation->Size <= allocator.GetSize(), "allocation ends inside of the range");
+        }
+    }
+
+    void TestNoOverlap()
+    {
+        constexpr uint64_t size{ 1 << 20 };
+        FreeListAllocator allocator{ size };
+        std::mt19937 generator{ 5489u };
+        std::uniform_int_distribution<uint64_t> sizeDistribution{ 1, 4096 };
+        std::uniform_int_distribution<int> alignmentDistribution{ 0, 8 };
+
+        // Random allocations & frees, every live allocation has to stay disjoint from the others
+        std::vector<FreeListAllocator::Allocation> allocations{};
+        for (int step{ 0 }; step < 10000; ++step)
+        {
+            if (allocations.empty() == false && generator() % 3 == 0) {
+                size_t index = generator() % allocations.size();
+                allocator.Free(allocations[index].Handle);
+                allocations.erase(allocations.begin() + index);
+                continue;
+            }
+
+            auto allocation = allocator.Allocate(sizeDistribution(generator), uint64_t{ 1 } << alignmentDistribution(generator));
+            if (allocation.has_value()) allocations.push_back(*allocation);
+        }
+        Check(Overlaps(allocations) == false, "live allocations don't overlap");
+
+        uint64_t usedSize{ 0 };
+        for (const auto& allocation : allocations) usedSize += allocation.Size;
+        FreeListAllocator::Stats stats = allocator.GetStats();
+        Check(stats.AllocationCount == allocations.size(), "stats count every live allocation");
+        Check(stats.UsedSize == usedSize, "used size is the sum of the allocation sizes");
+        Check(stats.UsedSize + stats.FreeSize == size, "used & free size add up to the total");
+    }
+
+    void TestSplitAndMerge()
+    {
+        constexpr uint64_t size{ 64 * 1024 };
+        FreeListAllocator allocator{ size };
+
+        // Fill everything with small ranges, then free them in a random order
+        std::vector<FreeListAllocator::Allocation> allocations{};
+        while (auto allocation = allocator.Allocate(256)) allocations.push_back(*allocation);
+        Check(allocations.size() == size / 256, "the whole range is split into allocations");
+        Check(allocator.GetStats().FreeSize == 0, "nothing is free once full");
+
+        std::mt19937 generator{ 5489u };
+        std::shuffle(allocations.begin(), allocations.end(), generator);
+        for (const auto& allocation : allocations) allocator.Free(allocation.Handle);
+
+        FreeListAllocator::Stats stats = allocator.GetStats();
+        Check(allocator.IsEmpty(), "empty after freeing everything");
+        Check(stats.FreeRangeCount == 1, "freed ranges merge back into one");
+        Check(stats.LargestFreeRange == size, "the merged range covers everything");
+        Check(allocator.GetFragmentation() == 0.f, "no fragmentation once merged");
+
+        auto whole = allocator.Allocate(size);
+        Check(whole.has_value() && whole->Offset == 0, "the whole range can be allocated again");
+    }
+
+    void TestStats()
+    {
+        // 8 ranges of 64 bytes, freeing every other one leaves 4 free ranges that can't merge
+        FreeListAllocator allocator{ 512 };
+        std::vector<FreeListAllocator::Allocation> allocations{};
+        for (int i{ 0 }; i < 8; ++i) allocations.push_back(*allocator.Allocate(64));
+        for (int i{ 0 }; i < 8; i += 2) allocator.Free(allocations[i].Handle);
+
+        FreeListAllocator::Stats stats = allocator.GetStats();
+        Check(stats.TotalSize == 512, "total size");
+        Check(stats.UsedSize == 256 && stats.FreeSize == 256, "used & free size");
+        Check(stats.AllocationCount == 4, "allocation count");
+        Check(stats.FreeRangeCount == 4, "free range count");
+        Check(stats.LargestFreeRange == 64, "largest free range");
+        Check(std::abs(allocator.GetFragmentation() - 0.75f) < 1e-6f, "fragmentation of 4 equal free ranges");
+
+        // Tails below the minimum split size are handed out with the allocation & counted as wasted
+        FreeListAllocator wasteful{ 256, 32 };
+        auto allocation = wasteful.Allocate(240);
+        Check(allocation.has_value() && allocation->Size == 256, "tail too small to split is kept");
+        Check(wasteful.GetStats().WastedSize == 16, "kept tail is counted as wasted");
+    }
+
+    void TestFull()
+    {
+        FreeListAllocator allocator{ 1024 };
+        Check(allocator.Allocate(0).has_value() == false, "zero sized allocation fails");
+        Check(allocator.Allocate(2048).has_value() == false, "allocation bigger than the range fails");
+
+        auto whole = allocator.Allocate(1024);
+        Check(whole.has_value(), "allocating the whole range");
+        Check(allocator.Allocate(1).has_value() == false, "allocation fails once full");
+
+        // Freeing makes room again, freeing twice or an unknown handle throws
+        allocator.Free(whole->Handle);
+        Check(allocator.Allocate(512, 512).has_value(), "allocation succeeds after freeing");
+
+        bool hasThrown{ false };
+        try { allocator.Free(whole->Handle + 100); }
+        catch (const std::invalid_argument&) { hasThrown = true; }
+        Check(hasThrown, "freeing an unknown handle throws");
+
+        FreeListAllocator other{ 1024 };
+        auto allocation = other.Allocate(16);
+        other.Free(allocation->Handle);
+        hasThrown = false;
+        try { other.Free(allocation->Handle); }
+        catch (const std::invalid_argument&) { hasThrown = true; }
+        Check(hasThrown, "freeing twice throws");
+    }
+}
+
+int main()
+{
+    TestAlignment();
+    TestNoOverlap();
+    TestSplitAndMerge();
+    TestStats();
+    TestFull();
+
+    if (g_FailureCount > 0) {
+        std::cerr << g_FailureCount << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "all free list allocator checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,189 @@
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "Source/MeshOptimizer.h"
+
+// Checks the reordering of the mesh optimizer on generated meshes, it doesn't touch Vulkan so it runs without a GPU
+namespace
+{
+    constexpr uint32_t CACHE_SIZE{ 16 };
+    constexpr float OVERDRAW_THRESHOLD{ 1.05f };
+
+    int g_FailureCount{ 0 };
+
+    void Check(bool condition, const char* description)
+    {
+        if (condition) return;
+        std::cerr << "FAILED: " << description << std::endl;
+        ++g_FailureCount;
+    }
+
+    struct TestVertex
+    {
+        float Position[3]{};
+        uint32_t Id{};
+    };
+
+    struct TestMesh
+    {
+        const char* pName{};
+        std::vector<TestVertex> Vertices{};
+        std::vector<uint32_t> Indices{};
+    };
+
+    // Triangles rotated so their smallest index comes first, which keeps the winding, then sorted
+    std::vector<std::array<uint32_t, 3>> GetTriangles(const std::vector<uint32_t>& indices)
+    {
+        std::vector<std::array<uint32_t, 3>> triangles{};
+        for (size_t i{ 0 }; i + 2 < indices.size(); i += 3)
+        {
+            std::array<uint32_t, 3> triangle{ indices[i], indices[i + 1], indices[i + 2] };
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+            triangles.push_back(triangle);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    // Rows of quads, the order a simple exporter writes them in
+    TestMesh CreateGrid(uint32_t size)
+    {
+        TestMesh mesh{ "grid" };
+        for (uint32_t y{ 0 }; y <= size; ++y)
+        {
+            for (uint32_t x{ 0 }; x <= size; ++x) mesh.Vertices.push_back({ { static_cast<float>(x), static_cast<float>(y), 0.f } });
+        }
+        for (uint32_t y{ 0 }; y < size; ++y)
+        {
+            for (uint32_t x{ 0 }; x < size; ++x)
+            {
+                const uint32_t corner{ y * (size + 1) + x };
+                mesh.Indices.insert(mesh.Indices.end(), { corner, corner + 1, corner + size + 2, corner, corner + size + 2, corner + size + 1 });
+            }
+        }
+        return mesh;
+    }
+
+    // Closed, so some clusters face away from the others
+    TestMesh CreateSphere(uint32_t rings, uint32_t segments)
+    {
+        TestMesh mesh{ "sphere" };
+        const float pi{ 3.14159265f };
+        for (uint32_t ring{ 0 }; ring <= rings; ++ring)
+        {
+            const float theta{ pi * ring / rings };
+            for (uint32_t segment{ 0 }; segment < segments; ++segment)
+            {
+                const float phi{ 2.f * pi * segment / segments };
+                mesh.Vertices.push_back({ { std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta) } });
+            }
+        }
+        for (uint32_t ring{ 0 }; ring < rings; ++ring)
+        {
+            for (uint32_t segment{ 0 }; segment < segments; ++segment)
+            {
+                const uint32_t a{ ring * segments + segment }, b{ ring * segments + (segment + 1) % segments };
+                mesh.Indices.insert(mesh.Indices.end(), { a, a + segments, b, b, a + segments, b + segments });
+            }
+        }
+        return mesh;
+    }
+
+    // The same triangles in a random order, the worst case for the cache
+    TestMesh Shuffle(TestMesh mesh, const char* pName)
+    {
+        std::vector<std::array<uint32_t, 3>> triangles{};
+        for (size_t i{ 0 }; i < mesh.Indices.size(); i += 3) triangles.push_back({ mesh.Indices[i], mesh.Indices[i + 1], mesh.Indices[i + 2] });
+        std::mt19937 generator{ 5489u };
+        std::shuffle(triangles.begin(), triangles.end(), generator);
+
+        mesh.pName = pName;
+        mesh.Indices.clear();
+        for (const auto& triangle : triangles) mesh.Indices.insert(mesh.Indices.end(), triangle.begin(), triangle.end());
+        return mesh;
+    }
+
+    void TestVertexCache(const TestMesh& mesh)
+    {
+        std::cout << mesh.pName << ":\n";
+        const VertexCacheStats before = optimizer::AnalyzeVertexCache(mesh.Indices, mesh.Vertices.size(), CACHE_SIZE);
+        const std::vector<uint32_t> indices = optimizer::OptimizeVertexCache(mesh.Indices, mesh.Vertices.size(), CACHE_SIZE);
+        const VertexCacheStats after = optimizer::AnalyzeVertexCache(indices, mesh.Vertices.size(), CACHE_SIZE);
+        std::cout << "\tvertex cache: ACMR " << before.ACMR << " -> " << after.ACMR << ", ATVR " << before.ATVR << " -> " << after.ATVR << '\n';
+
+        Check(GetTriangles(indices) == GetTriangles(mesh.Indices), "vertex cache optimization keeps every triangle & its winding");
+        Check(after.ACMR <= before.ACMR, "vertex cache optimization doesn't raise the ACMR");
+        Check(after.ATVR <= before.ATVR, "vertex cache optimization doesn't raise the ATVR");
+
+        // Running it again on its own output can't make things worse either
+        const VertexCacheStats again = optimizer::AnalyzeVertexCache(optimizer::OptimizeVertexCache(indices, mesh.Vertices.size(), CACHE_SIZE), mesh.Vertices.size(), CACHE_SIZE);
+        Check(again.ACMR <= after.ACMR * 1.001f, "optimizing optimized indices keeps the ACMR");
+    }
+
+    void TestOverdraw(const TestMesh& mesh)
+    {
+        const std::vector<uint32_t> cacheIndices = optimizer::OptimizeVertexCache(mesh.Indices, mesh.Vertices.size(), CACHE_SIZE);
+        const VertexCacheStats before = optimizer::AnalyzeVertexCache(cacheIndices, mesh.Vertices.size(), CACHE_SIZE);
+        const std::vector<uint32_t> indices = optimizer::OptimizeOverdraw(cacheIndices, mesh.Vertices[0].Position, sizeof(TestVertex), mesh.Vertices.size(), CACHE_SIZE, OVERDRAW_THRESHOLD);
+        const VertexCacheStats after = optimizer::AnalyzeVertexCache(indices, mesh.Vertices.size(), CACHE_SIZE);
+        std::cout << "\toverdraw: ACMR " << before.ACMR << " -> " << after.ACMR << ", ATVR " << before.ATVR << " -> " << after.ATVR << '\n';
+
+        // Clusters are only closed once they're within the threshold, the sort can't lose more than that
+        Check(GetTriangles(indices) == GetTriangles(mesh.Indices), "overdraw optimization keeps every triangle & its winding");
+        Check(after.ACMR <= before.ACMR * OVERDRAW_THRESHOLD, "overdraw optimization stays within the ACMR threshold");
+        Check(after.ATVR <= before.ATVR * OVERDRAW_THRESHOLD, "overdraw optimization stays within the ATVR threshold");
+    }
+
+    void TestVertexFetch(const TestMesh& mesh)
+    {
+        // An unused vertex at the front, it has to end up at the back
+        TestMesh unused{ mesh };
+        unused.Vertices.insert(unused.Vertices.begin(), TestVertex{});
+        for (uint32_t& index : unused.Indices) ++index;
+        for (uint32_t i{ 0 }; i < unused.Vertices.size(); ++i) unused.Vertices[i].Id = i;
+
+        std::vector<TestVertex> vertices{ unused.Vertices };
+        std::vector<uint32_t> indices{ unused.Indices };
+        optimizer::OptimizeVertexFetch(vertices, indices);
+
+        bool isSameVertex{ indices.size() == unused.Indices.size() };
+        for (size_t i{ 0 }; i < indices.size() && isSameVertex; ++i) isSameVertex = vertices[indices[i]].Id == unused.Indices[i];
+        Check(isSameVertex, "every corner keeps its vertex after the vertex fetch optimization");
+
+        uint32_t nextVertex{ 0 };
+        bool isInFirstUseOrder{ true };
+        for (uint32_t index : indices)
+        {
+            if (index == nextVertex) ++nextVertex;
+            else if (index > nextVertex) isInFirstUseOrder = false;
+        }
+        Check(isInFirstUseOrder, "vertices are stored in the order they're first used");
+        Check(vertices.size() == unused.Vertices.size() && vertices.back().Id == 0, "unused vertices are kept at the back");
+    }
+}
+
+int main()
+{
+    const TestMesh grid = CreateGrid(64);
+    const TestMesh sphere = CreateSphere(48, 64);
+    for (const TestMesh& mesh : { grid, Shuffle(grid, "shuffled grid"), sphere, Shuffle(sphere, "shuffled sphere") })
+    {
+        TestVertexCache(mesh);
+        TestOverdraw(mesh);
+        TestVertexFetch(mesh);
+    }
+
+    if (g_FailureCount > 0) {
+        std::cerr << g_FailureCount << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "all mesh optimizer checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,208 @@
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "Source/MeshletBuilder.h"
+
+// Checks the meshlet limits, coverage & culling bounds on generated meshes, it doesn't touch Vulkan so it runs without a GPU
+namespace
+{
+    int g_FailureCount{ 0 };
+
+    void Check(bool condition, const char* description)
+    {
+        if (condition) return;
+        std::cerr << "FAILED: " << description << std::endl;
+        ++g_FailureCount;
+    }
+
+    struct Position
+    {
+        float X{}, Y{}, Z{};
+    };
+
+    struct TestMesh
+    {
+        const char* pName{};
+        std::vector<Position> Positions{};
+        std::vector<uint32_t> Indices{};
+    };
+
+    std::vector<std::array<uint32_t, 3>> GetTriangles(const std::vector<uint32_t>& indices)
+    {
+        std::vector<std::array<uint32_t, 3>> triangles{};
+        for (size_t i{ 0 }; i + 2 < indices.size(); i += 3) triangles.push_back({ indices[i], indices[i + 1], indices[i + 2] });
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    // Closed, with a seam of split vertices where the segments wrap around like a UV seam
+    TestMesh CreateSphere(uint32_t rings, uint32_t segments)
+    {
+        TestMesh mesh{ "sphere" };
+        const float pi{ 3.14159265f };
+        for (uint32_t ring{ 0 }; ring <= rings; ++ring)
+        {
+            const float theta{ pi * ring / rings };
+            for (uint32_t segment{ 0 }; segment <= segments; ++segment)
+            {
+                const float phi{ 2.f * pi * (segment % segments) / segments };
+                mesh.Positions.push_back({ std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta) });
+            }
+        }
+        for (uint32_t ring{ 0 }; ring < rings; ++ring)
+        {
+            for (uint32_t segment{ 0 }; segment < segments; ++segment)
+            {
+                const uint32_t a{ ring * (segments + 1) + segment };
+                mesh.Indices.insert(mesh.Indices.end(), { a, a + segments + 1, a + 1, a + 1, a + segments + 1, a + segments + 2 });
+            }
+        }
+        return mesh;
+    }
+
+    // One vertex shared by hundreds of triangles, more than a meshlet can hold
+    TestMesh CreateFan(uint32_t triangleCount)
+    {
+        TestMesh mesh{ "fan" };
+        mesh.Positions.push_back({});
+        for (uint32_t i{ 0 }; i <= triangleCount; ++i)
+        {
+            const float angle{ 6.28318530718f * i / triangleCount };
+            mesh.Positions.push_back({ std::cos(angle), std::sin(angle), 0.f });
+            if (i > 0) mesh.Indices.insert(mesh.Indices.end(), { 0, i, i + 1 });
+        }
+        return mesh;
+    }
+
+    // Disconnected triangles facing every way, nothing to grow a meshlet along
+    TestMesh CreateSoup(uint32_t triangleCount)
+    {
+        TestMesh mesh{ "soup" };
+        std::mt19937 generator{ 5489u };
+        std::uniform_real_distribution<float> distribution{ -10.f, 10.f };
+        for (uint32_t i{ 0 }; i < triangleCount * 3; ++i)
+        {
+            mesh.Positions.push_back({ distribution(generator), distribution(generator), distribution(generator) });
+            mesh.Indices.push_back(i);
+        }
+        return mesh;
+    }
+
+    void TestMeshlets(const TestMesh& mesh, uint32_t maxVertices, uint32_t maxTriangles)
+    {
+        std::vector<uint32_t> indices{ mesh.Indices };
+        const MeshletData data = optimizer::BuildMeshlets(indices, &mesh.Positions[0].X, sizeof(Position), mesh.Positions.size(), maxVertices, maxTriangles);
+
+        // Every triangle ends up in exactly one meshlet, with its winding
+        Check(GetTriangles(indices) == GetTriangles(mesh.Indices), "the reordered indices hold every triangle exactly once");
+
+        bool isWithinLimits{ true }, isContiguous{ true }, isLocalInRange{ true }, isMatchingIndices{ true }, hasUniqueVertices{ true };
+        bool isInsideSphere{ true }, isBackFacingCorrect{ true };
+        uint32_t vertexOffset{ 0 }, triangleOffset{ 0 };
+        std::mt19937 generator{ 5489u };
+        std::uniform_real_distribution<float> cameraDistribution{ -20.f, 20.f };
+        for (const Meshlet& meshlet : data.Meshlets)
+        {
+            isWithinLimits = isWithinLimits && meshlet.VertexCount <= maxVertices && meshlet.TriangleCount <= maxTriangles && meshlet.TriangleCount > 0;
+            isContiguous = isContiguous && meshlet.VertexOffset == vertexOffset && meshlet.TriangleOffset == triangleOffset;
+            vertexOffset += meshlet.VertexCount;
+            triangleOffset += meshlet.TriangleCount;
+            if (vertexOffset > data.Vertices.size() || triangleOffset * 3 > data.Triangles.size()) {
+                isContiguous = false;
+                break;
+            }
+
+            std::vector<uint32_t> vertices{ data.Vertices.begin() + meshlet.VertexOffset, data.Vertices.begin() + meshlet.VertexOffset + meshlet.VertexCount };
+            std::sort(vertices.begin(), vertices.end());
+            hasUniqueVertices = hasUniqueVertices && std::adjacent_find(vertices.begin(), vertices.end()) == vertices.end();
+
+            // The local triangles & the reordered index range describe the same triangles
+            for (uint32_t corner{ 0 }; corner < meshlet.TriangleCount * 3; ++corner)
+            {
+                const uint8_t local{ data.Triangles[meshlet.TriangleOffset * 3 + corner] };
+                isLocalInRange = isLocalInRange && local < meshlet.VertexCount;
+                isMatchingIndices = isMatchingIndices && local < meshlet.VertexCount && data.Vertices[meshlet.VertexOffset + local] == indices[meshlet.TriangleOffset * 3 + corner];
+            }
+
+            for (uint32_t i{ 0 }; i < meshlet.VertexCount; ++i)
+            {
+                const Position& p = mesh.Positions[data.Vertices[meshlet.VertexOffset + i]];
+                float dx{ p.X - meshlet.Center[0] }, dy{ p.Y - meshlet.Center[1] }, dz{ p.Z - meshlet.Center[2] };
+                isInsideSphere = isInsideSphere && std::sqrt(dx * dx + dy * dy + dz * dz) <= meshlet.Radius * 1.0001f + 1e-6f;
+            }
+
+            // Culling is conservative, a meshlet is only back facing if all of its triangles are
+            for (int camera{ 0 }; camera < 16; ++camera)
+            {
+                const float cameraPosition[3]{ cameraDistribution(generator), cameraDistribution(generator), cameraDistribution(generator) };
+                if (optimizer::IsMeshletBackFacing(meshlet, cameraPosition) == false) continue;
+
+                for (uint32_t triangle{ meshlet.TriangleOffset }; triangle < meshlet.TriangleOffset + meshlet.TriangleCount; ++triangle)
+                {
+                    const Position& p0 = mesh.Positions[indices[triangle * 3]];
+                    const Position& p1 = mesh.Positions[indices[triangle * 3 + 1]];
+                    const Position& p2 = mesh.Positions[indices[triangle * 3 + 2]];
+                    Position e0{ p1.X - p0.X, p1.Y - p0.Y, p1.Z - p0.Z }, e1{ p2.X - p0.X, p2.Y - p0.Y, p2.Z - p0.Z };
+                    Position normal{ e0.Y * e1.Z - e0.Z * e1.Y, e0.Z * e1.X - e0.X * e1.Z, e0.X * e1.Y - e0.Y * e1.X };
+                    float facing = (p0.X - cameraPosition[0]) * normal.X + (p0.Y - cameraPosition[1]) * normal.Y + (p0.Z - cameraPosition[2]) * normal.Z;
+                    isBackFacingCorrect = isBackFacingCorrect && facing >= -1e-5f;
+                }
+            }
+        }
+
+        std::cout << mesh.pName << " (" << maxVertices << " vertices, " << maxTriangles << " triangles): " << data.Meshlets.size() << " meshlets for "
+            << mesh.Indices.size() / 3 << " triangles\n";
+        Check(isWithinLimits, "meshlets stay within the vertex & triangle limits");
+        Check(isContiguous && vertexOffset == data.Vertices.size() && triangleOffset * 3 == data.Triangles.size(), "meshlets are stored back to back");
+        Check(triangleOffset * 3 == indices.size(), "the meshlets cover every triangle");
+        Check(isLocalInRange, "local indices point inside of their meshlet");
+        Check(isMatchingIndices, "local triangles match the reordered indices");
+        Check(hasUniqueVertices, "meshlets don't store a vertex twice");
+        Check(isInsideSphere, "bounding spheres contain their vertices");
+        Check(isBackFacingCorrect, "back facing meshlets only hold back facing triangles");
+    }
+
+    void TestEdgeCases()
+    {
+        const TestMesh sphere = CreateSphere(4, 8);
+        for (auto [maxVertices, maxTriangles] : { std::pair{ 2u, 1u }, std::pair{ 255u, 1u }, std::pair{ 64u, 0u } })
+        {
+            std::vector<uint32_t> indices{ sphere.Indices };
+            bool hasThrown{ false };
+            try { optimizer::BuildMeshlets(indices, &sphere.Positions[0].X, sizeof(Position), sphere.Positions.size(), maxVertices, maxTriangles); }
+            catch (const std::invalid_argument&) { hasThrown = true; }
+            Check(hasThrown, "limits that don't fit the local indices throw");
+        }
+
+        std::vector<uint32_t> indices{};
+        const MeshletData data = optimizer::BuildMeshlets(indices, &sphere.Positions[0].X, sizeof(Position), sphere.Positions.size(), 64, 124);
+        Check(data.Meshlets.empty() && data.Vertices.empty() && data.Triangles.empty(), "no triangles give no meshlets");
+    }
+}
+
+int main()
+{
+    // The limits of PBR_Meshlet.mesh, the smallest possible meshlets & the largest local indices
+    for (const TestMesh& mesh : { CreateSphere(48, 64), CreateFan(600), CreateSoup(2000) })
+    {
+        for (auto [maxVertices, maxTriangles] : { std::pair{ 64u, 124u }, std::pair{ 3u, 1u }, std::pair{ 8u, 4u }, std::pair{ 254u, 512u } })
+        {
+            TestMeshlets(mesh, maxVertices, maxTriangles);
+        }
+    }
+    TestEdgeCases();
+
+    if (g_FailureCount > 0) {
+        std::cerr << g_FailureCount << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "all meshlet builder checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,192 @@
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <random>
+#include <fstream>
+#include <filesystem>
+
+#include <tiny_obj_loader.h>
+#include "Source/ObjParser.h"
+
+// Checks the OBJ parser against tinyobjloader & hand written files, runs from the Project directory so the models are found
+namespace
+{
+    int g_FailureCount{ 0 };
+
+    void Check(bool condition, const char* description)
+    {
+        if (condition) return;
+        std::cerr << "FAILED: " << description << std::endl;
+        ++g_FailureCount;
+    }
+
+    bool IsEqual(const std::vector<ObjIndex>& a, const std::vector<ObjIndex>& b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const ObjIndex& indexA, const ObjIndex& indexB)
+            { return indexA.Position == indexB.Position && indexA.TexCoord == indexB.TexCoord && indexA.Normal == indexB.Normal; });
+    }
+
+    bool IsEqual(const ObjData& a, const ObjData& b)
+    {
+        return a.Positions == b.Positions && a.TexCoords == b.TexCoords && a.Normals == b.Normals && IsEqual(a.Indices, b.Indices);
+    }
+
+    // Nothing is mounted, so vfs reads the files straight from disk
+    std::string WriteFile(const std::string& name, const std::string& contents)
+    {
+        std::string filePath{ (std::filesystem::temp_directory_path() / name).string() };
+        std::ofstream file{ filePath, std::ios::binary };
+        file << contents;
+        return filePath;
+    }
+
+    void TestBundledModels()
+    {
+        for (const char* filePath : { "Resources/Models/vehicle.obj", "Resources/Models/viking_room.obj", "Resources/Models/fireFX.obj" })
+        {
+            tinyobj::attrib_t attrib{};
+            std::vector<tinyobj::shape_t> shapes{};
+            std::vector<tinyobj::material_t> materials{};
+            std::string warn{}, err{};
+            if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filePath)) {
+                throw std::runtime_error(warn + err);
+            }
+            const ObjData obj = ObjParser{}.Parse(filePath);
+
+            // Both triangulate as a fan and keep the corners in file order
+            Check(attrib.vertices == obj.Positions, "positions match tinyobjloader");
+            Check(attrib.texcoords == obj.TexCoords, "texture coordinates match tinyobjloader");
+            Check(attrib.normals == obj.Normals, "normals match tinyobjloader");
+
+            std::vector<ObjIndex> expected{};
+            for (const tinyobj::shape_t& shape : shapes)
+            {
+                for (const tinyobj::index_t& index : shape.mesh.indices) expected.push_back({ index.vertex_index, index.texcoord_index, index.normal_index });
+            }
+            Check(IsEqual(expected, obj.Indices), "corners match tinyobjloader");
+
+            Check(IsEqual(ObjParser{ 1 }.Parse(filePath), obj), "a single thread parses the same as all threads");
+        }
+    }
+
+    void TestCornerFormats()
+    {
+        const std::string filePath = WriteFile("ObjParserTests_corners.obj",
+            "# comment\r\n"
+            "mtllib scene.mtl\r\n"
+            "o quad\r\n"
+            "v 0 0 0\r\n"
+            "v 1.5 0 -2e1\r\n"
+            "v 1 1 0 1.0\r\n"
+            "v -0.25 +1 .5\r\n"
+            "\r\n"
+            "vt 0 0\r\n"
+            "vt 1 0 0\r\n"
+            "vn 0 0 1\r\n"
+            "g group\r\n"
+            "usemtl material\r\n"
+            "s 1\r\n"
+            "f 1/1/1 2/2/1 3/1/1 4/2/1\r\n"
+            "f 1//1 2//1 3//1\n"
+            "f 1/2 2/1 4/2\n"
+            "f 2 3 4\n"
+            "f -4/-2/-1 -3/-1/-1 -2/-2/-1");
+        const ObjData obj = ObjParser{}.Parse(filePath.c_str());
+
+        Check(obj.Positions == std::vector<float>{ 0.f, 0.f, 0.f, 1.5f, 0.f, -20.f, 1.f, 1.f, 0.f, -0.25f, 1.f, 0.5f }, "positions, exponents & weights");
+        Check(obj.TexCoords == std::vector<float>{ 0.f, 0.f, 1.f, 0.f }, "texture coordinates without the third component");
+        Check(obj.Normals == std::vector<float>{ 0.f, 0.f, 1.f }, "normals");
+
+        // The quad is split into 2 triangles around its first corner, missing attributes are -1
+        const std::vector<ObjIndex> expected{
+            { 0, 0, 0 }, { 1, 1, 0 }, { 2, 0, 0 }, { 0, 0, 0 }, { 2, 0, 0 }, { 3, 1, 0 },
+            { 0, -1, 0 }, { 1, -1, 0 }, { 2, -1, 0 },
+            { 0, 1, -1 }, { 1, 0, -1 }, { 3, 1, -1 },
+            { 1, -1, -1 }, { 2, -1, -1 }, { 3, -1, -1 },
+            { 0, 0, 0 }, { 1, 1, 0 }, { 2, 0, 0 } };
+        Check(IsEqual(obj.Indices, expected), "v, v/vt, v//vn, v/vt/vn & negative corners");
+
+        std::filesystem::remove(filePath);
+    }
+
+    void TestChunks()
+    {
+        // Big enough to be split over several threads, negative corners at the start of a chunk point into the one before it
+        std::mt19937 generator{ 5489u };
+        std::uniform_int_distribution<int> valueDistribution{ -1'000'000, 1'000'000 };
+        std::string contents{};
+        std::vector<float> positions{};
+        std::vector<ObjIndex> expected{};
+        char line[128]{};
+        for (int quad{ 0 }; quad < 100'000; ++quad)
+        {
+            for (int corner{ 0 }; corner < 4; ++corner)
+            {
+                float coordinates[3]{};
+                for (float& coordinate : coordinates)
+                {
+                    std::snprintf(line, sizeof(line), "%.4f", valueDistribution(generator) / 10000.0);
+                    coordinate = std::strtof(line, nullptr);
+                    positions.push_back(coordinate);
+                }
+                std::snprintf(line, sizeof(line), "v %.4f %.4f %.4f\n", coordinates[0], coordinates[1], coordinates[2]);
+                contents += line;
+            }
+
+            // Every other quad uses absolute indices
+            const int32_t first{ quad * 4 };
+            if (quad % 2 == 0) contents += "f -4 -3 -2 -1\n";
+            else {
+                std::snprintf(line, sizeof(line), "f %d %d %d %d\n", first + 1, first + 2, first + 3, first + 4);
+                contents += line;
+            }
+            for (int32_t corner : { 0, 1, 2, 0, 2, 3 }) expected.push_back({ first + corner, -1, -1 });
+        }
+        const std::string filePath = WriteFile("ObjParserTests_chunks.obj", contents);
+
+        const ObjData obj = ObjParser{ 8 }.Parse(filePath.c_str());
+        Check(obj.Positions == positions, "positions parse like strtof");
+        Check(IsEqual(obj.Indices, expected), "negative corners are resolved across chunks");
+        Check(IsEqual(ObjParser{ 1 }.Parse(filePath.c_str()), obj), "a single thread parses the same as 8 threads");
+
+        std::filesystem::remove(filePath);
+    }
+
+    void TestOutOfRange()
+    {
+        for (const char* contents : { "v 0 0 0\nv 1 0 0\nf 1 2 3\n", "v 0 0 0\nf -2 1 1\n", "v 0 0 0\nf 1/1 1/1 1/1\n", "v 0 0 0\nvn 0 0 1\nf 1//2 1//1 1//1\n" })
+        {
+            const std::string filePath = WriteFile("ObjParserTests_range.obj", contents);
+            bool hasThrown{ false };
+            try { ObjParser{}.Parse(filePath.c_str()); }
+            catch (const std::runtime_error&) { hasThrown = true; }
+            Check(hasThrown, "corners past the attributes throw");
+            std::filesystem::remove(filePath);
+        }
+    }
+}
+
+int main()
+{
+    try {
+        TestBundledModels();
+        TestCornerFormats();
+        TestChunks();
+        TestOutOfRange();
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (g_FailureCount > 0) {
+        std::cerr << g_FailureCount << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "all obj parser checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
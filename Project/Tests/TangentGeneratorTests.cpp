@@ -0,0 +1,273 @@
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "Source/TangentGenerator.h"
+
+// Checks the tangent frames, handedness splits & degenerate UVs on generated meshes, it doesn't touch Vulkan so it runs without a GPU
+namespace
+{
+    int g_FailureCount{ 0 };
+
+    void Check(bool condition, const char* description)
+    {
+        if (condition) return;
+        std::cerr << "FAILED: " << description << std::endl;
+        ++g_FailureCount;
+    }
+
+    struct TestVertex
+    {
+        float Position[3]{};
+        float Normal[3]{};
+        float TexCoord[2]{};
+    };
+
+    struct TestMesh
+    {
+        std::vector<TestVertex> Vertices{};
+        std::vector<uint32_t> Indices{};
+    };
+
+    float Dot(const float* a, const float* b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+
+    TangentData Generate(TestMesh& mesh, uint32_t threadCount = 0)
+    {
+        return TangentGenerator{ threadCount }.Generate(mesh.Indices, mesh.Vertices[0].Position, mesh.Vertices[0].Normal, mesh.Vertices[0].TexCoord,
+            sizeof(TestVertex), mesh.Vertices.size());
+    }
+
+    // One vertex per triangle corner, the stream Mesh::LoadCorners produces
+    std::vector<TestVertex> GetCorners(const TestMesh& mesh)
+    {
+        std::vector<TestVertex> corners{};
+        for (uint32_t index : mesh.Indices) corners.push_back(mesh.Vertices[index]);
+        return corners;
+    }
+
+    TangentData GenerateCorners(const std::vector<TestVertex>& corners)
+    {
+        return TangentGenerator{}.GenerateCorners(corners[0].Position, corners[0].Normal, corners[0].TexCoord, sizeof(TestVertex), corners.size());
+    }
+
+    // Finite, unit length, perpendicular to the unit normal & a sign of +-1
+    bool IsValidFrame(const float* pTangent, const float* pNormal)
+    {
+        for (int i{ 0 }; i < 4; ++i)
+        {
+            if (std::isfinite(pTangent[i]) == false) return false;
+        }
+        if (std::abs(Dot(pTangent, pTangent) - 1.f) > 1e-4f || std::abs(pTangent[3]) != 1.f) return false;
+
+        const float normalLength{ std::sqrt(Dot(pNormal, pNormal)) };
+        return normalLength == 0.f || std::abs(Dot(pTangent, pNormal)) <= 1e-4f * normalLength;
+    }
+
+    // A flat grid in the xy plane facing +z, u follows x & v follows y, so every tangent is +x
+    // Mirrored grids use u = |x| instead, the left half is mirrored & the column at x = 0 is shared by both halves
+    TestMesh CreateGrid(uint32_t size, bool isMirrored)
+    {
+        TestMesh mesh{};
+        const float offset{ isMirrored ? size * 0.5f : 0.f };
+        for (uint32_t y{ 0 }; y <= size; ++y)
+        {
+            for (uint32_t x{ 0 }; x <= size; ++x)
+            {
+                const float positionX{ x - offset };
+                mesh.Vertices.push_back({ { positionX, static_cast<float>(y), 0.f }, { 0.f, 0.f, 1.f }, { isMirrored ? std::abs(positionX) : positionX, static_cast<float>(y) } });
+            }
+        }
+        for (uint32_t y{ 0 }; y < size; ++y)
+        {
+            for (uint32_t x{ 0 }; x < size; ++x)
+            {
+                const uint32_t corner{ y * (size + 1) + x };
+                mesh.Indices.insert(mesh.Indices.end(), { corner, corner + 1, corner + size + 2, corner, corner + size + 2, corner + size + 1 });
+            }
+        }
+        return mesh;
+    }
+
+    void TestGrid()
+    {
+        TestMesh mesh = CreateGrid(7, false);
+        const TangentData data = Generate(mesh);
+
+        bool isAlongX{ true };
+        for (size_t vertex{ 0 }; vertex < mesh.Vertices.size(); ++vertex)
+        {
+            const float* pTangent = &data.Tangents[4 * vertex];
+            isAlongX = isAlongX && IsValidFrame(pTangent, mesh.Vertices[vertex].Normal) && pTangent[0] > 0.9999f && pTangent[3] == 1.f;
+        }
+        Check(isAlongX, "tangents of a planar mapping follow u");
+        Check(data.SplitVertices.empty() && data.DegenerateTriangleCount == 0, "a planar mapping has no splits or degenerate triangles");
+    }
+
+    void TestMirroredUVs()
+    {
+        // Indexed, the seam vertices are used by both halves & have to be split
+        const uint32_t size{ 8 };
+        TestMesh mesh = CreateGrid(size, true);
+        const TestMesh original{ mesh };
+        const TangentData data = Generate(mesh);
+
+        Check(data.SplitVertices.size() == size + 1, "every vertex on the mirror seam is split once");
+        Check(mesh.Vertices.size() + data.SplitVertices.size() == data.Tangents.size() / 4, "split vertices get a tangent");
+
+        bool isSignMatching{ true }, isFrameValid{ true }, isSameVertex{ true };
+        for (size_t corner{ 0 }; corner < mesh.Indices.size(); ++corner)
+        {
+            const uint32_t vertex{ mesh.Indices[corner] };
+            const uint32_t originalVertex{ vertex < mesh.Vertices.size() ? vertex : data.SplitVertices[vertex - mesh.Vertices.size()] };
+            isSameVertex = isSameVertex && originalVertex == original.Indices[corner];
+
+            // A triangle is on the mirrored half if its centroid is left of the seam
+            const size_t triangle{ corner / 3 * 3 };
+            float centroidX{ 0.f };
+            for (size_t i{ 0 }; i < 3; ++i) centroidX += original.Vertices[original.Indices[triangle + i]].Position[0];
+            const float* pTangent = &data.Tangents[4 * static_cast<size_t>(vertex)];
+            isSignMatching = isSignMatching && pTangent[3] == (centroidX < 0.f ? -1.f : 1.f);
+
+            // u = -x on the left, so dP/du points along -x there
+            isFrameValid = isFrameValid && IsValidFrame(pTangent, original.Vertices[originalVertex].Normal) && pTangent[0] * (centroidX < 0.f ? -1.f : 1.f) > 0.9999f;
+        }
+        Check(isSameVertex, "split corners still point at a copy of their vertex");
+        Check(isSignMatching, "every corner gets the sign of its own triangle");
+        Check(isFrameValid, "tangents on both sides of the seam follow their own u");
+
+        // Unwelded, every corner gets its own frame & welding with the tangent in the key splits the same vertices
+        const std::vector<TestVertex> corners = GetCorners(original);
+        const TangentData cornerData = GenerateCorners(corners);
+        Check(cornerData.Tangents.size() == 4 * corners.size(), "one tangent per corner");
+        Check(cornerData.SplitVertices.size() == data.SplitVertices.size(), "the corner stream reports the same splits");
+
+        std::vector<std::array<float, 12>> weldedVertices{};
+        for (size_t corner{ 0 }; corner < corners.size(); ++corner)
+        {
+            std::array<float, 12> vertex{};
+            std::memcpy(vertex.data(), &corners[corner], sizeof(TestVertex));
+            std::copy_n(&cornerData.Tangents[4 * corner], 4, vertex.data() + 8);
+            weldedVertices.push_back(vertex);
+        }
+        std::sort(weldedVertices.begin(), weldedVertices.end());
+        weldedVertices.erase(std::unique(weldedVertices.begin(), weldedVertices.end()), weldedVertices.end());
+        Check(weldedVertices.size() == original.Vertices.size() + data.SplitVertices.size(), "welding the corners splits exactly the mirrored seam");
+
+        bool isSameFrame{ true };
+        for (size_t corner{ 0 }; corner < corners.size(); ++corner)
+        {
+            const float* pTangent = &data.Tangents[4 * static_cast<size_t>(mesh.Indices[corner])];
+            const float* pCornerTangent = &cornerData.Tangents[4 * corner];
+            for (int i{ 0 }; i < 4; ++i) isSameFrame = isSameFrame && std::abs(pTangent[i] - pCornerTangent[i]) <= 1e-6f;
+        }
+        Check(isSameFrame, "corners get the frame of their welded vertex");
+    }
+
+    void TestDegenerateUVs()
+    {
+        // Collapsed & collinear UVs, zero area triangles, a missing normal & a triangle count that isn't a multiple of the SIMD width
+        TestMesh mesh{};
+        mesh.Vertices = {
+            { { 0.f, 0.f, 0.f }, { 0.f, 0.f, 1.f }, { 0.5f, 0.5f } },
+            { { 1.f, 0.f, 0.f }, { 0.f, 0.f, 1.f }, { 0.5f, 0.5f } },
+            { { 0.f, 1.f, 0.f }, { 0.f, 0.f, 1.f }, { 0.5f, 0.5f } },
+            { { 0.f, 0.f, 1.f }, { 0.f, 1.f, 0.f }, { 0.f, 0.f } },
+            { { 1.f, 0.f, 1.f }, { 0.f, 1.f, 0.f }, { 1.f, 1.f } },
+            { { 0.f, 1.f, 1.f }, { 0.f, 1.f, 0.f }, { 2.f, 2.f } },
+            { { 2.f, 2.f, 2.f }, { 1.f, 0.f, 0.f }, { 0.f, 0.f } },
+            { { 2.f, 2.f, 2.f }, { 1.f, 0.f, 0.f }, { 1.f, 0.f } },
+            { { 2.f, 2.f, 2.f }, { 1.f, 0.f, 0.f }, { 0.f, 1.f } },
+            { { 5.f, 0.f, 0.f }, { 0.f, 0.f, 0.f }, { 0.f, 0.f } },
+            { { 6.f, 0.f, 0.f }, { 0.f, 0.f, 0.f }, { 1.f, 0.f } },
+            { { 5.f, 1.f, 0.f }, { 0.f, 0.f, 0.f }, { 0.f, 1.f } },
+            { { 3.f, 0.f, 0.f }, { 0.f, 0.f, -1.f }, { 0.f, 0.f } },
+            { { 4.f, 0.f, 0.f }, { 0.f, 0.f, -1.f }, { 1e-4f, 0.f } },
+            { { 3.f, 1.f, 0.f }, { 0.f, 0.f, -1.f }, { 0.f, 1e-4f } },
+        };
+        mesh.Indices = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14 };
+        const TestMesh original{ mesh };
+        const TangentData data = Generate(mesh);
+
+        Check(data.SplitVertices.empty(), "degenerate triangles don't split vertices");
+        Check(data.DegenerateTriangleCount == 2, "collapsed & collinear UVs are counted as degenerate");
+
+        bool isValid{ true };
+        for (size_t vertex{ 0 }; vertex < original.Vertices.size(); ++vertex)
+        {
+            isValid = isValid && IsValidFrame(&data.Tangents[4 * vertex], original.Vertices[vertex].Normal);
+        }
+        Check(isValid, "degenerate triangles still give finite unit tangents perpendicular to the normal");
+        Check(data.Tangents[4 * 9] > 0.9999f, "a missing normal keeps the tangent of the UVs");
+        Check(data.Tangents[4 * 12] > 0.9999f && data.Tangents[4 * 12 + 3] == 1.f, "tiny but valid UVs aren't degenerate");
+
+        const TangentData cornerData = GenerateCorners(GetCorners(original));
+        bool isCornerValid{ cornerData.Tangents.size() == 4 * original.Indices.size() };
+        for (size_t corner{ 0 }; corner < original.Indices.size() && isCornerValid; ++corner)
+        {
+            isCornerValid = IsValidFrame(&cornerData.Tangents[4 * corner], original.Vertices[original.Indices[corner]].Normal);
+        }
+        Check(isCornerValid, "degenerate corners give valid frames");
+        Check(cornerData.DegenerateTriangleCount == 2, "the corner stream counts the same degenerate triangles");
+    }
+
+    // Random triangles with random UVs & a few collapsed ones, over the size a single thread handles
+    void TestRandomMesh()
+    {
+        std::mt19937 generator{ 5489u };
+        std::uniform_real_distribution<float> distribution{ -1.f, 1.f };
+        std::uniform_int_distribution<uint32_t> vertexDistribution{ 0, 49'999 };
+
+        TestMesh mesh{};
+        for (uint32_t vertex{ 0 }; vertex < 50'000; ++vertex)
+        {
+            TestVertex testVertex{ { distribution(generator), distribution(generator), distribution(generator) },
+                { distribution(generator), distribution(generator), distribution(generator) }, { distribution(generator), distribution(generator) } };
+            if (vertex % 97 == 0) testVertex.TexCoord[0] = testVertex.TexCoord[1] = 0.f;
+            mesh.Vertices.push_back(testVertex);
+        }
+        for (uint32_t corner{ 0 }; corner < 3 * 150'001; ++corner) mesh.Indices.push_back(vertexDistribution(generator));
+        const TestMesh original{ mesh };
+
+        const TangentData data = Generate(mesh);
+        bool isValid{ data.Tangents.size() == 4 * (mesh.Vertices.size() + data.SplitVertices.size()) };
+        for (size_t vertex{ 0 }; vertex < data.Tangents.size() / 4 && isValid; ++vertex)
+        {
+            const uint32_t originalVertex{ vertex < mesh.Vertices.size() ? static_cast<uint32_t>(vertex) : data.SplitVertices[vertex - mesh.Vertices.size()] };
+            const float* pNormal = mesh.Vertices[originalVertex].Normal;
+            float unitNormal[3]{ pNormal[0], pNormal[1], pNormal[2] };
+            const float length{ std::sqrt(Dot(unitNormal, unitNormal)) };
+            for (float& axis : unitNormal) axis /= length;
+            isValid = IsValidFrame(&data.Tangents[4 * vertex], unitNormal);
+        }
+        Check(isValid, "random meshes give valid frames without NaNs");
+        Check(data.SplitVertices.empty() == false && data.DegenerateTriangleCount > 0, "random meshes have splits & degenerate triangles");
+
+        // Every vertex only reads its own corners, so the thread count can't change the result
+        TestMesh singleThreadMesh{ original };
+        const TangentData singleThreadData = Generate(singleThreadMesh, 1);
+        Check(singleThreadData.Tangents == data.Tangents && singleThreadData.SplitVertices == data.SplitVertices && singleThreadMesh.Indices == mesh.Indices,
+            "a single thread gives the same tangents as all threads");
+    }
+}
+
+int main()
+{
+    TestGrid();
+    TestMirroredUVs();
+    TestDegenerateUVs();
+    TestRandomMesh();
+
+    if (g_FailureCount > 0) {
+        std::cerr << g_FailureCount << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "all tangent generator checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,177 @@
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include "Source/VertexQuantizer.h"
+
+// Checks the error bounds of the quantized vertex format, it doesn't touch Vulkan so it runs without a GPU
+namespace
+{
+    // A rounded 10:10 octahedral normal is off by less than 0.25 degrees, the 10 bit tangent angle adds half a step of 360 / 1024 degrees
+    constexpr float MAX_NORMAL_ERROR{ 0.25f * 3.14159265f / 180.f };
+    constexpr float MAX_TANGENT_ERROR{ MAX_NORMAL_ERROR + 3.14159265f / 1024.f };
+
+    int g_FailureCount{ 0 };
+
+    void Check(bool condition, const char* description)
+    {
+        if (condition) return;
+        std::cerr << "FAILED: " << description << std::endl;
+        ++g_FailureCount;
+    }
+
+    bool IsFinite(const VertexPBR& vertex)
+    {
+        for (float value : { vertex.pos.x, vertex.pos.y, vertex.pos.z, vertex.normal.x, vertex.normal.y, vertex.normal.z,
+            vertex.tangent.x, vertex.tangent.y, vertex.tangent.z, vertex.tangent.w, vertex.texCoord.x, vertex.texCoord.y })
+        {
+            if (std::isfinite(value) == false) return false;
+        }
+        return true;
+    }
+
+    float GetAngle(const glm::vec3& a, const glm::vec3& b)
+    {
+        return std::acos(glm::clamp(glm::dot(glm::normalize(a), glm::normalize(b)), -1.f, 1.f));
+    }
+
+    // Random unit normals with a tangent perpendicular to them, plus the poles & the folded edges of the octahedron
+    std::vector<VertexPBR> CreateVertices(const MeshBounds& bounds)
+    {
+        std::mt19937 generator{ 5489u };
+        std::uniform_real_distribution<float> unitDistribution{ 0.f, 1.f };
+        std::normal_distribution<float> directionDistribution{};
+        std::uniform_real_distribution<float> texCoordDistribution{ -2.f, 4.f };
+
+        std::vector<glm::vec3> normals{ { 0.f, 0.f, 1.f }, { 0.f, 0.f, -1.f }, { 1.f, 0.f, 0.f }, { -1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, -1.f, 0.f },
+            { 1.f, 1.f, 0.f }, { -1.f, 1.f, 0.f }, { 1.f, -1.f, 0.f }, { -1.f, -1.f, 0.f }, { 0.f, 0.001f, -1.f }, { 0.001f, 0.f, -1.f } };
+        while (normals.size() < 100'000) normals.push_back({ directionDistribution(generator), directionDistribution(generator), directionDistribution(generator) });
+
+        std::vector<VertexPBR> vertices{};
+        for (size_t i{ 0 }; i < normals.size(); ++i)
+        {
+            VertexPBR vertex{};
+            glm::vec3 fraction{ unitDistribution(generator), unitDistribution(generator), unitDistribution(generator) };
+            if (i < 2) fraction = glm::vec3{ static_cast<float>(i) }; // Both corners of the bounds
+            vertex.pos = bounds.min + fraction * (bounds.max - bounds.min);
+
+            // Scaled normals are normalized before they're encoded
+            vertex.normal = normals[i] * (0.5f + unitDistribution(generator));
+            glm::vec3 unitNormal = glm::normalize(vertex.normal);
+            glm::vec3 direction{ directionDistribution(generator), directionDistribution(generator), directionDistribution(generator) };
+            glm::vec3 tangent = glm::normalize(direction - unitNormal * glm::dot(direction, unitNormal));
+            vertex.tangent = glm::vec4{ tangent, i % 2 == 0 ? 1.f : -1.f };
+
+            vertex.texCoord = glm::vec2{ texCoordDistribution(generator), texCoordDistribution(generator) };
+            vertices.push_back(vertex);
+        }
+        return vertices;
+    }
+
+    void TestErrorBounds()
+    {
+        const MeshBounds bounds{ glm::vec3{ -3.f, 0.5f, -120.f }, glm::vec3{ 5.f, 0.75f, 80.f } };
+        const std::vector<VertexPBR> vertices = CreateVertices(bounds);
+        std::vector<VertexPBRQuantized> quantizedVertices{};
+        quantizer::QuantizeVertices(vertices, bounds, quantizedVertices);
+        Check(quantizedVertices.size() == vertices.size(), "one quantized vertex per vertex");
+
+        // Rounding to the closest of 65535 steps per axis, with some room for the float math of the decoding
+        const glm::vec3 extent{ bounds.max - bounds.min };
+        const glm::vec3 maxPositionError{ extent * (0.5f / 65535.f) + extent * 1e-6f };
+
+        bool isPositionInBounds{ true }, isNormalInBounds{ true }, isTangentInBounds{ true }, isTexCoordInBounds{ true };
+        bool isHandednessKept{ true }, isFinite{ true }, isUnitLength{ true };
+        for (size_t i{ 0 }; i < vertices.size(); ++i)
+        {
+            const VertexPBR& vertex = vertices[i];
+            const VertexPBR decodedVertex = quantizer::DecodeVertex(quantizedVertices[i], bounds);
+            isFinite = isFinite && IsFinite(decodedVertex);
+
+            for (int axis{ 0 }; axis < 3; ++axis)
+            {
+                isPositionInBounds = isPositionInBounds && std::abs(decodedVertex.pos[axis] - vertex.pos[axis]) <= maxPositionError[axis];
+            }
+            isNormalInBounds = isNormalInBounds && GetAngle(decodedVertex.normal, vertex.normal) <= MAX_NORMAL_ERROR;
+            isTangentInBounds = isTangentInBounds && GetAngle(glm::vec3{ decodedVertex.tangent }, glm::vec3{ vertex.tangent }) <= MAX_TANGENT_ERROR;
+            isHandednessKept = isHandednessKept && decodedVertex.tangent.w == vertex.tangent.w;
+            isUnitLength = isUnitLength && std::abs(glm::length(decodedVertex.normal) - 1.f) < 1e-5f && std::abs(glm::length(glm::vec3{ decodedVertex.tangent }) - 1.f) < 1e-5f;
+
+            // Half floats keep 11 significant bits, rounding to the closest is off by at most 2^-11 relative
+            for (int axis{ 0 }; axis < 2; ++axis)
+            {
+                isTexCoordInBounds = isTexCoordInBounds && std::abs(decodedVertex.texCoord[axis] - vertex.texCoord[axis]) <= std::abs(vertex.texCoord[axis]) * 0x1p-11f + 0x1p-24f;
+            }
+        }
+        Check(isFinite, "decoded vertices are finite");
+        Check(isPositionInBounds, "positions are within half a step of the bounds");
+        Check(isNormalInBounds, "normals are within 0.25 degrees");
+        Check(isTangentInBounds, "tangents are within half an angle step & the normal error");
+        Check(isTexCoordInBounds, "texture coordinates are within half float precision");
+        Check(isHandednessKept, "the bitangent sign is kept");
+        Check(isUnitLength, "decoded normals & tangents are unit length");
+
+        // The corners of the bounds decode exactly
+        const VertexPBR minCorner = quantizer::DecodeVertex(quantizedVertices[0], bounds);
+        const VertexPBR maxCorner = quantizer::DecodeVertex(quantizedVertices[1], bounds);
+        Check(minCorner.pos == bounds.min && maxCorner.pos == bounds.max, "the corners of the bounds are exact");
+
+        // The error report agrees with the vertex by vertex checks
+        const QuantizationError error = quantizer::MeasureError(vertices, quantizedVertices, bounds);
+        Check(error.Position <= glm::length(maxPositionError), "measured position error");
+        Check(error.Normal <= MAX_NORMAL_ERROR && error.Tangent <= MAX_TANGENT_ERROR, "measured normal & tangent error");
+        Check(error.Normal > 0.f && error.Tangent > 0.f && error.Position > 0.f, "the measured errors aren't empty");
+
+        bool hasThrown{ false };
+        try { quantizer::MeasureError(vertices, {}, bounds); }
+        catch (const std::invalid_argument&) { hasThrown = true; }
+        Check(hasThrown, "measuring mismatched vertices throws");
+    }
+
+    void TestDegenerateVertices()
+    {
+        // Flat along y, without a normal or tangent
+        const MeshBounds bounds{ glm::vec3{ -1.f, 2.f, -1.f }, glm::vec3{ 1.f, 2.f, 1.f } };
+        std::vector<VertexPBR> vertices(3);
+        vertices[0].pos = glm::vec3{ 0.25f, 2.f, -0.5f };
+        vertices[1].pos = glm::vec3{ -1.f, 2.f, 1.f };
+        vertices[1].normal = glm::vec3{ 0.f, 1.f, 0.f };
+        vertices[2].pos = glm::vec3{ 1.f, 2.f, 1.f };
+        vertices[2].tangent = glm::vec4{ 0.f, 0.f, 0.f, -1.f };
+
+        std::vector<VertexPBRQuantized> quantizedVertices{};
+        quantizer::QuantizeVertices(vertices, bounds, quantizedVertices);
+
+        bool isFinite{ true }, isFlat{ true };
+        for (const VertexPBRQuantized& quantizedVertex : quantizedVertices)
+        {
+            const VertexPBR decodedVertex = quantizer::DecodeVertex(quantizedVertex, bounds);
+            isFinite = isFinite && IsFinite(decodedVertex);
+            isFlat = isFlat && decodedVertex.pos.y == 2.f;
+        }
+        Check(isFinite, "vertices without a normal or tangent decode to finite values");
+        Check(isFlat, "a flat axis of the bounds decodes exactly");
+        Check(quantizer::DecodeVertex(quantizedVertices[0], bounds).normal.z > 0.999f, "a missing normal points along z");
+        Check(quantizer::DecodeVertex(quantizedVertices[2], bounds).tangent.w == -1.f, "the sign of a zero tangent is kept");
+
+        const QuantizationError error = quantizer::MeasureError(vertices, quantizedVertices, bounds);
+        Check(std::isfinite(error.Position) && std::isfinite(error.Normal) && std::isfinite(error.Tangent) && std::isfinite(error.TexCoord), "measured errors are finite");
+    }
+}
+
+int main()
+{
+    TestErrorBounds();
+    TestDegenerateVertices();
+
+    if (g_FailureCount > 0) {
+        std::cerr << g_FailureCount << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "all vertex quantizer checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
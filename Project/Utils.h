@@ -4,29 +4,81 @@
 #include <vector>
 #include <vulkan/vulkan_core.h>
 #include <fstream>
+#include <string>
+#include <type_traits>
 #include "DataTypes.h"
 
 namespace config
 {
+	const std::vector<const char*> ValidationLayers{ "VK_LAYER_KHRONOS_validation" };
+#ifdef NDEBUG
+	const bool EnableValidationLayers = false;
+#else
+	const bool EnableValidationLayers = true;
+#endif
+
 	const uint32_t WIDTH = 800;
 	const uint32_t HEIGHT = 600;
 
 	const uint32_t MAX_FRAMES_IN_FLIGHT = 2;
 
-	const std::string VERTEX_SHADER_PATH = "Resources/Shaders/PBR.vert.spv";
+	const VkDeviceSize MEMORY_BLOCK_SIZE = 64 * 1024 * 1024; // Size of the device memory blocks resources are sub-allocated from
+	const VkDeviceSize STAGING_RING_SIZE = 32 * 1024 * 1024; // Uploads bigger than this get a dedicated staging buffer
+	const uint32_t GEOMETRY_POOL_VERTEX_COUNT = 1024 * 1024; // Vertices shared by all meshes
+	const uint32_t GEOMETRY_POOL_INDEX_COUNT = 4 * 1024 * 1024; // Indices shared by all meshes
+
+	const size_t VERTEX_DEDUPLICATION_SORT_THRESHOLD = 8 * 1024 * 1024; // Triangle corners, bigger meshes are welded with a parallel sort
+	const uint32_t VERTEX_CACHE_SIZE = 16; // Post-transform cache entries the mesh optimizer simulates
+	const bool OPTIMIZE_OVERDRAW = true; // Sort triangle clusters so the outer surfaces of a mesh are drawn first
+	const float OVERDRAW_THRESHOLD = 1.05f; // Vertex cache efficiency the overdraw sort may give up per cluster
+	const bool REPORT_MESH_OPTIMIZATION = false; // Print ACMR & ATVR before and after the mesh optimizer
+	const bool REPORT_TANGENT_GENERATION = false; // Print the degenerate triangles, split vertices & time of the tangent generator
+
+	const uint32_t MAX_LOD_COUNT = 5; // Levels of detail per mesh, including the full detail one
+	const float LOD_REDUCTION = 0.5f; // Triangles every level keeps of the previous one
+	const float LOD_MAX_ERROR = 0.05f; // Largest simplification error, relative to the diagonal of the mesh bounds
+	const float LOD_PIXEL_ERROR = 1.0f; // Projected error a level of detail may have on screen
+	const float LOD_HYSTERESIS = 0.25f; // Part of the pixel error a coarser level has to stay below before switching to it
+
+	const uint32_t MESHLET_MAX_VERTICES = 64; // Has to match max_vertices in PBR_Meshlet.mesh
+	const uint32_t MESHLET_MAX_TRIANGLES = 124; // Has to match max_primitives in PBR_Meshlet.mesh, 124 * 3 bytes still fit 4 byte alignment
+	const bool CULL_MESHLETS = true; // Frustum & back face cull the meshlets of the full detail level on the CPU every frame
+	const bool USE_MESH_SHADERS = true; // Draw the full detail level with VK_EXT_mesh_shader if the device supports it, VertexPBR only
+	const bool REPORT_MESHLETS = false; // Print the meshlet counts & fill rates of every mesh
+	const bool CULL_OBJECTS = true; // Skip the draws of meshes whose bounds are outside of the frustum, tested on the CPU every frame
+
+	const bool DRAW_INSTANCED = false; // Draw a grid of copies of the vehicle in a single draw with PBR_Instanced.vert, VertexPBR only
+	const uint32_t INSTANCE_COUNT = 10000; // Copies in the grid, their transforms are written every frame
+	const float INSTANCE_SPACING = 1.5f; // Distance between the copies, in vehicle sizes
+	const bool GPU_CULLING = false; // Frustum cull the grid with Cull.comp & draw the visible copies with one indirect draw, VertexPBR only, replaces DRAW_INSTANCED
+	const bool VALIDATE_GPU_CULLING = EnableValidationLayers; // Compare the draws Cull.comp writes for the startup camera against culling on the CPU, throws on a mismatch
+
+	const bool VALIDATE_GEOMETRY_COMPACTION = false; // Free a range in front of the vehicle, compact the geometry pool at startup & compare the moved vertices & indices
+
+	const bool GENERATE_MIPMAPS = true; // Full mip chains for every texture, sampled trilinearly
+	const bool FORCE_CPU_MIPMAPS = false; // Filter the mip levels on the CPU even if the GPU can blit the texture format
+	const bool IMPORT_HOST_MEMORY = true; // Import mapped mesh & texture caches as transfer sources with VK_EXT_external_memory_host instead of copying them into the staging ring
+	const bool VALIDATE_HOST_MEMORY_IMPORT = EnableValidationLayers; // Copy an unaligned range of an imported file at startup & compare it with the file, throws on a mismatch
+	const bool USE_BLOCK_COMPRESSION = true; // Upload BC4, BC5 & BC7 mip chains cooked into KTX2 files next to the images if the device supports textureCompressionBC
+	const bool PACK_SPECULAR_GLOSS = false; // One RG texture with the specular luminance & the gloss instead of two, drops the specular color
+	const uint32_t MATERIAL_TEXTURE_COUNT = 4; // Has to match the size of texSampler in PBR.frag, missing textures repeat the last one
+
+	using VertexType = VertexPBR; // VertexPBR or VertexPBRQuantized
+	const bool REPORT_VERTEX_QUANTIZATION = false; // Print the largest errors the quantization of every mesh introduces
+
+	const std::string VERTEX_SHADER_PATH = std::is_same_v<VertexType, VertexPBRQuantized> ? "Resources/Shaders/PBR_Quantized.vert.spv" : "Resources/Shaders/PBR.vert.spv";
+	const std::string INSTANCED_VERTEX_SHADER_PATH = "Resources/Shaders/PBR_Instanced.vert.spv";
+	const std::string INDIRECT_VERTEX_SHADER_PATH = "Resources/Shaders/PBR_Indirect.vert.spv";
+	const std::string CULL_SHADER_PATH = "Resources/Shaders/Cull.comp.spv";
+	const std::string MESH_SHADER_PATH = "Resources/Shaders/PBR_Meshlet.mesh.spv";
 	const std::string FRAGMENT_SHADER_PATH = "Resources/Shaders/PBR.frag.spv";
 
+	const std::string ASSET_PACK_PATH = "Resources.pack"; // Built by the AssetPack target, mounted at "Resources/" if it exists
+
 	const std::string MODEL_PATH = "Resources/Models/viking_room.obj";
 	const std::string TEXTURE_PATH = "Resources/Textures/viking_room.png";
 
 	const std::vector<const char*> DeviceExtensions{ VK_KHR_SWAPCHAIN_EXTENSION_NAME };
-	const std::vector<const char*> ValidationLayers{ "VK_LAYER_KHRONOS_validation" };
-#ifdef NDEBUG
-	const bool EnableValidationLayers = false;
-#else
-	const bool EnableValidationLayers = true;
-#endif
-	using VertexType = VertexPBR;
 
 	const float MODEL_OFFSET_X = 0.0f;
 	const std::vector<Vertex3D> Vertices{